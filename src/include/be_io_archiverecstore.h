@@ -11,6 +11,8 @@
 #ifndef __BE_ARCHIVERECSTORE_H__
 #define __BE_ARCHIVERECSTORE_H__
 
+#include <future>
+
 #include <be_io_recordstore.h>
 
 namespace BiometricEvaluation {
@@ -133,6 +135,28 @@ namespace BiometricEvaluation {
 			    const std::string &key)
 			    override;
 
+			void
+			enableChecksums()
+			    override;
+
+			bool
+			hasChecksums()
+			    const
+			    override;
+
+			uint32_t
+			getChecksum(
+			    const std::string &key)
+			    const
+			    override;
+
+			std::vector<std::string>
+			getKeyRange(
+			    const std::string &first,
+			    const std::string &last = "")
+			    const
+			    override;
+
 			void move(
 			    const std::string &pathname)
 			    override;
@@ -180,6 +204,11 @@ namespace BiometricEvaluation {
 			 *
 			 * @param[in] pathname
 			 *	The pathname of the existing RecordStore.
+			 * @param[in] deadSpaceRatio
+			 *	Fraction of the archive file that must be
+			 *	unreferenced before compaction is performed.
+			 *	When 0, compaction is performed whenever
+			 *	needsVacuum() is true.
 			 * @throw Error::ObjectDoesNotExist
 			 *	A record with the given key does not exist.
 			 * @throw Error::StrategyError
@@ -189,7 +218,78 @@ namespace BiometricEvaluation {
 			 * This is an expensive operation.
 			 */
 			static void vacuum(
-			    const std::string &pathname);
+			    const std::string &pathname,
+			    double deadSpaceRatio = 0.0);
+
+			/**
+			 * @brief
+			 * Run vacuum() on another thread.
+			 * @details
+			 * The RecordStore at pathname must not be opened
+			 * by any other object until the returned future
+			 * is ready.
+			 *
+			 * @param[in] pathname
+			 *	The pathname of the existing RecordStore.
+			 * @param[in] deadSpaceRatio
+			 *	See vacuum(const std::string&, double).
+			 * @return
+			 *	Future that becomes ready when compaction
+			 *	has finished. Exceptions from vacuum() are
+			 *	rethrown by get().
+			 */
+			static std::future<void> vacuumAsync(
+			    const std::string &pathname,
+			    double deadSpaceRatio = 0.0);
+
+			/**
+			 * @brief
+			 * Compact this RecordStore in place.
+			 * @details
+			 * Live records are copied to a new archive file in
+			 * archive order using large sequential transfers,
+			 * and a new manifest is written. The new files
+			 * replace the old only after both are on disk; a
+			 * compaction interrupted before that point is
+			 * discarded the next time the RecordStore is opened.
+			 * The sequence cursor is not disturbed.
+			 *
+			 * @throw Error::StrategyError
+			 *	RecordStore was opened read-only, or an
+			 *	error occurred when using the underlying
+			 *	storage system.
+			 */
+			void vacuum();
+
+			/**
+			 * @brief
+			 * Obtain the number of bytes in the archive file that
+			 * are not referenced by any record.
+			 *
+			 * @return
+			 *	Size of removed and replaced data, in bytes.
+			 */
+			uint64_t getDeadSpace() const;
+
+			/**
+			 * @brief
+			 * Compact automatically when dead space grows too
+			 * large.
+			 * @details
+			 * After each remove() (including the one performed
+			 * by replace()), vacuum() is called if the fraction
+			 * of the archive that is dead space is at least
+			 * deadSpaceRatio.
+			 *
+			 * @param[in] deadSpaceRatio
+			 *	Threshold in (0, 1], or 0 to disable automatic
+			 *	compaction (the default).
+			 *
+			 * @throw Error::StrategyError
+			 *	deadSpaceRatio is out of range.
+			 */
+			void setVacuumThreshold(
+			    double deadSpaceRatio);
 	
 			/**
 			 * Obtain the name of the file storing the data for 
@@ -113,6 +113,28 @@ namespace BiometricEvaluation {
 			    const std::string &key)
 			    override;
 
+			void
+			enableChecksums()
+			    override;
+
+			bool
+			hasChecksums()
+			    const
+			    override;
+
+			uint32_t
+			getChecksum(
+			    const std::string &key)
+			    const
+			    override;
+
+			std::vector<std::string>
+			getKeyRange(
+			    const std::string &first,
+			    const std::string &last = "")
+			    const
+			    override;
+
 			void move(
 			    const std::string &pathname)
 			    override;
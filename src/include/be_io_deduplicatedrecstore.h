@@ -0,0 +1,242 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_IO_DEDUPLICATEDRECSTORE_H__
+#define __BE_IO_DEDUPLICATEDRECSTORE_H__
+
+#include <memory>
+#include <be_io_recordstore.h>
+
+namespace BiometricEvaluation
+{
+	namespace IO
+	{
+		/**
+		 * @brief
+		 * Sibling-implemented IO::RecordStore that stores identical
+		 * record data only once.
+		 * @details
+		 * Record data is addressed by its SHA-256 digest.  Each
+		 * unique blob of data is stored once in an internal
+		 * RecordStore, and each key refers to the digest of its
+		 * data.  Blobs are reference counted and removed when
+		 * the last key referring to them is removed.
+		 */
+		class DeduplicatedRecordStore : public RecordStore
+		{
+		public:
+			/**
+			 * Create a new DeduplicatedRecordStore, read/write
+			 * mode.
+			 *
+			 * @param[in] pathname
+			 * 	The directory where the store is to be created.
+			 * @param[in] description
+			 *	The store's description.
+			 * @param[in] recordStoreType
+			 *	The type of RecordStore subclass the internal
+			 *	RecordStores should be.
+			 *
+			 * @throw Error::ObjectExists
+			 * 	The store already exists.
+			 * @throw Error::StrategyError
+			 * 	An error occurred when accessing the underlying
+			 * 	file system.
+			 */
+			DeduplicatedRecordStore(
+			    const std::string &pathname,
+			    const std::string &description,
+			    const RecordStore::Kind &recordStoreType =
+			    RecordStore::Kind::Default);
+
+			/**
+			 * Open an existing DeduplicatedRecordStore.
+			 *
+			 * @param[in] pathname
+			 *	The path name of the store.
+			 * @param[in] mode
+			 *	Open mode, read-only or read-write.
+			 *
+			 * @throw Error::ObjectDoesNotExist
+			 *	The store does not exist.
+			 * @throw Error::StrategyError
+			 *	An error occurred when accessing the underlying
+			 *	file system.
+			 */
+			DeduplicatedRecordStore(
+			    const std::string &pathname,
+			    IO::Mode mode = IO::Mode::ReadOnly);
+
+			/*
+			 * Destructor.
+			 */
+			~DeduplicatedRecordStore();
+
+			/**
+			 * @brief
+			 * Obtain the size of all records' data.
+			 * @details
+			 * This is the number of bytes the records would
+			 * occupy if each were stored separately.
+			 *
+			 * @return
+			 *	Sum of the lengths of all records.
+			 *
+			 * @throw Error::StrategyError
+			 *	An error occurred when using the underlying
+			 *	storage system.
+			 */
+			uint64_t
+			getLogicalSize()
+			    const;
+
+			/**
+			 * @brief
+			 * Obtain the deduplication ratio.
+			 * @details
+			 * getSpaceUsed() reports the space actually used,
+			 * after deduplication.
+			 *
+			 * @return
+			 *	getLogicalSize() divided by the size of the
+			 *	unique data stored, or 1.0 when the store
+			 *	is empty.
+			 *
+			 * @throw Error::StrategyError
+			 *	An error occurred when using the underlying
+			 *	storage system.
+			 */
+			double
+			getDeduplicationRatio()
+			    const;
+
+			/*
+			 * Implementation of the RecordStore interface.
+			 */
+
+			/*
+			 * We need the base class insert() and replace() as well
+			 * otherwise, they are hidden by the declarations below.
+			 */
+			using RecordStore::insert;
+			using RecordStore::replace;
+
+			uint64_t
+			getSpaceUsed() const override;
+			void sync() const override;
+			unsigned int getCount() const override;
+			std::string getPathname() const override;
+			std::string getDescription() const override;
+			void changeDescription(
+			    const std::string &description) override;
+
+			void
+			insert(
+			    const std::string &key,
+			    const void *const data,
+			    const uint64_t size)
+			    override;
+
+			void
+			remove(
+			    const std::string &key) override;
+
+			Memory::uint8Array
+			read(
+			    const std::string &key) const override;
+
+			uint64_t
+			length(
+			    const std::string &key) const override;
+
+			void
+			flush(
+			    const std::string &key) const override;
+
+			RecordStore::Record
+			sequence(
+			    int cursor = BE_RECSTORE_SEQ_NEXT)
+			    override;
+
+			std::string
+			sequenceKey(
+			    int cursor = BE_RECSTORE_SEQ_NEXT)
+			    override;
+
+			void
+			setCursorAtKey(
+			    const std::string &key)
+			    override;
+
+			void
+			enableChecksums()
+			    override;
+
+			bool
+			hasChecksums()
+			    const
+			    override;
+
+			uint32_t
+			getChecksum(
+			    const std::string &key)
+			    const
+			    override;
+
+			std::vector<std::string>
+			getKeyRange(
+			    const std::string &first,
+			    const std::string &last = "")
+			    const
+			    override;
+
+			void
+			move(
+			    const std::string &pathname)
+			    override;
+
+			/**
+			 * @brief
+			 * Copy constructor (disabled).
+			 * @details
+			 * Disabled because this object could represent a
+			 * file on disk.
+			 *
+			 * @param rhs
+			 *	DeduplicatedRecordStore object to copy.
+			 */
+			DeduplicatedRecordStore(
+			    const DeduplicatedRecordStore &rhs) = delete;
+
+			/**
+			 * @brief
+			 * Assignment operator (disabled).
+			 * @details
+			 * Disabled because this object could represent a
+			 * file on disk.
+			 *
+			 * @param rhs
+			 *	DeduplicatedRecordStore object to assign.
+			 *
+			 * @return
+			 * 	DeduplicatedRecordStore object, now containing
+			 *	the contents of rhs.
+			 */
+			DeduplicatedRecordStore&
+			operator=(
+			    const DeduplicatedRecordStore &rhs) = delete;
+
+		private:
+			class Impl;
+			std::unique_ptr<DeduplicatedRecordStore::Impl> pimpl;
+		};
+	}
+}
+#endif	/* __BE_IO_DEDUPLICATEDRECSTORE_H__ */
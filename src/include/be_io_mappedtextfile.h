@@ -0,0 +1,123 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef BE_IO_MAPPEDTEXTFILE_H_
+#define BE_IO_MAPPEDTEXTFILE_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BiometricEvaluation
+{
+	namespace IO
+	{
+		/**
+		 * @brief
+		 * A read-only text file mapped into memory, with an index
+		 * of its lines.
+		 * @details
+		 * The file is mapped and the start of each line located
+		 * in a single pass at construction, after which any line
+		 * is obtained in constant time as a view into the mapping,
+		 * without copying. A line does not include its newline;
+		 * a final line without a newline is still a line.
+		 *
+		 * Views returned remain valid for the lifetime of the
+		 * object.
+		 */
+		class MappedTextFile
+		{
+		public:
+			/**
+			 * @brief
+			 * Map and index a text file.
+			 *
+			 * @param[in] pathname
+			 * Path to the text file.
+			 * @param[in] populate
+			 * Whether to read the entire file into memory
+			 * now, rather than as lines are accessed.
+			 *
+			 * @throw Error::ObjectDoesNotExist
+			 * pathname does not exist.
+			 * @throw Error::FileError
+			 * pathname could not be opened or mapped.
+			 */
+			MappedTextFile(
+			    const std::string &pathname,
+			    bool populate = false);
+
+			~MappedTextFile();
+
+			MappedTextFile(
+			    const MappedTextFile&) = delete;
+			MappedTextFile&
+			operator=(
+			    const MappedTextFile&) = delete;
+
+			/** @return Number of lines in the file. */
+			uint64_t
+			getNumLines()
+			    const;
+
+			/**
+			 * @brief
+			 * Obtain a line of the file.
+			 *
+			 * @param[in] lineNum
+			 * Index of the line, starting at 0.
+			 *
+			 * @return
+			 * The line, without its newline.
+			 *
+			 * @throw Error::ObjectDoesNotExist
+			 * lineNum is not less than getNumLines().
+			 */
+			std::string_view
+			getLine(
+			    uint64_t lineNum)
+			    const;
+
+			/** @return Size of the file, in bytes. */
+			uint64_t
+			getSize()
+			    const;
+
+		private:
+			/** Record the start of each line of the mapping */
+			void
+			indexLines();
+
+			/** @return Offset of the start of a line */
+			uint64_t
+			getLineStart(
+			    uint64_t lineNum)
+			    const;
+
+			/** Start of the mapping */
+			const char *_data{nullptr};
+			/** Size of the mapping */
+			uint64_t _size{0};
+			/**
+			 * Offset of the start of each line, followed by
+			 * one past the newline ending the last line.
+			 * Files smaller than 4 GiB are indexed in
+			 * _shortLineStarts instead, at half the size.
+			 */
+			std::vector<uint64_t> _lineStarts;
+			/** _lineStarts, for files smaller than 4 GiB */
+			std::vector<uint32_t> _shortLineStarts;
+		};
+	}
+}
+
+#endif /* BE_IO_MAPPEDTEXTFILE_H_ */
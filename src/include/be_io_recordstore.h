@@ -89,6 +89,8 @@ namespace BiometricEvaluation {
 				Compressed,
 				/** ListRecordStore */
 				List,
+				/** DeduplicatedRecordStore */
+				Deduplicated,
 
 				/** "Default" RecordStore kind */
 				Default = BerkeleyDB
@@ -426,6 +428,135 @@ namespace BiometricEvaluation {
 			    const std::string &key)
 			    const;
 
+			/**
+			 * @brief
+			 * Begin maintaining a checksum for every record.
+			 * @details
+			 * A CRC-32C of each record's data is stored alongside
+			 * the record when it is inserted or replaced, and
+			 * persists with the RecordStore.  Checksums can
+			 * only be enabled before any records are inserted.
+			 *
+			 * @throw Error::StrategyError
+			 *	The RecordStore is opened read-only or
+			 *	already contains records.
+			 */
+			virtual void
+			enableChecksums() = 0;
+
+			/**
+			 * @return
+			 *	true if a checksum is maintained for every
+			 *	record, false otherwise.
+			 */
+			virtual bool
+			hasChecksums()
+			    const = 0;
+
+			/**
+			 * @brief
+			 * Obtain the checksum stored for a record.
+			 *
+			 * @param[in] key
+			 *	The key of the record.
+			 *
+			 * @return
+			 *	CRC-32C of the record's data when it was
+			 *	stored.
+			 *
+			 * @throw Error::ObjectDoesNotExist
+			 *	No checksum is stored for key.
+			 * @throw Error::StrategyError
+			 *	Checksums are not enabled.
+			 */
+			virtual uint32_t
+			getChecksum(
+			    const std::string &key)
+			    const = 0;
+
+			/**
+			 * @brief
+			 * Check every record against its stored checksum.
+			 * @details
+			 * The RecordStore is synchronized, and its keys are
+			 * divided into contiguous ranges, each read by a
+			 * separate thread through its own read-only handle,
+			 * so that verification is limited by the storage
+			 * device rather than by a single reader.
+			 *
+			 * @param[in] numThreads
+			 *	Number of threads to read with.  When 0,
+			 *	the number of hardware threads is used.
+			 *
+			 * @return
+			 *	Keys of records whose data could not be read
+			 *	or did not match the stored checksum.
+			 *	Records with no stored checksum, such as
+			 *	those inserted before checksums were enabled,
+			 *	are not checked.  Empty when no corruption
+			 *	was found.
+			 *
+			 * @throw Error::StrategyError
+			 *	Checksums are not enabled, or an error
+			 *	occurred when using the underlying storage
+			 *	system.
+			 */
+			virtual std::vector<std::string>
+			verify(
+			    uint32_t numThreads = 0)
+			    const;
+
+			/**
+			 * @brief
+			 * Obtain the keys within a range.
+			 * @details
+			 * Keys are compared byte-wise.  Implementations use
+			 * the ordered index of the underlying storage system
+			 * where one exists, and otherwise maintain a sorted
+			 * index of keys, so the cost is proportional to the
+			 * number of keys returned rather than to the number
+			 * of records in the RecordStore.  The sequence
+			 * cursor is not affected.
+			 *
+			 * @param[in] first
+			 *	Smallest key to return.
+			 * @param[in] last
+			 *	Keys greater than or equal to last are not
+			 *	returned.  When empty, the range is unbounded.
+			 *
+			 * @return
+			 *	Keys k where first <= k < last, in ascending
+			 *	order.
+			 *
+			 * @throw Error::StrategyError
+			 *	An error occurred when using the underlying
+			 *	storage system.
+			 */
+			virtual std::vector<std::string>
+			getKeyRange(
+			    const std::string &first,
+			    const std::string &last = "")
+			    const = 0;
+
+			/**
+			 * @brief
+			 * Obtain the keys that begin with a prefix.
+			 *
+			 * @param[in] prefix
+			 *	Leading characters of keys to return.
+			 *
+			 * @return
+			 *	Keys beginning with prefix, in ascending order.
+			 *
+			 * @throw Error::StrategyError
+			 *	An error occurred when using the underlying
+			 *	storage system.
+			 */
+			std::vector<std::string>
+			getKeysWithPrefix(
+			    const std::string &prefix)
+			    const;
+
 			/** @return Iterator to the first record. */
 			virtual iterator
 			begin()
@@ -535,6 +535,48 @@ namespace BiometricEvaluation
 			uint64_t
 			countLines(
 			    const Memory::uint8Array &textBuffer);
+
+			/**
+			 * @brief
+			 * Compute the CRC-32C (Castagnoli) checksum of a
+			 * buffer.
+			 * @details
+			 * The SSE4.2 CRC32 instruction is used when the
+			 * processor supports it; otherwise a table-driven
+			 * implementation is used.  Both produce identical
+			 * results.
+			 *
+			 * @param data
+			 * Buffer to checksum.
+			 * @param size
+			 * Number of bytes in data.
+			 * @param crc
+			 * Checksum of preceding data, allowing a checksum to
+			 * be computed incrementally.
+			 *
+			 * @return
+			 * CRC-32C of data.
+			 */
+			uint32_t
+			crc32c(
+			    const void *data,
+			    const uint64_t size,
+			    const uint32_t crc = 0);
+
+			/**
+			 * @brief
+			 * Compute the CRC-32C (Castagnoli) checksum of a
+			 * buffer.
+			 *
+			 * @param data
+			 * Buffer to checksum.
+			 *
+			 * @return
+			 * CRC-32C of data.
+			 */
+			uint32_t
+			crc32c(
+			    const Memory::uint8Array &data);
 		}
 	}
 }
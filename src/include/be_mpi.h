@@ -145,7 +145,24 @@ namespace BiometricEvaluation {
 			 * normal control/data messaging cannot
 			 * be used.
 			 */
-			OOB = 2
+			OOB = 2,
+			/**
+			 * @brief
+			 * Results of work package processing, or the
+			 * acknowledgement that they were written.
+			 */
+			Result = 3,
+			/**
+			 * @brief
+			 * Identifiers of work packages that have been
+			 * processed.
+			 */
+			Completion = 4,
+			/**
+			 * @brief
+			 * Samples of the counters of a task.
+			 */
+			Telemetry = 5
 		};
 
 		/** Storage type for MessageTag. */
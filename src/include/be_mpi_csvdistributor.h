@@ -38,6 +38,10 @@ namespace BiometricEvaluation
 		 * checkpoint contains a seed, and the input is not
 		 * currently randomized, and exception is thrown.
 		 * See MPI::CSVResources.
+		 *
+		 * The position of a line is its place in the order the
+		 * lines are read. On restart, lines completed in the
+		 * checkpointed run are passed over.
 		 */
 		class CSVDistributor : public Distributor
 		{
@@ -75,10 +79,17 @@ namespace BiometricEvaluation
 			checkpointSave(const std::string &reason);
 			void
 			checkpointRestore();
+			uint64_t
+			getNumRemainingElements()
+			    const;
 
 		private:
 			std::unique_ptr<MPI::CSVResources> _resources;
 			uint64_t _distributedLineCount{};
+			/* Position of the next line read */
+			uint64_t _nextPosition{0};
+			/* Completed lines past the next position */
+			uint64_t _completedAhead{0};
 		};
 	}
 }
@@ -11,18 +11,28 @@
 #ifndef BE_MPI_CSVRESOURCES_H_
 #define BE_MPI_CSVRESOURCES_H_
 
+#include <memory>
 #include <random>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <utility>
 
-#include <be_memory_autoarray.h>
+#include <be_io_mappedtextfile.h>
 #include <be_mpi_resources.h>
 
 namespace BiometricEvaluation
 {
 	namespace MPI
 	{
+		/**
+		 * @brief
+		 * Resources for distributing the lines of a text file.
+		 * @details
+		 * The file is mapped into memory and its lines indexed
+		 * when first needed, so lines are read in any order
+		 * without copying. Randomizing lines shuffles the index.
+		 */
 		class CSVResources : public Resources
 		{
 		public:
@@ -57,13 +67,13 @@ namespace BiometricEvaluation
 
 			/**
 			 * @brief
-			 * Obtain whether or not the entire CSV was read into
-			 * memory at construction.
+			 * Obtain whether or not the entire CSV is read into
+			 * memory when first used.
 			 *
 			 * @return
-			 * true if the entire INPUTCSVPROPERTY was read into 
-			 * memory at construction, false if an ifstream is
-			 * kept open.
+			 * true if the entire INPUTCSVPROPERTY is read into
+			 * memory when first used, false if it is read as
+			 * lines are.
 			 */
 			bool
 			useBuffer()
@@ -71,12 +81,11 @@ namespace BiometricEvaluation
 			
 			/**
 			 * @brief
-			 * If using buffer, whether or not to randomize how
-			 * lines from the buffer are iterated.
+			 * Whether or not to randomize the order in which
+			 * lines are read.
 			 *
 			 * @return
-			 * true if RANDOMIZEPROPERTY and USEBUFFERPROPERTY are
-			 * true, false otherwise.
+			 * true if RANDOMIZEPROPERTY is true, false otherwise.
 			 */
 			bool
 			randomizeLines()
@@ -101,24 +110,78 @@ namespace BiometricEvaluation
 
 			/**
 			 * @brief
-			 * Obtain the next line from a buffer of file stream.
+			 * Obtain the next line of the CSV.
 			 * @note
 			 * If _randomizeLines is true, sequential calls to
 			 * this method will not necessarily return sequential
 			 * lines.
 			 *
 			 * @return
-			 * The next line from buffer or file stream and the line
-			 * number in the file where the line is from.
+			 * The next line of the CSV and the line number in the
+			 * file where the line is from.
 			 * 
-			 * @throw Error::StrategyError
-			 * Error with the file stream.
+			 * @throw Error::FileError
+			 * Error mapping the CSV.
 			 * @throw Error::ObjectDoesNotExist
-			 * File stream or buffer is exhausted.
+			 * All lines have been read.
 			 */
 			std::pair<uint64_t, std::string>
 			readLine();
 
+			/**
+			 * @brief
+			 * Obtain the next line of the CSV without copying.
+			 * @details
+			 * As readLine(), but the line is a view of the
+			 * mapped CSV, valid for the lifetime of this object.
+			 *
+			 * @return
+			 * The next line of the CSV and the line number in the
+			 * file where the line is from.
+			 *
+			 * @throw Error::FileError
+			 * Error mapping the CSV.
+			 * @throw Error::ObjectDoesNotExist
+			 * All lines have been read.
+			 */
+			std::pair<uint64_t, std::string_view>
+			readLineView();
+
+			/**
+			 * @brief
+			 * Pass over lines as though read with readLine().
+			 *
+			 * @param[in] count
+			 * Number of lines to pass over.
+			 *
+			 * @throw Error::FileError
+			 * Error mapping the CSV.
+			 * @throw Error::ObjectDoesNotExist
+			 * Fewer than count lines remain.
+			 */
+			void
+			skipLines(
+			    uint64_t count);
+
+			/**
+			 * @brief
+			 * Split a line of the CSV on the delimiter, without
+			 * copying.
+			 *
+			 * @param[in] line
+			 * A line of the CSV.
+			 *
+			 * @return
+			 * Views of the tokens of line, or of line itself
+			 * when there is no delimiter.
+			 *
+			 * @see Text::tokenize
+			 */
+			std::vector<std::string_view>
+			tokenizeLine(
+			    std::string_view line)
+			    const;
+
 			/**
 			 * @brief
 			 * Obtain number of lines of input
@@ -126,8 +189,8 @@ namespace BiometricEvaluation
 			 * @return
 			 * Number of lines of input to send.
 			 *
-			 * @throw Error::StrategyError
-			 * Neither CSV file open nor CSV buffer populated.
+			 * @throw Error::FileError
+			 * Error mapping the CSV.
 			 */
 			uint64_t
 			getNumLines()
@@ -150,53 +213,43 @@ namespace BiometricEvaluation
 		private:
 			/**
 			 * @brief
-			 * Open the CSV file.
+			 * Obtain the mapped CSV file.
 			 *
 			 * @details
-			 * If _useBuffer = true, the CSV is read into
-			 * _csvBuffer. Otherwise, _csvStream is opened.
+			 * The CSV is mapped and indexed on first use, as
+			 * Receivers only need the other resources. If
+			 * _randomizeLines is true, _lineOrder is shuffled
+			 * then.
 			 *
 			 * @throw Error::FileError
-			 * Error opening the file.
-			 * @throw Error::ObjectDoesNotExist
-			 * CSV does not exist.
+			 * Error opening or mapping the file.
 			 */
-			void
-			openCSV();
-			
-			std::pair<uint64_t, std::string>
-			readLine(
-			    bool randomize);
-			    
+			const IO::MappedTextFile &
+			getCSV()
+			    const;
+
 			uint32_t _chunkSize;
-	
-			/** Number of lines in CSV file */
-			uint64_t _numLines;
-			/** Lines remaining to be read */
-			uint64_t _remainingLines;
+
+			/** Lines read or passed over */
+			uint64_t _linesRead{0};
 
 			/** Path to file (INPUTCSVPROPERTY) */
 			std::string _csvPath;
-			/** Open file (when _useBuffer == false) */
-			std::shared_ptr<std::ifstream> _csvStream;
+			/** Mapped file, once used */
+			mutable std::unique_ptr<IO::MappedTextFile> _csv;
 
 			/** Whether or not to trim whitespace from lines */
 			bool _trimWhitespace;
 			/** Whether or not to read entire file first */
 			bool _useBuffer;
-			/** Contents of _csvPath (when _useBuffer == true) */
-			Memory::uint8Array _csvBuffer;
-			/** Whether or not to randomize lines in buffer */
+			/** Whether or not to randomize lines */
 			bool _randomizeLines;
-			/** Randomized lines once in _csvBuffer */
-			std::vector<std::pair<uint64_t, std::string>>
-			    _randomizedLines;
+			/** Indices of lines in the order read, if randomized */
+			mutable std::vector<uint64_t> _lineOrder;
 			/** Random number generator */
-			std::mt19937_64 _rng;
+			mutable std::mt19937_64 _rng;
 			/** Seed for random number generator */
 			std::mt19937_64::result_type _rngSeed;
-			/** Current offset into _csvBuffer */
-			uint64_t _offset;
 
 			/** Delimiter to use when tokenizing */
 			std::string _delimiter;
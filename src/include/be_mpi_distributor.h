@@ -10,15 +10,27 @@
 #ifndef _BE_MPI_DISTRIBUTOR_H
 #define _BE_MPI_DISTRIBUTOR_H
 
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <be_error_exception.h>
 #include <be_io_logsheet.h>
 #include <be_io_propertiesfile.h>
 #include <be_mpi.h>
+#include <be_mpi_rangeset.h>
+#include <be_mpi_transport.h>
 #include <be_mpi_resources.h>
+#include <be_mpi_resultcollector.h>
+#include <be_mpi_telemetry.h>
 #include <be_mpi_workpackage.h>
 
 namespace BiometricEvaluation {
@@ -44,6 +56,40 @@ namespace BiometricEvaluation {
 		 * written to that sheet. Otherwise, log messages will be 
 		 * written to a Null Logsheet.
 		 *
+		 * When the Adaptive Chunk Size property is set, the number
+		 * of elements in each work package is chosen from the rate
+		 * at which the requesting task completes packages, as
+		 * reported by its Receivers, so that each package takes
+		 * about Package Duration seconds, and is reduced as the
+		 * remaining work drains so that tasks finish together.  Implementations of
+		 * createWorkPackage() honor this by adding elements until
+		 * isWorkPackageFull() returns true.
+		 *
+		 * When the Result Record Store property is set, results
+		 * emitted by work package processors are returned to the
+		 * Distributor in batches and written to that RecordStore
+		 * while work is distributed.  The job does not end until
+		 * every Receiver's results have been written.
+		 *
+		 * When checkpointing is enabled, Receivers report each work
+		 * package once it has been processed, and once its results
+		 * have been written.  The positions of the input elements
+		 * in completed packages are appended to a completion file
+		 * in the checkpoint path as they are reported, so that a
+		 * restart, even after a crash, distributes only elements
+		 * that were not processed.  Implementations of
+		 * createWorkPackage() take part by calling
+		 * addPackagedPositions() and skipping the positions in
+		 * getCompletedPositions().
+		 *
+		 * When the Work Package Timeout or Speculative Work
+		 * Packages properties are set, packages are also kept
+		 * until reported, and are sent again to a task asking for
+		 * work when late, when every task holding them has ended
+		 * without processing them, or, speculatively, once no new
+		 * work remains.  The first report of a package is used;
+		 * results of a package processed twice replace each other.
+		 *
 		 * @see IO::Properties
 		 * @see MPI::Receiver
 		 * @see MPI::WorkPackage
@@ -68,6 +114,12 @@ namespace BiometricEvaluation {
 			 */
 			static const std::string CHECKPOINTPID;
 
+			/**
+			 * The name of the file recording the positions of
+			 * completed input elements, "Distributor.done".
+			 */
+			static const std::string COMPLETIONFILENAME;
+
 			/**
 			 * @brief
 			 * Constructor with properties file name.
@@ -133,6 +185,45 @@ namespace BiometricEvaluation {
 			 */
 			virtual void checkpointRestore() = 0;
 
+			/**
+			 * @brief
+			 * Obtain the number of elements not yet placed in
+			 * a work package.
+			 * @details
+			 * Used to shrink adaptively sized work packages as
+			 * work drains.  The default implementation returns 0,
+			 * meaning the amount is unknown.
+			 * @return
+			 * Number of elements remaining to be distributed.
+			 */
+			virtual uint64_t getNumRemainingElements() const;
+
+			/**
+			 * @brief
+			 * Determine whether the work package being created
+			 * should receive no more elements.
+			 * @details
+			 * Called by createWorkPackage() before adding each
+			 * element.  Without adaptive sizing, the package is
+			 * full at chunkSize elements.  Otherwise, the
+			 * package is full when the element limit for the
+			 * requesting task is reached, subject to the
+			 * minimum and maximum element and byte properties.
+			 * @param[in] chunkSize
+			 * The fixed chunk size of the implementation, also
+			 * used for a task whose throughput is not yet known.
+			 * @param[in] numElements
+			 * Number of elements already in the package.
+			 * @param[in] numBytes
+			 * Size of the package data so far, in bytes.
+			 * @return
+			 * true if no more elements should be added.
+			 */
+			bool isWorkPackageFull(
+			    uint64_t chunkSize,
+			    uint64_t numElements,
+			    uint64_t numBytes) const;
+
 			/**
 		 	 * @brief
 			 * Get access to the Logsheet object.
@@ -150,6 +241,64 @@ namespace BiometricEvaluation {
 			std::shared_ptr<IO::PropertiesFile>
 			getCheckpointData() const;
 
+			/**
+			 * @brief
+			 * Record input elements placed in the work package
+			 * being created.
+			 * @details
+			 * Called by createWorkPackage() for each position
+			 * of the input it consumes, including elements that
+			 * could not be read, when checkpointing is enabled.
+			 * Positions count from 0 in the order the input is
+			 * sequenced. Once the package has been processed,
+			 * the positions are recorded as completed.
+			 * @param[in] first
+			 * Position of the first element.
+			 * @param[in] last
+			 * Position of the last element.
+			 * @param[in] label
+			 * Identifies the element at last, such as its key,
+			 * so the input can be positioned after it on restore.
+			 */
+			void addPackagedPositions(
+			    uint64_t first,
+			    uint64_t last,
+			    const std::string &label = "");
+
+			/**
+			 * @brief
+			 * Obtain the positions of input elements processed
+			 * by this and earlier runs.
+			 * @details
+			 * On restore, loaded before checkpointRestore() is
+			 * called.
+			 * @return
+			 * The completed positions.
+			 */
+			const MPI::RangeSet &getCompletedPositions() const;
+
+			/**
+			 * @return
+			 * Whether a completion file was found on restore,
+			 * in which case getCompletedPositions() is
+			 * authoritative even when empty.
+			 */
+			bool hasCompletionRecord() const;
+
+			/**
+			 * @brief
+			 * Obtain the label given for the element at the end
+			 * of a run of completed positions.
+			 * @param[in] position
+			 * Last position of a run, such as one before
+			 * getCompletedPositions().getFirstMissing().
+			 * @return
+			 * The label given to addPackagedPositions(), or ""
+			 * if none is known.
+			 */
+			std::string getCompletedLabel(
+			    uint64_t position) const;
+
 		private:
 			/**
 			* @brief
@@ -168,6 +317,29 @@ namespace BiometricEvaluation {
 			    MPI::WorkPackage &workPackage,
 			    int MPITask);
 
+			/*
+			 * Send work packages to a task, in one message when
+			 * the task is a node leader.
+			 */
+			void sendWorkPackages(
+			    const std::vector<MPI::WorkPackage *> &workPackages,
+			    int MPITask);
+
+			/*
+			 * Group the tasks of each node under a leader, and
+			 * tell each task its leader, and each leader the
+			 * tasks it serves. Only leaders remain active.
+			 */
+			void assignNodeLeaders(
+			    const std::vector<int> &nodes);
+
+			/* Number of tasks served by a task, including itself */
+			uint64_t getNumServedTasks(
+			    int MPITask) const;
+
+			/* Tasks served by each node leader, besides itself */
+			std::map<int, std::vector<int>> _nodeLeaders;
+
 			/**
 			 * @brief
 			 * Shut down all MPI processing.
@@ -177,6 +349,31 @@ namespace BiometricEvaluation {
 			 */
 			void shutdown();
 
+			/*
+			 * Receive result batches waiting up to timeout
+			 * milliseconds for the first, queueing them to be
+			 * written, and acknowledge the batches finished,
+			 * ending the job when a batch was not written.
+			 * Returns whether a batch was received.
+			 */
+			bool collectResults(
+			    int timeout);
+
+			/*
+			 * Call collect, which returns whether a message
+			 * was received, until ended is true for each
+			 * Receiver task, or until no message has been
+			 * received for FINALREPORTTIMEOUT seconds, when
+			 * the tasks that have not reported are logged.
+			 */
+			void waitForFinalReports(
+			    const std::string &description,
+			    const std::function<bool(int)> &ended,
+			    const std::function<bool()> &collect);
+
+			/* Messages to and from the Receiver tasks */
+			std::shared_ptr<MPI::Transport> _transport;
+
 			std::unique_ptr<MPI::Resources> _resources;
 
 			/* The list of tasks accepting work */
@@ -184,6 +381,156 @@ namespace BiometricEvaluation {
 
 			std::shared_ptr<IO::Logsheet> _logsheet;
 			std::shared_ptr<IO::PropertiesFile> _checkpointData;
+
+			/** Work package history of a task */
+			struct TaskThroughput {
+				/** Start of the current measurement */
+				std::chrono::steady_clock::time_point since;
+				/** Elements completed since then */
+				uint64_t numCompleted{0};
+				/** Smoothed elements per second, 0 if unknown */
+				double rate{0};
+			};
+
+			/**
+			 * @brief
+			 * Record that a package a task asked for has been
+			 * processed.
+			 * @details
+			 * Updates the task's throughput from the elements
+			 * it completed over at least the package duration.
+			 */
+			void recordCompletion(
+			    int MPITask,
+			    uint64_t numElements);
+
+			/* Throughput of each task sent work */
+			std::map<int, TaskThroughput> _taskThroughput;
+
+			/* The task the package being created is for */
+			int _currentTask{0};
+
+			/*
+			 * Element limit for the package being created,
+			 * computed on first use; 0 when not yet computed.
+			 */
+			mutable uint64_t _packageElementLimit{0};
+
+			/*
+			 * createWorkPackage() has returned an empty package,
+			 * so every element has been distributed.
+			 */
+			bool _inputExhausted{false};
+
+			/* Writes returned results; nullptr when discarded */
+			std::unique_ptr<MPI::ResultCollector> _resultCollector;
+
+			/* Tasks that have sent their last result batch */
+			std::set<int> _resultsEnded;
+
+			/* Positions of elements, with a label for the last */
+			using PackagedPositions = std::vector<
+			    std::pair<MPI::RangeSet::Range, std::string>>;
+
+			/*
+			 * Receive reports of completed work packages,
+			 * waiting up to timeout milliseconds for the first.
+			 * Returns whether a report was received.
+			 */
+			bool collectCompletions(
+			    int timeout);
+
+			/*
+			 * Record positions as completed, appending them to
+			 * the completion file.
+			 */
+			void completePositions(
+			    const PackagedPositions &positions);
+
+			/* Read the completion file of an earlier run */
+			void loadCompletions();
+
+			/*
+			 * Replace the completion file with the completed
+			 * ranges, and reopen it for appending.
+			 */
+			void writeCompletions();
+
+			/* Positions of the package being created */
+			PackagedPositions _packagePositions;
+
+			/* A work package sent and not yet reported */
+			struct OutstandingPackage {
+				/* Positions of the elements in the package */
+				PackagedPositions positions;
+				/* The package, when it may be sent again */
+				MPI::WorkPackage workPackage;
+				/* Tasks the package was sent to */
+				std::set<int> tasks;
+				/* When the package was last sent */
+				std::chrono::steady_clock::time_point sent;
+				/* Task that asked for the package */
+				int requester{0};
+				/* Number of elements in the package */
+				uint64_t numElements{0};
+			};
+
+			/*
+			 * Send an outstanding package to a task asking for
+			 * work, if one is orphaned or late, or when
+			 * speculating, still being processed.
+			 * @return
+			 * Whether a package was sent.
+			 */
+			bool resendWorkPackage(
+			    int MPITask,
+			    bool speculate);
+
+			/* Packages sent, by package ID */
+			std::map<uint64_t, OutstandingPackage>
+			    _outstandingPackages;
+			uint64_t _nextPackageID{1};
+
+			/* Requests for work held until a package is resent */
+			std::deque<int> _idleTasks;
+
+			/* Packages sent again */
+			uint64_t _numResent{0};
+
+			/* Positions processed, and labels at range ends */
+			MPI::RangeSet _completedPositions;
+			std::map<uint64_t, std::string> _completedLabels;
+
+			std::ofstream _completionFile;
+			bool _hasCompletionRecord{false};
+
+			/* Tasks that have sent their last completion report */
+			std::set<int> _completionsEnded;
+
+			/*
+			 * Receive telemetry samples from other tasks,
+			 * waiting up to timeout milliseconds for the first,
+			 * and write them along with a sample of our own
+			 * when one is due. Returns whether a sample was
+			 * received.
+			 */
+			bool collectTelemetry(
+			    int timeout);
+
+			/*
+			 * Write the final sample of each task, their total,
+			 * and a summary to the log.
+			 */
+			void summarizeTelemetry();
+
+			/* Counters of this task */
+			MPI::Telemetry _telemetry;
+
+			/* Where samples are written when not to the log */
+			std::shared_ptr<IO::Logsheet> _telemetryLogsheet;
+
+			/* Final sample of each task that has sent one */
+			std::map<int, MPI::Telemetry::Sample> _finalSamples;
 		};
 	}
 }
@@ -0,0 +1,93 @@
+/**
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties.  Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain.  NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+#ifndef _BE_MPI_RANGESET_H
+#define _BE_MPI_RANGESET_H
+
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace BiometricEvaluation {
+	namespace MPI {
+		/**
+		 * @brief
+		 * A set of positions, kept as ranges of consecutive
+		 * positions.
+		 * @details
+		 * Used to record which elements of a Distributor's input
+		 * have been processed. As work completes mostly in order,
+		 * the set stays small however many elements it holds.
+		 */
+		class RangeSet {
+		public:
+			/** A range of positions, first to last inclusive. */
+			using Range = std::pair<uint64_t, uint64_t>;
+
+			/**
+			 * @brief
+			 * Add a range of positions to the set.
+			 * @param[in] first
+			 * First position of the range.
+			 * @param[in] last
+			 * Last position of the range, >= first.
+			 * @throw Error::ParameterError
+			 * last is less than first.
+			 */
+			void insert(
+			    uint64_t first,
+			    uint64_t last);
+
+			/**
+			 * @brief
+			 * Add a position to the set.
+			 * @param[in] position
+			 * The position.
+			 */
+			void insert(
+			    uint64_t position);
+
+			/**
+			 * @param[in] position
+			 * A position.
+			 * @return
+			 * Whether position is in the set.
+			 */
+			bool contains(
+			    uint64_t position) const;
+
+			/**
+			 * @param[in] from
+			 * Position to start looking at.
+			 * @return
+			 * The first position at or after from that is not
+			 * in the set.
+			 */
+			uint64_t getFirstMissing(
+			    uint64_t from = 0) const;
+
+			/** @return Number of positions in the set. */
+			uint64_t getCount() const;
+
+			/** @return The ranges of the set, in order. */
+			std::vector<Range> getRanges() const;
+
+			/** @return Whether the set holds no positions. */
+			bool empty() const;
+
+		private:
+			/* Last position of each range, by first position */
+			std::map<uint64_t, uint64_t> _ranges;
+			uint64_t _count{0};
+		};
+	}
+}
+
+#endif /* _BE_MPI_RANGESET_H */
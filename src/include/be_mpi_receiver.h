@@ -10,16 +10,24 @@
 #ifndef _BE_MPI_RECEIVER_H
 #define _BE_MPI_RECEIVER_H
 
+#include <deque>
+#include <mutex>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 #include <memory>
 
 #include <be_error_exception.h>
 #include <be_mpi.h>
+#include <be_mpi_transport.h>
 #include <be_mpi_resources.h>
+#include <be_mpi_resultbatch.h>
+#include <be_mpi_telemetry.h>
 #include <be_mpi_workpackage.h>
 #include <be_mpi_workpackageprocessor.h>
 #include <be_process_forkmanager.h>
+#include <be_process_posixthreadmanager.h>
 
 namespace BiometricEvaluation {
 	namespace MPI {
@@ -47,6 +55,46 @@ namespace BiometricEvaluation {
 		 * file, each named after the ID of the MPI task created by
 		 * the MPI runtime, and the child process created by Receiver.
 		 *
+		 * With the Prefetch Packages property greater than 1, the
+		 * receiver keeps that many work packages requested from the
+		 * Distributor or queued locally, hiding the round trip to the
+		 * Distributor behind processing. Queued packages are handed
+		 * to workers after normal completion, but are discarded on
+		 * an early exit. As requests are sent before the packages
+		 * held are processed, adaptively sized packages are sized
+		 * from the packages reported as completed.
+		 *
+		 * Between messages, the receiver waits for an event: a worker
+		 * asking for work, a message from the Distributor, or a
+		 * signal. Messages from the Distributor are detected by a
+		 * helper thread when the MPI implementation supports
+		 * MPI_THREAD_MULTIPLE, and by polling otherwise.
+		 *
+		 * Work packages are handed to each worker through a region
+		 * of memory shared with it, sized by the Worker Shared
+		 * Memory Size property, with only the package size written
+		 * to the worker's pipe. Packages too large for the region
+		 * are written through the pipe.
+		 *
+		 * With the Threaded Workers property set, workers are
+		 * threads of the receiver process instead of child
+		 * processes. Each obtains its processor from
+		 * WorkPackageProcessor::newThreadedProcessor(), so state
+		 * created by performInitialization() is shared rather than
+		 * copied, and work packages are handed over without being
+		 * copied. A worker thread that fails takes the receiver
+		 * with it, and exit signals take effect once the work
+		 * package in progress is finished.
+		 *
+		 * Results emitted by the work package processor are
+		 * returned with a worker's next request for work, and
+		 * gathered into batches of Result Batch Size bytes that are
+		 * sent to the Distributor. When Result Batches In Flight
+		 * batches have not yet been written and another batch is
+		 * ready, work packages are held back from workers until
+		 * the Distributor catches up. Without a Result Record Store
+		 * property, results are discarded by the workers.
+		 *
 		 * @see IO::Properties
 		 * @see IO::Logsheet
 		 * @see MPI::Distributor
@@ -91,14 +139,191 @@ namespace BiometricEvaluation {
 		protected:
 
 		private:
+			class PackageWorker;
+
+			/*
+			 * Wait until a worker or Task-0 has sent a message,
+			 * or a signal is received. Messages from workers
+			 * are ignored unless includeWorkers is set.
+			 */
+			void waitForEvent(
+			    MPI::Transport::MessageWaiter *messageWaiter,
+			    bool replyExpected,
+			    bool includeWorkers = true);
+
 			MPI::TaskStatus requestWorkPackages();
-			void sendWorkPackage(MPI::WorkPackage &workPackage);
+			bool sendWorkPackage(MPI::WorkPackage &workPackage);
+
+			/* Act on an exit command sent out of band */
+			void receiveOutOfBand();
+
+			/*
+			 * Take status messages from workers until one asks
+			 * for work, and return it; nullptr when none does.
+			 */
+			std::shared_ptr<Process::WorkerController>
+			    takeReadyWorker();
+			MPI::TaskCommand receiveWorkPackage(
+			    std::deque<MPI::WorkPackage> &workPackages);
+			void endWorkPackageRequests(
+			    const MPI::TaskStatus &taskStatus,
+			    uint32_t &numRequests,
+			    std::deque<MPI::WorkPackage> &workPackages);
 			void startWorkers();
+
+			/*
+			 * Have all workers act on an exit signal. Worker
+			 * threads see the exit flag the signal would set.
+			 */
+			void signalWorkers(int signo);
+
 			void shutdown(
 			    const MPI::TaskStatus &status,
 			    const std::string &reason);
 
-			Process::ForkManager _processManager;
+			/* Whether results are returned to Task-0 */
+			bool returnsResults() const;
+
+			/*
+			 * Take the results returned with a worker's status
+			 * message into the batch for Task-0.
+			 */
+			void takeWorkerResults(
+			    const Memory::uint8Array &message);
+
+			/*
+			 * Take acknowledgements of batches written, or not,
+			 * by Task-0, then send the batch when full and Task-0
+			 * is not too far behind, or when flushing and
+			 * non-empty.
+			 */
+			void exchangeResults(
+			    bool flush = false);
+
+			/*
+			 * Whether work should be held back from workers
+			 * until Task-0 writes more results.
+			 */
+			bool holdingResults() const;
+
+			/*
+			 * Send all remaining results and wait until Task-0
+			 * has written them, then tell Task-0 none follow.
+			 */
+			void flushResults();
+
+			/*
+			 * Take a worker's status message, with its results.
+			 * When the worker finished its work package, the
+			 * package is completed once its results are written.
+			 */
+			MPI::TaskStatus takeWorkerStatus(
+			    PackageWorker *packageWorker,
+			    const Memory::uint8Array &message);
+
+			/* Send IDs of completed work packages to Task-0 */
+			void reportCompletions();
+
+			/* Results waiting to be sent to Task-0 */
+			MPI::ResultBatch _results;
+
+			/* Batches sent and not yet acknowledged */
+			uint64_t _resultBatchesInFlight{0};
+
+			/* Batches being sent, kept until the send completes */
+			std::deque<std::pair<
+			    std::unique_ptr<MPI::Transport::SendRequest>,
+			    MPI::ResultBatch>> _resultSends;
+
+			/* Completed packages whose results are in _results */
+			std::vector<uint64_t> _resultCompletions;
+
+			/* Completed packages with results in each batch sent */
+			std::deque<std::vector<uint64_t>> _sentCompletions;
+
+			/* Completed packages not yet reported to Task-0 */
+			std::vector<uint64_t> _completedPackages;
+
+			/* Reports being sent, kept until the send completes */
+			std::deque<std::pair<
+			    std::unique_ptr<MPI::Transport::SendRequest>,
+			    std::vector<uint64_t>>> _completionSends;
+
+			/*
+			 * Send a telemetry sample to Task-0 when one is
+			 * due, or the final sample, which is sent before
+			 * returning.
+			 */
+			void reportTelemetry(
+			    uint64_t queued,
+			    bool final = false);
+
+			/* Counters of this task */
+			MPI::Telemetry _telemetry;
+
+			/* Samples being sent, kept until the send completes */
+			std::deque<std::pair<
+			    std::unique_ptr<MPI::Transport::SendRequest>,
+			    std::unique_ptr<MPI::Telemetry::Sample>>>
+			    _telemetrySends;
+
+			/*
+			 * Learn which task to ask for work: Task-0, or our
+			 * node leader. When we are a leader, learn the
+			 * tasks we serve.
+			 */
+			void receiveNodeLeader();
+
+			/*
+			 * Separate the packages sent to a node leader in
+			 * one message, and queue them.
+			 */
+			void splitWorkPackages(
+			    const Memory::uint8Array &data,
+			    uint64_t numPackages,
+			    std::deque<MPI::WorkPackage> &workPackages);
+
+			/* Send a queued work package to a task we serve */
+			void forwardWorkPackage(
+			    MPI::WorkPackage &workPackage,
+			    int member);
+
+			/*
+			 * Take requests from the tasks we serve, answering
+			 * them with queued work packages, or when ending,
+			 * with endCommand.
+			 */
+			void serveMembers(
+			    std::deque<MPI::WorkPackage> &workPackages,
+			    bool ending,
+			    MPI::TaskCommand endCommand);
+
+			/*
+			 * Answer the tasks we serve with endCommand until
+			 * each has said it will ask for no more work.
+			 */
+			void endMembers(
+			    std::deque<MPI::WorkPackage> &workPackages,
+			    MPI::TaskCommand endCommand,
+			    MPI::Transport::MessageWaiter *messageWaiter);
+
+			/* Task that work is asked of: Task-0 or a leader */
+			int _workSource{0};
+
+			/* Whether we hand out work to other tasks */
+			bool _nodeLeader{false};
+
+			/* Tasks we serve that have not ended */
+			std::set<int> _members;
+
+			/* Requests from served tasks not yet answered */
+			std::deque<int> _memberRequests;
+
+			/* Messages to and from Task-0 */
+			std::shared_ptr<MPI::Transport> _transport;
+
+			/* Process::ForkManager or POSIXThreadManager */
+			std::unique_ptr<Process::Manager> _processManager;
 			
 			std::shared_ptr<MPI::WorkPackageProcessor>
 			    _workPackageProcessor;
@@ -116,11 +341,42 @@ namespace BiometricEvaluation {
 				const std::shared_ptr<MPI::WorkPackageProcessor>
 				    &workPackageProcessor,
 				const std::shared_ptr<MPI::Resources>
-				    &resources);
+				    &resources,
+				int workerNumber);
 					
 			    int32_t workerMain();
 
 			    ~PackageWorker();
+
+			    /*
+			     * Memory shared with the worker process, mapped
+			     * before the fork; nullptr when not available.
+			     */
+			    uint8_t *getSharedMemory() const;
+			    uint64_t getSharedMemorySize() const;
+
+			    /*
+			     * Hand a work package to a worker thread; the
+			     * package's size message follows on the pipe.
+			     */
+			    void setWorkPackage(MPI::WorkPackage &&workPackage);
+
+			    /*
+			     * ID of the work package last sent to the worker,
+			     * kept by the Receiver; 0 when none.
+			     */
+			    uint64_t getPackageID() const;
+			    void setPackageID(uint64_t id);
+
+			    /*
+			     * When the work package last sent to the worker
+			     * was sent, kept by the Receiver; the epoch when
+			     * none.
+			     */
+			    MPI::Telemetry::Clock::time_point
+				getPackageStart() const;
+			    void setPackageStart(
+				MPI::Telemetry::Clock::time_point start);
 				
 			private:
 			    std::shared_ptr<
@@ -128,7 +384,27 @@ namespace BiometricEvaluation {
 				    _workPackageProcessor;
 				std::shared_ptr<MPI::Resources> _resources;
 				std::shared_ptr<IO::Logsheet> _logsheet;
+				uint8_t *_sharedMemory{nullptr};
+				uint64_t _sharedMemorySize{0};
+				bool _threaded{false};
+				int _workerNumber{0};
+				std::mutex _workPackageMutex;
+				MPI::WorkPackage _workPackage;
+				uint64_t _packageID{0};
+				MPI::Telemetry::Clock::time_point
+				    _packageStart;
 			};
+
+			/* Workers, for stopping threads at shutdown */
+			std::vector<std::shared_ptr<PackageWorker>>
+			    _packageWorkers;
+
+			/*
+			 * Workers that asked for work while none was
+			 * queued, waiting for the next package.
+			 */
+			std::deque<std::shared_ptr<Process::WorkerController>>
+			    _readyWorkers;
 		};
 	}
 }
@@ -97,6 +97,34 @@ namespace BiometricEvaluation {
 			    const std::string &key,
 			    const Memory::uint8Array &value) = 0;
 
+			/**
+			 * @brief
+			 * Perform an action using a record whose value is
+			 * read in place from the work package.
+			 * @details
+			 * The default implementation copies the value and
+			 * calls processRecord(key, value). Implementations
+			 * can override this method to avoid the copy.
+			 *
+			 * @param[in] key
+			 * The key associated with the record that is to be
+			 * processed.
+			 * @param[in] value
+			 * The data from the record that is to be processed,
+			 * valid only for the duration of the call.
+			 * @param[in] size
+			 * The size of value, in octets.
+			 *
+			 * @throw Error::Exception
+			 * An fatal error occurred when processing the work
+			 * package; the processing responsible for this
+			 * object should shut down.
+			 */
+			virtual void processRecordInPlace(
+			    const std::string &key,
+			    const uint8_t *value,
+			    const uint64_t size);
+
 			/* Implement WorkPackageProcessor interface */
 			virtual std::shared_ptr<WorkPackageProcessor>
 			    newProcessor(
@@ -112,6 +140,17 @@ namespace BiometricEvaluation {
 			std::shared_ptr<MPI::RecordStoreResources>
 			     getResources();
 		private:
+			/*
+			 * Process the ranges of records of a work package
+			 * from a distributor using local reads, reading
+			 * the records from the input record store.
+			 * Throws Error::StrategyError, before processing a
+			 * range, when the store sequences the range with
+			 * different first or last keys.
+			 */
+			void processKeyRanges(
+			    const Memory::uint8Array &packageData);
+
 			std::shared_ptr<MPI::RecordStoreResources>
 			     _resources;
 		};
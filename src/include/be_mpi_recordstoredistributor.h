@@ -23,7 +23,11 @@ namespace BiometricEvaluation {
 		 * @details
 		 * This class supports checkpointing when an early exit
 		 * is requested, allowing all workers to complete their
-		 * current work package. 
+		 * current work package. The position of each record is
+		 * its place in the sequence of the RecordStore, and its
+		 * key labels the position, so a restore resumes after
+		 * the last completed key and passes over records
+		 * completed out of order.
 		 *
 		 * See MPI::Distributor
 		 */
@@ -50,6 +54,10 @@ namespace BiometricEvaluation {
 			 *
 			 * The work package sent to Receivers can contain
 			 * either RecordStore keys, or key/value pairs.
+			 * When RecordStoreResources::LOCALREADSPROPERTY is
+			 * set, it instead contains ranges of records in the
+			 * sequence of the RecordStore, which the Receivers
+			 * read, with values if includeValues is true.
 			 * @note
 			 * The size of a single value item is limited to
 			 * 2^32 octets. If the size of the value item is
@@ -81,6 +89,7 @@ namespace BiometricEvaluation {
 			createWorkPackage(MPI::WorkPackage &workPackage);
 			void checkpointSave(const std::string &reason);
 			void checkpointRestore();
+			uint64_t getNumRemainingElements() const;
 
 		private:
 			std::unique_ptr<MPI::RecordStoreResources>
@@ -88,6 +97,8 @@ namespace BiometricEvaluation {
 			uint64_t _recordsRemaining;
 			bool _includeValues;
 			std::string _lastDistributedKey{};
+			/* Position of the next record in the sequence */
+			uint64_t _nextPosition{0};
 		};
 	}
 }
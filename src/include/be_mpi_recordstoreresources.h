@@ -37,6 +37,19 @@ namespace BiometricEvaluation {
 			 * The property string ``Chunk Size''; required.
 			 */
 			static const std::string CHUNKSIZEPROPERTY;
+			/**
+			 * @brief
+			 * The property string ``Local Record Reads'';
+			 * optional.
+			 * @details
+			 * When true, every task reads the input record store
+			 * itself: work packages describe ranges of records
+			 * in the sequence of the store rather than carrying
+			 * them, and receivers read each range in sequence.
+			 * Every task must therefore see the same store, in
+			 * the same sequence. Defaults to false.
+			 */
+			static const std::string LOCALREADSPROPERTY;
 
 			/**
 			 * @brief
@@ -91,8 +104,18 @@ namespace BiometricEvaluation {
 			 std::shared_ptr<IO::RecordStore>
 			    getRecordStore() const;
 
+			/**
+			 * @brief
+			 * Obtain whether receivers read the records of
+			 * their work packages from the input record store.
+			 * @return
+			 * The value of LOCALREADSPROPERTY.
+			 */
+			bool useLocalReads() const;
+
 		private:
 			uint32_t _chunkSize;
+			bool _localReads{false};
 			std::shared_ptr<IO::RecordStore> _recordStore{};
 		};
 	}
@@ -10,10 +10,14 @@
 #ifndef _BE_MPI_RESOURCES_H
 #define _BE_MPI_RESOURCES_H
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include <be_io_recordstore.h>
+#include <be_process_placement.h>
+
 namespace BiometricEvaluation {
 	namespace MPI {
 		/**
@@ -73,6 +77,235 @@ namespace BiometricEvaluation {
 			 */
 			static const std::string CHECKPOINTPATHPROPERTY;
 
+			/**
+			 * @brief
+			 * The property string "Adaptive Chunk Size"; optional.
+			 * @details
+			 * When true, a Distributor sizes each work package
+			 * from the throughput of the task requesting it and
+			 * the amount of work remaining, rather than always
+			 * sending the fixed chunk size.  Defaults to false.
+			 */
+			static const std::string ADAPTIVECHUNKSIZEPROPERTY;
+
+			/**
+			 * @brief
+			 * The property string "Minimum Chunk Size"; optional.
+			 * @details
+			 * Fewest elements in an adaptively sized work package,
+			 * unless less work remains.  Defaults to 1.
+			 */
+			static const std::string MINCHUNKSIZEPROPERTY;
+
+			/**
+			 * @brief
+			 * The property string "Maximum Chunk Size"; optional.
+			 * @details
+			 * Most elements in an adaptively sized work package.
+			 * Defaults to 0, no limit.
+			 */
+			static const std::string MAXCHUNKSIZEPROPERTY;
+
+			/**
+			 * @brief
+			 * The property string "Minimum Package Size";
+			 * optional.
+			 * @details
+			 * Elements are added to an adaptively sized work
+			 * package until its data is at least this many bytes,
+			 * within "Maximum Chunk Size."  Defaults to 0.
+			 */
+			static const std::string MINPACKAGESIZEPROPERTY;
+
+			/**
+			 * @brief
+			 * The property string "Maximum Package Size";
+			 * optional.
+			 * @details
+			 * No element is added to an adaptively sized work
+			 * package once its data is at least this many bytes.
+			 * Defaults to 0, no limit.
+			 */
+			static const std::string MAXPACKAGESIZEPROPERTY;
+
+			/**
+			 * @brief
+			 * The property string "Package Duration"; optional.
+			 * @details
+			 * Seconds an adaptively sized work package should
+			 * take the requesting task to process.  Defaults to
+			 * 2.0.
+			 */
+			static const std::string PACKAGEDURATIONPROPERTY;
+
+			/**
+			 * @brief
+			 * The property string "Prefetch Packages"; optional.
+			 * @details
+			 * Number of work packages a Receiver keeps requested
+			 * from the Distributor or queued for its workers, so
+			 * that a worker becoming free need not wait on the
+			 * Distributor.  Defaults to 1, requesting a package
+			 * only when a worker is free.
+			 */
+			static const std::string PREFETCHPACKAGESPROPERTY;
+
+			/**
+			 * @brief
+			 * The property string "Worker Shared Memory Size";
+			 * optional.
+			 * @details
+			 * Bytes of memory shared between a Receiver and each
+			 * of its workers, through which work packages are
+			 * delivered.  Larger packages, or all packages when
+			 * 0, are written through the worker's pipe.
+			 * Defaults to 32 MiB.
+			 */
+			static const std::string WORKERSHAREDMEMORYPROPERTY;
+
+			/**
+			 * @brief
+			 * The property string "Threaded Workers"; optional.
+			 * @details
+			 * When true, a Receiver runs its workers as threads
+			 * of its own process rather than as child processes,
+			 * so they share the state set up by the
+			 * WorkPackageProcessor.  Defaults to false, or to
+			 * true, and must be true, for a job run within one
+			 * process.
+			 */
+			static const std::string THREADEDWORKERSPROPERTY;
+
+			/**
+			 * @brief
+			 * The property string "Worker Placement"; optional.
+			 * @details
+			 * Where a Receiver runs its workers: "None",
+			 * "Compact", "Scatter", "Per Core", or "Per NUMA
+			 * Node", as Process::Placement.  Workers are placed
+			 * within the CPUs to which the launcher bound the
+			 * task, so bind tasks to separate parts of a node
+			 * when running several per node.  Defaults to
+			 * "None".
+			 */
+			static const std::string WORKERPLACEMENTPROPERTY;
+
+			/**
+			 * @brief
+			 * The property string "Result Record Store";
+			 * optional.
+			 * @details
+			 * Path name of the RecordStore into which Task-0
+			 * writes results emitted by work package processors,
+			 * created if it does not exist.  When not set,
+			 * results are discarded.
+			 */
+			static const std::string RESULTRECORDSTOREPROPERTY;
+
+			/**
+			 * @brief
+			 * The property string "Result Record Store Kind";
+			 * optional.
+			 * @details
+			 * Kind of RecordStore created for results.  Defaults
+			 * to the default RecordStore kind.
+			 */
+			static const std::string RESULTRECORDSTOREKINDPROPERTY;
+
+			/**
+			 * @brief
+			 * The property string "Result Batch Size"; optional.
+			 * @details
+			 * Bytes of results a Receiver gathers from its
+			 * workers before sending them to Task-0.  Defaults
+			 * to 1 MiB.
+			 */
+			static const std::string RESULTBATCHSIZEPROPERTY;
+
+			/**
+			 * @brief
+			 * The property string "Result Batches In Flight";
+			 * optional.
+			 * @details
+			 * Batches of results a Receiver may have sent that
+			 * Task-0 has not yet written.  Once reached, and a
+			 * further batch has been gathered, the Receiver
+			 * stops handing out work packages until Task-0
+			 * catches up.  Defaults to 4.
+			 */
+			static const std::string RESULTBATCHESINFLIGHTPROPERTY;
+
+			/**
+			 * @brief
+			 * The property string "Work Package Timeout";
+			 * optional.
+			 * @details
+			 * Seconds after which a work package not yet
+			 * processed is sent again, to the next task asking
+			 * for work.  The time includes any time the package
+			 * spends queued by a Receiver.  Defaults to 0, never
+			 * sending a package again for being late.
+			 */
+			static const std::string WORKPACKAGETIMEOUTPROPERTY;
+
+			/**
+			 * @brief
+			 * The property string "Speculative Work Packages";
+			 * optional.
+			 * @details
+			 * When true, once all work has been distributed,
+			 * tasks asking for work are sent copies of packages
+			 * still being processed elsewhere, so that a slow
+			 * task does not hold up the end of the job.
+			 * Defaults to false.
+			 */
+			static const std::string SPECULATIVEPACKAGESPROPERTY;
+
+			/**
+			 * @brief
+			 * The property string "Telemetry Interval"; optional.
+			 * @details
+			 * Seconds between samples of the throughput, queue
+			 * depths, and time blocked of each task, which are
+			 * gathered to Task-0 and summarized at the end of
+			 * the job. Defaults to 0, taking no samples.
+			 */
+			static const std::string TELEMETRYINTERVALPROPERTY;
+
+			/**
+			 * @brief
+			 * The property string "Telemetry Logsheet URL";
+			 * optional.
+			 * @details
+			 * Where Task-0 writes each sample taken, one per
+			 * line. When not set, samples are written to the
+			 * log of Task-0 as comments.
+			 */
+			static const std::string TELEMETRYLOGSHEETURLPROPERTY;
+
+			/**
+			 * @brief
+			 * The property string "Node Leaders"; optional.
+			 * @details
+			 * When true, Task-0 sends work only to a leader task
+			 * on each node, several packages at a time, and each
+			 * leader hands the packages out to the other tasks
+			 * on its node. Defaults to false.
+			 */
+			static const std::string NODELEADERSPROPERTY;
+
+			/**
+			 * @brief
+			 * The property string "Tasks Per Node Leader";
+			 * optional.
+			 * @details
+			 * With Node Leaders, the most tasks a leader serves,
+			 * including itself, so that a node with many tasks
+			 * may have several leaders. Defaults to 0, one
+			 * leader per node.
+			 */
+			static const std::string TASKSPERNODELEADERPROPERTY;
+
 			/**
 			 * @brief
 			 * Obtain the list of required properties.
@@ -144,6 +377,69 @@ namespace BiometricEvaluation {
 			int getNumTasks() const;
 			int getWorkersPerNode() const;
 
+			/**
+			 * @return
+			 * Whether work packages are sized adaptively.
+			 */
+			bool useAdaptiveChunkSize() const;
+			/** @return Fewest elements in a package. */
+			uint64_t getMinChunkSize() const;
+			/** @return Most elements in a package, 0 if none. */
+			uint64_t getMaxChunkSize() const;
+			/** @return Smallest package data, in bytes. */
+			uint64_t getMinPackageSize() const;
+			/** @return Largest package data in bytes, 0 if none. */
+			uint64_t getMaxPackageSize() const;
+			/** @return Seconds a package should take to process. */
+			double getPackageDuration() const;
+			/** @return Packages to keep requested or queued. */
+			uint32_t getPrefetchPackages() const;
+			/** @return Bytes shared with each worker, 0 if none. */
+			uint64_t getWorkerSharedMemorySize() const;
+			/** @return Whether workers are threads. */
+			bool useThreadedWorkers() const;
+			/** @return CPUs on which workers are placed. */
+			Process::Placement getWorkerPlacement() const;
+			/** @return Result RecordStore path, empty if none. */
+			std::string getResultRecordStore() const;
+			/** @return Kind of RecordStore created for results. */
+			IO::RecordStore::Kind getResultRecordStoreKind() const;
+			/** @return Bytes of results to gather per batch. */
+			uint64_t getResultBatchSize() const;
+			/** @return Unwritten result batches allowed. */
+			uint32_t getResultBatchesInFlight() const;
+			/** @return Seconds before a package is resent, or 0. */
+			double getWorkPackageTimeout() const;
+			/** @return Whether packages are sent speculatively. */
+			bool useSpeculativePackages() const;
+			/** @return Seconds between telemetry samples, or 0. */
+			double getTelemetryInterval() const;
+			/** @return URL of the telemetry Logsheet, if any. */
+			std::string getTelemetryLogsheetURL() const;
+			/** @return Whether telemetry samples are taken. */
+			bool collectsTelemetry() const;
+			/** @return Whether work goes through node leaders. */
+			bool useNodeLeaders() const;
+			/** @return Most tasks per node leader, or 0. */
+			uint32_t getTasksPerNodeLeader() const;
+
+			/**
+			 * @return
+			 * Whether work packages may be sent again: when
+			 * late, speculatively, or when the tasks they were
+			 * sent to end without processing them.
+			 */
+			bool resendsWorkPackages() const;
+
+			/**
+			 * @return
+			 * Whether Receivers report the work packages they
+			 * process: when checkpointing, when packages may be
+			 * sent again, or when packages are sized from the
+			 * throughput of tasks.
+			 */
+			bool tracksWorkPackages() const;
+
 		private:
 			std::string _propertiesFileName;
 			int _rank;
@@ -151,6 +447,28 @@ namespace BiometricEvaluation {
 			int _workersPerNode;
 			std::string _logsheetURL;
 			std::string _checkpointPath;
+			bool _adaptiveChunkSize{false};
+			uint64_t _minChunkSize{1};
+			uint64_t _maxChunkSize{0};
+			uint64_t _minPackageSize{0};
+			uint64_t _maxPackageSize{0};
+			double _packageDuration{2.0};
+			uint32_t _prefetchPackages{1};
+			uint64_t _workerSharedMemorySize{32 * 1024 * 1024};
+			bool _threadedWorkers{false};
+			Process::Placement _workerPlacement{
+			    Process::Placement::None};
+			std::string _resultRecordStore;
+			IO::RecordStore::Kind _resultRecordStoreKind{
+			    IO::RecordStore::Kind::Default};
+			uint64_t _resultBatchSize{1024 * 1024};
+			uint32_t _resultBatchesInFlight{4};
+			double _workPackageTimeout{0};
+			bool _speculativePackages{false};
+			double _telemetryInterval{0};
+			std::string _telemetryLogsheetURL;
+			bool _nodeLeaders{false};
+			uint32_t _tasksPerNodeLeader{0};
 		};
 	}
 }
@@ -0,0 +1,135 @@
+/**
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties.  Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain.  NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+#ifndef _BE_MPI_RESULTBATCH_H
+#define _BE_MPI_RESULTBATCH_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <be_memory_autoarray.h>
+
+namespace BiometricEvaluation {
+	namespace MPI {
+		/**
+		 * @brief
+		 * A set of results returned from work package processing.
+		 * @details
+		 * Each result is a key and a value, as would be stored in
+		 * an IO::RecordStore. Results are kept serialized in a
+		 * single buffer, so that batches are combined by
+		 * concatenating their raw data and sent between tasks
+		 * without conversion.
+		 */
+		class ResultBatch {
+		public:
+			/** A result within a batch. */
+			struct Result {
+				/** Key of the result. */
+				std::string key;
+				/** Value of the result, within the batch. */
+				const uint8_t *value;
+				/** Size of the value, in bytes. */
+				uint64_t size;
+			};
+
+			/**
+			 * @brief
+			 * Construct an empty batch.
+			 */
+			ResultBatch();
+
+			/**
+			 * @brief
+			 * Construct a batch taking ownership of raw data
+			 * obtained from getData().
+			 * @param[in] data
+			 * Serialized results.
+			 * @throw Error::DataError
+			 * data does not hold a sequence of results.
+			 */
+			ResultBatch(
+			    Memory::uint8Array &&data);
+
+			/**
+			 * @brief
+			 * Add a result to the batch.
+			 * @param[in] key
+			 * Key of the result.
+			 * @param[in] value
+			 * Value of the result.
+			 * @param[in] size
+			 * Size of value, in bytes.
+			 */
+			void add(
+			    const std::string &key,
+			    const void *value,
+			    uint64_t size);
+
+			/**
+			 * @brief
+			 * Add the results of another batch, in raw form.
+			 * @param[in] data
+			 * Serialized results, from getData().
+			 * @param[in] size
+			 * Size of data, in bytes.
+			 * @throw Error::DataError
+			 * data does not hold a sequence of results.
+			 */
+			void append(
+			    const uint8_t *data,
+			    uint64_t size);
+
+			/**
+			 * @brief
+			 * Obtain the results of the batch.
+			 * @return
+			 * The results, in the order added. Values refer
+			 * to memory held by this object.
+			 */
+			std::vector<Result> getResults() const;
+
+			/** @return The serialized results. */
+			const Memory::uint8Array &getData() const;
+
+			/** @return Size of the serialized results, in bytes. */
+			uint64_t getSize() const;
+
+			/** @return Number of results in the batch. */
+			uint64_t getNumResults() const;
+
+			/** @return Whether the batch holds no results. */
+			bool empty() const;
+
+			/**
+			 * @brief
+			 * Remove all results, keeping the memory allocated
+			 * for reuse.
+			 */
+			void clear();
+
+		private:
+			/* Make room for size more bytes, returning the start */
+			uint8_t *extend(
+			    uint64_t size);
+
+			/* Count the results in raw data, checking the format */
+			static uint64_t countResults(
+			    const uint8_t *data,
+			    uint64_t size);
+
+			Memory::uint8Array _data;
+			uint64_t _capacity{0};
+			uint64_t _numResults{0};
+		};
+	}
+}
+
+#endif /* _BE_MPI_RESULTBATCH_H */
@@ -0,0 +1,134 @@
+/**
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties.  Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain.  NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+#ifndef _BE_MPI_RESULTCOLLECTOR_H
+#define _BE_MPI_RESULTCOLLECTOR_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <be_io_recordstore.h>
+#include <be_memory_autoarray.h>
+
+namespace BiometricEvaluation {
+	namespace MPI {
+		/**
+		 * @brief
+		 * Writes batches of results into a RecordStore.
+		 * @details
+		 * Batches are written by a thread of the collector, in the
+		 * order they were added, so the caller can go on receiving
+		 * batches while earlier ones are stored. A result whose key
+		 * is already in the RecordStore replaces the existing
+		 * record, so results of work processed again are kept
+		 * once.
+		 *
+		 * The Distributor uses a collector to store the results
+		 * returned by Receivers, acknowledging each batch once
+		 * written, or as failed when it, or any of its results,
+		 * could not be written. The RecordStore is synchronized on
+		 * creation and after each batch, so it remains usable
+		 * should the job not end cleanly.
+		 *
+		 * @see MPI::ResultBatch
+		 */
+		class ResultCollector {
+		public:
+			/**
+			 * @brief
+			 * Construct a collector for a RecordStore.
+			 * @param[in] pathname
+			 * Path name of the RecordStore, which is opened
+			 * if it exists and created otherwise.
+			 * @param[in] kind
+			 * Kind of RecordStore to create.
+			 * @throw Error::StrategyError
+			 * The RecordStore could not be opened or created.
+			 */
+			ResultCollector(
+			    const std::string &pathname,
+			    IO::RecordStore::Kind kind);
+
+			/**
+			 * @brief
+			 * Queue a batch of results to be written.
+			 * @param[in] source
+			 * Rank of the task that sent the batch.
+			 * @param[in] data
+			 * The serialized batch, from ResultBatch::getData().
+			 */
+			void add(
+			    int source,
+			    Memory::uint8Array &&data);
+
+			/**
+			 * @brief
+			 * Obtain the batches finished since the last call.
+			 * @return
+			 * The rank of the source of each batch finished,
+			 * in the order the batches were added, and whether
+			 * the batch was written. A batch that could not be
+			 * parsed, or had a result that could not be
+			 * stored, was not written.
+			 */
+			std::vector<std::pair<int, bool>> takeFinished();
+
+			/**
+			 * @brief
+			 * Write all queued batches, stop the writing thread,
+			 * and synchronize the RecordStore.
+			 * @details
+			 * No batches may be added afterwards.
+			 */
+			void finish();
+
+			/** @return Number of results written. */
+			uint64_t getNumWritten();
+
+			/** @return Number of results replacing a record. */
+			uint64_t getNumReplaced();
+
+			/** @return Number of results or batches not written. */
+			uint64_t getNumFailed();
+
+			/** Finishes writing. */
+			~ResultCollector();
+
+		private:
+			/* Write batches as they are queued */
+			void run();
+
+			/* Write the results of one batch; false on failure */
+			bool write(
+			    Memory::uint8Array &data);
+
+			std::shared_ptr<IO::RecordStore> _recordStore;
+
+			std::mutex _mutex;
+			std::condition_variable _condition;
+			std::deque<std::pair<int, Memory::uint8Array>> _queue;
+			std::vector<std::pair<int, bool>> _finished;
+			bool _finishing{false};
+			uint64_t _numWritten{0};
+			uint64_t _numReplaced{0};
+			uint64_t _numFailed{0};
+
+			std::thread _thread;
+		};
+	}
+}
+
+#endif /* _BE_MPI_RESULTCOLLECTOR_H */
@@ -10,11 +10,13 @@
 #ifndef _BE_MPI_RUNTIME_H
 #define _BE_MPI_RUNTIME_H
 
+#include <memory>
 #include <string>
 
 #include <be_mpi.h>
 #include <be_mpi_distributor.h>
 #include <be_mpi_receiver.h>
+#include <be_mpi_transport.h>
 
 namespace BiometricEvaluation {
 	namespace MPI {
@@ -23,6 +25,12 @@ namespace BiometricEvaluation {
 		extern bool QuickExit;	/* Quick exit signal received */
 		extern bool TermExit;	/* Immediate exit signal received */
 
+		/*
+		 * Readable when an exit signal has been received, for waiting
+		 * on signals with other events; -1 before Runtime::start().
+		 */
+		extern int signalDescriptor;
+
 		extern bool checkpointEnable;
 		extern bool doCheckpointRestore;
 
@@ -63,6 +71,26 @@ namespace BiometricEvaluation {
 			    char** &argv,
 			    bool checkpointEnable = false);
 
+			/**
+			 * @brief
+			 * Construct the runtime environment for a job run
+			 * within this process, without MPI.
+			 * @details
+			 * The Distributor runs on the thread calling start()
+			 * as Task-0, and a single Receiver runs on a thread
+			 * of its own as Task-1. Work package workers are
+			 * threads of the Receiver, as forking a process that
+			 * runs several threads is fragile, so the Receiver's
+			 * properties must not set "Threaded Workers" to
+			 * false.
+			 * @param[in] checkpointEnable
+			 * True indicates that a checkpoint should be saved
+			 * on early shutdown and restored on startup, if the
+			 * checkpoint data is present.
+			 */
+			explicit Runtime(
+			    bool checkpointEnable = false);
+
 			~Runtime();
 
 			/**
@@ -70,7 +98,8 @@ namespace BiometricEvaluation {
 			 * Startup the runtime environment for the MPI job.
 			 * @details
 			 * Exceptions thrown by the Distributor or Recevier
-			 * are caught and logged.
+			 * are caught and logged. Within one process, the
+			 * task that did not throw is then made to exit.
 			 * @param[in] distributor
 			 * The Distributor object that will form the basis
 			 * of the first MPI task.
@@ -107,6 +136,10 @@ namespace BiometricEvaluation {
 		private:
 			int _argc;
 			char **_argv;
+
+			/* Job run by threads of this process */
+			bool _inProcess{false};
+			std::shared_ptr<MPI::Transport> _transport;
 		};
 	}
 }
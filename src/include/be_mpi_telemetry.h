@@ -0,0 +1,214 @@
+/**
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties.  Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain.  NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+#ifndef _BE_MPI_TELEMETRY_H
+#define _BE_MPI_TELEMETRY_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace BiometricEvaluation {
+	namespace MPI {
+		/**
+		 * @brief
+		 * Counters and timers describing the work of one task.
+		 * @details
+		 * The Distributor counts the work packages it sends and
+		 * the Receivers those they receive. Each also counts the
+		 * time spent blocked waiting for messages. A Receiver
+		 * further times its workers from when a package is handed
+		 * to a worker until the worker reports back, and notes its
+		 * queue depths when a sample is taken.
+		 *
+		 * Receivers send samples to Task-0 periodically and once
+		 * at shutdown, where they are written as a time series and
+		 * summarized.
+		 */
+		class Telemetry {
+		public:
+			using Clock = std::chrono::steady_clock;
+
+			/**
+			 * @brief
+			 * A snapshot of the counters of a task.
+			 * @details
+			 * Counters are totals since the task started. A
+			 * sample is sent between tasks as it is laid out
+			 * in memory.
+			 */
+			struct Sample {
+				/** Rank of the task */
+				int32_t rank{0};
+				/** Whether this is the task's last sample */
+				uint32_t final{0};
+				/** Workers of the task; 0 for Task-0 */
+				uint64_t numWorkers{0};
+				/** Seconds since the task started */
+				double elapsed{0};
+				/**
+				 * Work packages sent, or received; for a
+				 * node leader, those kept for its workers
+				 */
+				uint64_t packages{0};
+				/** Elements in those work packages */
+				uint64_t elements{0};
+				/** Octets of work package data */
+				uint64_t bytes{0};
+				/** Work packages processed by workers */
+				uint64_t packagesProcessed{0};
+				/** Seconds blocked waiting for messages */
+				double blocked{0};
+				/** Seconds workers held a package, summed */
+				double busy{0};
+				/**
+				 * Work packages sent and not yet reported
+				 * processed (Task-0), or queued for a worker
+				 * (Task-N)
+				 */
+				uint64_t queued{0};
+				/**
+				 * Work requests held without an answer
+				 * (Task-0) or workers waiting for a
+				 * package (Task-N)
+				 */
+				uint64_t idle{0};
+			};
+
+			/**
+			 * @brief
+			 * Adds the time between its construction and
+			 * destruction to the blocked time of a Telemetry.
+			 */
+			class BlockedTimer {
+			public:
+				BlockedTimer(
+				    Telemetry &telemetry);
+				~BlockedTimer();
+			private:
+				Telemetry &_telemetry;
+				Clock::time_point _start;
+			};
+
+			/**
+			 * @brief
+			 * Start counting for a task.
+			 * @param[in] rank
+			 * Rank of the task.
+			 * @param[in] numWorkers
+			 * Number of workers of the task.
+			 */
+			Telemetry(
+			    int rank = 0,
+			    uint64_t numWorkers = 0);
+
+			/**
+			 * @brief
+			 * Count a work package sent or received.
+			 * @param[in] numElements
+			 * Number of elements in the package.
+			 * @param[in] size
+			 * Size of the package data.
+			 */
+			void countPackage(
+			    uint64_t numElements,
+			    uint64_t size);
+
+			/**
+			 * @brief
+			 * Count a work package processed by a worker.
+			 * @param[in] start
+			 * When the package was handed to the worker.
+			 */
+			void countProcessed(
+			    Clock::time_point start);
+
+			/**
+			 * @brief
+			 * Add to the time blocked waiting for messages.
+			 * @param[in] duration
+			 * Time blocked.
+			 */
+			void addBlocked(
+			    Clock::duration duration);
+
+			/**
+			 * @brief
+			 * Note the current depth of the task's queues.
+			 * @param[in] queued
+			 * Work packages waiting.
+			 * @param[in] idle
+			 * Requests, or workers, waiting.
+			 */
+			void setQueueDepths(
+			    uint64_t queued,
+			    uint64_t idle);
+
+			/**
+			 * @brief
+			 * Obtain a sample of the counters now.
+			 * @param[in] final
+			 * Whether this is the last sample of the task.
+			 * @return
+			 * The sample.
+			 */
+			Sample getSample(
+			    bool final = false) const;
+
+			/**
+			 * @brief
+			 * Whether a sample is due, given the interval
+			 * between samples.
+			 * @details
+			 * Returns true at most once per interval.
+			 * @param[in] interval
+			 * Seconds between samples.
+			 * @return
+			 * true if interval seconds have passed since the
+			 * last time true was returned, or since the start.
+			 */
+			bool sampleDue(
+			    double interval);
+
+			/**
+			 * @return
+			 * Names of the fields written by toString(),
+			 * separated by spaces.
+			 */
+			static std::string getHeader();
+
+			/**
+			 * @brief
+			 * Write a sample as one line of space-separated
+			 * fields.
+			 * @details
+			 * The counters of the sample are followed by the
+			 * rates of packages and elements per second, the
+			 * fraction of time blocked, and the fraction of
+			 * worker time busy.
+			 * @param[in] type
+			 * The type of the line, such as "Sample".
+			 * @param[in] sample
+			 * The sample.
+			 * @return
+			 * The fields of the sample, as named by getHeader().
+			 */
+			static std::string toString(
+			    const std::string &type,
+			    const Sample &sample);
+
+		private:
+			Sample _sample;
+			Clock::time_point _start;
+			Clock::time_point _lastSample;
+		};
+	}
+}
+
+#endif /* _BE_MPI_TELEMETRY_H */
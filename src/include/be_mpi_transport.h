@@ -0,0 +1,341 @@
+/**
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties.  Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain.  NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+#ifndef _BE_MPI_TRANSPORT_H
+#define _BE_MPI_TRANSPORT_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <be_memory_autoarray.h>
+#include <be_mpi.h>
+
+namespace BiometricEvaluation {
+	namespace MPI {
+
+		/**
+		 * @brief
+		 * The means by which the tasks of a job exchange messages.
+		 * @details
+		 * The Distributor and Receiver speak the TaskCommand,
+		 * TaskStatus and MessageTag protocol through a Transport
+		 * rather than through MPI directly, so the same job can be
+		 * run across MPI tasks or within a single process.
+		 *
+		 * Messages between a pair of tasks with the same tag are
+		 * received in the order they were sent. A message is a
+		 * sequence of bytes; no conversion of data representation
+		 * takes place between tasks.
+		 *
+		 * The Transport for a job is created by the Runtime and
+		 * obtained with MPI::getTransport().
+		 *
+		 * @see MPI::Runtime
+		 */
+		class Transport {
+		public:
+			/** Source matching a message from any task. */
+			static const int ANYSOURCE;
+
+			/**
+			 * @brief
+			 * Notification of waiting messages, for waiting on
+			 * messages together with other events.
+			 */
+			class MessageWaiter {
+			public:
+				/**
+				 * @return
+				 * A descriptor that is readable when a
+				 * message may be waiting for this task.
+				 */
+				virtual int getDescriptor() const = 0;
+
+				/**
+				 * @brief
+				 * Prepare to wait on the descriptor again.
+				 * @details
+				 * Must be called before each wait. When a
+				 * message is still waiting, the descriptor
+				 * becomes readable again, so every message
+				 * that may arrive must be received before
+				 * waiting, whatever its tag.
+				 */
+				virtual void rearm() = 0;
+
+				virtual ~MessageWaiter();
+			};
+
+			/**
+			 * @brief
+			 * A send in progress, started by startSend().
+			 */
+			class SendRequest {
+			public:
+				/**
+				 * @return
+				 * Whether the send has completed, so the
+				 * data may be reused.
+				 */
+				virtual bool test() = 0;
+
+				/**
+				 * @brief
+				 * Wait for the send to complete.
+				 */
+				virtual void wait() = 0;
+
+				/** Waits for the send to complete. */
+				virtual ~SendRequest();
+			};
+
+			/** @return The rank of the calling task. */
+			virtual int getRank() const = 0;
+
+			/** @return The number of tasks in the job. */
+			virtual int getNumTasks() const = 0;
+
+			/** @return Name of the node running this task. */
+			virtual std::string getProcessorName() const = 0;
+
+			/**
+			 * @brief
+			 * Identify the node each task runs on.
+			 * @details
+			 * Every task must call this method at the same point
+			 * in the job, as with barrier().
+			 * @return
+			 * A number for each task, by rank, that is the same
+			 * for tasks running on the same node.
+			 */
+			virtual std::vector<int> getNodes() = 0;
+
+			/**
+			 * @brief
+			 * Send a message, returning once the data may be
+			 * reused.
+			 * @param[in] destination
+			 * Rank of the receiving task.
+			 * @param[in] tag
+			 * The type of message.
+			 * @param[in] data
+			 * The message.
+			 * @param[in] size
+			 * Size of data, in bytes.
+			 * @throw Error::StrategyError
+			 * The message could not be sent.
+			 */
+			virtual void send(
+			    int destination,
+			    MessageTag tag,
+			    const void *data,
+			    uint64_t size) = 0;
+
+			/**
+			 * @brief
+			 * Send the concatenation of several buffers as one
+			 * message, without first copying them together when
+			 * the implementation allows.
+			 * @param[in] destination
+			 * Rank of the receiving task.
+			 * @param[in] tag
+			 * The type of message.
+			 * @param[in] segments
+			 * The parts of the message, in order.
+			 * @throw Error::StrategyError
+			 * The message could not be sent.
+			 */
+			virtual void send(
+			    int destination,
+			    MessageTag tag,
+			    const std::vector<Memory::uint8Array> &segments)
+			    = 0;
+
+			/**
+			 * @brief
+			 * Start sending a message, returning at once.
+			 * @details
+			 * The data must not be modified or released until
+			 * the send has completed. A task sending this way
+			 * can't be held up by the receiving task while that
+			 * task is itself sending to it.
+			 * @param[in] destination
+			 * Rank of the receiving task.
+			 * @param[in] tag
+			 * The type of message.
+			 * @param[in] data
+			 * The message.
+			 * @param[in] size
+			 * Size of data, in bytes.
+			 * @return
+			 * The send in progress.
+			 * @throw Error::StrategyError
+			 * The message could not be sent.
+			 */
+			virtual std::unique_ptr<SendRequest> startSend(
+			    int destination,
+			    MessageTag tag,
+			    const void *data,
+			    uint64_t size) = 0;
+
+			/**
+			 * @brief
+			 * Check for a message without receiving it.
+			 * @param[in] source
+			 * Rank of the sending task, or ANYSOURCE.
+			 * @param[in] tag
+			 * The type of message.
+			 * @param[in] timeout
+			 * Milliseconds to wait for a message: 0 to return
+			 * at once, or < 0 to wait until one arrives.
+			 * @param[out] actualSource
+			 * Rank of the task that sent the message.
+			 * @param[out] size
+			 * Size of the message, in bytes.
+			 * @return
+			 * true if a message is waiting, false otherwise.
+			 */
+			virtual bool probe(
+			    int source,
+			    MessageTag tag,
+			    int timeout,
+			    int &actualSource,
+			    uint64_t &size) = 0;
+
+			/**
+			 * @brief
+			 * Receive a message, waiting for it to arrive.
+			 * @param[in] source
+			 * Rank of the sending task, or ANYSOURCE.
+			 * @param[in] tag
+			 * The type of message.
+			 * @param[out] data
+			 * Buffer for the message.
+			 * @param[in] size
+			 * Size of data, in bytes; the message must fit.
+			 * @return
+			 * Rank of the task that sent the message.
+			 * @throw Error::StrategyError
+			 * The message could not be received.
+			 */
+			virtual int receive(
+			    int source,
+			    MessageTag tag,
+			    void *data,
+			    uint64_t size) = 0;
+
+			/**
+			 * @brief
+			 * Wait until every task has called this method.
+			 */
+			virtual void barrier() = 0;
+
+			/**
+			 * @brief
+			 * Obtain an object for waiting on messages with
+			 * poll() or similar.
+			 * @return
+			 * A MessageWaiter for the calling task, or nullptr
+			 * when the implementation can't provide one and
+			 * the caller must check for messages periodically.
+			 */
+			virtual std::unique_ptr<MessageWaiter>
+			    newMessageWaiter() = 0;
+
+			/**
+			 * @brief
+			 * End the use of the transport by this process.
+			 */
+			virtual void shutdown() = 0;
+
+			/**
+			 * @brief
+			 * End every task of the job immediately.
+			 * @param[in] errcode
+			 * The error code to exit with.
+			 */
+			virtual void abort(int errcode) = 0;
+
+			/**
+			 * @brief
+			 * Send a single value.
+			 * @param[in] destination
+			 * Rank of the receiving task.
+			 * @param[in] tag
+			 * The type of message.
+			 * @param[in] value
+			 * The value to send.
+			 */
+			template<typename T>
+			void
+			sendValue(
+			    int destination,
+			    MessageTag tag,
+			    const T &value)
+			{
+				this->send(destination, tag, &value,
+				    sizeof(value));
+			}
+
+			/**
+			 * @brief
+			 * Receive a single value.
+			 * @param[in] source
+			 * Rank of the sending task, or ANYSOURCE.
+			 * @param[in] tag
+			 * The type of message.
+			 * @param[out] actualSource
+			 * If not nullptr, set to the rank of the task that
+			 * sent the value.
+			 * @return
+			 * The value received.
+			 */
+			template<typename T>
+			T
+			receiveValue(
+			    int source,
+			    MessageTag tag,
+			    int *actualSource = nullptr)
+			{
+				T value;
+				const int sender = this->receive(source, tag,
+				    &value, sizeof(value));
+				if (actualSource != nullptr)
+					*actualSource = sender;
+				return (value);
+			}
+
+			virtual ~Transport();
+		};
+
+		/**
+		 * @brief
+		 * Obtain the Transport of the current job.
+		 * @return
+		 * The Transport created by the Runtime, or nullptr if
+		 * no Runtime has been constructed.
+		 */
+		std::shared_ptr<Transport> getTransport();
+
+		/**
+		 * @brief
+		 * Set the Transport of the current job.
+		 * @details
+		 * Called by the Runtime.
+		 * @param[in] transport
+		 * The Transport for the job.
+		 */
+		void setTransport(
+		    const std::shared_ptr<Transport> &transport);
+	}
+}
+
+#endif /* _BE_MPI_TRANSPORT_H */
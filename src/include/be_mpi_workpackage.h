@@ -10,6 +10,8 @@
 #ifndef _BE_MPI_WORKPACKAGE_H
 #define _BE_MPI_WORKPACKAGE_H
 
+#include <vector>
+
 #include <be_memory_autoarray.h>
 
 namespace BiometricEvaluation {
@@ -21,6 +23,12 @@ namespace BiometricEvaluation {
 		 * @details
 		 * The work package is an wrapper around the data to
 		 * be processed, along with some ancillary information.
+		 *
+		 * The data may be gathered from a list of segments, each
+		 * moved into the package with appendData(), so that
+		 * large items such as record values are never copied into
+		 * one contiguous buffer on the sending side. The raw data
+		 * is the concatenation of the segments.
  		 */
 		class WorkPackage {
 		public:
@@ -38,6 +46,21 @@ namespace BiometricEvaluation {
 			 * package.
 			 */
 			WorkPackage(const Memory::uint8Array &data);
+
+			/**
+			 * @brief
+			 * Construct a work package taking ownership of
+			 * some data, without copying it.
+			 * @param[in] data
+			 * The data that will be managed by this work
+			 * package.
+			 */
+			WorkPackage(Memory::uint8Array &&data);
+
+			WorkPackage(const WorkPackage &) = default;
+			WorkPackage(WorkPackage &&) = default;
+			WorkPackage &operator=(const WorkPackage &) = default;
+			WorkPackage &operator=(WorkPackage &&) = default;
 			~WorkPackage();
 
 			/**
@@ -46,6 +69,19 @@ namespace BiometricEvaluation {
 			 */
 			void getData(Memory::uint8Array &data) const;
 
+			/**
+		 	 * @brief
+			 * Obtain the package data in raw form, without
+			 * copying it.
+			 * @details
+			 * A package gathered from several segments is
+			 * combined into one on the first call.
+			 * @return
+			 * Reference to the raw data, valid until the package
+			 * is modified or destroyed.
+			 */
+			const Memory::uint8Array &getData() const;
+
 			/**
 		 	 * @brief
 			 * Set the package data from raw data.
@@ -54,6 +90,35 @@ namespace BiometricEvaluation {
 			 */
 			void setData(const Memory::uint8Array &data);
 
+			/**
+		 	 * @brief
+			 * Set the package data from raw data, without
+			 * copying it.
+			 * @param[in] data
+			 * The data moved into the work package.
+			 */
+			void setData(Memory::uint8Array &&data);
+
+			/**
+		 	 * @brief
+			 * Add a segment to the end of the package data.
+			 * @param[in] segment
+			 * The data moved into the work package.
+			 */
+			void appendData(Memory::uint8Array &&segment);
+
+			/**
+		 	 * @brief
+			 * Obtain the segments that make up the package data.
+			 * @details
+			 * Allows the data to be transmitted or written
+			 * without first being combined into one buffer.
+			 * @return
+			 * The segments, in order.
+			 */
+			const std::vector<Memory::uint8Array> &
+			getSegments() const;
+
 			/**
 		 	 * @brief
 			 * Obtain the size of the package data.
@@ -83,10 +148,34 @@ namespace BiometricEvaluation {
 			 */
 			void setNumElements(const uint64_t numElements);
 
+			/**
+		 	 * @brief
+			 * Obtain the identifier of the package.
+			 * @details
+			 * Set by the Distributor when the completion of
+			 * packages is tracked, so a Receiver can report
+			 * the package done.
+			 * @return
+			 * The identifier, or 0 if the package is not
+			 * tracked.
+			 */
+			uint64_t getID() const;
+
+			/**
+		 	 * @brief
+			 * Set the identifier of the package.
+			 * @param[in] id
+			 * The identifier, or 0 if not tracked.
+			 */
+			void setID(const uint64_t id);
+
 		protected:
 		private:
-			Memory::uint8Array _data;
-			uint64_t _numElements;
+			/* The package data, in order; combined on demand */
+			mutable std::vector<Memory::uint8Array> _segments;
+			uint64_t _size{0};
+			uint64_t _numElements{0};
+			uint64_t _id{0};
 		};
 	}
 }
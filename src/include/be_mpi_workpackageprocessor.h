@@ -12,6 +12,7 @@
 
 #include <memory>
 #include <be_io_logsheet.h>
+#include <be_mpi_resultbatch.h>
 #include <be_mpi_workpackage.h>
 
 /**
@@ -62,6 +63,32 @@ namespace BiometricEvaluation {
 			    newProcessor(
 				std::shared_ptr<IO::Logsheet> &logsheet) = 0;
 
+			/**
+			 * @brief
+			 * Obtain an object that will process work packages
+			 * in a worker thread.
+			 * @details
+			 * Called instead of newProcessor() when the Receiver
+			 * runs its workers as threads. Each worker thread
+			 * calls this method concurrently, and all threads
+			 * share the state set up by performInitialization(),
+			 * so an implementation can hand out references to one
+			 * copy of large read-only data rather than a copy
+			 * per worker. Any state shared this way must be safe
+			 * for concurrent use.
+			 *
+			 * This method is part of the factory personality.
+			 * The default implementation calls newProcessor().
+			 * @param logsheet
+			 * A shared pointer to the IO::Logsheet that may be
+			 * used to save messages generated by the object.
+			 * @return
+			 * A shared pointer to the work package processor.
+			 */
+			virtual std::shared_ptr<WorkPackageProcessor>
+			    newThreadedProcessor(
+				std::shared_ptr<IO::Logsheet> &logsheet);
+
 			/**
 			 * @brief
 			 * Initialization function to be called before work
@@ -138,11 +165,65 @@ namespace BiometricEvaluation {
 			 */
 			std::shared_ptr<IO::Logsheet> getLogsheet();
 
+			/**
+			 * @brief
+			 * Return a result of processing to the job.
+			 * @details
+			 * Results are collected by the Receiver and written
+			 * by Task-0 into the RecordStore named by the
+			 * "Result Record Store" property, rather than each
+			 * worker keeping its own output. Results are sent
+			 * once the current work package has been processed.
+			 * When no result RecordStore is configured, results
+			 * are discarded.
+			 *
+			 * This method is part of the worker personality, and
+			 * must be called from the thread processing the work
+			 * package.
+			 * @param[in] key
+			 * Key under which to store the result. A later
+			 * result with the same key replaces the earlier one.
+			 * @param[in] value
+			 * The result.
+			 * @param[in] size
+			 * Size of value, in bytes.
+			 */
+			void emitResult(
+			    const std::string &key,
+			    const void *value,
+			    uint64_t size);
+
+			/**
+			 * @brief
+			 * Return a result of processing to the job.
+			 * @param[in] key
+			 * Key under which to store the result. A later
+			 * result with the same key replaces the earlier one.
+			 * @param[in] value
+			 * The result.
+			 * @see emitResult(const std::string&, const void*,
+			 * uint64_t)
+			 */
+			void emitResult(
+			    const std::string &key,
+			    const Memory::uint8Array &value);
+
+			/**
+			 * @brief
+			 * Obtain the results emitted since the last call.
+			 * @details
+			 * Called by the framework after each work package.
+			 * @return
+			 * The results emitted.
+			 */
+			MPI::ResultBatch takeResults();
+
 			virtual ~WorkPackageProcessor();
 
 		protected:
 		private:
 			std::shared_ptr<IO::Logsheet> _logsheet;
+			MPI::ResultBatch _results;
 		};
 	}
 }
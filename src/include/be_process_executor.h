@@ -0,0 +1,659 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_PROCESS_EXECUTOR_H__
+#define __BE_PROCESS_EXECUTOR_H__
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace BiometricEvaluation
+{
+	namespace Process
+	{
+		class Executor;
+
+		/**
+		 * @brief
+		 * The result of a task run by an Executor.
+		 * @details
+		 * Wraps a std::shared_future, so a Future may be copied
+		 * and waited on from several places. Waiting from one of
+		 * the Executor's own threads runs other queued tasks
+		 * meanwhile, so tasks may wait on tasks they submit.
+		 */
+		template<typename T>
+		class Future
+		{
+		public:
+			/** Invalid Future */
+			Future() = default;
+
+			/**
+			 * @brief
+			 * Obtain the result of the task, waiting for it.
+			 *
+			 * @return
+			 *	The value returned by the task.
+			 *
+			 * @throw
+			 *	The exception thrown by the task, if any.
+			 */
+			decltype(std::declval<std::shared_future<T>>().get())
+			get()
+			    const;
+
+			/**
+			 * @brief
+			 * Wait for the task to finish.
+			 */
+			void
+			wait()
+			    const;
+
+			/**
+			 * @return
+			 *	Whether the task has finished.
+			 */
+			bool
+			isReady()
+			    const;
+
+			/**
+			 * @return
+			 *	Whether this Future refers to a task.
+			 */
+			bool
+			valid()
+			    const;
+
+			/**
+			 * @brief
+			 * Run a function once the task has finished.
+			 * @details
+			 * The continuation is queued on the same Executor
+			 * when the task finishes, and is passed this
+			 * Future, whose get() returns the result or throws
+			 * the task's exception.
+			 *
+			 * @param[in] continuation
+			 *	Function taking a Future<T>.
+			 *
+			 * @return
+			 *	Future for the result of continuation.
+			 */
+			template<typename F>
+			Future<std::invoke_result_t<std::decay_t<F>, Future<T>>>
+			then(
+			    F &&continuation)
+			    const;
+
+		private:
+			friend class Executor;
+			template<typename U>
+			friend class Future;
+
+			/** Completion of a task and what runs after it */
+			struct State;
+
+			Future(
+			    std::shared_future<T> future,
+			    std::shared_ptr<State> state);
+
+			/** Result of the task */
+			std::shared_future<T> _future;
+			/** Completion and continuations of the task */
+			std::shared_ptr<State> _state;
+		};
+
+		/**
+		 * @brief
+		 * A fixed pool of threads that run small tasks.
+		 * @details
+		 * Each thread keeps its own double-ended queue of tasks.
+		 * Tasks submitted from a pool thread go on that thread's
+		 * queue, which it works from the newest end; tasks from
+		 * other threads are spread over the queues. A thread whose
+		 * queue is empty steals the oldest task from another's,
+		 * and sleeps only when every queue is empty.
+		 *
+		 * Unlike a Manager's Workers, which are long-lived and
+		 * exchange messages, tasks are functions that return a
+		 * value through a Future. One Executor, such as
+		 * getDefault(), can be shared by unrelated components.
+		 *
+		 * @note
+		 * An Executor's threads do not survive fork(). Create
+		 * Executors after forking, in the process that uses them.
+		 */
+		class Executor
+		{
+		public:
+			/**
+			 * @brief
+			 * Start the threads of the pool.
+			 *
+			 * @param[in] numThreads
+			 *	Number of threads, or 0 for one per hardware
+			 *	thread.
+			 *
+			 * @throw Error::StrategyError
+			 *	A thread could not be started.
+			 */
+			Executor(
+			    uint32_t numThreads = 0);
+
+			/**
+			 * @brief
+			 * Run all queued tasks, then stop the threads.
+			 * @note
+			 * Tasks must not be submitted once destruction has
+			 * begun, other than by tasks already queued.
+			 */
+			~Executor();
+
+			Executor(
+			    const Executor&) = delete;
+			Executor&
+			operator=(
+			    const Executor&) = delete;
+
+			/**
+			 * @return
+			 *	Number of threads in the pool.
+			 */
+			uint32_t
+			getNumThreads()
+			    const;
+
+			/**
+			 * @brief
+			 * Queue a function to be run by the pool.
+			 *
+			 * @param[in] function
+			 *	Function to run.
+			 * @param[in] args
+			 *	Arguments to function, copied or moved.
+			 *
+			 * @return
+			 *	Future for the result of function.
+			 */
+			template<typename F, typename... Args>
+			Future<std::invoke_result_t<std::decay_t<F>,
+			    std::decay_t<Args>...>>
+			submit(
+			    F &&function,
+			    Args&&... args);
+
+			/**
+			 * @brief
+			 * Call a function for each integer in a range,
+			 * in parallel.
+			 * @details
+			 * The range is divided into chunks, each run as a
+			 * task. Returns when every chunk is done.
+			 *
+			 * @param[in] first
+			 *	First value.
+			 * @param[in] last
+			 *	One past the last value.
+			 * @param[in] function
+			 *	Function taking one value of the range.
+			 * @param[in] grainSize
+			 *	Values per task, or 0 to choose one.
+			 *
+			 * @throw
+			 *	The first exception thrown by function, after
+			 *	all chunks have finished.
+			 */
+			template<typename Index, typename F>
+			void
+			parallelFor(
+			    Index first,
+			    Index last,
+			    F &&function,
+			    uint64_t grainSize = 0);
+
+			/**
+			 * @brief
+			 * Call a function for each element of a sequence,
+			 * in parallel.
+			 * @details
+			 * With random-access iterators, such as those of
+			 * std::vector, function is passed a reference to
+			 * each element. Otherwise, such as with
+			 * IO::RecordStore iterators, the calling thread
+			 * advances the iterator and hands copies of the
+			 * elements to tasks in batches, with a bounded
+			 * number of batches in flight. Returns when every
+			 * element is done.
+			 *
+			 * @param[in] first
+			 *	Iterator to the first element.
+			 * @param[in] last
+			 *	Iterator past the last element.
+			 * @param[in] function
+			 *	Function taking one element.
+			 * @param[in] grainSize
+			 *	Elements per task, or 0 to choose one.
+			 *
+			 * @throw
+			 *	The first exception thrown by function, after
+			 *	all tasks have finished.
+			 */
+			template<typename Iterator, typename F>
+			void
+			parallelForEach(
+			    Iterator first,
+			    Iterator last,
+			    F &&function,
+			    uint64_t grainSize = 0);
+
+			/**
+			 * @brief
+			 * Call a function for each element of a container,
+			 * in parallel.
+			 * @see parallelForEach(Iterator, Iterator, F&&,
+			 * uint64_t)
+			 */
+			template<typename Container, typename F>
+			void
+			parallelForEach(
+			    Container &container,
+			    F &&function,
+			    uint64_t grainSize = 0);
+
+			/**
+			 * @brief
+			 * Run one queued task in the calling thread.
+			 * @details
+			 * From a pool thread, the thread's own queue is
+			 * tried first; otherwise a task is stolen.
+			 *
+			 * @return
+			 *	true if a task was run, false if none was
+			 *	queued.
+			 */
+			bool
+			runPendingTask();
+
+			/**
+			 * @return
+			 *	Whether the calling thread belongs to this
+			 *	Executor.
+			 */
+			bool
+			isPoolThread()
+			    const;
+
+			/**
+			 * @brief
+			 * Obtain an Executor shared by the process.
+			 * @details
+			 * Created on first use, with one thread per
+			 * hardware thread.
+			 *
+			 * @return
+			 *	The shared Executor.
+			 */
+			static Executor&
+			getDefault();
+
+		private:
+			template<typename T>
+			friend class Future;
+
+			/** One thread's tasks */
+			struct Queue
+			{
+				std::mutex mutex;
+				std::deque<std::function<void()>> tasks;
+			};
+
+			/**
+			 * @brief
+			 * Queue a task.
+			 */
+			void
+			enqueue(
+			    std::function<void()> task);
+
+			/**
+			 * @brief
+			 * Take a task, from queue index first, then from
+			 * the others.
+			 */
+			bool
+			takeTask(
+			    uint32_t index,
+			    std::function<void()> &task);
+
+			/**
+			 * @brief
+			 * Run tasks until stopping.
+			 */
+			void
+			threadMain(
+			    uint32_t index);
+
+			/**
+			 * @brief
+			 * Wait for futures, running tasks meanwhile, then
+			 * rethrow the first exception.
+			 */
+			template<typename T>
+			void
+			waitForAll(
+			    std::vector<Future<T>> &futures);
+
+			/** Number of tasks to divide a range into */
+			uint64_t
+			getNumChunks(
+			    uint64_t count,
+			    uint64_t grainSize)
+			    const;
+
+			/** Queue of each thread */
+			std::vector<std::unique_ptr<Queue>> _queues;
+			/** The threads */
+			std::vector<std::thread> _threads;
+			/** Queue for the next task from outside the pool */
+			std::atomic<uint32_t> _nextQueue{0};
+
+			/** Protects sleeping and stopping */
+			std::mutex _mutex;
+			/** Signaled when a task is queued or when stopping */
+			std::condition_variable _taskQueued;
+			/** Tasks queued and not yet taken (briefly < 0 while queuing) */
+			std::atomic<int64_t> _numQueued{0};
+			/** Set when the threads should exit */
+			bool _stopping{false};
+		};
+	}
+}
+
+/*
+ * Future<T>.
+ */
+
+template<typename T>
+struct BiometricEvaluation::Process::Future<T>::State
+{
+	State(
+	    Executor *executor) :
+	    executor{executor}
+	{
+	}
+
+	/** Mark the task finished and queue its continuations */
+	void
+	finish()
+	{
+		std::vector<std::function<void()>> ready;
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			this->done = true;
+			ready.swap(this->continuations);
+		}
+		for (auto &continuation : ready)
+			this->executor->enqueue(std::move(continuation));
+	}
+
+	/** Queue continuation once the task is finished */
+	void
+	addContinuation(
+	    std::function<void()> continuation)
+	{
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			if (!this->done) {
+				this->continuations.push_back(
+				    std::move(continuation));
+				return;
+			}
+		}
+		this->executor->enqueue(std::move(continuation));
+	}
+
+	Executor *executor;
+	std::mutex mutex;
+	bool done{false};
+	std::vector<std::function<void()>> continuations;
+};
+
+template<typename T>
+BiometricEvaluation::Process::Future<T>::Future(
+    std::shared_future<T> future,
+    std::shared_ptr<State> state) :
+    _future{std::move(future)},
+    _state{std::move(state)}
+{
+
+}
+
+template<typename T>
+decltype(std::declval<std::shared_future<T>>().get())
+BiometricEvaluation::Process::Future<T>::get()
+    const
+{
+	this->wait();
+	return (this->_future.get());
+}
+
+template<typename T>
+void
+BiometricEvaluation::Process::Future<T>::wait()
+    const
+{
+	/* Keep a pool thread busy rather than blocking it */
+	if ((this->_state != nullptr) && this->_state->executor->isPoolThread()) {
+		while (!this->isReady())
+			if (!this->_state->executor->runPendingTask())
+				this->_future.wait_for(
+				    std::chrono::microseconds(100));
+		return;
+	}
+	this->_future.wait();
+}
+
+template<typename T>
+bool
+BiometricEvaluation::Process::Future<T>::isReady()
+    const
+{
+	return (this->_future.wait_for(std::chrono::seconds(0)) ==
+	    std::future_status::ready);
+}
+
+template<typename T>
+bool
+BiometricEvaluation::Process::Future<T>::valid()
+    const
+{
+	return (this->_future.valid());
+}
+
+template<typename T>
+template<typename F>
+BiometricEvaluation::Process::Future<std::invoke_result_t<std::decay_t<F>,
+    BiometricEvaluation::Process::Future<T>>>
+BiometricEvaluation::Process::Future<T>::then(
+    F &&continuation)
+    const
+{
+	using R = std::invoke_result_t<std::decay_t<F>, Future<T>>;
+
+	const Future<T> antecedent{*this};
+	auto task = std::make_shared<std::packaged_task<R()>>(
+	    [continuation = std::forward<F>(continuation), antecedent]()
+	    mutable {
+		return (continuation(antecedent));
+	});
+	auto state = std::make_shared<typename Future<R>::State>(
+	    this->_state->executor);
+	Future<R> future{task->get_future().share(), state};
+
+	this->_state->addContinuation([task, state]() {
+		(*task)();
+		state->finish();
+	});
+	return (future);
+}
+
+/*
+ * Executor.
+ */
+
+template<typename F, typename... Args>
+BiometricEvaluation::Process::Future<std::invoke_result_t<std::decay_t<F>,
+    std::decay_t<Args>...>>
+BiometricEvaluation::Process::Executor::submit(
+    F &&function,
+    Args&&... args)
+{
+	using R = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+
+	auto task = std::make_shared<std::packaged_task<R()>>(
+	    [function = std::forward<F>(function),
+	    arguments = std::make_tuple(std::forward<Args>(args)...)]()
+	    mutable {
+		return (std::apply(function, std::move(arguments)));
+	});
+	auto state = std::make_shared<typename Future<R>::State>(this);
+	Future<R> future{task->get_future().share(), state};
+
+	this->enqueue([task, state]() {
+		(*task)();
+		state->finish();
+	});
+	return (future);
+}
+
+template<typename T>
+void
+BiometricEvaluation::Process::Executor::waitForAll(
+    std::vector<Future<T>> &futures)
+{
+	for (const auto &future : futures)
+		future.wait();
+	for (const auto &future : futures)
+		future.get();
+}
+
+template<typename Index, typename F>
+void
+BiometricEvaluation::Process::Executor::parallelFor(
+    Index first,
+    Index last,
+    F &&function,
+    uint64_t grainSize)
+{
+	if (!(first < last))
+		return;
+
+	const uint64_t count = static_cast<uint64_t>(last - first);
+	const uint64_t numChunks = this->getNumChunks(count, grainSize);
+	const uint64_t chunkSize = count / numChunks;
+	const uint64_t remainder = count % numChunks;
+
+	std::vector<Future<void>> futures;
+	futures.reserve(numChunks);
+	Index begin = first;
+	for (uint64_t i = 0; i < numChunks; i++) {
+		const Index end = begin + static_cast<Index>(chunkSize +
+		    (i < remainder ? 1 : 0));
+		futures.push_back(this->submit([&function, begin, end]() {
+			for (Index index = begin; index < end; index++)
+				function(index);
+		}));
+		begin = end;
+	}
+	this->waitForAll(futures);
+}
+
+template<typename Iterator, typename F>
+void
+BiometricEvaluation::Process::Executor::parallelForEach(
+    Iterator first,
+    Iterator last,
+    F &&function,
+    uint64_t grainSize)
+{
+	using Category =
+	    typename std::iterator_traits<Iterator>::iterator_category;
+
+	if constexpr (std::is_base_of_v<std::random_access_iterator_tag,
+	    Category>) {
+		this->parallelFor(static_cast<std::ptrdiff_t>(0),
+		    static_cast<std::ptrdiff_t>(last - first),
+		    [&function, first](std::ptrdiff_t index) {
+			function(*(first + index));
+		}, grainSize);
+	} else {
+		/*
+		 * The iterator can only be advanced by one thread, so this
+		 * one reads ahead while tasks work on earlier batches.
+		 */
+		using Value = typename std::iterator_traits<Iterator>::
+		    value_type;
+		if (grainSize == 0)
+			grainSize = 16;
+		const size_t maxInFlight = 2 * this->getNumThreads();
+
+		std::vector<Future<void>> futures;
+		std::deque<Future<void>> inFlight;
+		while (!(first == last)) {
+			std::vector<Value> batch;
+			batch.reserve(grainSize);
+			for (; !(first == last) && (batch.size() < grainSize);
+			    ++first)
+				batch.push_back(*first);
+
+			/* Bound memory held by batches not yet processed */
+			while (inFlight.size() >= maxInFlight) {
+				inFlight.front().wait();
+				futures.push_back(inFlight.front());
+				inFlight.pop_front();
+			}
+			inFlight.push_back(this->submit([&function,
+			    values = std::move(batch)]() mutable {
+				for (auto &value : values)
+					function(value);
+			}));
+		}
+		futures.insert(futures.end(), inFlight.begin(), inFlight.end());
+		this->waitForAll(futures);
+	}
+}
+
+template<typename Container, typename F>
+void
+BiometricEvaluation::Process::Executor::parallelForEach(
+    Container &container,
+    F &&function,
+    uint64_t grainSize)
+{
+	this->parallelForEach(std::begin(container), std::end(container),
+	    std::forward<F>(function), grainSize);
+}
+
+#endif /* __BE_PROCESS_EXECUTOR_H__ */
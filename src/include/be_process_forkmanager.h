@@ -74,6 +74,8 @@ namespace BiometricEvaluation
 			 * @param[in] communicate
 			 *	Whether or not to enable communication
 			 *	among the Workers and Managers.
+			 * @param[in] placement
+			 *	CPUs on which to run Workers.
 			 *
 			 * @throw Error::ObjectExists
 			 *	At least one Worker is already working.
@@ -83,7 +85,8 @@ namespace BiometricEvaluation
 			void
 			startWorkers(
 			    bool wait = true,
-			    bool communicate = false);
+			    bool communicate = false,
+			    Placement placement = Placement::None);
    
 			/**
 			 * @brief
@@ -98,6 +101,8 @@ namespace BiometricEvaluation
  			 * @param[in] communicate
 			 *	Whether or not to enable communication
 			 *	among the Workers and Managers.
+			 * @param[in] placement
+			 *	CPUs on which to run Workers.
 			 *
 			 * @throw Error::ObjectExists
 			 *	worker is already working.
@@ -108,7 +113,8 @@ namespace BiometricEvaluation
 			startWorker(
 			    std::shared_ptr<WorkerController> worker,
 			    bool wait = true,
-			    bool communicate = false);
+			    bool communicate = false,
+			    Placement placement = Placement::None);
 
 			/**
 			 * @brief
@@ -443,6 +449,9 @@ namespace BiometricEvaluation
 			 * @param communicate
 			 *	Whether or not to enable communication between
 			 *	Worker and Manager.
+			 * @param cpus
+			 *	CPUs on which to run the Worker, or empty to
+			 *	let the operating system choose.
 			 *
 			 * @throw Error::ObjectExists
 			 *	The decorated Worker is already working.
@@ -455,7 +464,8 @@ namespace BiometricEvaluation
 			 */
 			void
 			start(
-			    bool communicate = false);
+			    bool communicate = false,
+			    const std::vector<uint32_t> &cpus = {});
 
 			/**
 			 * @brief
@@ -493,6 +503,8 @@ namespace BiometricEvaluation
  			 * @param[in] communicate
 			 *	Whether or not to enable communication
 			 *	among the Workers and Managers.
+			 * @param[in] placement
+			 *	CPUs on which to run Workers.
 			 *
  			 * @throw Error::ObjectExists
 			 *	One or more of the Workers is already working.
@@ -502,7 +514,8 @@ namespace BiometricEvaluation
 			friend void
 			ForkManager::startWorkers(
 			    bool wait,
-			    bool communicate);
+			    bool communicate,
+			    Placement placement);
 
 			/**
 			 * @brief
@@ -517,6 +530,8 @@ namespace BiometricEvaluation
  			 * @param[in] communicate
 			 *	Whether or not to enable communication
 			 *	among the Workers and Managers.
+			 * @param[in] placement
+			 *	CPUs on which to run Workers.
 			 *
 			 * @throw Error::ObjectExists
 			 *	worker is already working.
@@ -527,7 +542,8 @@ namespace BiometricEvaluation
 			ForkManager::startWorker(
 			    std::shared_ptr<WorkerController> worker,
 			    bool wait,
-			    bool communicate);
+			    bool communicate,
+			    Placement placement);
 
 			/**
 			 * @brief
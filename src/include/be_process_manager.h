@@ -11,10 +11,13 @@
 #ifndef __BE_PROCESS_MANAGER_H__
 #define __BE_PROCESS_MANAGER_H__
 
+#include <map>
+#include <utility>
 #include <vector>
 
 #include <be_error_exception.h>
 #include <be_process.h>
+#include <be_process_placement.h>
 #include <be_process_worker.h>
 #include <be_process_workercontroller.h>
 
@@ -34,7 +37,13 @@ namespace BiometricEvaluation
 			 * Manager constructor.
 			 */
 			Manager();
-		
+
+			Manager(
+			    const Manager&) = delete;
+			Manager&
+			operator=(
+			    const Manager&) = delete;
+
 			/**
 			 * @brief
 			 * Adds a Worker to be managed by this Manager.
@@ -98,16 +107,21 @@ namespace BiometricEvaluation
 			 * @param[in] communicate
 			 *	Whether or not to enable communication
 			 *	among the Workers and Managers.
+			 * @param[in] placement
+			 *	CPUs on which to run each Worker.
 			 *
 			 * @throw Error::ObjectExists
 			 *	At least one Worker is already working.
+			 * @throw Error::NotImplemented
+			 *	placement is not supported on this system.
 			 * @throw Error::StrategyError
 			 *	Problem starting Workers.
 			 */
 			virtual void
 			startWorkers(
 			    bool wait = true,
-			    bool communicate = false) = 0;
+			    bool communicate = false,
+			    Placement placement = Placement::None) = 0;
 
 			/**
 			 * @brief
@@ -122,9 +136,14 @@ namespace BiometricEvaluation
 			 * @param[in] communicate
 			 *	Whether or not to enable communication
 			 *	among the Workers and Managers.
+			 * @param[in] placement
+			 *	CPUs on which to run the Worker, chosen from
+			 *	its position among the Manager's Workers.
 			 *
 			 * @throw Error::ObjectExists
 			 *	worker is already working.
+			 * @throw Error::NotImplemented
+			 *	placement is not supported on this system.
 			 * @throw Error::StrategyError
 			 *	worker is not managed by this Manager instance.
 			 *
@@ -138,7 +157,8 @@ namespace BiometricEvaluation
 			startWorker(
 			    std::shared_ptr<WorkerController> worker,
 			    bool wait = true,
-			    bool communicate = false) = 0;
+			    bool communicate = false,
+			    Placement placement = Placement::None) = 0;
 
 			/**
 			 * @brief
@@ -180,12 +200,19 @@ namespace BiometricEvaluation
 			/**
 			 * @brief
 			 * Wait for a message from a Worker.
+			 * @details
+			 * When more than one Worker has a message waiting,
+			 * Workers are taken in turn, starting after the
+			 * Worker last returned.
 			 *
 			 * @param[out] sender
 			 *	Reference to a shared pointer of the 
 			 *	WorkerController that sent the message.
 			 * @param[in,out] nextFD
 			 *	Location to store a pipe that has data to read.
+			 *	Read the message with the Worker's
+			 *	receiveMessageFromWorker(), as the pipe may
+			 *	only signal a shared memory channel.
 			 * @param[in] numSeconds
 			 *	Number of seconds to wait for a message, or
 			 *	< 0 to block.
@@ -228,6 +255,54 @@ namespace BiometricEvaluation
 			    Memory::uint8Array &message,
 			    int numSeconds = -1) const;
 
+			/**
+			 * @brief
+			 * Obtain all messages waiting from Workers.
+			 * @details
+			 * Waits as getNextMessage() does, then reads every
+			 * message waiting on the pipe of each Worker that
+			 * has one, taking Workers in turn as
+			 * waitForMessage() does. Messages that arrive while
+			 * reading are left for the next call.
+			 *
+			 * @param[out] messages
+			 *	Appended with the sending WorkerController
+			 *	and the message, for each message read.
+			 * @param[in] numSeconds
+			 *	Number of seconds to wait for a message, or
+			 *	< 0 to block.
+			 *
+			 * @return
+			 *	Number of messages read.
+			 *
+			 * @throw Error::ObjectDoesNotExist
+			 *	(Unexpected) widowed pipe.
+			 * @throw Error::StrategyError
+			 *	Error receiving message.
+			 */
+			virtual uint64_t
+			getNextMessages(
+			    std::vector<std::pair<
+			    std::shared_ptr<WorkerController>,
+			    Memory::uint8Array>> &messages,
+			    int numSeconds = -1) const;
+
+			/**
+			 * @brief
+			 * Obtain the pipes on which Workers send messages.
+			 * @details
+			 * Allows waiting for a message from a Worker together
+			 * with other events, such as with poll(). When a
+			 * pipe is readable, getNextMessage() will not block.
+			 *
+			 * @return
+			 *	The receiving pipe of each Worker that is
+			 *	working and has not been asked to stop.
+			 */
+			virtual std::vector<int>
+			getReceivingPipes()
+			    const;
+
 			/**
 			 * @brief
 			 * Send one message to all Workers.
@@ -263,9 +338,77 @@ namespace BiometricEvaluation
 			/** Workers that are about to exit (stop requested). */
 			std::vector<std::shared_ptr<WorkerController>>
 			    _pendingExit;
-			
+
+			/**
+			 * @brief
+			 * Listen for messages from a Worker.
+			 * @details
+			 * Called once a Worker is started. Does nothing
+			 * when communication with the Worker is not enabled.
+			 *
+			 * @param worker
+			 *	The started Worker.
+			 *
+			 * @throw Error::StrategyError
+			 *	Could not listen to the Worker's pipe.
+			 */
+			void
+			watchWorker(
+			    const std::shared_ptr<WorkerController> &worker);
+
+			/**
+			 * @brief
+			 * Stop listening for messages from a Worker.
+			 *
+			 * @param worker
+			 *	A Worker that is stopping or has stopped.
+			 */
+			void
+			unwatchWorker(
+			    const std::shared_ptr<WorkerController> &worker)
+			    const;
+
 		private:
-		
+			/**
+			 * @brief
+			 * Wait until Worker pipes have a message to read.
+			 *
+			 * @param numSeconds
+			 *	Number of seconds to wait, or < 0 to block.
+			 *
+			 * @return
+			 *	Readable pipes of working Workers, in the
+			 *	order they should be read.
+			 */
+			std::vector<int>
+			waitForReadablePipes(
+			    int numSeconds)
+			    const;
+
+			/**
+			 * @brief
+			 * Stop listening on a pipe.
+			 *
+			 * @param fd
+			 *	A receiving pipe being listened to.
+			 */
+			void
+			unwatchPipe(
+			    int fd)
+			    const;
+
+			/**
+			 * Receiving pipes of started Workers and their
+			 * WorkerController, kept as Workers start and stop.
+			 */
+			mutable std::map<int, std::shared_ptr<WorkerController>>
+			    _watched;
+
+			/** Pipe of the Worker whose message was last taken */
+			mutable int _lastPipe{-1};
+
+			/** epoll instance listening on _watched (Linux) */
+			int _pollFD{-1};
 		};
 	}
 }
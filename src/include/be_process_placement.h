@@ -0,0 +1,98 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_PROCESS_PLACEMENT_H__
+#define __BE_PROCESS_PLACEMENT_H__
+
+#include <cstdint>
+#include <vector>
+
+#include <be_framework_enumeration.h>
+
+namespace BiometricEvaluation
+{
+	namespace Process
+	{
+		/**
+		 * @brief
+		 * Where the Workers of a Manager run.
+		 * @details
+		 * Workers are numbered in the order they were added to
+		 * their Manager, and are placed among the CPUs on which
+		 * the Manager's thread may run, so that processes bound
+		 * to part of a machine, such as by an MPI launcher, place
+		 * their Workers within that part. Memory is not bound,
+		 * but the operating system normally allocates a Worker's
+		 * memory on the NUMA node of the CPU that first uses it.
+		 */
+		enum class Placement
+		{
+			/** Let the operating system schedule Workers */
+			None,
+			/** One CPU each, filling a core, then a socket */
+			Compact,
+			/** One core each, taking NUMA nodes in turn */
+			Scatter,
+			/** All CPUs of one core each, in turn */
+			PerCore,
+			/** All CPUs of one NUMA node each, in turn */
+			PerNUMANode
+		};
+
+		/**
+		 * @brief
+		 * Obtain the CPUs on which a Worker should run.
+		 *
+		 * @param[in] placement
+		 *	Placement of the Manager's Workers.
+		 * @param[in] index
+		 *	Index of the Worker.
+		 *
+		 * @return
+		 *	Operating system indices of the CPUs, empty when
+		 *	placement is Placement::None.
+		 *
+		 * @throw Error::NotImplemented
+		 *	Built without hwloc, or the topology of the
+		 *	machine could not be determined.
+		 */
+		std::vector<uint32_t>
+		getPlacementCPUs(
+		    Placement placement,
+		    uint32_t index);
+
+		/**
+		 * @brief
+		 * Run the calling thread or process on CPUs.
+		 *
+		 * @param[in] cpus
+		 *	Operating system indices of the CPUs, as returned
+		 *	from getPlacementCPUs(). Does nothing when empty.
+		 * @param[in] wholeProcess
+		 *	Whether to bind all threads of the process rather
+		 *	than only the calling thread.
+		 *
+		 * @throw Error::NotImplemented
+		 *	Built without hwloc.
+		 * @throw Error::StrategyError
+		 *	Could not bind to cpus.
+		 */
+		void
+		bindToCPUs(
+		    const std::vector<uint32_t> &cpus,
+		    bool wholeProcess);
+	}
+}
+
+BE_FRAMEWORK_ENUMERATION_DECLARATIONS(
+    BiometricEvaluation::Process::Placement,
+    BE_Process_Placement_EnumToStringMap);
+
+#endif /* __BE_PROCESS_PLACEMENT_H__ */
@@ -60,6 +60,8 @@ namespace BiometricEvaluation
 			 * @param[in] communicate
 			 *	Whether or not to enable communication
 			 *	among the Workers and Managers.
+			 * @param[in] placement
+			 *	CPUs on which to run Workers.
 			 *
 			 * @throw Error::ObjectExists
 			 *	At least one Worker is already working.
@@ -69,7 +71,8 @@ namespace BiometricEvaluation
 			void
 			startWorkers(
 			    bool wait = true,
-			    bool communicate = false);
+			    bool communicate = false,
+			    Placement placement = Placement::None);
 
 			/**
 			 * @brief
@@ -84,6 +87,8 @@ namespace BiometricEvaluation
 			 * @param communicate
 			 *	Whether or not to enable communication
 			 *	among the Workers and Managers.
+			 * @param[in] placement
+			 *	CPUs on which to run Workers.
 			 *
 			 * @throw Error::ObjectExists
 			 *	worker is already working.
@@ -94,7 +99,8 @@ namespace BiometricEvaluation
 			startWorker(
 			    std::shared_ptr<WorkerController> worker,
 			    bool wait = true,
-			    bool communicate = false);
+			    bool communicate = false,
+			    Placement placement = Placement::None);
 
 			/**
 			 * @brief
@@ -190,6 +196,9 @@ namespace BiometricEvaluation
 			 * @param communicate
 			 *	Whether or not to enable communication between
 			 *	Worker and Manager.
+			 * @param cpus
+			 *	CPUs on which to run the Worker, or empty to
+			 *	let the operating system choose.
 			 *
 			 * @throw Error::ObjectExists
 			 *	The decorated Worker is already working.
@@ -202,7 +211,8 @@ namespace BiometricEvaluation
 			 */
 			void
 			start(
-			    bool communicate = false);
+			    bool communicate = false,
+			    const std::vector<uint32_t> &cpus = {});
 
 			/**
 			 * @brief
@@ -248,6 +258,9 @@ namespace BiometricEvaluation
 
 			/** Whether or not the Worker has worked */
 			bool _hasWorked;
+
+			/** CPUs on which the Worker runs, if bound */
+			std::vector<uint32_t> _cpus;
 		};
 	}
 }
@@ -0,0 +1,179 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_PROCESS_SHAREDMEMORYCHANNEL_H__
+#define __BE_PROCESS_SHAREDMEMORYCHANNEL_H__
+
+#include <cstdint>
+
+#include <be_memory_autoarray.h>
+
+namespace BiometricEvaluation
+{
+	namespace Process
+	{
+		/**
+		 * @brief
+		 * A one-way message channel through shared memory.
+		 * @details
+		 * Messages are copied into a ring buffer mapped shared and
+		 * anonymous, so a channel created before fork() is shared
+		 * by parent and child, and one created in a process is
+		 * shared by its threads. There must be one sender and one
+		 * receiver.
+		 *
+		 * Sending and receiving only touch the shared ring. A
+		 * system call is made only to wake a side that found the
+		 * ring empty (receiver) or full (sender) and is waiting,
+		 * through a descriptor that becomes readable and can be
+		 * waited on with poll() or epoll alongside other events.
+		 * Messages larger than the ring are streamed through it.
+		 *
+		 * @note
+		 * A side blocked on a process that has exited is released
+		 * with an exception within about a second.
+		 */
+		class SharedMemoryChannel
+		{
+		public:
+			/**
+			 * @brief
+			 * Create a channel.
+			 *
+			 * @param[in] capacity
+			 *	Size of the ring buffer, in bytes.
+			 *
+			 * @throw Error::ParameterError
+			 *	capacity is too small.
+			 * @throw Error::StrategyError
+			 *	Could not map memory or create descriptors.
+			 */
+			SharedMemoryChannel(
+			    uint64_t capacity);
+
+			~SharedMemoryChannel();
+
+			SharedMemoryChannel(
+			    const SharedMemoryChannel&) = delete;
+			SharedMemoryChannel&
+			operator=(
+			    const SharedMemoryChannel&) = delete;
+
+			/**
+			 * @brief
+			 * Send a message, blocking while the ring is full.
+			 *
+			 * @param[in] message
+			 *	Message to send.
+			 *
+			 * @throw Error::ObjectDoesNotExist
+			 *	The receiving process has exited.
+			 * @throw Error::StrategyError
+			 *	Error waiting for the receiver.
+			 */
+			void
+			send(
+			    const Memory::uint8Array &message);
+
+			/**
+			 * @brief
+			 * Receive a message, blocking until one is sent.
+			 *
+			 * @param[out] message
+			 *	Buffer to hold the message.
+			 *
+			 * @throw Error::ObjectDoesNotExist
+			 *	The sending process has exited.
+			 * @throw Error::StrategyError
+			 *	Error waiting for the sender.
+			 */
+			void
+			receive(
+			    Memory::uint8Array &message);
+
+			/**
+			 * @brief
+			 * Obtain the number of bytes sent and not yet
+			 * received.
+			 * @details
+			 * Called by the receiver. When nothing is waiting,
+			 * the descriptor is cleared and the sender will make
+			 * it readable with its next message.
+			 *
+			 * @return
+			 *	Bytes of messages, including their lengths,
+			 *	waiting to be received.
+			 */
+			uint64_t
+			getPendingBytes();
+
+			/**
+			 * @brief
+			 * Wait for a message to be sent.
+			 *
+			 * @param[in] milliseconds
+			 *	Time to wait, or < 0 to block.
+			 *
+			 * @return
+			 *	true if a message is waiting, false otherwise.
+			 *
+			 * @throw Error::StrategyError
+			 *	Error waiting for the sender.
+			 */
+			bool
+			waitForMessage(
+			    int milliseconds);
+
+			/**
+			 * @return
+			 *	Descriptor that is readable when a message has
+			 *	been sent since the receiver last found the
+			 *	channel empty.
+			 */
+			int
+			getDescriptor()
+			    const;
+
+		private:
+			struct Ring;
+
+			/**
+			 * @brief
+			 * Copy bytes into the ring, waiting for space.
+			 */
+			void
+			write(
+			    const uint8_t *data,
+			    uint64_t size);
+
+			/**
+			 * @brief
+			 * Copy bytes out of the ring, waiting for data.
+			 */
+			void
+			read(
+			    uint8_t *data,
+			    uint64_t size);
+
+			/** Shared state and buffer */
+			Ring *_ring;
+			/** Size of the buffer */
+			uint64_t _capacity;
+			/** Size of the mapping */
+			uint64_t _mappedSize;
+			/** Signals the receiver: readable end, writable end */
+			int _dataEvent[2];
+			/** Signals the sender: readable end, writable end */
+			int _spaceEvent[2];
+		};
+	}
+}
+
+#endif /* __BE_PROCESS_SHAREDMEMORYCHANNEL_H__ */
@@ -12,15 +12,21 @@
 #define __BE_PROCESS_STATISTICS_H__
 
 #include <pthread.h>
+#include <sys/types.h>
 
+#include <cstdint>
 #include <memory>
 #include <optional>
+#include <string>
 #include <tuple>
+#include <vector>
 
 #include <be_io_filelogcabinet.h>
 
 namespace BiometricEvaluation {
 	namespace Process {
+		class StatisticsFileWriter;
+
 
 		/**
 		 * @brief
@@ -35,6 +41,14 @@ namespace BiometricEvaluation {
 		 * current process, and can automatically be logged to a 
 		 * FileLogsheet object contained within the provided 
 		 * FileLogCabinet. The task statistics are optionally logged.
+		 *
+		 * Each log entry, and each call to sample(), also records
+		 * a Sample in a ring buffer of recent samples that the
+		 * application can read with getSamples(). Auto-sampling
+		 * fills the buffer at an interval without a Logsheet.
+		 * On Linux, the /proc files read for each sample are
+		 * opened once and kept open, one per task, for as long
+		 * as the task exists.
 		 * @note
 		 * The resolution of a returned value for many methods may
 		 * not match the resolution allowed by the interface. For
@@ -44,6 +58,67 @@ namespace BiometricEvaluation {
 		 */
 		class Statistics {
 		public:
+			/** Times for one task (thread) of the process */
+			struct TaskSample
+			{
+				/** Task ID */
+				pid_t tid{};
+				/** User time, in microseconds */
+				uint64_t utime{};
+				/** System time, in microseconds */
+				uint64_t stime{};
+				/**
+				 * User time since the previous Sample, in
+				 * microseconds. For a task new since then,
+				 * all of its user time.
+				 */
+				uint64_t utimeDelta{};
+				/** As utimeDelta, for system time */
+				uint64_t stimeDelta{};
+			};
+
+			/** Statistics for the process at one moment */
+			struct Sample
+			{
+				/** Microseconds since the epoch */
+				uint64_t timestamp{};
+				/** User time, in microseconds */
+				uint64_t utime{};
+				/** System time, in microseconds */
+				uint64_t stime{};
+				/** Resident set size, in kilobytes */
+				uint64_t vmrss{};
+				/** Virtual memory size, in kilobytes */
+				uint64_t vmsize{};
+				/** Peak virtual memory size, in kilobytes */
+				uint64_t vmpeak{};
+				/** Data segment size, in kilobytes */
+				uint64_t vmdata{};
+				/** Stack size, in kilobytes */
+				uint64_t vmstack{};
+				/** Number of threads */
+				uint32_t threads{};
+
+				/*
+				 * I/O counters, left 0 when the operating
+				 * system does not provide them.
+				 */
+				/** Bytes read, including from caches */
+				uint64_t readChars{};
+				/** Bytes written, including to caches */
+				uint64_t writeChars{};
+				/** Read system calls */
+				uint64_t readCalls{};
+				/** Write system calls */
+				uint64_t writeCalls{};
+				/** Bytes read from storage */
+				uint64_t readBytes{};
+				/** Bytes written to storage */
+				uint64_t writeBytes{};
+
+				/** Each task of the process */
+				std::vector<TaskSample> tasks{};
+			};
 
 			/**
 			 * Constructor with no parameters.
@@ -96,6 +171,24 @@ namespace BiometricEvaluation {
 			    std::optional<std::shared_ptr<IO::Logsheet>>
 				tasksLogSheet = std::nullopt);
 
+			/**
+			 * @brief
+			 * Construct a Statistics object that logs to a
+			 * binary statistics file.
+			 * @details
+			 * logStats() and automatic logging write a Sample,
+			 * including the task statistics, to statisticsFile
+			 * rather than an entry to a Logsheet. Comments are
+			 * not recorded. Stopping automatic logging flushes
+			 * statisticsFile.
+			 *
+			 * @param[in] statisticsFile
+			 *	File that will be appended.
+			 */
+			Statistics(
+			    const std::shared_ptr<StatisticsFileWriter>
+				&statisticsFile);
+
 			~Statistics();
 
 			/**
@@ -215,7 +308,7 @@ namespace BiometricEvaluation {
 			 *	not created with FileLogCabinet object.
 			 * @throw Error::StrategyError
 			 *	An error occurred when writing to the
-			 *	FileLogsheet.
+			 *	FileLogsheet or statistics file.
 			 * @throw Error::NotImplemented
 			 *	The statistics gathering is not implemented for
 			 *	this operating system.
@@ -264,6 +357,85 @@ namespace BiometricEvaluation {
 			 */
 			void stopAutoLogging();
 
+			/**
+			 * @brief
+			 * Sample the process statistics and add them to
+			 * the buffer of recent samples.
+			 *
+			 * @return
+			 *	The new Sample.
+			 *
+			 * @throw Error::StrategyError
+			 *	An error occurred when obtaining the process
+			 *	statistics from the operating system.
+			 * @throw Error::NotImplemented
+			 *	This method is not implemented on this OS.
+			 */
+			Sample sample();
+
+			/**
+			 * @brief
+			 * Obtain the recent samples.
+			 *
+			 * @return
+			 *	Samples taken by sample(), logStats(), and
+			 *	automatic logging or sampling, oldest first,
+			 *	no more than getSampleCapacity() of them.
+			 */
+			std::vector<Sample> getSamples();
+
+			/**
+			 * @brief
+			 * Set how many recent samples are kept.
+			 * @details
+			 * Samples already kept are discarded.
+			 *
+			 * @param[in] capacity
+			 *	Number of samples to keep. Defaults to 128.
+			 *
+			 * @throw Error::ParameterError
+			 *	capacity is 0.
+			 */
+			void setSampleCapacity(uint32_t capacity);
+
+			/**
+			 * @return
+			 * How many recent samples are kept.
+			 */
+			uint32_t getSampleCapacity() const;
+
+			/**
+			 * @brief
+			 * Start sampling process statistics automatically,
+			 * in intervals of microseconds, without logging.
+			 * @details
+			 * Samples are read with getSamples(). Objects
+			 * created with or without a Logsheet may sample.
+			 *
+			 * @param[in] interval
+			 *	The gap between samples, in microseconds.
+			 * @throw Error::ObjectExists
+			 *	Autologging or autosampling is currently
+			 *	invoked.
+			 * @throw Error::StrategyError
+			 *	The sampling thread could not be started.
+			 * @throw Error::NotImplemented
+			 *	Sampling is not implemented on this OS.
+			 */
+			void startAutoSampling(uint64_t interval);
+
+			/**
+			 * @brief
+			 * Stop the automatic sampling of process statistics.
+			 *
+			 * @throw Error::ObjectDoesNotExist
+			 *	Not currently autosampling.
+			 * @throw Error::StrategyError
+			 *	An error occurred when stopping, most likely
+			 *	because the sampling thread died.
+			 */
+			void stopAutoSampling();
+
 			/**
 			 * Helper function in C++ space that has access to
 			 * this object, and is called from C space by the
@@ -291,6 +463,34 @@ namespace BiometricEvaluation {
 			    std::string_view comment);
 
 		private:
+			/** Open /proc files of the process */
+			struct Sampler;
+
+			/**
+			 * @brief
+			 * Take and keep a Sample, with _logMutex held.
+			 */
+			Sample sampleLocked();
+
+			/**
+			 * @brief
+			 * Obtain the Sampler, creating it on first use.
+			 * @throw Error::NotImplemented
+			 *	Sampling is not implemented on this OS.
+			 */
+			Sampler &getSampler();
+
+			/**
+			 * @brief
+			 * Start the thread that logs or samples.
+			 */
+			void startAutoThread(uint64_t interval);
+
+			/**
+			 * @brief
+			 * Stop the thread that logs or samples.
+			 */
+			void stopAutoThread();
 
 			pid_t _pid;
 			std::shared_ptr<IO::FileLogCabinet> _logCabinet{};
@@ -304,6 +504,15 @@ namespace BiometricEvaluation {
 			pthread_t _loggingThread{};
 			pthread_mutex_t _logMutex{};
 			std::string _comment{};
+			/** Whether the automatic thread only samples */
+			bool _autoSampling{};
+			std::unique_ptr<Sampler> _sampler{};
+			/** Recent samples; oldest at _nextSample when full */
+			std::vector<Sample> _samples{};
+			std::size_t _nextSample{};
+			uint32_t _sampleCapacity{128};
+			/** Destination of logged samples, instead of _logSheet */
+			std::shared_ptr<StatisticsFileWriter> _statisticsFile{};
 		};
 
 	}
@@ -0,0 +1,252 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_PROCESS_STATISTICSFILE_H__
+#define __BE_PROCESS_STATISTICSFILE_H__
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <be_io_compressor.h>
+#include <be_process_statistics.h>
+
+namespace BiometricEvaluation
+{
+	namespace Process
+	{
+		/**
+		 * @brief
+		 * Write Statistics samples to a compact binary file.
+		 * @details
+		 * The file starts with a schema header naming the fields
+		 * of the fixed-width sample and task records, followed by
+		 * blocks of records. Samples are kept in memory until a
+		 * block is full, then the block is written, optionally
+		 * compressed, so writing a sample does not perform I/O.
+		 * Use StatisticsFileReader to read the file, or to convert
+		 * it to CSV.
+		 *
+		 * Samples are written by passing this object to a
+		 * Statistics, whose logStats() and automatic logging
+		 * then write here rather than to a Logsheet, or by
+		 * calling write().
+		 *
+		 * @note
+		 * Samples in a block that has not been written are lost
+		 * if the process exits abnormally. Calling flush() limits
+		 * the loss.
+		 * @note
+		 * Objects of this class are not thread-safe; Statistics
+		 * serializes its own calls.
+		 */
+		class StatisticsFileWriter
+		{
+		public:
+			/**
+			 * @brief
+			 * Create a new statistics file.
+			 *
+			 * @param[in] pathname
+			 *	Path of the file to create.
+			 * @param[in] compress
+			 *	Whether to compress each block.
+			 * @param[in] samplesPerBlock
+			 *	Number of samples kept before a block is
+			 *	written.
+			 * @param[in] writeTasks
+			 *	Whether to write the statistics of each task
+			 *	along with the process statistics.
+			 *
+			 * @throw Error::ObjectExists
+			 *	pathname exists.
+			 * @throw Error::ParameterError
+			 *	samplesPerBlock is 0.
+			 * @throw Error::StrategyError
+			 *	Could not create pathname.
+			 */
+			StatisticsFileWriter(
+			    const std::string &pathname,
+			    bool compress = true,
+			    uint32_t samplesPerBlock = 64,
+			    bool writeTasks = true);
+
+			/** Writes any remaining samples */
+			~StatisticsFileWriter();
+
+			StatisticsFileWriter(
+			    const StatisticsFileWriter&) = delete;
+			StatisticsFileWriter&
+			operator=(
+			    const StatisticsFileWriter&) = delete;
+
+			/**
+			 * @brief
+			 * Add a sample to the file.
+			 *
+			 * @param[in] sample
+			 *	Sample to add.
+			 *
+			 * @throw Error::StrategyError
+			 *	Could not write a full block.
+			 */
+			void
+			write(
+			    const Statistics::Sample &sample);
+
+			/**
+			 * @brief
+			 * Write the samples added since the last block
+			 * as a block of their own.
+			 *
+			 * @throw Error::StrategyError
+			 *	Could not write the block.
+			 */
+			void
+			flush();
+
+			/**
+			 * @return
+			 * Path of the file.
+			 */
+			std::string
+			getPathname()
+			    const;
+
+		private:
+			std::string _pathname;
+			std::ofstream _stream;
+			std::shared_ptr<IO::Compressor> _compressor{};
+			uint32_t _samplesPerBlock;
+			bool _writeTasks;
+
+			/** Encoded records of the current block */
+			std::vector<uint8_t> _samples{};
+			std::vector<uint8_t> _tasks{};
+			uint32_t _numSamples{};
+			uint32_t _numTasks{};
+		};
+
+		/**
+		 * @brief
+		 * Read a file written by StatisticsFileWriter.
+		 * @details
+		 * Fields the reader does not know, written by a newer
+		 * writer after the known fields of a record, are skipped.
+		 * An incomplete block at the end of the file, as left by
+		 * a process that exited while writing, ends the file.
+		 */
+		class StatisticsFileReader
+		{
+		public:
+			/**
+			 * @brief
+			 * Open a statistics file.
+			 *
+			 * @param[in] pathname
+			 *	Path of the file.
+			 *
+			 * @throw Error::ObjectDoesNotExist
+			 *	pathname does not exist.
+			 * @throw Error::StrategyError
+			 *	pathname could not be read, or is not a
+			 *	statistics file of a known schema.
+			 */
+			StatisticsFileReader(
+			    const std::string &pathname);
+
+			/**
+			 * @brief
+			 * Obtain the next sample.
+			 *
+			 * @return
+			 *	The next sample in the file. The tasks of
+			 *	the sample are empty when the file was
+			 *	written without them.
+			 *
+			 * @throw Error::ObjectDoesNotExist
+			 *	No samples remain.
+			 * @throw Error::StrategyError
+			 *	A block could not be read or decompressed.
+			 */
+			Statistics::Sample
+			sequence();
+
+			/**
+			 * @brief
+			 * Write the remaining samples as CSV.
+			 *
+			 * @param[in] samplesCSV
+			 *	Stream to receive a header line and a line
+			 *	for each sample, without tasks.
+			 *
+			 * @throw Error::StrategyError
+			 *	A block could not be read, or samplesCSV
+			 *	could not be written.
+			 */
+			void
+			writeCSV(
+			    std::ostream &samplesCSV);
+
+			/**
+			 * @brief
+			 * Write the remaining samples, and their tasks,
+			 * as CSV.
+			 *
+			 * @param[in] samplesCSV
+			 *	Stream to receive a header line and a line
+			 *	for each sample, without tasks.
+			 * @param[in] tasksCSV
+			 *	Stream to receive a header line and a line
+			 *	for each task of each sample, identified by
+			 *	the sample's timestamp.
+			 *
+			 * @throw Error::StrategyError
+			 *	A block could not be read, or a stream
+			 *	could not be written.
+			 */
+			void
+			writeCSV(
+			    std::ostream &samplesCSV,
+			    std::ostream &tasksCSV);
+
+		private:
+			/**
+			 * @brief
+			 * Read the next block into _block.
+			 *
+			 * @return
+			 *	false when no complete block remains.
+			 */
+			bool
+			readBlock();
+
+			/** Write remaining samples, and tasks if non-null */
+			void
+			writeCSV(
+			    std::ostream &samplesCSV,
+			    std::ostream *tasksCSV);
+
+			std::ifstream _stream;
+			/** Bytes in each sample and task record */
+			uint32_t _sampleWidth{};
+			uint32_t _taskWidth{};
+
+			/** Samples of the current block */
+			std::vector<Statistics::Sample> _block{};
+			std::size_t _next{};
+		};
+	}
+}
+
+#endif /* __BE_PROCESS_STATISTICSFILE_H__ */
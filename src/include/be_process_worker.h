@@ -12,10 +12,12 @@
 #define __BE_PROCESS_WORKER_H__
 
 #include <cstdint>
+#include <memory>
 
 #include <be_error_exception.h>
 #include <be_memory_autoarray.h>
 #include <be_process.h>
+#include <be_process_sharedmemorychannel.h>
 
 namespace BiometricEvaluation
 {
@@ -144,6 +146,39 @@ namespace BiometricEvaluation
 			stop()
 			    final;
 			
+			/**
+			 * @brief
+			 * Exchange messages with the Manager through shared
+			 * memory instead of pipes.
+			 * @details
+			 * Each direction uses a SharedMemoryChannel, which
+			 * avoids system calls for Workers that exchange
+			 * many messages. Must be called before the Worker
+			 * is first started with communication enabled.
+			 *
+			 * @param[in] size
+			 *	Bytes of shared memory used in each direction,
+			 *	or 0 to use pipes (the default).
+			 *
+			 * @throw Error::ObjectExists
+			 *	Communication was already initialized.
+			 */
+			void
+			setSharedMemoryChannelSize(
+			    uint64_t size);
+
+			/**
+			 * @brief
+			 * Obtain the size of the shared memory channels.
+			 *
+			 * @return
+			 *	Bytes of shared memory used for messages in
+			 *	each direction, or 0 when pipes are used.
+			 */
+			uint64_t
+			getSharedMemoryChannelSize()
+			    const;
+
 			/**
 			 * @brief
 			 * Perform initialization for communication from
@@ -183,7 +218,8 @@ namespace BiometricEvaluation
 			 * @throw Error::ObjectDoesNotExist
 			 *	Worker exiting soon, communication disabled.
 			 * @throw Error::StrategyError
-			 *	Communications not enabled.
+			 *	Communications not enabled, or messages are
+			 *	sent through shared memory.
 			 */
 			int
 			getSendingPipe() const;
@@ -192,6 +228,11 @@ namespace BiometricEvaluation
 			 * @brief
 			 * Obtain the pipe used to receive messages to
 			 * this Worker.
+			 * @details
+			 * With shared memory channels, this is a descriptor
+			 * that becomes readable when a message is sent.
+			 * Either way, messages are read with
+			 * receiveMessageFromWorker().
 			 *
 			 * @return
 			 *	Receiving pipe.
@@ -204,6 +245,61 @@ namespace BiometricEvaluation
 			int
 			getReceivingPipe() const;
 
+			/**
+			 * @brief
+			 * Send a message to this Worker.
+			 *
+			 * @param[in] message
+			 *	Message to send.
+			 *
+			 * @note
+			 * Behavior is undefined if called by a non-Manager.
+			 *
+			 * @throw Error::ObjectDoesNotExist
+			 *	Worker exiting soon, or widowed pipe.
+			 * @throw Error::StrategyError
+			 *	Communications not enabled.
+			 */
+			void
+			sendMessageToWorker(
+			    const Memory::uint8Array &message);
+
+			/**
+			 * @brief
+			 * Receive a message sent by this Worker.
+			 *
+			 * @param[out] message
+			 *	Buffer to store the received message.
+			 *
+			 * @note
+			 * Behavior is undefined if called by a non-Manager.
+			 *
+			 * @throw Error::ObjectDoesNotExist
+			 *	Widowed pipe.
+			 * @throw Error::StrategyError
+			 *	Communications not enabled.
+			 */
+			void
+			receiveMessageFromWorker(
+			    Memory::uint8Array &message);
+
+			/**
+			 * @brief
+			 * Obtain the number of bytes of messages sent by
+			 * this Worker and not yet received.
+			 *
+			 * @return
+			 *	Bytes waiting, including message lengths.
+			 *
+			 * @note
+			 * Behavior is undefined if called by a non-Manager.
+			 *
+			 * @throw Error::StrategyError
+			 *	Communications not enabled.
+			 */
+			uint64_t
+			getPendingBytesFromWorker();
+
 			/**
 			 * @brief
 			 * Send a message to the Manager.
@@ -304,6 +400,13 @@ namespace BiometricEvaluation
 			int _pipeToChild[2];
 			/** Pipes to receive from self */
 			int _pipeFromChild[2];
+
+			/** Size of shared memory channels; 0 for pipes */
+			uint64_t _sharedMemoryChannelSize;
+			/** Shared memory channel to send to self */
+			std::unique_ptr<SharedMemoryChannel> _channelToChild;
+			/** Shared memory channel to receive from self */
+			std::unique_ptr<SharedMemoryChannel> _channelFromChild;
 		};
 	}
 }
@@ -12,6 +12,7 @@
 #define __BE_PROCESS_WORKERCONTROLLER_H__
 
 #include <memory>
+#include <vector>
 
 #include <be_error_exception.h>
 #include <be_memory_autoarray.h>
@@ -240,6 +241,9 @@ namespace BiometricEvaluation
 			 * @param communicate
 			 *	Whether or not to enable communication
 			 *	between Worker and Manager.
+			 * @param cpus
+			 *	CPUs on which to run the Worker, or empty to
+			 *	let the operating system choose.
 			 *
 			 * @throw Error::ObjectExists
 			 *	The decorated Worker is already working.
@@ -252,7 +256,8 @@ namespace BiometricEvaluation
 			 */
 			virtual void
 			start(
-			    bool communicate = false) = 0;
+			    bool communicate = false,
+			    const std::vector<uint32_t> &cpus = {}) = 0;
 
 			/**
 			 * @brief
@@ -12,6 +12,7 @@
 
 #include <locale>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <be_error_exception.h>
@@ -218,6 +219,32 @@ namespace BiometricEvaluation {
 		    const char delimiter,
 		    bool escape = true);
 
+		/**
+		 * @brief
+		 * Return tokens bound by delimiters and the beginning and end
+		 * of a string, without copying.
+		 * @details
+		 * Tokens are found as by split(), except that an escaped
+		 * delimiter still ends a token.
+		 *
+		 * @param[in] str
+		 *	String to tokenize.
+		 * @param[in] delimiter
+		 *	Character that defines the end of a token.
+		 *
+		 * @return
+		 *	Vector of views of the tokens of str, in order of
+		 *	appearance, valid for as long as str's characters.
+		 *
+		 * @note
+		 * If delimiter does not appear in string, the returned vector
+		 * will still contain one item, str.
+		 */
+		std::vector<std::string_view>
+		tokenize(
+		    std::string_view str,
+		    const char delimiter);
+
 		/**
 		 * @brief
 		 * Extract the filename component of a pathname.
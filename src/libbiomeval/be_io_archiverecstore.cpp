@@ -119,6 +119,36 @@ BiometricEvaluation::IO::ArchiveRecordStore::setCursorAtKey(
 	this->pimpl->setCursorAtKey(key);
 }
 
+void
+BiometricEvaluation::IO::ArchiveRecordStore::enableChecksums()
+{
+	this->pimpl->enableChecksums();
+}
+
+bool
+BiometricEvaluation::IO::ArchiveRecordStore::hasChecksums()
+    const
+{
+	return (this->pimpl->hasChecksums());
+}
+
+uint32_t
+BiometricEvaluation::IO::ArchiveRecordStore::getChecksum(
+    const std::string &key)
+    const
+{
+	return (this->pimpl->getChecksum(key));
+}
+
+std::vector<std::string>
+BiometricEvaluation::IO::ArchiveRecordStore::getKeyRange(
+    const std::string &first,
+    const std::string &last)
+    const
+{
+	return (this->pimpl->getKeyRange(first, last));
+}
+
 unsigned int
 BiometricEvaluation::IO::ArchiveRecordStore::getCount()
     const
@@ -162,9 +192,41 @@ BiometricEvaluation::IO::ArchiveRecordStore::needsVacuum(
 
 void
 BiometricEvaluation::IO::ArchiveRecordStore::vacuum(
-    const std::string &pathname)
+    const std::string &pathname,
+    double deadSpaceRatio)
+{
+	return (IO::ArchiveRecordStore::Impl::vacuum(pathname,
+	    deadSpaceRatio));
+}
+
+std::future<void>
+BiometricEvaluation::IO::ArchiveRecordStore::vacuumAsync(
+    const std::string &pathname,
+    double deadSpaceRatio)
+{
+	return (std::async(std::launch::async, [pathname, deadSpaceRatio]() {
+		IO::ArchiveRecordStore::Impl::vacuum(pathname, deadSpaceRatio);
+	}));
+}
+
+void
+BiometricEvaluation::IO::ArchiveRecordStore::vacuum()
+{
+	this->pimpl->vacuum();
+}
+
+uint64_t
+BiometricEvaluation::IO::ArchiveRecordStore::getDeadSpace()
+    const
+{
+	return (this->pimpl->getDeadSpace());
+}
+
+void
+BiometricEvaluation::IO::ArchiveRecordStore::setVacuumThreshold(
+    double deadSpaceRatio)
 {
-	return (IO::ArchiveRecordStore::Impl::vacuum(pathname));
+	this->pimpl->setVacuumThreshold(deadSpaceRatio);
 }
 
 std::string
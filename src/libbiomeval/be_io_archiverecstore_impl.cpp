@@ -11,13 +11,20 @@
 #include "be_io_archiverecstore_impl.h"
 #include <sys/stat.h>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #include <algorithm>
 #include <cerrno>
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include <be_error.h>
 #include <be_io_utility.h>
@@ -28,12 +35,128 @@
 
 namespace BE = BiometricEvaluation;
 
+/** Suffix of the temporary files written by vacuum() */
+static const std::string VACUUM_SUFFIX{".vacuum"};
+
+#ifndef _WIN32
+/** Size of a single transfer when the kernel cannot copy for us */
+static const uint64_t VACUUM_BUFFER_SIZE{1024 * 1024};
+
+/*
+ * Copy length bytes at inOffset of inFD to outOffset of outFD. On Linux,
+ * copy_file_range(2) is tried first so the data need not pass through
+ * user space; otherwise, or when the file system does not support it,
+ * large buffered reads and writes are used.
+ */
+static void
+copyExtent(
+    int inFD,
+    int outFD,
+    off_t inOffset,
+    off_t outOffset,
+    uint64_t length)
+{
+#if defined Linux
+	while (length > 0) {
+		loff_t in = inOffset, out = outOffset;
+		ssize_t copied = ::copy_file_range(inFD, &in, outFD, &out,
+		    length, 0);
+		if (copied > 0) {
+			inOffset += copied;
+			outOffset += copied;
+			length -= copied;
+			continue;
+		}
+		if (copied == 0)
+			throw BE::Error::StrategyError("Unexpected end of "
+			    "archive");
+		if (errno == EINTR)
+			continue;
+		if ((errno == ENOSYS) || (errno == EXDEV) ||
+		    (errno == EINVAL) || (errno == EOPNOTSUPP))
+			break;
+		throw BE::Error::StrategyError("Could not copy archive "
+		    "data (" + BE::Error::errorStr() + ")");
+	}
+	if (length == 0)
+		return;
+#endif /* Linux */
+
+	std::vector<char> buf(std::min(length, VACUUM_BUFFER_SIZE));
+	while (length > 0) {
+		ssize_t numRead = ::pread(inFD, buf.data(),
+		    std::min<uint64_t>(length, buf.size()), inOffset);
+		if (numRead < 0) {
+			if (errno == EINTR)
+				continue;
+			throw BE::Error::StrategyError("Could not read "
+			    "archive (" + BE::Error::errorStr() + ")");
+		}
+		if (numRead == 0)
+			throw BE::Error::StrategyError("Unexpected end of "
+			    "archive");
+
+		ssize_t written = 0;
+		while (written < numRead) {
+			ssize_t rv = ::pwrite(outFD, buf.data() + written,
+			    numRead - written, outOffset + written);
+			if (rv < 0) {
+				if (errno == EINTR)
+					continue;
+				throw BE::Error::StrategyError("Could not "
+				    "write archive (" + BE::Error::errorStr() +
+				    ")");
+			}
+			written += rv;
+		}
+		inOffset += numRead;
+		outOffset += numRead;
+		length -= numRead;
+	}
+}
+
+/*
+ * Write a string to a new file and force it to disk.
+ */
+static void
+writeAndSync(
+    const std::string &pathname,
+    const std::string &contents)
+{
+	int fd = ::open(pathname.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd < 0)
+		throw BE::Error::StrategyError("Could not create " + pathname +
+		    " (" + BE::Error::errorStr() + ")");
+
+	std::string::size_type written = 0;
+	while (written < contents.size()) {
+		ssize_t rv = ::write(fd, contents.data() + written,
+		    contents.size() - written);
+		if (rv < 0) {
+			if (errno == EINTR)
+				continue;
+			::close(fd);
+			throw BE::Error::StrategyError("Could not write " +
+			    pathname + " (" + BE::Error::errorStr() + ")");
+		}
+		written += rv;
+	}
+	if ((::fsync(fd) != 0) || (::close(fd) != 0))
+		throw BE::Error::StrategyError("Could not sync " + pathname +
+		    " (" + BE::Error::errorStr() + ")");
+}
+#endif /* _WIN32 */
+
 BiometricEvaluation::IO::ArchiveRecordStore::Impl::Impl(
     const std::string &pathname,
     const std::string &description) :
     RecordStore::Impl(pathname, description, RecordStore::Kind::Archive)
 {
 	_dirty = false;
+	_liveBytes = 0;
+	_archiveBytes = 0;
+	_vacuumThreshold = 0.0;
+	_sortedKeysBuilt = false;
 
 	try {
 		this->open_streams();
@@ -48,8 +171,13 @@ BiometricEvaluation::IO::ArchiveRecordStore::Impl::Impl(
     RecordStore::Impl(pathname, mode)
 {
 	_dirty = false;
+	_liveBytes = 0;
+	_archiveBytes = 0;
+	_vacuumThreshold = 0.0;
+	_sortedKeysBuilt = false;
 
 	try {
+		this->recover_vacuum();
 		this->open_streams();
 		read_manifest();
 	} catch (const Error::ConversionError &e) {
@@ -270,6 +398,18 @@ BiometricEvaluation::IO::ArchiveRecordStore::Impl::read_manifest()
 		if (!_dirty && entry.offset == OFFSET_RECORD_REMOVED)
 			_dirty = true;
 	}
+
+	_liveBytes = 0;
+	for (auto it = _entries.cbegin(); it != _entries.cend(); it++)
+		if (it->second.offset != OFFSET_RECORD_REMOVED)
+			_liveBytes += it->second.size;
+	try {
+		_archiveBytes = IO::Utility::getFileSize(
+		    canonicalName(ARCHIVE_FILE_NAME));
+	} catch (const Error::Exception &e) {
+		throw Error::FileError("Could not get size of archive: " +
+		    e.whatString());
+	}
 }
 
 BiometricEvaluation::Memory::uint8Array
@@ -352,6 +492,8 @@ BiometricEvaluation::IO::ArchiveRecordStore::Impl::insert(
 	} catch (const Error::StrategyError &) {
 		throw;	
 	}
+	_liveBytes += size;
+	_archiveBytes += size;
 }
 
 void
@@ -373,6 +515,12 @@ BiometricEvaluation::IO::ArchiveRecordStore::Impl::write_manifest_entry(
 		    "for " + key);
 
 	efficient_insert(_entries, key, entry);
+	if (_sortedKeysBuilt) {
+		if (entry.offset == OFFSET_RECORD_REMOVED)
+			_sortedKeys.erase(key);
+		else
+			_sortedKeys.insert(key);
+	}
 }
 
 void
@@ -392,6 +540,7 @@ BiometricEvaluation::IO::ArchiveRecordStore::Impl::remove(
 	    _entries.find_quick(key);
 	if (entry.get() == nullptr)
 		throw Error::ObjectDoesNotExist(key);
+	const uint64_t size = entry->second.size;
 	entry->second.offset = OFFSET_RECORD_REMOVED;
 	_entries[key] = entry->second;
 	    
@@ -402,6 +551,12 @@ BiometricEvaluation::IO::ArchiveRecordStore::Impl::remove(
 	} catch (const Error::StrategyError &) {
 		throw;
 	}
+	_liveBytes -= size;
+
+	if ((_vacuumThreshold > 0) && (_archiveBytes > 0) &&
+	    ((static_cast<double>(this->getDeadSpace()) / _archiveBytes) >=
+	    _vacuumThreshold))
+		this->vacuum();
 }
 
 void
@@ -526,8 +681,10 @@ BiometricEvaluation::IO::ArchiveRecordStore::Impl::setCursorAtKey(
 	if (lb == _entries.begin()) {
 		this->_cursorPos = lb;
 		this->setCursor(BE_RECSTORE_SEQ_START);
-	} else
+	} else {
 		this->_cursorPos = --lb;
+		this->setCursor(BE_RECSTORE_SEQ_NEXT);
+	}
 }
 
 void
@@ -541,13 +698,24 @@ BiometricEvaluation::IO::ArchiveRecordStore::Impl::efficient_insert(
 
 void
 BiometricEvaluation::IO::ArchiveRecordStore::Impl::vacuum(
-    const std::string &pathname)
+    const std::string &pathname,
+    double deadSpaceRatio)
 {
 	/* See if vacuuming is necessary */
 	std::unique_ptr<IO::ArchiveRecordStore::Impl> oldRS(
 	    new IO::ArchiveRecordStore::Impl(pathname, Mode::ReadOnly));
 	if (!oldRS->needsVacuum())
 		return;
+	if ((deadSpaceRatio > 0) && ((oldRS->_archiveBytes == 0) ||
+	    ((static_cast<double>(oldRS->getDeadSpace()) /
+	    oldRS->_archiveBytes) < deadSpaceRatio)))
+		return;
+
+#ifndef _WIN32
+	oldRS.reset(new IO::ArchiveRecordStore::Impl(pathname,
+	    Mode::ReadWrite));
+	oldRS->vacuum();
+#else
 	std::string description = oldRS->getDescription();
 	oldRS.reset(nullptr);
 
@@ -574,6 +742,204 @@ BiometricEvaluation::IO::ArchiveRecordStore::Impl::vacuum(
 		throw Error::StrategyError("Could not rename temp RS to "
 		    + pathname);
 	}
+#endif /* _WIN32 */
+}
+
+void
+BiometricEvaluation::IO::ArchiveRecordStore::Impl::vacuum()
+{
+	if (getMode() == Mode::ReadOnly)
+		throw Error::StrategyError("RecordStore was opened read-only");
+#ifdef _WIN32
+	throw Error::NotImplemented("ArchiveRecordStore::vacuum()");
+#else
+	if (!_dirty && (this->getDeadSpace() == 0))
+		return;
+
+	/* Buffered writes must reach the archive before it is copied */
+	this->close_streams();
+
+	/*
+	 * Gather the live records and sort them by position so the old
+	 * archive is read front to back. Removed records stay in _entries
+	 * so that an active sequence cursor remains valid.
+	 */
+	struct Extent {
+		ManifestEntry *entry;
+		long offset;
+		long newOffset;
+	};
+	std::vector<Extent> extents;
+	for (auto it = _entries.cbegin(); it != _entries.cend(); it++)
+		if (it->second.offset != OFFSET_RECORD_REMOVED)
+			extents.push_back({&_entries[it->first],
+			    it->second.offset, 0});
+	std::sort(extents.begin(), extents.end(),
+	    [](const Extent &lhs, const Extent &rhs) {
+		return (lhs.offset < rhs.offset);
+	    });
+
+	const std::string archiveName = canonicalName(ARCHIVE_FILE_NAME);
+	const std::string manifestName = canonicalName(MANIFEST_FILE_NAME);
+	const std::string newArchiveName = archiveName + VACUUM_SUFFIX;
+	const std::string newManifestName = manifestName + VACUUM_SUFFIX;
+
+	uint64_t newArchiveBytes = 0;
+	int inFD = -1, outFD = -1;
+	try {
+		inFD = ::open(archiveName.c_str(), O_RDONLY);
+		if (inFD < 0)
+			throw Error::StrategyError("Could not open archive (" +
+			    Error::errorStr() + ")");
+		outFD = ::open(newArchiveName.c_str(),
+		    O_WRONLY | O_CREAT | O_TRUNC, 0666);
+		if (outFD < 0)
+			throw Error::StrategyError("Could not create "
+			    "compacted archive (" + Error::errorStr() + ")");
+
+		/* Records adjacent in the archive are copied as one run */
+		std::vector<Extent>::size_type i = 0;
+		while (i < extents.size()) {
+			const long runOffset = extents[i].offset;
+			uint64_t runLength = 0;
+			for (; (i < extents.size()) && (extents[i].offset ==
+			    static_cast<long>(runOffset + runLength)); i++) {
+				extents[i].newOffset = newArchiveBytes +
+				    runLength;
+				runLength += extents[i].entry->size;
+			}
+			copyExtent(inFD, outFD, runOffset, newArchiveBytes,
+			    runLength);
+			newArchiveBytes += runLength;
+		}
+
+		if (::fsync(outFD) != 0)
+			throw Error::StrategyError("Could not sync compacted "
+			    "archive (" + Error::errorStr() + ")");
+		::close(inFD);
+		inFD = -1;
+		if (::close(outFD) != 0) {
+			outFD = -1;
+			throw Error::StrategyError("Could not close compacted "
+			    "archive (" + Error::errorStr() + ")");
+		}
+		outFD = -1;
+
+		/* Manifest keeps the original record order */
+		for (auto &extent : extents)
+			extent.entry->offset = extent.newOffset;
+		std::ostringstream manifest;
+		for (auto it = _entries.cbegin(); it != _entries.cend(); it++)
+			if (it->second.offset != OFFSET_RECORD_REMOVED)
+				manifest << it->first << " " <<
+				    it->second.size << " " <<
+				    it->second.offset << '\n';
+		writeAndSync(newManifestName, manifest.str());
+
+		/* Renaming the archive commits; see recover_vacuum() */
+		if (std::rename(newArchiveName.c_str(), archiveName.c_str()))
+			throw Error::StrategyError("Could not replace "
+			    "archive (" + Error::errorStr() + ")");
+	} catch (const Error::Exception &) {
+		if (inFD >= 0)
+			::close(inFD);
+		if (outFD >= 0)
+			::close(outFD);
+		for (auto &extent : extents)
+			extent.entry->offset = extent.offset;
+		/*
+		 * A manifest without an archive means a committed vacuum
+		 * to recover_vacuum(), so the manifest must go first.
+		 */
+		std::remove(newManifestName.c_str());
+		std::remove(newArchiveName.c_str());
+		this->open_streams();
+		throw;
+	}
+	_archiveBytes = newArchiveBytes;
+	_dirty = false;
+
+	if (std::rename(newManifestName.c_str(), manifestName.c_str()))
+		throw Error::StrategyError("Could not replace manifest (" +
+		    Error::errorStr() + "); vacuum will complete when "
+		    "RecordStore is next opened");
+	this->open_streams();
+#endif /* _WIN32 */
+}
+
+uint64_t
+BiometricEvaluation::IO::ArchiveRecordStore::Impl::getDeadSpace()
+    const
+{
+	if (_archiveBytes < _liveBytes)
+		return (0);
+	return (_archiveBytes - _liveBytes);
+}
+
+void
+BiometricEvaluation::IO::ArchiveRecordStore::Impl::setVacuumThreshold(
+    double deadSpaceRatio)
+{
+	if ((deadSpaceRatio < 0) || (deadSpaceRatio > 1))
+		throw Error::StrategyError("Dead space ratio must be in "
+		    "[0, 1]");
+	_vacuumThreshold = deadSpaceRatio;
+}
+
+void
+BiometricEvaluation::IO::ArchiveRecordStore::Impl::recover_vacuum()
+{
+	const std::string newArchiveName = canonicalName(ARCHIVE_FILE_NAME) +
+	    VACUUM_SUFFIX;
+	const std::string newManifestName =
+	    canonicalName(MANIFEST_FILE_NAME) + VACUUM_SUFFIX;
+	const bool haveArchive = IO::Utility::fileExists(newArchiveName);
+	const bool haveManifest = IO::Utility::fileExists(newManifestName);
+
+	/* Archive was replaced, so its manifest must be installed */
+	if (haveManifest && !haveArchive) {
+		if (this->getMode() == Mode::ReadOnly)
+			throw Error::StrategyError("Interrupted vacuum must be "
+			    "completed by opening the RecordStore read-write");
+		if (std::rename(newManifestName.c_str(),
+		    canonicalName(MANIFEST_FILE_NAME).c_str()))
+			throw Error::StrategyError("Could not complete "
+			    "interrupted vacuum (" + Error::errorStr() + ")");
+		return;
+	}
+
+	/*
+	 * Otherwise, the old archive and manifest are intact, and the
+	 * leftovers of the interrupted vacuum are ignored when read-only.
+	 */
+	if (this->getMode() == Mode::ReadOnly)
+		return;
+	if (haveArchive && std::remove(newArchiveName.c_str()))
+		throw Error::StrategyError("Could not remove " +
+		    newArchiveName + " (" + Error::errorStr() + ")");
+	if (haveManifest && std::remove(newManifestName.c_str()))
+		throw Error::StrategyError("Could not remove " +
+		    newManifestName + " (" + Error::errorStr() + ")");
+}
+
+std::vector<std::string>
+BiometricEvaluation::IO::ArchiveRecordStore::Impl::getKeyRange(
+    const std::string &first,
+    const std::string &last)
+    const
+{
+	if (!_sortedKeysBuilt) {
+		for (auto it = _entries.cbegin(); it != _entries.cend(); it++)
+			if (it->second.offset != OFFSET_RECORD_REMOVED)
+				_sortedKeys.insert(it->first);
+		_sortedKeysBuilt = true;
+	}
+
+	if (!last.empty() && (last <= first))
+		return {};
+	return (std::vector<std::string>(_sortedKeys.lower_bound(first),
+	    last.empty() ? _sortedKeys.cend() :
+	    _sortedKeys.lower_bound(last)));
 }
 
 void
@@ -609,12 +975,13 @@ BiometricEvaluation::IO::ArchiveRecordStore::Impl::keyExists(
     const ManifestMap::key_type &k)
 {
 	/* O(1) */
-	if (!_dirty)
-		return (_entries.keyExists(k));
 	if (_entries.keyExists(k) == false)
 		return (false);
 	
-	/* Check if key was removed -- O(1) */
+	/*
+	 * Check if key was removed -- O(1). This is needed even when not
+	 * dirty, since vacuum() leaves removed keys in _entries.
+	 */
 	std::shared_ptr<ManifestMap::value_type> entry =
 	    _entries.find_quick(k);
 	return ((entry.get() != nullptr) &&
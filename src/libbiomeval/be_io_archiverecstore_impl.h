@@ -13,7 +13,9 @@
 
 #include <exception>
 #include <fstream>
+#include <set>
 #include <string>
+#include <vector>
 
 #include <be_io_archiverecstore.h>
 #include "be_io_recordstore_impl.h"
@@ -100,6 +102,11 @@ namespace BiometricEvaluation {
 			void setCursorAtKey(
 			    const std::string &key);
 
+			std::vector<std::string>
+			getKeyRange(
+			    const std::string &first,
+			    const std::string &last) const;
+
 			void move(
 			    const std::string &pathname);
 	
@@ -148,7 +155,36 @@ namespace BiometricEvaluation {
 			 * This is an expensive operation.
 			 */
 			static void vacuum(
-			    const std::string &pathname);
+			    const std::string &pathname,
+			    double deadSpaceRatio = 0.0);
+
+			/**
+			 * Compact this store in place.
+			 *
+			 * @throw Error::StrategyError
+			 *	Store is read-only, or an error occurred
+			 *	when using the underlying storage system.
+			 */
+			void vacuum();
+
+			/**
+			 * @return
+			 *	Number of unreferenced bytes in the archive.
+			 */
+			uint64_t getDeadSpace() const;
+
+			/**
+			 * Set the dead space ratio that triggers vacuum()
+			 * from remove().
+			 *
+			 * @param[in] deadSpaceRatio
+			 *	Threshold in (0, 1], or 0 to disable.
+			 *
+			 * @throw Error::StrategyError
+			 *	deadSpaceRatio is out of range.
+			 */
+			void setVacuumThreshold(
+			    double deadSpaceRatio);
 	
 			/**
 			 * Obtain the name of the file storing the data for 
@@ -211,6 +247,39 @@ namespace BiometricEvaluation {
 			 * deleted entry and would benefit from vacuum().
 			 */
 			bool _dirty;
+
+			/** Sum of the sizes of all live records */
+			uint64_t _liveBytes;
+			/** Size of the archive file */
+			uint64_t _archiveBytes;
+			/** Dead space ratio triggering vacuum(), 0 if never */
+			double _vacuumThreshold;
+
+			/**
+			 * Live keys in sorted order, since _entries is kept
+			 * in insertion order.  Built by the first call to
+			 * getKeyRange() and maintained afterward.
+			 */
+			mutable std::set<std::string> _sortedKeys;
+			/** Whether _sortedKeys has been built */
+			mutable bool _sortedKeysBuilt;
+
+			/**
+			 * @brief
+			 * Complete or discard an interrupted vacuum().
+			 * @details
+			 * The rename of the compacted archive is the commit
+			 * point: if the compacted manifest remains without
+			 * a compacted archive it is moved into place,
+			 * otherwise any leftover temporary files are removed.
+			 * Nothing is changed when opened read-only.
+			 *
+			 * @throw Error::StrategyError
+			 *	Temporary files could not be renamed or removed,
+			 *	or the vacuum must be completed and the store
+			 *	was opened read-only.
+			 */
+			void recover_vacuum();
 			
 			/**
 			 * @brief
@@ -135,6 +135,36 @@ BiometricEvaluation::IO::CompressedRecordStore::setCursorAtKey(
 	this->pimpl->setCursorAtKey(key);
 }
 
+void
+BiometricEvaluation::IO::CompressedRecordStore::enableChecksums()
+{
+	this->pimpl->enableChecksums();
+}
+
+bool
+BiometricEvaluation::IO::CompressedRecordStore::hasChecksums()
+    const
+{
+	return (this->pimpl->hasChecksums());
+}
+
+uint32_t
+BiometricEvaluation::IO::CompressedRecordStore::getChecksum(
+    const std::string &key)
+    const
+{
+	return (this->pimpl->getChecksum(key));
+}
+
+std::vector<std::string>
+BiometricEvaluation::IO::CompressedRecordStore::getKeyRange(
+    const std::string &first,
+    const std::string &last)
+    const
+{
+	return (this->pimpl->getKeyRange(first, last));
+}
+
 unsigned int
 BiometricEvaluation::IO::CompressedRecordStore::getCount()
     const
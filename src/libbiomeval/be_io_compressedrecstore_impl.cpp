@@ -228,6 +228,15 @@ BiometricEvaluation::IO::CompressedRecordStore::Impl::setCursorAtKey(
 {
 	_rs->setCursorAtKey(key);
 }
+
+std::vector<std::string>
+BiometricEvaluation::IO::CompressedRecordStore::Impl::getKeyRange(
+    const std::string &first,
+    const std::string &last)
+    const
+{
+	return (_rs->getKeyRange(first, last));
+}
     
 uint64_t
 BiometricEvaluation::IO::CompressedRecordStore::Impl::getSpaceUsed()
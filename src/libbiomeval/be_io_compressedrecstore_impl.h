@@ -141,6 +141,12 @@ namespace BiometricEvaluation
 			setCursorAtKey(
 			    const std::string &key);
 
+			std::vector<std::string>
+			getKeyRange(
+			    const std::string &first,
+			    const std::string &last)
+			    const;
+
 			void
 			move(
 			    const std::string &pathname);
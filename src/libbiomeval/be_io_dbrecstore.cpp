@@ -118,6 +118,36 @@ BiometricEvaluation::IO::DBRecordStore::setCursorAtKey(
 	this->pimpl->setCursorAtKey(key);
 }
 
+void
+BiometricEvaluation::IO::DBRecordStore::enableChecksums()
+{
+	this->pimpl->enableChecksums();
+}
+
+bool
+BiometricEvaluation::IO::DBRecordStore::hasChecksums()
+    const
+{
+	return (this->pimpl->hasChecksums());
+}
+
+uint32_t
+BiometricEvaluation::IO::DBRecordStore::getChecksum(
+    const std::string &key)
+    const
+{
+	return (this->pimpl->getChecksum(key));
+}
+
+std::vector<std::string>
+BiometricEvaluation::IO::DBRecordStore::getKeyRange(
+    const std::string &first,
+    const std::string &last)
+    const
+{
+	return (this->pimpl->getKeyRange(first, last));
+}
+
 unsigned int
 BiometricEvaluation::IO::DBRecordStore::getCount()
     const
@@ -620,6 +620,61 @@ BiometricEvaluation::IO::DBRecordStore::Impl::setCursorAtKey(
 	setCursor(BE_RECSTORE_SEQ_NEXT);
 }
 
+std::vector<std::string>
+BiometricEvaluation::IO::DBRecordStore::Impl::getKeyRange(
+    const std::string &first,
+    const std::string &last)
+    const
+{
+	/*
+	 * Position a cursor of our own, leaving the sequence cursor alone,
+	 * with the BTREE's ordered search, then walk forward.  Only the key
+	 * is read.
+	 */
+	Dbc *dbC{nullptr};
+	try {
+		this->_dbP->cursor(nullptr, &dbC, 0);
+	} catch (const DbException &e) {
+		throw BE::Error::StrategyError("Could not create DB cursor "
+		    "(DB error = " + std::to_string(
+		    e.get_errno()) + " -- " + e.what() + ")");
+	}
+
+	std::vector<std::string> keys;
+	try {
+		std::string start{first};
+		Dbt dbtkey;
+		Dbt dbtdata;
+		dbtkey.set_data((void *)start.data());
+		dbtkey.set_size(start.length());
+		dbtdata.set_dlen(0);
+		dbtdata.set_flags(DB_DBT_PARTIAL);
+		auto rv = dbC->get(&dbtkey, &dbtdata, DB_SET_RANGE);
+		while (rv == 0) {
+			std::string key((const char *)dbtkey.get_data(),
+			    dbtkey.get_size());
+			if (!last.empty() && (key >= last))
+				break;
+			keys.push_back(std::move(key));
+			rv = dbC->get(&dbtkey, &dbtdata, DB_NEXT);
+		}
+		if ((rv != 0) && (rv != DB_NOTFOUND))
+			throw Error::StrategyError("Could not read key range "
+			    "(DB error = " + std::to_string(rv) + ")");
+	} catch (const DbException &e) {
+		dbC->close();
+		throw BE::Error::StrategyError("Could not read key range "
+		    "(DB error = " + std::to_string(
+		    e.get_errno()) + " -- " + e.what() + ")");
+	} catch (const Error::Exception &) {
+		dbC->close();
+		throw;
+	}
+	dbC->close();
+
+	return (keys);
+}
+
 /*
  * Private method implementations.
  */
@@ -108,6 +108,11 @@ namespace BiometricEvaluation {
 			void setCursorAtKey(
 			    const std::string &key);
 
+			std::vector<std::string>
+			getKeyRange(
+			    const std::string &first,
+			    const std::string &last) const;
+
 			void move(
 			    const std::string &pathname);
 
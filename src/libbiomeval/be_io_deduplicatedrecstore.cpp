@@ -0,0 +1,195 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include "be_io_deduplicatedrecstore_impl.h"
+
+namespace BE = BiometricEvaluation;
+
+BiometricEvaluation::IO::DeduplicatedRecordStore::DeduplicatedRecordStore(
+    const std::string &pathname,
+    const std::string &description,
+    const RecordStore::Kind &recordStoreType)
+{
+	/*
+	 * Exceptions float out.
+	 */
+	this->pimpl.reset(new IO::DeduplicatedRecordStore::Impl(
+	    pathname, description, recordStoreType));
+}
+
+BiometricEvaluation::IO::DeduplicatedRecordStore::DeduplicatedRecordStore(
+    const std::string &pathname,
+    IO::Mode mode)
+{
+	/*
+	 * Exceptions float out.
+	 */
+	this->pimpl.reset(new IO::DeduplicatedRecordStore::Impl(
+	    pathname, mode));
+}
+
+BiometricEvaluation::IO::DeduplicatedRecordStore::~DeduplicatedRecordStore()
+{
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::move(
+    const std::string &pathname)
+{
+	this->pimpl->move(pathname);
+}
+
+uint64_t
+BiometricEvaluation::IO::DeduplicatedRecordStore::getLogicalSize()
+    const
+{
+	return (this->pimpl->getLogicalSize());
+}
+
+double
+BiometricEvaluation::IO::DeduplicatedRecordStore::getDeduplicationRatio()
+    const
+{
+	return (this->pimpl->getDeduplicationRatio());
+}
+
+uint64_t
+BiometricEvaluation::IO::DeduplicatedRecordStore::getSpaceUsed()
+    const
+{
+	return (this->pimpl->getSpaceUsed());
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::sync()
+    const
+{
+	this->pimpl->sync();
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::insert(
+    const std::string &key,
+    const void *const data,
+    const uint64_t size)
+{
+	this->pimpl->insert(key, data, size);
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::remove(
+    const std::string &key)
+{
+	this->pimpl->remove(key);
+}
+
+BiometricEvaluation::Memory::uint8Array
+BiometricEvaluation::IO::DeduplicatedRecordStore::read(
+    const std::string &key)
+    const
+{
+	return (this->pimpl->read(key));
+}
+
+uint64_t
+BiometricEvaluation::IO::DeduplicatedRecordStore::length(
+    const std::string &key)
+    const
+{
+	return (this->pimpl->length(key));
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::flush(
+    const std::string &key)
+    const
+{
+	this->pimpl->flush(key);
+}
+
+BiometricEvaluation::IO::RecordStore::Record
+BiometricEvaluation::IO::DeduplicatedRecordStore::sequence(
+    int cursor)
+{
+	return (this->pimpl->sequence(cursor));
+}
+
+std::string
+BiometricEvaluation::IO::DeduplicatedRecordStore::sequenceKey(
+    int cursor)
+{
+	return (this->pimpl->sequenceKey(cursor));
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::setCursorAtKey(
+    const std::string &key)
+{
+	this->pimpl->setCursorAtKey(key);
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::enableChecksums()
+{
+	this->pimpl->enableChecksums();
+}
+
+bool
+BiometricEvaluation::IO::DeduplicatedRecordStore::hasChecksums()
+    const
+{
+	return (this->pimpl->hasChecksums());
+}
+
+uint32_t
+BiometricEvaluation::IO::DeduplicatedRecordStore::getChecksum(
+    const std::string &key)
+    const
+{
+	return (this->pimpl->getChecksum(key));
+}
+
+std::vector<std::string>
+BiometricEvaluation::IO::DeduplicatedRecordStore::getKeyRange(
+    const std::string &first,
+    const std::string &last)
+    const
+{
+	return (this->pimpl->getKeyRange(first, last));
+}
+
+unsigned int
+BiometricEvaluation::IO::DeduplicatedRecordStore::getCount()
+    const
+{
+	return (this->pimpl->getCount());
+}
+
+std::string
+BiometricEvaluation::IO::DeduplicatedRecordStore::getPathname()
+    const
+{
+	return (this->pimpl->getPathname());
+}
+
+std::string
+BiometricEvaluation::IO::DeduplicatedRecordStore::getDescription()
+    const
+{
+	return (this->pimpl->getDescription());
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::changeDescription(
+    const std::string &description)
+{
+	return (this->pimpl->changeDescription(description));
+}
+
@@ -0,0 +1,324 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <cstdlib>
+#include <string>
+
+#include "be_io_deduplicatedrecstore_impl.h"
+#include <be_memory_autoarrayutility.h>
+#include <be_text.h>
+
+namespace BE = BiometricEvaluation;
+
+static const std::string BLOB_STORE{"theBlobStore"};
+static const std::string REFERENCE_STORE{"theReferenceStore"};
+static const std::string REFCOUNT_SUFFIX{"_refcount"};
+/** Message digest used to address data */
+static const std::string DIGEST{"sha256"};
+
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::Impl(
+    const std::string &pathname,
+    const std::string &description,
+    const RecordStore::Kind &recordStoreType) :
+    RecordStore::Impl(pathname, description,
+    RecordStore::Kind::Deduplicated),
+    _sizesKnown(true),
+    _logicalSize(0),
+    _uniqueSize(0)
+{
+	if (recordStoreType == RecordStore::Kind::List ||
+	    recordStoreType == RecordStore::Kind::Deduplicated)
+		throw Error::StrategyError("Invalid internal RecordStore type");
+
+	const std::string blobPath = pathname + '/' + BLOB_STORE;
+	this->_blobs = IO::RecordStore::createRecordStore(blobPath,
+	    description, recordStoreType);
+	this->_refcounts = IO::RecordStore::createRecordStore(
+	    blobPath + REFCOUNT_SUFFIX, description, recordStoreType);
+	this->_refs = IO::RecordStore::createRecordStore(
+	    pathname + '/' + REFERENCE_STORE, description, recordStoreType);
+}
+
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::Impl(
+    const std::string &pathname,
+    IO::Mode mode) :
+    RecordStore::Impl(pathname, mode),
+    _sizesKnown(false),
+    _logicalSize(0),
+    _uniqueSize(0)
+{
+	this->openBackingStores(mode);
+}
+
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::~Impl()
+{
+
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::openBackingStores(
+    IO::Mode mode)
+{
+	const std::string blobPath = this->getPathname() + '/' + BLOB_STORE;
+	this->_blobs = RecordStore::openRecordStore(blobPath, mode);
+	this->_refcounts = RecordStore::openRecordStore(
+	    blobPath + REFCOUNT_SUFFIX, mode);
+	this->_refs = RecordStore::openRecordStore(
+	    this->getPathname() + '/' + REFERENCE_STORE, mode);
+}
+
+uint64_t
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::getReferenceCount(
+    const std::string &digest)
+    const
+{
+	Memory::uint8Array buf;
+	try {
+		buf = _refcounts->read(digest);
+	} catch (const Error::ObjectDoesNotExist&) {
+		return (0);
+	}
+	return (static_cast<uint64_t>(atoll(
+	    Memory::AutoArrayUtility::getString(buf, buf.size()).c_str())));
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::setReferenceCount(
+    const std::string &digest,
+    const uint64_t count)
+{
+	const std::string countStr = std::to_string(count);
+	if (_refcounts->containsKey(digest))
+		_refcounts->replace(digest, countStr.data(), countStr.size());
+	else
+		_refcounts->insert(digest, countStr.data(), countStr.size());
+}
+
+std::string
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::getDigest(
+    const std::string &key)
+    const
+{
+	Memory::uint8Array buf = _refs->read(key);
+	return (Memory::AutoArrayUtility::getString(buf, buf.size()));
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::insert(
+    const std::string &key,
+    const void *const data,
+    const uint64_t size)
+{
+	if (this->getMode() == Mode::ReadOnly)
+		throw Error::StrategyError(RSREADONLYERROR);
+	if (!this->validateKeyString(key))
+		throw Error::StrategyError("Invalid key format");
+	if (_refs->containsKey(key))
+		throw Error::ObjectExists(key);
+
+	/* Store the blob before anything refers to it */
+	const std::string digest = Text::digest(data, size, DIGEST);
+	const uint64_t count = this->getReferenceCount(digest);
+	if (count == 0)
+		_blobs->insert(digest, data, size);
+	this->setReferenceCount(digest, count + 1);
+	_refs->insert(key, digest.data(), digest.size());
+
+	if (_sizesKnown) {
+		_logicalSize += size;
+		if (count == 0)
+			_uniqueSize += size;
+	}
+	RecordStore::Impl::insert(key, data, size);
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::remove(
+    const std::string &key)
+{
+	if (this->getMode() == Mode::ReadOnly)
+		throw Error::StrategyError(RSREADONLYERROR);
+
+	/* Drop the reference before the blob it refers to */
+	const std::string digest = this->getDigest(key);
+	const uint64_t size = _blobs->length(digest);
+	_refs->remove(key);
+	const uint64_t count = this->getReferenceCount(digest);
+	if (count <= 1) {
+		_blobs->remove(digest);
+		_refcounts->remove(digest);
+	} else
+		this->setReferenceCount(digest, count - 1);
+
+	if (_sizesKnown) {
+		_logicalSize -= size;
+		if (count <= 1)
+			_uniqueSize -= size;
+	}
+	RecordStore::Impl::remove(key);
+}
+
+BiometricEvaluation::Memory::uint8Array
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::read(
+    const std::string &key)
+    const
+{
+	return (_blobs->read(this->getDigest(key)));
+}
+
+uint64_t
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::length(
+    const std::string &key)
+    const
+{
+	return (_blobs->length(this->getDigest(key)));
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::flush(
+    const std::string &key)
+    const
+{
+	if (this->getMode() == Mode::ReadOnly)
+		throw Error::StrategyError(RSREADONLYERROR);
+
+	const std::string digest = this->getDigest(key);
+	_blobs->flush(digest);
+	_refcounts->flush(digest);
+	_refs->flush(key);
+}
+
+BiometricEvaluation::IO::RecordStore::Record
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::i_sequence(
+    bool returnData,
+    int cursor)
+{
+	BE::IO::RecordStore::Record record;
+	/* Obtain the next key, but not data, since it is a reference */
+	record.key = _refs->sequenceKey(cursor);
+
+	if (returnData == true)
+		record.data = this->read(record.key);
+	return (record);
+}
+
+BiometricEvaluation::IO::RecordStore::Record
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::sequence(
+    int cursor)
+{
+	return (i_sequence(true, cursor));
+}
+
+std::string
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::sequenceKey(
+    int cursor)
+{
+	BiometricEvaluation::IO::RecordStore::Record record =
+	    i_sequence(false, cursor);
+	return (record.key);
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::setCursorAtKey(
+    const std::string &key)
+{
+	_refs->setCursorAtKey(key);
+}
+
+std::vector<std::string>
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::getKeyRange(
+    const std::string &first,
+    const std::string &last)
+    const
+{
+	return (_refs->getKeyRange(first, last));
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::sync()
+    const
+{
+	if (this->getMode() == Mode::ReadOnly)
+		return;
+
+	_blobs->sync();
+	_refcounts->sync();
+	_refs->sync();
+	RecordStore::Impl::sync();
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::move(
+    const std::string &pathname)
+{
+	if (this->getMode() == Mode::ReadOnly)
+		throw Error::StrategyError(RSREADONLYERROR);
+
+	_blobs.reset();
+	_refcounts.reset();
+	_refs.reset();
+
+	RecordStore::Impl::move(pathname);
+
+	this->openBackingStores(IO::Mode::ReadWrite);
+}
+
+uint64_t
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::getSpaceUsed()
+    const
+{
+	return (_blobs->getSpaceUsed() + _refcounts->getSpaceUsed() +
+	    _refs->getSpaceUsed() + RecordStore::Impl::getSpaceUsed());
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::computeSizes()
+    const
+{
+	uint64_t logicalSize = 0, uniqueSize = 0;
+	int cursor = BE_RECSTORE_SEQ_START;
+	while (true) {
+		std::string digest;
+		try {
+			digest = _refcounts->sequenceKey(cursor);
+		} catch (const Error::ObjectDoesNotExist&) {
+			break;
+		}
+		cursor = BE_RECSTORE_SEQ_NEXT;
+
+		const uint64_t size = _blobs->length(digest);
+		uniqueSize += size;
+		logicalSize += size * this->getReferenceCount(digest);
+	}
+
+	_logicalSize = logicalSize;
+	_uniqueSize = uniqueSize;
+	_sizesKnown = true;
+}
+
+uint64_t
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::getLogicalSize()
+    const
+{
+	if (!_sizesKnown)
+		this->computeSizes();
+	return (_logicalSize);
+}
+
+double
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::getDeduplicationRatio()
+    const
+{
+	if (!_sizesKnown)
+		this->computeSizes();
+	if (_uniqueSize == 0)
+		return (1.0);
+	return (static_cast<double>(_logicalSize) / _uniqueSize);
+}
@@ -0,0 +1,272 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_IO_DEDUPLICATEDRECSTORE_IMPL_H__
+#define __BE_IO_DEDUPLICATEDRECSTORE_IMPL_H__
+
+#include <be_io_deduplicatedrecstore.h>
+#include "be_io_recordstore_impl.h"
+
+namespace BiometricEvaluation
+{
+	namespace IO
+	{
+		/**
+		 * @brief
+		 * Implementation of DeduplicatedRecordStore.
+		 */
+		class DeduplicatedRecordStore::Impl : public RecordStore::Impl
+		{
+		public:
+			/**
+			 * Create a new DeduplicatedRecordStore, read/write
+			 * mode.
+			 *
+			 * @param[in] pathname
+			 * 	The directory where the store is to be created.
+			 * @param[in] description
+			 *	The store's description.
+			 * @param[in] recordStoreType
+			 *	The type of RecordStore subclass the internal
+			 *	RecordStores should be.
+			 *
+			 * @throw Error::ObjectExists
+			 * 	The store already exists.
+			 * @throw Error::StrategyError
+			 * 	An error occurred when accessing the underlying
+			 * 	file system.
+			 */
+			Impl(
+			    const std::string &pathname,
+			    const std::string &description,
+			    const RecordStore::Kind &recordStoreType);
+
+			/**
+			 * Open an existing DeduplicatedRecordStore.
+			 *
+			 * @param[in] pathname
+			 *	The path name of the store.
+			 * @param[in] mode
+			 *	Open mode, read-only or read-write.
+			 *
+			 * @throw Error::ObjectDoesNotExist
+			 *	The store does not exist.
+			 * @throw Error::StrategyError
+			 *	An error occurred when accessing the underlying
+			 *	file system.
+			 */
+			Impl(
+			    const std::string &pathname,
+			    IO::Mode mode = IO::Mode::ReadOnly);
+
+			/*
+			 * Destructor.
+			 */
+			~Impl();
+
+			uint64_t
+			getLogicalSize()
+			    const;
+
+			double
+			getDeduplicationRatio()
+			    const;
+
+			uint64_t
+			getSpaceUsed() const;
+
+			void
+			sync() const;
+
+			void
+			insert(
+			    const std::string &key,
+			    const void *const data,
+			    const uint64_t size);
+
+			void
+			remove(
+			    const std::string &key);
+
+			Memory::uint8Array
+			read(
+			    const std::string &key) const;
+
+			uint64_t
+			length(
+			    const std::string &key) const;
+
+			void
+			flush(
+			    const std::string &key) const;
+
+			RecordStore::Record
+			sequence(
+			    int cursor = BE_RECSTORE_SEQ_NEXT);
+
+			std::string
+			sequenceKey(
+			    int cursor = BE_RECSTORE_SEQ_NEXT);
+
+			void
+			setCursorAtKey(
+			    const std::string &key);
+
+			std::vector<std::string>
+			getKeyRange(
+			    const std::string &first,
+			    const std::string &last)
+			    const;
+
+			void
+			move(
+			    const std::string &pathname);
+
+			/**
+			 * @brief
+			 * Copy constructor (disabled).
+			 * @details
+			 * Disabled because this object could represent a
+			 * file on disk.
+			 *
+			 * @param rhs
+			 *	DeduplicatedRecordStore object to copy.
+			 */
+			Impl(
+			    const DeduplicatedRecordStore &rhs) = delete;
+
+			/**
+			 * @brief
+			 * Assignment operator (disabled).
+			 * @details
+			 * Disabled because this object could represent a
+			 * file on disk.
+			 *
+			 * @param rhs
+			 *	DeduplicatedRecordStore object to assign.
+			 *
+			 * @return
+			 * 	DeduplicatedRecordStore object, now containing
+			 *	the contents of rhs.
+			 */
+			Impl&
+			operator=(
+			    const DeduplicatedRecordStore &rhs) = delete;
+
+		private:
+			/** Unique record data, keyed by digest */
+			std::shared_ptr<IO::RecordStore> _blobs;
+
+			/** Reference count of each digest in _blobs */
+			std::shared_ptr<IO::RecordStore> _refcounts;
+
+			/** Digest of each key's data */
+			std::shared_ptr<IO::RecordStore> _refs;
+
+			/** Whether _logicalSize and _uniqueSize are known */
+			mutable bool _sizesKnown;
+			/** Sum of the length of every record */
+			mutable uint64_t _logicalSize;
+			/** Sum of the length of every blob */
+			mutable uint64_t _uniqueSize;
+
+			/**
+			 * @brief
+			 * Open the internal RecordStores.
+			 *
+			 * @param[in] mode
+			 *	Mode in which to open the internal stores.
+			 */
+			void
+			openBackingStores(
+			    IO::Mode mode);
+
+			/**
+			 * @brief
+			 * Obtain the number of keys referring to a digest.
+			 *
+			 * @param[in] digest
+			 *	Digest of a blob.
+			 *
+			 * @return
+			 *	Number of keys referring to digest, 0 if
+			 *	no blob exists for digest.
+			 */
+			uint64_t
+			getReferenceCount(
+			    const std::string &digest)
+			    const;
+
+			/**
+			 * @brief
+			 * Record the number of keys referring to a digest.
+			 *
+			 * @param[in] digest
+			 *	Digest of a blob that exists.
+			 * @param[in] count
+			 *	Number of keys referring to digest.
+			 */
+			void
+			setReferenceCount(
+			    const std::string &digest,
+			    const uint64_t count);
+
+			/**
+			 * @brief
+			 * Obtain the digest a key refers to.
+			 *
+			 * @param[in] key
+			 *	Key of a record.
+			 *
+			 * @return
+			 *	Digest of key's data.
+			 *
+			 * @throw Error::ObjectDoesNotExist
+			 *	key does not exist.
+			 */
+			std::string
+			getDigest(
+			    const std::string &key)
+			    const;
+
+			/**
+			 * @brief
+			 * Compute _logicalSize and _uniqueSize by examining
+			 * every blob.
+			 */
+			void
+			computeSizes()
+			    const;
+
+			/**
+			 * Internal implementation of sequencing through a
+			 * store, returning the key, and optionally, the
+			 * data.
+			 * @param[in] returnData
+			 * 	Whether to return the data with the key.
+			 * @param[in] cursor
+			 *	The location within the sequence of the
+			 *	key/data pair to return.
+			 * @return
+			 *	The record that is next in sequence.
+			 * @throw Error::ObjectDoesNotExist
+			 *	End of sequencing.
+			 * @throw Error::StrategyError
+			 *	An error occurred when using the underlying
+			 *	storage system.
+			 */
+			RecordStore::Record
+			i_sequence(
+			    bool returnData,
+			    int cursor);
+		};
+	}
+}
+#endif	/* __BE_IO_DEDUPLICATEDRECSTORE_IMPL_H__ */
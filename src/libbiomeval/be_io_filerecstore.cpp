@@ -126,6 +126,36 @@ BiometricEvaluation::IO::FileRecordStore::setCursorAtKey(
 	this->pimpl->setCursorAtKey(key);
 }
 
+void
+BiometricEvaluation::IO::FileRecordStore::enableChecksums()
+{
+	this->pimpl->enableChecksums();
+}
+
+bool
+BiometricEvaluation::IO::FileRecordStore::hasChecksums()
+    const
+{
+	return (this->pimpl->hasChecksums());
+}
+
+uint32_t
+BiometricEvaluation::IO::FileRecordStore::getChecksum(
+    const std::string &key)
+    const
+{
+	return (this->pimpl->getChecksum(key));
+}
+
+std::vector<std::string>
+BiometricEvaluation::IO::FileRecordStore::getKeyRange(
+    const std::string &first,
+    const std::string &last)
+    const
+{
+	return (this->pimpl->getKeyRange(first, last));
+}
+
 unsigned int
 BiometricEvaluation::IO::FileRecordStore::getCount()
     const
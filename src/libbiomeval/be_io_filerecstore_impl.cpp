@@ -30,6 +30,7 @@ BiometricEvaluation::IO::FileRecordStore::Impl::Impl(
     RecordStore::Impl(pathname, description, RecordStore::Kind::File)
 {
 	_cursorPos = 1;
+	_sortedKeysBuilt = false;
 	_theFilesDir = RecordStore::Impl::canonicalName(_fileArea);
 	if (mkdir(_theFilesDir.c_str(), S_IRWXU | S_IRWXG | S_IRWXO) != 0)
 		throw Error::StrategyError("Could not create file area "
@@ -42,6 +43,7 @@ BiometricEvaluation::IO::FileRecordStore::Impl::Impl(
     RecordStore::Impl(pathname, mode)
 {
 	_cursorPos = 1;
+	_sortedKeysBuilt = false;
 	_theFilesDir = RecordStore::Impl::canonicalName(_fileArea);
 }
 
@@ -134,6 +136,8 @@ BiometricEvaluation::IO::FileRecordStore::Impl::insert(
 		throw;
 	}
 	RecordStore::Impl::insert(key, data, size);
+	if (_sortedKeysBuilt)
+		_sortedKeys.insert(key);
 }
 
 void
@@ -153,6 +157,8 @@ BiometricEvaluation::IO::FileRecordStore::Impl::remove(
 		throw Error::StrategyError("Could not remove " + pathname);
 
 	RecordStore::Impl::remove(key);
+	if (_sortedKeysBuilt)
+		_sortedKeys.erase(key);
 }
 
 BiometricEvaluation::Memory::uint8Array
@@ -202,6 +208,7 @@ BiometricEvaluation::IO::FileRecordStore::Impl::replace(
 	} catch (const Error::StrategyError& ) {
 		throw;
 	}
+	this->updateChecksum(key, data, size);
 }
 
 uint64_t
@@ -391,6 +398,8 @@ BiometricEvaluation::IO::FileRecordStore::Impl::setCursorAtKey(
 	/* Exited the loop by exhausting the directory */
 	if (entry == nullptr)
 		throw Error::ObjectDoesNotExist(key);
+	/* Otherwise sequence() would restart at the first record */
+	setCursor(BE_RECSTORE_SEQ_NEXT);
 
 	if (dir != nullptr) {
 		if (closedir(dir)) {
@@ -405,6 +414,69 @@ BiometricEvaluation::IO::FileRecordStore::Impl::setCursorAtKey(
 /* Private method implementations.                                            */
 /******************************************************************************/
 
+/*
+ * Obtains the keys in [first, last) from the sorted key index, building
+ * the index from the store directory on first use.
+ */
+std::vector<std::string>
+BiometricEvaluation::IO::FileRecordStore::Impl::getKeyRange(
+    const std::string &first,
+    const std::string &last)
+    const
+{
+	if (!_sortedKeysBuilt)
+		this->readSortedKeys();
+
+	if (!last.empty() && (last <= first))
+		return {};
+	return (std::vector<std::string>(_sortedKeys.lower_bound(first),
+	    last.empty() ? _sortedKeys.cend() :
+	    _sortedKeys.lower_bound(last)));
+}
+
+void
+BiometricEvaluation::IO::FileRecordStore::Impl::readSortedKeys()
+    const
+{
+	DIR *dir = opendir(_theFilesDir.c_str());
+	if (dir == nullptr)
+		throw Error::StrategyError("Cannot open store directory");
+
+	std::set<std::string> keys;
+	struct dirent *entry;
+	struct stat sb;
+	while ((entry = readdir(dir)) != nullptr) {
+#ifndef _WIN32
+		if (entry->d_ino == 0)
+			continue;
+#endif
+		const std::string cname = _theFilesDir + "/" + entry->d_name;
+		if (stat(cname.c_str(), &sb) != 0) {
+			const std::string errorStr{"Cannot stat store file (" +
+				Error::errorStr() + ")"};
+			if (closedir(dir)) {
+				throw Error::StrategyError("Could not close " +
+				    this->_theFilesDir + " (" +
+				    Error::errorStr() + ") while exiting with "
+				    "error " + errorStr);
+			}
+
+			throw Error::StrategyError{errorStr};
+		}
+		if ((S_IFMT & sb.st_mode) == S_IFDIR)	/* skip '.' and '..' */
+			continue;
+		keys.insert(entry->d_name);
+	}
+
+	if (closedir(dir)) {
+		throw Error::StrategyError("Could not close " + _theFilesDir +
+		    " (" + Error::errorStr() + ")");
+	}
+
+	_sortedKeys = std::move(keys);
+	_sortedKeysBuilt = true;
+}
+
 /*
  * Writes a file, replacing any data that previously existed in the file.
  */
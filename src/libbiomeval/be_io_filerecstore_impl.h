@@ -10,6 +10,10 @@
 #ifndef __BE_FILERECSTORE_IMPL_H__
 #define __BE_FILERECSTORE_IMPL_H__
 
+#include <set>
+#include <string>
+#include <vector>
+
 #include "be_io_recordstore_impl.h"
 #include <be_io_filerecstore.h>
 
@@ -104,6 +108,11 @@ namespace BiometricEvaluation {
 
 			void setCursorAtKey(const std::string &key);
 
+			std::vector<std::string>
+			getKeyRange(
+			    const std::string &first,
+			    const std::string &last) const;
+
 			void move(const std::string &pathname);
 
 			/* Prevent copying of FileRecordStore objects */
@@ -123,6 +132,27 @@ namespace BiometricEvaluation {
 			uint64_t _cursorPos;
 			std::string _theFilesDir;
 
+			/**
+			 * Keys in sorted order, since the directory is not.
+			 * Built by the first call to getKeyRange() and
+			 * maintained afterward.
+			 */
+			mutable std::set<std::string> _sortedKeys;
+			/** Whether _sortedKeys has been built */
+			mutable bool _sortedKeysBuilt;
+
+			/**
+			 * @brief
+			 * Build _sortedKeys from the names of the record
+			 * files.
+			 *
+			 * @throw Error::StrategyError
+			 *	The file area could not be read.
+			 */
+			void
+			readSortedKeys()
+			    const;
+
 			/**
 			 * Internal implementation of sequencing through a
 			 * store, returning the key, and optionally, the
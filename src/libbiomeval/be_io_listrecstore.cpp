@@ -61,6 +61,36 @@ BiometricEvaluation::IO::ListRecordStore::setCursorAtKey(
 	this->pimpl->setCursorAtKey(key);
 }
 
+void
+BiometricEvaluation::IO::ListRecordStore::enableChecksums()
+{
+	this->pimpl->enableChecksums();
+}
+
+bool
+BiometricEvaluation::IO::ListRecordStore::hasChecksums()
+    const
+{
+	return (this->pimpl->hasChecksums());
+}
+
+uint32_t
+BiometricEvaluation::IO::ListRecordStore::getChecksum(
+    const std::string &key)
+    const
+{
+	return (this->pimpl->getChecksum(key));
+}
+
+std::vector<std::string>
+BiometricEvaluation::IO::ListRecordStore::getKeyRange(
+    const std::string &first,
+    const std::string &last)
+    const
+{
+	return (this->pimpl->getKeyRange(first, last));
+}
+
 uint64_t
 BiometricEvaluation::IO::ListRecordStore::getSpaceUsed()
     const
@@ -147,6 +147,34 @@ BiometricEvaluation::IO::ListRecordStore::Impl::setCursorAtKey(
 		    RecordStore::Impl::canonicalName(KEYLISTFILENAME));
 }
 
+std::vector<std::string>
+BiometricEvaluation::IO::ListRecordStore::Impl::getKeyRange(
+    const std::string &first,
+    const std::string &last)
+    const
+{
+	if (!_sortedKeysBuilt) {
+		/* Use a separate stream so the sequence cursor is unchanged */
+		std::ifstream keyList(canonicalName(KEYLISTFILENAME));
+		if (!keyList.is_open())
+			throw Error::StrategyError("Could not open key list "
+			    "file");
+		std::string line;
+		while (std::getline(keyList, line))
+			_sortedKeys.insert(Text::trimWhitespace(line));
+		if (!keyList.eof())
+			throw Error::StrategyError("Could not read " +
+			    canonicalName(KEYLISTFILENAME));
+		_sortedKeysBuilt = true;
+	}
+
+	if (!last.empty() && (last <= first))
+		return {};
+	return (std::vector<std::string>(_sortedKeys.lower_bound(first),
+	    last.empty() ? _sortedKeys.cend() :
+	    _sortedKeys.lower_bound(last)));
+}
+
 uint64_t
 BiometricEvaluation::IO::ListRecordStore::Impl::getSpaceUsed()
     const
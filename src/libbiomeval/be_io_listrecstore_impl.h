@@ -12,6 +12,9 @@
 #define __BE_IO_LISTRECSTORE_IMPL_H__
 
 #include <list>
+#include <set>
+#include <string>
+#include <vector>
 
 #include <be_io_listrecstore.h>
 #include "be_io_recordstore_impl.h"
@@ -53,6 +56,11 @@ namespace BiometricEvaluation
 			void
 			setCursorAtKey(const std::string &key);
 
+			std::vector<std::string>
+			getKeyRange(
+			    const std::string &first,
+			    const std::string &last) const;
+
 			uint64_t
 			getSpaceUsed() const;
 
@@ -84,6 +92,14 @@ namespace BiometricEvaluation
 			 * file keys
 			 */
 			std::shared_ptr<IO::RecordStore> _sourceRecordStore;
+			/**
+			 * KeyList file keys in sorted order.  Built by the
+			 * first call to getKeyRange(); the KeyList file
+			 * cannot change once the store is opened.
+			 */
+			mutable std::set<std::string> _sortedKeys;
+			/** Whether _sortedKeys has been built */
+			mutable bool _sortedKeysBuilt{false};
 			
 			/**
 			 * Internal implementation of sequencing through a
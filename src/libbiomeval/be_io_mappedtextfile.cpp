@@ -0,0 +1,228 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#endif
+
+#include <be_error.h>
+#include <be_error_exception.h>
+#include <be_io_mappedtextfile.h>
+#include <be_io_utility.h>
+
+namespace BE = BiometricEvaluation;
+
+/*
+ * Append the offset following each newline in data, which starts at
+ * base within the file, to lineStarts.
+ */
+template<typename Offset>
+static void
+indexNewlinesSoftware(
+    const char *data,
+    uint64_t size,
+    uint64_t base,
+    std::vector<Offset> &lineStarts)
+{
+	const char *cur = data;
+	const char *end = data + size;
+	while (cur < end) {
+		const void *newline = std::memchr(cur, '\n', end - cur);
+		if (newline == nullptr)
+			break;
+		cur = static_cast<const char *>(newline) + 1;
+		lineStarts.push_back(static_cast<Offset>(base + (cur - data)));
+	}
+}
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BE_MAPPEDTEXTFILE_AVX2 1
+/*
+ * Compare 32 characters at a time against newline, taking the offset of
+ * each match from the comparison mask. memchr() stops at every match,
+ * which is costly when lines are short.
+ */
+template<typename Offset>
+__attribute__((target("avx2")))
+static void
+indexNewlinesAVX2(
+    const char *data,
+    uint64_t size,
+    std::vector<Offset> &lineStarts)
+{
+	const __m256i newline = _mm256_set1_epi8('\n');
+	uint64_t offset = 0;
+	for (; (offset + sizeof(__m256i)) <= size;
+	    offset += sizeof(__m256i)) {
+		const __m256i block = _mm256_loadu_si256(
+		    reinterpret_cast<const __m256i *>(data + offset));
+		uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+		    _mm256_cmpeq_epi8(block, newline)));
+		while (mask != 0) {
+			lineStarts.push_back(static_cast<Offset>(
+			    offset + __builtin_ctz(mask) + 1));
+			mask &= (mask - 1);
+		}
+	}
+	indexNewlinesSoftware(data + offset, size - offset, offset,
+	    lineStarts);
+}
+#endif /* __x86_64__ */
+
+/*
+ * Index the start of each line of data into lineStarts, followed by one
+ * past the newline ending the last line.
+ */
+template<typename Offset>
+static void
+indexLineStarts(
+    const char *data,
+    uint64_t size,
+    std::vector<Offset> &lineStarts)
+{
+	lineStarts.clear();
+	lineStarts.push_back(0);
+	if (size == 0)
+		return;
+
+	/*
+	 * Reserve once, estimating the number of lines from those in
+	 * the first part of the file, so the index is not grown (and
+	 * briefly held twice) repeatedly as it is built.
+	 */
+	static const uint64_t SAMPLESIZE{64 * 1024};
+	const uint64_t sampleSize = std::min(size, SAMPLESIZE);
+	const uint64_t sampleLines = std::count(data, data + sampleSize, '\n');
+	uint64_t numLines = sampleLines + 1;
+	if (sampleSize < size)
+		numLines = static_cast<uint64_t>(1.1 * numLines *
+		    (static_cast<double>(size) / sampleSize));
+	lineStarts.reserve(std::min(numLines, size) + 1);
+
+#ifdef BE_MAPPEDTEXTFILE_AVX2
+	static const bool haveAVX2 = __builtin_cpu_supports("avx2");
+	if (haveAVX2)
+		indexNewlinesAVX2(data, size, lineStarts);
+	else
+#endif
+		indexNewlinesSoftware(data, size, 0, lineStarts);
+
+	/* End a final line without a newline as though it had one */
+	if (data[size - 1] != '\n')
+		lineStarts.push_back(static_cast<Offset>(size + 1));
+}
+
+BiometricEvaluation::IO::MappedTextFile::MappedTextFile(
+    const std::string &pathname,
+    bool populate)
+{
+	if (!IO::Utility::fileExists(pathname))
+		throw Error::ObjectDoesNotExist(pathname);
+
+	const int fd = ::open(pathname.c_str(), O_RDONLY);
+	if (fd == -1)
+		throw Error::FileError("Could not open " + pathname + ": " +
+		    Error::errorStr());
+	struct stat sb;
+	if (::fstat(fd, &sb) != 0) {
+		const std::string err = Error::errorStr();
+		::close(fd);
+		throw Error::FileError("Could not stat " + pathname + ": " +
+		    err);
+	}
+	this->_size = sb.st_size;
+
+	/* An empty file can't be mapped, and has no lines */
+	if (this->_size != 0) {
+		int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+		if (populate)
+			flags |= MAP_POPULATE;
+#endif
+		void *data = ::mmap(nullptr, this->_size, PROT_READ, flags,
+		    fd, 0);
+		if (data == MAP_FAILED) {
+			const std::string err = Error::errorStr();
+			::close(fd);
+			throw Error::FileError("Could not map " + pathname +
+			    ": " + err);
+		}
+		this->_data = static_cast<const char *>(data);
+	}
+	::close(fd);
+
+	this->indexLines();
+}
+
+void
+BiometricEvaluation::IO::MappedTextFile::indexLines()
+{
+	/* One past the end of the file must fit in a short offset */
+	if (this->_size < UINT32_MAX)
+		indexLineStarts(this->_data, this->_size,
+		    this->_shortLineStarts);
+	else
+		indexLineStarts(this->_data, this->_size, this->_lineStarts);
+}
+
+uint64_t
+BiometricEvaluation::IO::MappedTextFile::getLineStart(
+    uint64_t lineNum)
+    const
+{
+	if (this->_lineStarts.empty())
+		return (this->_shortLineStarts[lineNum]);
+	return (this->_lineStarts[lineNum]);
+}
+
+uint64_t
+BiometricEvaluation::IO::MappedTextFile::getNumLines()
+    const
+{
+	if (this->_lineStarts.empty())
+		return (this->_shortLineStarts.size() - 1);
+	return (this->_lineStarts.size() - 1);
+}
+
+std::string_view
+BiometricEvaluation::IO::MappedTextFile::getLine(
+    uint64_t lineNum)
+    const
+{
+	if (lineNum >= this->getNumLines())
+		throw Error::ObjectDoesNotExist("Line " +
+		    std::to_string(lineNum));
+
+	const uint64_t start = this->getLineStart(lineNum);
+	return (std::string_view(this->_data + start,
+	    this->getLineStart(lineNum + 1) - start - 1));
+}
+
+uint64_t
+BiometricEvaluation::IO::MappedTextFile::getSize()
+    const
+{
+	return (this->_size);
+}
+
+BiometricEvaluation::IO::MappedTextFile::~MappedTextFile()
+{
+	if (this->_data != nullptr)
+		::munmap(const_cast<char *>(this->_data), this->_size);
+}
@@ -8,8 +8,13 @@
  * about its quality, reliability, or any other characteristic.
  ******************************************************************************/
 
+#include <algorithm>
+#include <future>
+#include <thread>
+
 #include "be_io_recordstore_impl.h"
 #include <be_io_recordstore.h>
+#include <be_io_utility.h>
 
 namespace BE = BiometricEvaluation;
 
@@ -39,7 +44,9 @@ BE_IO_RecordStore_Kind_EnumToStringMap = {
 	{BiometricEvaluation::IO::RecordStore::Kind::File, "File"},
 	{BiometricEvaluation::IO::RecordStore::Kind::SQLite, "SQLite"},
 	{BiometricEvaluation::IO::RecordStore::Kind::Compressed, "Compressed"},
-	{BiometricEvaluation::IO::RecordStore::Kind::List, "List"}
+	{BiometricEvaluation::IO::RecordStore::Kind::List, "List"},
+	{BiometricEvaluation::IO::RecordStore::Kind::Deduplicated,
+	    "Deduplicated"}
 };
 BE_FRAMEWORK_ENUMERATION_DEFINITIONS(
     BiometricEvaluation::IO::RecordStore::Kind,
@@ -90,6 +97,102 @@ BiometricEvaluation::IO::RecordStore::containsKey(
 	return (true);
 }
 
+std::vector<std::string>
+BiometricEvaluation::IO::RecordStore::verify(
+    uint32_t numThreads)
+    const
+{
+	if (!this->hasChecksums())
+		throw Error::StrategyError("Checksums are not enabled");
+	this->sync();
+
+	/* Keys in storage order, so each range is read sequentially */
+	std::vector<std::string> keys;
+	keys.reserve(this->getCount());
+	{
+		const auto rs = openRecordStore(this->getPathname());
+		while (true) {
+			try {
+				keys.push_back(rs->sequenceKey());
+			} catch (const Error::ObjectDoesNotExist&) {
+				break;
+			}
+		}
+	}
+	if (keys.empty())
+		return {};
+
+	if (numThreads == 0)
+		numThreads = std::max(1U, std::thread::hardware_concurrency());
+	numThreads = static_cast<uint32_t>(std::min<uint64_t>(numThreads,
+	    keys.size()));
+
+	const auto verifyRange = [&](
+	    const std::vector<std::string>::size_type first,
+	    const std::vector<std::string>::size_type last) {
+		std::vector<std::string> corrupt;
+		const auto rs = openRecordStore(this->getPathname());
+		for (auto i = first; i < last; i++) {
+			/* Records without a checksum cannot be judged */
+			uint32_t expected;
+			try {
+				expected = this->getChecksum(keys[i]);
+			} catch (const Error::ObjectDoesNotExist&) {
+				continue;
+			}
+			try {
+				if (IO::Utility::crc32c(rs->read(keys[i])) !=
+				    expected)
+					corrupt.push_back(keys[i]);
+			} catch (const Error::Exception&) {
+				corrupt.push_back(keys[i]);
+			}
+		}
+		return (corrupt);
+	};
+
+	std::vector<std::future<std::vector<std::string>>> ranges;
+	const auto rangeSize = keys.size() / numThreads;
+	const auto remainder = keys.size() % numThreads;
+	std::vector<std::string>::size_type first = 0;
+	for (uint32_t i = 0; i < numThreads; i++) {
+		const auto last = first + rangeSize + (i < remainder ? 1 : 0);
+		ranges.push_back(std::async(std::launch::async, verifyRange,
+		    first, last));
+		first = last;
+	}
+
+	std::vector<std::string> corrupt;
+	for (auto &range : ranges) {
+		const auto rangeCorrupt = range.get();
+		corrupt.insert(corrupt.end(), rangeCorrupt.begin(),
+		    rangeCorrupt.end());
+	}
+	return (corrupt);
+}
+
+std::vector<std::string>
+BiometricEvaluation::IO::RecordStore::getKeysWithPrefix(
+    const std::string &prefix)
+    const
+{
+	/*
+	 * The smallest key greater than every key beginning with prefix
+	 * is prefix with its last byte that can be incremented incremented
+	 * and the bytes after it removed.
+	 */
+	std::string last{prefix};
+	while (!last.empty()) {
+		if (static_cast<unsigned char>(last.back()) != 0xFF) {
+			last.back() = static_cast<char>(
+			    static_cast<unsigned char>(last.back()) + 1);
+			break;
+		}
+		last.pop_back();
+	}
+	return (this->getKeyRange(prefix, last));
+}
+
 bool
 BiometricEvaluation::IO::RecordStore::isRecordStore(
     const std::string &pathname)
@@ -13,6 +13,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <cstdio>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -25,6 +26,7 @@
 #include <be_io_compressedrecstore.h>
 #include <be_io_compressor.h>
 #include <be_io_dbrecstore.h>
+#include <be_io_deduplicatedrecstore.h>
 #include <be_io_filerecstore.h>
 #include <be_io_listrecstore.h>
 #include <be_io_propertiesfile.h>
@@ -45,6 +47,16 @@ const std::string BE::IO::RecordStore::Impl::CONTROLFILENAME(".rscontrol.prop");
 static const std::string DESCRIPTIONPROPERTY("Description");
 static const std::string COUNTPROPERTY("Count");
 static const std::string TYPEPROPERTY("Type");
+static const std::string CHECKSUMPROPERTY("Checksum");
+
+/** Checksum algorithm recorded in CHECKSUMPROPERTY */
+static const std::string CHECKSUMCRC32C("CRC32C");
+/** Name of the file holding record checksums */
+static const std::string CHECKSUMFILENAME(".rschecksums");
+/** Marks a line of the checksum file that removes a record's checksum */
+static const std::string CHECKSUMREMOVED("-");
+/** Lines of the checksum file beyond which it is compacted when opened */
+static const uint64_t CHECKSUMCOMPACTLINES(1024);
 
 /** Error message when trying to change a core property */
 static const std::string COREPROPERTYERROR("Cannot change core properties");
@@ -84,7 +96,8 @@ BiometricEvaluation::IO::RecordStore::Impl::Impl(
     const BE::IO::RecordStore::Kind &kind) :
     _pathname(pathname),
     _cursor(RecordStore::BE_RECSTORE_SEQ_START),
-    _mode(IO::Mode::ReadWrite)
+    _mode(IO::Mode::ReadWrite),
+    _checksumsEnabled(false)
 {
 	if (IO::Utility::fileExists(pathname))
 		throw Error::ObjectExists(pathname + " already exists");
@@ -113,7 +126,8 @@ BiometricEvaluation::IO::RecordStore::Impl::Impl(
     IO::Mode mode) :
     _pathname(pathname),
     _cursor(RecordStore::BE_RECSTORE_SEQ_START),
-    _mode(mode)
+    _mode(mode),
+    _checksumsEnabled(false)
 {
 	if (!IO::Utility::fileExists(pathname))
 		throw Error::ObjectDoesNotExist("Could not find " + pathname);
@@ -127,12 +141,26 @@ BiometricEvaluation::IO::RecordStore::Impl::Impl(
 	} catch (const Error::StrategyError&) {
 		throw;
 	}
+
+	try {
+		if (_props->getProperty(CHECKSUMPROPERTY) != CHECKSUMCRC32C)
+			throw Error::StrategyError("Unsupported checksum "
+			    "algorithm");
+		_checksumsEnabled = true;
+	} catch (const Error::ObjectDoesNotExist&) {}
+	if (_checksumsEnabled)
+		this->readChecksums();
 }
 
 /*
- * Destructor for the abstract class; required empty implementaton.
+ * Destructor for the abstract class. Checksums are written as records
+ * change, so there is nothing left to write here.
  */
-BiometricEvaluation::IO::RecordStore::Impl::~Impl() { }
+BiometricEvaluation::IO::RecordStore::Impl::~Impl()
+{
+	if (_checksumFile != nullptr)
+		std::fclose(_checksumFile);
+}
 
 /******************************************************************************/
 /* Common public methods implementations.                                     */
@@ -152,6 +180,7 @@ BiometricEvaluation::IO::RecordStore::Impl::insert(
     const uint64_t size)
 {
 	_props->setPropertyFromInteger(COUNTPROPERTY, this->getCount() + 1);
+	this->updateChecksum(key, data, size);
 }
 
 void
@@ -159,6 +188,46 @@ BiometricEvaluation::IO::RecordStore::Impl::remove(
     const std::string &key)
 {
 	_props->setPropertyFromInteger(COUNTPROPERTY, this->getCount() - 1);
+	if (_checksumsEnabled && (_checksums.erase(key) != 0))
+		this->appendChecksum(CHECKSUMREMOVED + ' ' + key + '\n');
+}
+
+void
+BiometricEvaluation::IO::RecordStore::Impl::enableChecksums()
+{
+	if (_mode == Mode::ReadOnly)
+		throw Error::StrategyError(RSREADONLYERROR);
+	if (_checksumsEnabled)
+		return;
+	if (this->getCount() != 0)
+		throw Error::StrategyError("Checksums can only be enabled "
+		    "on an empty RecordStore");
+
+	_props->setProperty(CHECKSUMPROPERTY, CHECKSUMCRC32C);
+	_props->sync();
+	_checksumsEnabled = true;
+	this->compactChecksums();
+}
+
+bool
+BiometricEvaluation::IO::RecordStore::Impl::hasChecksums()
+    const
+{
+	return (_checksumsEnabled);
+}
+
+uint32_t
+BiometricEvaluation::IO::RecordStore::Impl::getChecksum(
+    const std::string &key)
+    const
+{
+	if (!_checksumsEnabled)
+		throw Error::StrategyError("Checksums are not enabled");
+
+	const auto it = _checksums.find(key);
+	if (it == _checksums.end())
+		throw Error::ObjectDoesNotExist(key);
+	return (it->second);
 }
 
 int
@@ -226,6 +295,10 @@ BiometricEvaluation::IO::RecordStore::Impl::move(const std::string &pathname)
 	/* Sync the old data first */
 	_props->sync();
 	_props.reset();
+	if (_checksumFile != nullptr) {
+		std::fclose(_checksumFile);
+		_checksumFile = nullptr;
+	}
 
 	/* Rename the directory */
 	if (rename(this->_pathname.c_str(), pathname.c_str()))
@@ -324,6 +397,8 @@ BiometricEvaluation::IO::RecordStore::Impl::openRecordStore(
 		rs = new ArchiveRecordStore(pathname, mode);
 	else if (type == to_string(RecordStore::Kind::Compressed))
 		rs = new CompressedRecordStore(pathname, mode);
+	else if (type == to_string(RecordStore::Kind::Deduplicated))
+		rs = new DeduplicatedRecordStore(pathname, mode);
 	else if (type == to_string(RecordStore::Kind::List)) {
 		if (mode == IO::Mode::ReadWrite)
 			throw Error::StrategyError("ListRecordStores cannot "
@@ -360,6 +435,10 @@ BiometricEvaluation::IO::RecordStore::Impl::createRecordStore(
 		rs = new CompressedRecordStore(pathname, description,
 		    RecordStore::Kind::Default, IO::Compressor::Kind::GZIP);
 		break;
+	case BE::IO::RecordStore::Kind::Deduplicated:
+		rs = new DeduplicatedRecordStore(pathname, description,
+		    RecordStore::Kind::Default);
+		break;
 	case BE::IO::RecordStore::Kind::List:
 		throw Error::StrategyError("ListRecordStores cannot be "
 		    "created with this function");
@@ -404,6 +483,8 @@ BiometricEvaluation::IO::RecordStore::Impl::mergeRecordStores(
 		case BiometricEvaluation::IO::RecordStore::Kind::File:
 			/* FALLTHROUGH */
 		case BiometricEvaluation::IO::RecordStore::Kind::SQLite:
+			/* FALLTHROUGH */
+		case BiometricEvaluation::IO::RecordStore::Kind::Deduplicated:
 			merged_rs = RecordStore::createRecordStore(
 			   mergePathname, description, kind);
 			break;
@@ -477,6 +558,23 @@ BiometricEvaluation::IO::RecordStore::Impl::genKeySegName(
 	return (keyseg.str());
 }
 
+void
+BiometricEvaluation::IO::RecordStore::Impl::updateChecksum(
+    const std::string &key,
+    const void *const data,
+    const uint64_t size)
+{
+	if (!_checksumsEnabled)
+		return;
+
+	const uint32_t checksum = IO::Utility::crc32c(data, size);
+	_checksums[key] = checksum;
+
+	std::ostringstream line;
+	line << std::hex << checksum << ' ' << key << '\n';
+	this->appendChecksum(line.str());
+}
+
 std::shared_ptr<BiometricEvaluation::IO::Properties>
 BiometricEvaluation::IO::RecordStore::Impl::getProperties() const
 {
@@ -540,7 +638,8 @@ BiometricEvaluation::IO::RecordStore::Impl::isKeyCoreProperty(
 	return (
 	    (key == DESCRIPTIONPROPERTY) ||
 	    (key == COUNTPROPERTY) ||
-	    (key == TYPEPROPERTY));
+	    (key == TYPEPROPERTY) ||
+	    (key == CHECKSUMPROPERTY));
 }
 
 void
@@ -571,3 +670,100 @@ BiometricEvaluation::IO::RecordStore::Impl::openControlFile()
 	}
 }
 
+void
+BiometricEvaluation::IO::RecordStore::Impl::readChecksums()
+{
+	_checksums.clear();
+
+	const std::string checksumFile = canonicalName(CHECKSUMFILENAME);
+	if (!IO::Utility::fileExists(checksumFile))
+		return;
+
+	/*
+	 * Each line is the hex checksum, a space, and the key, or
+	 * CHECKSUMREMOVED, a space, and the key. Later lines supersede
+	 * earlier ones.
+	 */
+	std::ifstream file(checksumFile);
+	if (!file)
+		throw Error::StrategyError("Could not open " + checksumFile);
+	uint64_t numLines{0};
+	std::string line;
+	while (std::getline(file, line)) {
+		/* A crash while appending may leave a partial last line */
+		if (file.eof())
+			break;
+		numLines++;
+
+		const std::string::size_type space = line.find(' ');
+		if ((space == std::string::npos) || (space == 0))
+			throw Error::StrategyError("Malformed line in " +
+			    checksumFile);
+		const std::string key = line.substr(space + 1);
+		if (line.compare(0, space, CHECKSUMREMOVED) == 0) {
+			_checksums.erase(key);
+			continue;
+		}
+		try {
+			_checksums[key] = static_cast<uint32_t>(std::stoul(
+			    line.substr(0, space), nullptr, 16));
+		} catch (const std::exception&) {
+			throw Error::StrategyError("Malformed line in " +
+			    checksumFile);
+		}
+	}
+	if (file.bad())
+		throw Error::StrategyError("Could not read " + checksumFile);
+	file.close();
+
+	/* Drop superseded lines so the file does not grow without bound */
+	if ((_mode == Mode::ReadWrite) && (numLines >
+	    (2 * _checksums.size()) + CHECKSUMCOMPACTLINES))
+		this->compactChecksums();
+}
+
+void
+BiometricEvaluation::IO::RecordStore::Impl::appendChecksum(
+    const std::string &line)
+{
+	if (_checksumFile == nullptr) {
+		const std::string checksumFile = canonicalName(
+		    CHECKSUMFILENAME);
+		_checksumFile = std::fopen(checksumFile.c_str(), "a");
+		if (_checksumFile == nullptr)
+			throw Error::StrategyError("Could not open " +
+			    checksumFile + " (" + Error::errorStr() + ")");
+	}
+
+	/* Flushed now, so the line survives the process exiting */
+	if ((std::fputs(line.c_str(), _checksumFile) == EOF) ||
+	    (std::fflush(_checksumFile) != 0))
+		throw Error::StrategyError("Could not write " +
+		    canonicalName(CHECKSUMFILENAME) + " (" +
+		    Error::errorStr() + ")");
+}
+
+void
+BiometricEvaluation::IO::RecordStore::Impl::compactChecksums()
+{
+	const std::string checksumFile = canonicalName(CHECKSUMFILENAME);
+	const std::string tmpFile = checksumFile + ".tmp";
+
+	std::ofstream file(tmpFile, std::ios_base::trunc);
+	if (!file)
+		throw Error::StrategyError("Could not open " + tmpFile);
+	file << std::hex;
+	for (const auto &checksum : _checksums)
+		file << checksum.second << ' ' << checksum.first << '\n';
+	file.close();
+	if (!file)
+		throw Error::StrategyError("Could not write " + tmpFile);
+
+	if (_checksumFile != nullptr) {
+		std::fclose(_checksumFile);
+		_checksumFile = nullptr;
+	}
+	if (std::rename(tmpFile.c_str(), checksumFile.c_str()) != 0)
+		throw Error::StrategyError("Could not rename " + tmpFile +
+		    " (" + Error::errorStr() + ")");
+}
@@ -10,8 +10,10 @@
 #ifndef __BE_IO_RECORDSTORE_IMPL_H__
 #define __BE_IO_RECORDSTORE_IMPL_H__
 
+#include <cstdio>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <be_io_propertiesfile.h>
@@ -145,6 +147,47 @@ namespace BiometricEvaluation {
 			void remove(
 			    const std::string &key);
 
+			/**
+			 * @brief
+			 * Begin maintaining a checksum for every record.
+			 *
+			 * @throw Error::StrategyError
+			 *	The RecordStore is opened read-only or
+			 *	already contains records.
+			 */
+			void
+			enableChecksums();
+
+			/**
+			 * @return
+			 *	true if a checksum is maintained for every
+			 *	record, false otherwise.
+			 */
+			bool
+			hasChecksums()
+			    const;
+
+			/**
+			 * @brief
+			 * Obtain the stored checksum of a record.
+			 *
+			 * @param[in] key
+			 *	The key of the record.
+			 *
+			 * @return
+			 *	CRC-32C of the record's data when it was
+			 *	stored.
+			 *
+			 * @throw Error::ObjectDoesNotExist
+			 *	No checksum is stored for key.
+			 * @throw Error::StrategyError
+			 *	Checksums are not enabled.
+			 */
+			uint32_t
+			getChecksum(
+			    const std::string &key)
+			    const;
+
 			/**
 			 * @brief
 			 * Determine if a location appears to be a RecordStore.
@@ -379,6 +422,27 @@ namespace BiometricEvaluation {
 			std::shared_ptr<IO::Properties>
 			getProperties()
 			    const;
+
+			/**
+			 * @brief
+			 * Record the checksum of a record's new contents.
+			 * @details
+			 * insert() records checksums itself; implementations
+			 * that replace data without calling insert() must
+			 * call this method.
+			 *
+			 * @param[in] key
+			 *	The key of the record.
+			 * @param[in] data
+			 *	The record's data.
+			 * @param[in] size
+			 *	The size of data, in bytes.
+			 */
+			void
+			updateChecksum(
+			    const std::string &key,
+			    const void *const data,
+			    const uint64_t size);
 			
 		private:
 			/** Properties of the RecordStore */
@@ -403,6 +467,50 @@ namespace BiometricEvaluation {
 			 * Mode in which the RecordStore was opened.
 			 */
 			BiometricEvaluation::IO::Mode _mode;
+
+			/*
+			 * CRC-32C of every record's data, when enabled.
+			 */
+			bool _checksumsEnabled;
+			std::unordered_map<std::string, uint32_t> _checksums;
+			/** Checksum file, opened for appending on first use */
+			std::FILE *_checksumFile{nullptr};
+
+			/**
+			 * @brief
+			 * Read the checksum file into _checksums,
+			 * compacting it when mostly superseded lines.
+			 *
+			 * @throw Error::StrategyError
+			 *	The checksum file could not be read.
+			 */
+			void
+			readChecksums();
+
+			/**
+			 * @brief
+			 * Append a line to the checksum file.
+			 *
+			 * @param[in] line
+			 *	Line to append, including its newline.
+			 *
+			 * @throw Error::StrategyError
+			 *	The checksum file could not be written.
+			 */
+			void
+			appendChecksum(
+			    const std::string &line);
+
+			/**
+			 * @brief
+			 * Atomically replace the checksum file with the
+			 * contents of _checksums.
+			 *
+			 * @throw Error::StrategyError
+			 *	The checksum file could not be written.
+			 */
+			void
+			compactChecksums();
 			
 			/**
 			 * @brief
@@ -643,6 +643,64 @@ BiometricEvaluation::IO::SQLiteRecordStore::Impl::setCursorAtKey(
 	_sequenceEnd = false;
 }
 
+std::vector<std::string>
+BiometricEvaluation::IO::SQLiteRecordStore::Impl::getKeyRange(
+    const std::string &first,
+    const std::string &last)
+    const
+{
+	/* The primary key index orders keys with the BINARY collation */
+	sqlite3_stmt *statement = nullptr;
+	std::string sqlCommand = "SELECT " + KEY_COL + " FROM " +
+	    PRIMARY_KV_TABLE + " WHERE " + KEY_COL + " >= $first";
+	if (!last.empty())
+		sqlCommand += " AND " + KEY_COL + " < $last";
+	sqlCommand += " ORDER BY " + KEY_COL;
+
+#ifdef	SQLITE_V2_SUPPORT
+	int32_t rv = sqlite3_prepare_v2(_db, sqlCommand.c_str(),
+	    sqlCommand.length(), &statement, nullptr);
+#else
+	int32_t rv = sqlite3_prepare(_db, sqlCommand.c_str(),
+	    sqlCommand.length(), &statement, nullptr);
+#endif
+	if (rv != SQLITE_OK) {
+		sqlite3_finalize(statement);
+		sqliteError(rv);
+	}
+	if (statement == nullptr)
+		throw Error::StrategyError("SQLite: Could not allocate "
+		    "statement");
+
+	rv = sqlite3_bind_text(statement,
+	    sqlite3_bind_parameter_index(statement, "$first"),
+	    first.data(), first.size(), SQLITE_STATIC);
+	if ((rv == SQLITE_OK) && !last.empty())
+		rv = sqlite3_bind_text(statement,
+		    sqlite3_bind_parameter_index(statement, "$last"),
+		    last.data(), last.size(), SQLITE_STATIC);
+	if (rv != SQLITE_OK) {
+		sqlite3_finalize(statement);
+		sqliteError(rv);
+	}
+
+	std::vector<std::string> keys;
+	while ((rv = sqlite3_step(statement)) == SQLITE_ROW) {
+		const auto key = reinterpret_cast<const char *>(
+		    sqlite3_column_text(statement, 0));
+		keys.emplace_back(key, sqlite3_column_bytes(statement, 0));
+	}
+	if (rv != SQLITE_DONE) {
+		sqlite3_finalize(statement);
+		sqliteError(rv);
+	}
+
+	rv = sqlite3_finalize(statement);
+	if (rv != SQLITE_OK)
+		sqliteError(rv);
+	return (keys);
+}
+
 void
 BiometricEvaluation::IO::SQLiteRecordStore::Impl::cleanup()
 {
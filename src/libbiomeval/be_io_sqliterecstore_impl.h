@@ -69,6 +69,11 @@ namespace BiometricEvaluation
 			void
 			setCursorAtKey(const std::string &key);
 
+			std::vector<std::string>
+			getKeyRange(
+			    const std::string &first,
+			    const std::string &last) const;
+
 			~Impl();
 
 			Impl(const SQLiteRecordStore&) = delete;
@@ -11,6 +11,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <array>
 #include <cerrno>
 #include <cstdint>
 #include <cstdio>
@@ -587,3 +588,77 @@ BiometricEvaluation::IO::Utility::countLines(
 	return (std::count(&textBuffer[0], &textBuffer[textBuffer.size() - 1],
 	    '\n') + 1);
 }
+
+/*
+ * CRC-32C (Castagnoli), reflected polynomial 0x82F63B78.
+ */
+static const uint32_t CRC32C_POLYNOMIAL = 0x82F63B78;
+
+static uint32_t
+crc32cSoftware(
+    const uint8_t *data,
+    uint64_t size,
+    uint32_t crc)
+{
+	static const auto table = []() {
+		std::array<uint32_t, 256> t{};
+		for (uint32_t i = 0; i < 256; i++) {
+			uint32_t c = i;
+			for (int k = 0; k < 8; k++)
+				c = (c & 1) ? ((c >> 1) ^ CRC32C_POLYNOMIAL) :
+				    (c >> 1);
+			t[i] = c;
+		}
+		return (t);
+	}();
+
+	while (size-- > 0)
+		crc = table[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+	return (crc);
+}
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BE_CRC32C_SSE42 1
+__attribute__((target("sse4.2")))
+static uint32_t
+crc32cSSE42(
+    const uint8_t *data,
+    uint64_t size,
+    uint32_t crc)
+{
+	uint64_t crc64 = crc;
+	while (size >= sizeof(uint64_t)) {
+		uint64_t word;
+		std::memcpy(&word, data, sizeof(word));
+		crc64 = __builtin_ia32_crc32di(crc64, word);
+		data += sizeof(word);
+		size -= sizeof(word);
+	}
+	crc = static_cast<uint32_t>(crc64);
+	while (size-- > 0)
+		crc = __builtin_ia32_crc32qi(crc, *data++);
+	return (crc);
+}
+#endif /* __x86_64__ */
+
+uint32_t
+BiometricEvaluation::IO::Utility::crc32c(
+    const void *data,
+    const uint64_t size,
+    const uint32_t crc)
+{
+	const uint8_t *buf = static_cast<const uint8_t *>(data);
+#ifdef BE_CRC32C_SSE42
+	static const bool haveSSE42 = __builtin_cpu_supports("sse4.2");
+	if (haveSSE42)
+		return (~crc32cSSE42(buf, size, ~crc));
+#endif
+	return (~crc32cSoftware(buf, size, ~crc));
+}
+
+uint32_t
+BiometricEvaluation::IO::Utility::crc32c(
+    const BiometricEvaluation::Memory::uint8Array &data)
+{
+	return (crc32c(data, data.size()));
+}
@@ -9,7 +9,6 @@
  */
 
 #include <sys/types.h>
-#include <mpi.h>
 #include <unistd.h>
 
 #include <iostream>
@@ -19,6 +18,7 @@
 #include <be_io_syslogsheet.h>
 #include <be_error_exception.h>
 #include <be_mpi.h>
+#include <be_mpi_transport.h>
 
 namespace BE = BiometricEvaluation;
 
@@ -50,7 +50,10 @@ const std::map<BiometricEvaluation::MPI::MessageTag, std::string>
 BE_MPI_MessageTag_EnumToStringMap  = {
 	{BiometricEvaluation::MPI::MessageTag::Control, "Control"},
 	{BiometricEvaluation::MPI::MessageTag::Data, "Data"},
-	{BiometricEvaluation::MPI::MessageTag::OOB, "Out-of-band"}
+	{BiometricEvaluation::MPI::MessageTag::OOB, "Out-of-band"},
+	{BiometricEvaluation::MPI::MessageTag::Result, "Result"},
+	{BiometricEvaluation::MPI::MessageTag::Completion, "Completion"},
+	{BiometricEvaluation::MPI::MessageTag::Telemetry, "Telemetry"}
 };
 BE_FRAMEWORK_ENUMERATION_DEFINITIONS(
     BiometricEvaluation::MPI::MessageTag,
@@ -59,24 +62,14 @@ BE_FRAMEWORK_ENUMERATION_DEFINITIONS(
 std::string
 BiometricEvaluation::MPI::generateUniqueID()
 {
-	/* Don't call MPI methods if uninitialized */
-	int mpiInitialized{};
-	MPI_Initialized(&mpiInitialized);
-	if (!mpiInitialized)
+	/* No rank before the Runtime is constructed */
+	const auto transport = MPI::getTransport();
+	if (transport == nullptr)
 		return ("NA-NA-" + std::to_string(getpid()));
 
-	char hn[MPI_MAX_PROCESSOR_NAME];
-	int hlen;
-	(void)MPI_Get_processor_name(hn, &hlen);
-	std::string hostname((char *)hn);
 	std::ostringstream oss;
-#if 0
-	oss << hostname << ' ' 
-	    << ::MPI::COMM_WORLD.Get_rank()
-	    << '[' << getpid() << ']';
-#endif
-	oss << hostname << '-' 
-	    << ::MPI::COMM_WORLD.Get_rank()
+	oss << transport->getProcessorName() << '-'
+	    << transport->getRank()
 	    << '-' << getpid();
 	return (oss.str());
 }
@@ -161,11 +154,13 @@ BiometricEvaluation::MPI::openLogsheet(
 		}
 		case BE::IO::Logsheet::Kind::Syslog: {
 			/* Use the MPI rank as the application name */
+			const auto transport = MPI::getTransport();
 			try {
 				logsheet.reset(new BE::IO::SysLogsheet(
 				    url,
 				    description,
-				    std::to_string(::MPI::COMM_WORLD.Get_rank()),
+				    transport == nullptr ? "NA" :
+				    std::to_string(transport->getRank()),
 				    true, true));
 			} catch (const BE::Error::Exception &e) {
 				throw BE::Error::Exception(
@@ -8,6 +8,10 @@
  * about its quality, reliability, or any other characteristic.
  */
 
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
 #include <be_mpi_csvdistributor.h>
 
 namespace BE = BiometricEvaluation;
@@ -46,7 +50,7 @@ static void
 fillBufferWithTokens(
     BE::Memory::uint8Array &buf,
     uint64_t lineNum,
-    const std::string &line,
+    std::string_view line,
     BE::Memory::uint8Array::size_type &index)
 {
 #if 0
@@ -99,24 +103,21 @@ BiometricEvaluation::MPI::CSVDistributor::createWorkPackage(
 	 * If there are no more keys to be read from the record store,
 	 * send an empty work package.
 	 */
-	if (this->_resources->getNumRemainingLines() == 0) {
+	if (this->getNumRemainingElements() == 0) {
 		workPackage.setNumElements(0);
-		workPackage.setData(packageData);
+		workPackage.setData(std::move(packageData));
 		return;
 	}
 
 	/*
 	 * Distribute a work package based on the chunk size given
-	 * in the resources object. If a failure occurs reading a key,
+	 * in the resources object, or adaptively sized by the
+	 * Distributor. If a failure occurs reading a key,
 	 * continue onto the next key. It is possible to send an empty
 	 * work package due to sequential failures.
 	 */
-	uint64_t lineCount;
-	if (this->_resources->getNumRemainingLines() >
-	    this->_resources->getChunkSize())
-		lineCount = this->_resources->getChunkSize();
-	else
-		lineCount = this->_resources->getNumRemainingLines();
+	const uint64_t lineCount = this->getNumRemainingElements();
+	const uint64_t chunkSize = this->_resources->getChunkSize();
 
 	/*
 	 * The value array must be 0-sized to start, and will stay that way
@@ -129,16 +130,35 @@ BiometricEvaluation::MPI::CSVDistributor::createWorkPackage(
 	 * Pull lines from the file and combine a chunk of them into a
 	 * single work package.
 	 */
-	std::pair<uint64_t, std::string> lineData;
-	for (uint64_t n = 0; n < lineCount; n++) {
+	std::pair<uint64_t, std::string_view> lineData;
+	const MPI::RangeSet &completed = this->getCompletedPositions();
+	for (uint64_t n = 0; (n < lineCount) &&
+	    !this->isWorkPackageFull(chunkSize, n, index); n++) {
+		/* Pass over lines completed before a checkpoint restore */
 		try {
-			lineData = this->_resources->readLine();
+			while ((this->_completedAhead > 0) &&
+			    completed.contains(this->_nextPosition)) {
+				this->_resources->skipLines(1);
+				this->_nextPosition++;
+				this->_completedAhead--;
+				this->_distributedLineCount++;
+			}
+		} catch (const BE::Error::Exception &e) {
+			log->writeDebug("Caught " + e.whatString());
+			break;
+		}
+
+		const uint64_t position = this->_nextPosition++;
+		try {
+			lineData = this->_resources->readLineView();
 			fillBufferWithTokens(packageData, lineData.first,
 			    lineData.second, index);
 		} catch (const BE::Error::Exception &e) {
 			log->writeDebug("Caught " + e.whatString());
+			this->addPackagedPositions(position, position);
 			continue;
 		}
+		this->addPackagedPositions(position, position);
 		realLineCount++;
 	}
 
@@ -147,7 +167,16 @@ BiometricEvaluation::MPI::CSVDistributor::createWorkPackage(
 	 */
 	this->_distributedLineCount += realLineCount;
 	workPackage.setNumElements(realLineCount);
-	workPackage.setData(packageData);
+	workPackage.setData(std::move(packageData));
+}
+
+uint64_t
+BiometricEvaluation::MPI::CSVDistributor::getNumRemainingElements()
+    const
+{
+	const uint64_t remainingLines = this->_resources->getNumRemainingLines();
+	return (remainingLines - std::min(this->_completedAhead,
+	    remainingLines));
 }
 
 void
@@ -182,9 +211,10 @@ BiometricEvaluation::MPI::CSVDistributor::checkpointRestore()
 {
 	try {
 		auto chkData = this->getCheckpointData();
-		this->_distributedLineCount =
-		    chkData->getPropertyAsInteger(
-			BE::MPI::CSVDistributor::CHECKPOINTLINECOUNT);
+		if (!this->hasCompletionRecord())
+			this->_distributedLineCount =
+			    chkData->getPropertyAsInteger(
+				BE::MPI::CSVDistributor::CHECKPOINTLINECOUNT);
 
 		/*
 		 * Check the randomizer seed against what has been
@@ -215,13 +245,27 @@ BiometricEvaluation::MPI::CSVDistributor::checkpointRestore()
 		}
 		/*
 		 * Skip over the lines used during the checkpointed run.
+		 * When completed lines were recorded, skip the completed
+		 * prefix; createWorkPackage() passes over the rest.
 		 */
-		for (uint64_t n = 0; n < this->_distributedLineCount; n++) {
-			(void)this->_resources->readLine();
+		const MPI::RangeSet &completed = this->getCompletedPositions();
+		if (this->hasCompletionRecord()) {
+			this->_distributedLineCount =
+			    completed.getFirstMissing();
+			this->_completedAhead = completed.getCount() -
+			    this->_distributedLineCount;
 		}
-		this->getLogsheet()->writeDebug(
-		    "Checkpoint restore: " + chkData->getProperty(
-			BE::MPI::Distributor::CHECKPOINTREASON));
+		this->_resources->skipLines(this->_distributedLineCount);
+		this->_nextPosition = this->_distributedLineCount;
+		if (this->hasCompletionRecord())
+			this->getLogsheet()->writeDebug("Checkpoint restore: " +
+			    std::to_string(completed.getCount()) +
+			    " lines completed, resuming at line " +
+			    std::to_string(this->_nextPosition));
+		else
+			this->getLogsheet()->writeDebug(
+			    "Checkpoint restore: " + chkData->getProperty(
+				BE::MPI::Distributor::CHECKPOINTREASON));
 	} catch (const Error::Exception &e) {
 		this->getLogsheet()->writeDebug(
 		    "Checkpoint restore: Caught " + e.whatString());
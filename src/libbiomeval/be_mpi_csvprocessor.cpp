@@ -33,8 +33,7 @@ BiometricEvaluation::MPI::CSVProcessor::processWorkPackage(
 	/*
 	 * Extract the key/value data from the work package
 	 */
-	 Memory::uint8Array packageData(0);
-	 workPackage.getData(packageData);
+	const Memory::uint8Array &packageData = workPackage.getData();
 	 uint64_t numElements = workPackage.getNumElements();
 
 	/*
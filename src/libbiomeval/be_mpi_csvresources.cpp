@@ -9,11 +9,12 @@
  */
 
 #include <algorithm>
+#include <locale>
+#include <numeric>
 #include <string>
 
 #include <be_io_utility.h>
 #include <be_io_propertiesfile.h>
-#include <be_memory_autoarrayutility.h>
 #include <be_mpi_csvresources.h>
 #include <be_text.h>
 
@@ -70,12 +71,6 @@ BiometricEvaluation::MPI::CSVResources::CSVResources(
 		    BE::MPI::CSVResources::RANDOMIZEPROPERTY);
 	} catch (const BE::Error::Exception&) {}
 	if (this->_randomizeLines) {
-		if (!this->_useBuffer)
-			throw BE::Error::StrategyError("\"" + 
-			    BE::MPI::CSVResources::RANDOMIZEPROPERTY + "\" "
-			    "was enabled, but it requires \"" +
-			    BE::MPI::CSVResources::USEBUFFERPROPERTY + ",\" "
-			    "which was not.");
 		try {
 			this->_rngSeed = props->getPropertyAsInteger(
 			    BE::MPI::CSVResources::RANDOMSEEDPROPERTY);
@@ -87,13 +82,15 @@ BiometricEvaluation::MPI::CSVResources::CSVResources(
 	this->_trimWhitespace = props->getPropertyAsBoolean(
 	    BE::MPI::CSVResources::TRIMPROPERTY);
 
-	this->openCSV();
+	/* The CSV is mapped when first used */
+	if (!BE::IO::Utility::fileExists(this->_csvPath))
+		throw BE::Error::ObjectDoesNotExist("File does not exist: " +
+		    this->_csvPath);
 }
 
 BiometricEvaluation::MPI::CSVResources::~CSVResources()
 {
-	if (!this->_useBuffer && !this->_csvStream)
-		this->_csvStream->close();
+
 }
 
 std::vector<std::string>
@@ -119,57 +116,49 @@ BiometricEvaluation::MPI::CSVResources::getOptionalProperties()
 	return (props);
 }
 
-void
-BiometricEvaluation::MPI::CSVResources::openCSV()
+/*
+ * Remove leading and trailing whitespace from a line, as
+ * Text::trimWhitespace(), without copying.
+ */
+static std::string_view
+trimWhitespace(
+    std::string_view line)
 {
-	/* Check that file exists */
-	if (!BE::IO::Utility::fileExists(this->_csvPath))
-		throw BE::Error::ObjectDoesNotExist("File does not exist: " +
-		    this->_csvPath);
+	/* Constructing a locale is costly, and this is called per line */
+	static const std::locale locale;
+	while (!line.empty() && std::isspace(line.front(), locale))
+		line.remove_prefix(1);
+	while (!line.empty() && std::isspace(line.back(), locale))
+		line.remove_suffix(1);
+	return (line);
+}
 
-	/* Completely read in file, or open a stream */
-	if (this->_useBuffer) {
-		this->_csvBuffer = BE::IO::Utility::readFile(this->_csvPath, 
-		    std::ios_base::in);
-		this->_offset = 0;
-		this->_numLines = BE::IO::Utility::countLines(this->_csvBuffer);
-		
-		/* To randomize, we need to have all lines in memory */
-		if (this->_randomizeLines) {
-			uint64_t bufferSize = this->_csvBuffer.size();
-			uint64_t offset = 0, endOffset = 0;
-		
-			for (uint64_t lineNum = 0; lineNum < this->_numLines;
-			    lineNum++) {
-			    	endOffset = offset;
-				while ((endOffset < bufferSize) &&
-				    (this->_csvBuffer[endOffset] != '\n'))
-					endOffset++;
-				std::string line((char *)&this->_csvBuffer[
-				    offset], endOffset - offset);
-				offset = endOffset + 1;
-				this->_randomizedLines.push_back(std::make_pair(
-				    lineNum + 1, line));
-			}
+const BiometricEvaluation::IO::MappedTextFile &
+BiometricEvaluation::MPI::CSVResources::getCSV()
+    const
+{
+	if (this->_csv)
+		return (*this->_csv);
 
-			std::shuffle(this->_randomizedLines.begin(),
-			    this->_randomizedLines.end(), this->_rng);
-		}
-	} else {
-		this->_numLines = BE::IO::Utility::countLines(this->_csvPath);
-		this->_csvStream = std::make_shared<std::ifstream>(
-		    this->_csvPath);
-		if (!this->_csvStream)
-			throw Error::FileError("Error while opening CSV");
+	this->_csv.reset(new IO::MappedTextFile(this->_csvPath,
+	    this->_useBuffer));
+
+	/* Randomize by shuffling the order lines are read in */
+	if (this->_randomizeLines) {
+		this->_lineOrder.resize(this->_csv->getNumLines());
+		std::iota(this->_lineOrder.begin(), this->_lineOrder.end(), 0);
+		std::shuffle(this->_lineOrder.begin(), this->_lineOrder.end(),
+		    this->_rng);
 	}
-	this->_remainingLines = this->_numLines;
+
+	return (*this->_csv);
 }
 
 uint64_t
 BiometricEvaluation::MPI::CSVResources::getNumLines()
     const
 {
-	return (this->_numLines);
+	return (this->getCSV().getNumLines());
 }
 
 bool
@@ -204,14 +193,14 @@ uint64_t
 BiometricEvaluation::MPI::CSVResources::getNumRemainingLines()
     const
 {
-	return (this->_remainingLines);
+	return (this->getNumLines() - this->_linesRead);
 }
 
 std::mt19937_64::result_type
 BiometricEvaluation::MPI::CSVResources::getRandomSeed()
     const
 {
-	if (!this->_randomizeLines || !this->_useBuffer)
+	if (!this->_randomizeLines)
 		throw BE::Error::StrategyError("Lines not randomized.");
 
 	return (this->_rngSeed);
@@ -220,53 +209,43 @@ BiometricEvaluation::MPI::CSVResources::getRandomSeed()
 std::pair<uint64_t, std::string>
 BiometricEvaluation::MPI::CSVResources::readLine()
 {
-	if (this->_useBuffer) {
-		if (this->_randomizeLines) {
-			this->_remainingLines -= 1;
-			if (this->_trimWhitespace) {
-				const auto ret = this->_randomizedLines[
-				    this->_numLines - this->_remainingLines -
-				    1];
-				return {ret.first, BE::Text::trimWhitespace(
-				    ret.second)};
-			} else
-				return (this->_randomizedLines[this->_numLines -
-				    this->_remainingLines - 1]);
-		} else {
-			uint64_t bufferSize = this->_csvBuffer.size();
-			if (this->_offset >= bufferSize)
-				throw BE::Error::ObjectDoesNotExist(
-				    "Buffer exhausted");
-	
-			uint64_t endOffset = this->_offset;
-			while ((endOffset < bufferSize) &&
-			    (this->_csvBuffer[endOffset] != '\n'))
-				endOffset++;
-	
-			std::string line((char *)&this->_csvBuffer[
-			    this->_offset], endOffset - this->_offset);
-			if (this->_trimWhitespace)
-				line = BE::Text::trimWhitespace(line);
-			this->_offset = endOffset + 1;
-
-			this->_remainingLines -= 1;
-			return (std::make_pair(this->_numLines -
-			    this->_remainingLines, line));
-		}
-	} else {
-		if (!this->_csvStream)
-			throw BE::Error::StrategyError("Stream not open");
+	const auto line = this->readLineView();
+	return (std::make_pair(line.first, std::string(line.second)));
+}
 
-		std::string line;
-		std::getline(*this->_csvStream, line);
-		if (this->_trimWhitespace)
-			line = BE::Text::trimWhitespace(line);
-		if (!this->_csvStream)
-			throw BE::Error::ObjectDoesNotExist("Stream exhausted");
+std::pair<uint64_t, std::string_view>
+BiometricEvaluation::MPI::CSVResources::readLineView()
+{
+	const IO::MappedTextFile &csv = this->getCSV();
+	if (this->_linesRead >= csv.getNumLines())
+		throw BE::Error::ObjectDoesNotExist("CSV exhausted");
+
+	uint64_t index = this->_linesRead;
+	if (this->_randomizeLines)
+		index = this->_lineOrder[index];
+	this->_linesRead++;
+
+	std::string_view line = csv.getLine(index);
+	if (this->_trimWhitespace)
+		line = trimWhitespace(line);
+	return (std::make_pair(index + 1, line));
+}
 
-		this->_remainingLines -= 1;
-		return (std::make_pair(this->_numLines - this->_remainingLines, 
-		    line));
-	}
+void
+BiometricEvaluation::MPI::CSVResources::skipLines(
+    uint64_t count)
+{
+	if (count > this->getNumRemainingLines())
+		throw BE::Error::ObjectDoesNotExist("CSV exhausted");
+	this->_linesRead += count;
 }
 
+std::vector<std::string_view>
+BiometricEvaluation::MPI::CSVResources::tokenizeLine(
+    std::string_view line)
+    const
+{
+	if (this->_delimiter.empty())
+		return {line};
+	return (BE::Text::tokenize(line, this->_delimiter[0]));
+}
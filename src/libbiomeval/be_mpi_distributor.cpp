@@ -8,13 +8,19 @@
  * about its quality, reliability, or any other characteristic.
  */
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <fstream>
 #include <set>
 #include <string>
 #include <sstream>
+#include <vector>
 
-#include <mpi.h>
 #include <unistd.h>
 
+#include <be_error.h>
 #include <be_error_exception.h>
 #include <be_io_filelogsheet.h>
 #include <be_io_propertiesfile.h>
@@ -36,13 +42,26 @@ const std::string
 BiometricEvaluation::MPI::Distributor::CHECKPOINTREASON = "Reason";
 const std::string
 BiometricEvaluation::MPI::Distributor::CHECKPOINTPID = "PID";
+const std::string
+BiometricEvaluation::MPI::Distributor::COMPLETIONFILENAME =
+    "Distributor.done";
+
+/*
+ * Seconds without a message after which tasks are no longer waited on
+ * for their final reports at shutdown.
+ */
+static const int FINALREPORTTIMEOUT{60};
 
 /******************************************************************************/
 /* Class method definitions.                                                  */
 /******************************************************************************/
 BiometricEvaluation::MPI::Distributor::Distributor(
-    const std::string &propertiesFileName)
+    const std::string &propertiesFileName) :
+    _transport{MPI::getTransport()}
 {
+	if (this->_transport == nullptr)
+		throw Error::ObjectDoesNotExist("MPI::Runtime has not been "
+		    "constructed");
 	this->_resources = BE::Memory::make_unique<Resources>(
 	    propertiesFileName);
 
@@ -52,7 +71,7 @@ BiometricEvaluation::MPI::Distributor::Distributor(
 	 * and those processes rank >= 1 contain the Distributor that does
 	 * no work.
 	 */
-	if (::MPI::COMM_WORLD.Get_rank() == 0) {
+	if (this->_transport->getRank() == 0) {
 		this->_logsheet =
 		    BE::MPI::openLogsheet(
 			this->_resources->getLogsheetURL(),
@@ -84,6 +103,20 @@ BiometricEvaluation::MPI::Distributor::Distributor(
 			    BE::MPI::Distributor::CHECKPOINTPID, getpid());
 			this->_checkpointData->sync();
 		}
+
+		if (!this->_resources->getResultRecordStore().empty())
+			this->_resultCollector.reset(new ResultCollector(
+			    this->_resources->getResultRecordStore(),
+			    this->_resources->getResultRecordStoreKind()));
+
+		if (this->_resources->collectsTelemetry() &&
+		    !this->_resources->getTelemetryLogsheetURL().empty()) {
+			this->_telemetryLogsheet = BE::MPI::openLogsheet(
+			    this->_resources->getTelemetryLogsheetURL(),
+			    "MPI::Distributor telemetry");
+			this->_telemetryLogsheet->writeComment(
+			    MPI::Telemetry::getHeader());
+		}
 	}
 }
 
@@ -110,11 +143,30 @@ void
 BiometricEvaluation::MPI::Distributor::start()
 {
 	if (BE::MPI::doCheckpointRestore) {
+		this->loadCompletions();
 		this->checkpointRestore();
 	}
+	if (BE::MPI::checkpointEnable) {
+		try {
+			this->writeCompletions();
+		} catch (const Error::Exception &e) {
+			MPI::logMessage(*this->_logsheet,
+			    "Writing completions: " + e.whatString());
+		}
+
+		/*
+		 * Save now as well, so that what a restore must check,
+		 * such as a CSV's random seed, is recorded even if the
+		 * job ends without an exit signal.
+		 */
+		this->checkpointSave("Started");
+	}
 
 	/* Release other tasks to start up */
-	::MPI::COMM_WORLD.Barrier();
+	this->_transport->barrier();
+	std::vector<int> nodes;
+	if (this->_resources->useNodeLeaders())
+		nodes = this->_transport->getNodes();
 
 	/* Tell each child task to init */
 	BE::IO::Logsheet *log = this->_logsheet.get();
@@ -122,17 +174,17 @@ BiometricEvaluation::MPI::Distributor::start()
 	for (int task{1}; task < this->_resources->getNumTasks(); ++task) {
 		MPI::taskcmd_t taskCmd =
 		    to_int_type(MPI::TaskCommand::Continue);
-		::MPI::COMM_WORLD.Send((void *)&taskCmd, 1, MPI_INT32_T,
-		     task, to_int_type(MPI::MessageTag::Control));
+		this->_transport->sendValue(task, MPI::MessageTag::Control,
+		    taskCmd);
 	}
 	MPI::logMessage(*log, "Finished sending start messages");
 
 	/* Wait for the OK reply from each child, signaling ready for work. */
 	MPI::logMessage(*log, "Waiting for start message responses");
 	for (int task{1}; task < this->_resources->getNumTasks(); ++task) {
-		MPI::taskstat_t taskStatus;
-		::MPI::COMM_WORLD.Recv(&taskStatus, 1, MPI_INT32_T,
-		    task, to_int_type(MPI::MessageTag::Control));
+		const MPI::taskstat_t taskStatus =
+		    this->_transport->receiveValue<MPI::taskstat_t>(task,
+		    MPI::MessageTag::Control);
 
 		MPI::logMessage(*log, "Received start message response from "
 		    "Task-" + std::to_string(task) + "(" +
@@ -141,6 +193,9 @@ BiometricEvaluation::MPI::Distributor::start()
 			this->_activeMpiTasks.insert(task);
 	}
 	MPI::logMessage(*log, "Received all start message responses");
+	if (this->_resources->useNodeLeaders())
+		this->assignNodeLeaders(nodes);
+	this->_telemetry = MPI::Telemetry(0, 0);
 
 	if (this->_activeMpiTasks.empty())
 		MPI::logMessage(*log, "No receiver tasks available");
@@ -150,66 +205,695 @@ BiometricEvaluation::MPI::Distributor::start()
 	this->shutdown();
 }
 
+void
+BiometricEvaluation::MPI::Distributor::assignNodeLeaders(
+    const std::vector<int> &nodes)
+{
+	BE::IO::Logsheet *log = this->_logsheet.get();
+
+	/*
+	 * Tasks of a node are taken in rank order, the first of each
+	 * group of up to the limit leading the group.
+	 */
+	std::map<int, std::vector<int>> nodeTasks;
+	for (const auto task : this->_activeMpiTasks)
+		nodeTasks[nodes.at(task)].push_back(task);
+	const uint32_t limit = this->_resources->getTasksPerNodeLeader();
+	std::set<int> leaders;
+	for (const auto &node : nodeTasks) {
+		int leader{0};
+		for (std::size_t i = 0; i < node.second.size(); i++) {
+			const int task = node.second[i];
+			if ((limit == 0) ? (i == 0) : (i % limit == 0)) {
+				leader = task;
+				leaders.insert(leader);
+				this->_nodeLeaders[leader];
+			} else {
+				this->_nodeLeaders[leader].push_back(task);
+			}
+			this->_transport->sendValue(task,
+			    MPI::MessageTag::Control,
+			    static_cast<int32_t>(leader));
+		}
+	}
+
+	/* Leaders learn the tasks they serve, which now ask them for work */
+	for (const auto &group : this->_nodeLeaders) {
+		const std::vector<int32_t> members(group.second.begin(),
+		    group.second.end());
+		this->_transport->send(group.first, MPI::MessageTag::Control,
+		    members.data(), members.size() * sizeof(int32_t));
+		*log << "Task-" << group.first << " leads " <<
+		    group.second.size() << " other task(s)";
+		MPI::logEntry(*log);
+	}
+	this->_activeMpiTasks = leaders;
+}
+
+uint64_t
+BiometricEvaluation::MPI::Distributor::getNumServedTasks(
+    int MPITask) const
+{
+	const auto it = this->_nodeLeaders.find(MPITask);
+	if (it == this->_nodeLeaders.end())
+		return (1);
+	return (it->second.size() + 1);
+}
+
+void
+BiometricEvaluation::MPI::Distributor::sendWorkPackages(
+    const std::vector<MPI::WorkPackage *> &workPackages,
+    int MPITask)
+{
+	if (this->_nodeLeaders.count(MPITask) == 0) {
+		for (const auto workPackage : workPackages)
+			this->sendWorkPackage(*workPackage, MPITask);
+		return;
+	}
+
+	/*
+	 * A node leader is sent its packages as one, each package
+	 * preceded by its number of elements, ID, and size; the number
+	 * of packages follows in place of the number of elements.
+	 */
+	uint64_t size{0};
+	uint64_t numElements{0};
+	for (const auto workPackage : workPackages) {
+		size += (3 * sizeof(uint64_t)) + workPackage->getSize();
+		numElements += workPackage->getNumElements();
+	}
+	BE::Memory::uint8Array data(size);
+	uint8_t *cur = data;
+	for (const auto workPackage : workPackages) {
+		const uint64_t frame[3]{workPackage->getNumElements(),
+		    workPackage->getID(), workPackage->getSize()};
+		std::memcpy(cur, frame, sizeof(frame));
+		cur += sizeof(frame);
+		for (const auto &segment : workPackage->getSegments()) {
+			if (segment.size() == 0)
+				continue;
+			std::memcpy(cur, segment, segment.size());
+			cur += segment.size();
+		}
+	}
+	this->_transport->send(MPITask, BE::MPI::MessageTag::Data, data,
+	    size);
+
+	const uint64_t header[2]{workPackages.size(), 0};
+	this->_transport->send(MPITask, BE::MPI::MessageTag::Data, header,
+	    sizeof(header));
+	for (const auto workPackage : workPackages)
+		this->_telemetry.countPackage(workPackage->getNumElements(),
+		    workPackage->getSize());
+
+	BE::IO::Logsheet *log = this->_logsheet.get();
+	*log << "Sent " << workPackages.size() << " packages of size " <<
+	    size << " (" << numElements << " elements) to Task-" << MPITask;
+	MPI::logEntry(*log);
+}
+
 void
 BiometricEvaluation::MPI::Distributor::sendWorkPackage(
     BE::MPI::WorkPackage &workPackage, int MPITask)
 {
+	if (this->_nodeLeaders.count(MPITask) != 0) {
+		this->sendWorkPackages({&workPackage}, MPITask);
+		return;
+	}
+
 	/*
 	 * Send three pieces of information:
 	 * The raw data and length, in the first message;
-	 * The number of elements in the second message.
+	 * The number of elements and the package ID in the second message.
+	 *
+	 * Data gathered from several segments is sent as one message
+	 * without first being copied together where the transport
+	 * allows; the receiver sees the same contiguous bytes.
 	 */
-	BE::Memory::uint8Array data(0);
-	workPackage.getData(data);
-	int size = static_cast<int>(data.size());
-	::MPI::COMM_WORLD.Send(
-	    (void *)data, size, MPI_CHAR, MPITask,
-	    to_int_type(BE::MPI::MessageTag::Data));
-
-	uint64_t numElements = workPackage.getNumElements();
-	::MPI::COMM_WORLD.Send(
-	    (void *)&numElements, 1, MPI_UINT64_T,
-	    MPITask, to_int_type(BE::MPI::MessageTag::Data));
+	const uint64_t size = workPackage.getSize();
+	const auto &segments = workPackage.getSegments();
+	if (segments.size() <= 1) {
+		const auto &data = workPackage.getData();
+		this->_transport->send(MPITask, BE::MPI::MessageTag::Data,
+		    data, size);
+	} else {
+		this->_transport->send(MPITask, BE::MPI::MessageTag::Data,
+		    segments);
+	}
+
+	const uint64_t numElements = workPackage.getNumElements();
+	const uint64_t header[2]{numElements, workPackage.getID()};
+	this->_transport->send(MPITask, BE::MPI::MessageTag::Data, header,
+	    sizeof(header));
+	this->_telemetry.countPackage(numElements, size);
 
 	BE::IO::Logsheet *log = this->_logsheet.get();
 	std::ostringstream sstr;
-	sstr << "Sent package of size " << size << " to Task-" << MPITask;
+	sstr << "Sent package of size " << size << " (" << numElements <<
+	    " elements) to Task-" << MPITask;
 	MPI::logMessage(*log, sstr.str());
 }
 
+bool
+BiometricEvaluation::MPI::Distributor::resendWorkPackage(
+    int MPITask,
+    bool speculate)
+{
+	/*
+	 * Prefer a package no task is left to process, then the
+	 * oldest late package, then, when speculating, the oldest
+	 * package that was sent only once.
+	 */
+	const auto now = std::chrono::steady_clock::now();
+	const double timeout = this->_resources->getWorkPackageTimeout();
+	std::map<uint64_t, OutstandingPackage>::iterator orphaned, late,
+	    speculative;
+	orphaned = late = speculative = this->_outstandingPackages.end();
+	/* A node leader's packages may be with any task it serves */
+	const auto ended = [this](int task) -> bool {
+		if (this->_completionsEnded.count(task) == 0)
+			return (false);
+		const auto it = this->_nodeLeaders.find(task);
+		return ((it == this->_nodeLeaders.end()) ||
+		    std::all_of(it->second.begin(), it->second.end(),
+		    [this](int t) {
+		    return (this->_completionsEnded.count(t) != 0); }));
+	};
+	for (auto it = this->_outstandingPackages.begin();
+	    it != this->_outstandingPackages.end(); ++it) {
+		const auto &tasks = it->second.tasks;
+		if (tasks.empty() || (tasks.count(MPITask) != 0))
+			continue;
+		if (std::all_of(tasks.begin(), tasks.end(), ended)) {
+			orphaned = it;
+			break;
+		}
+		if ((timeout > 0) &&
+		    (late == this->_outstandingPackages.end()) &&
+		    (std::chrono::duration<double>(now -
+		    it->second.sent).count() >= timeout))
+			late = it;
+		if (speculate && this->_resources->useSpeculativePackages() &&
+		    (speculative == this->_outstandingPackages.end()) &&
+		    (tasks.size() == 1))
+			speculative = it;
+	}
+
+	std::string reason;
+	auto it = orphaned;
+	if (orphaned != this->_outstandingPackages.end()) {
+		reason = "orphaned";
+	} else if (late != this->_outstandingPackages.end()) {
+		it = late;
+		reason = "late";
+	} else if (speculative != this->_outstandingPackages.end()) {
+		it = speculative;
+		reason = "speculative";
+	} else {
+		return (false);
+	}
+
+	const MPI::taskcmd_t taskCmd = to_int_type(MPI::TaskCommand::Continue);
+	this->_transport->sendValue(MPITask, MPI::MessageTag::Control,
+	    taskCmd);
+	this->sendWorkPackage(it->second.workPackage, MPITask);
+	it->second.tasks.insert(MPITask);
+	it->second.sent = now;
+	this->_numResent++;
+
+	BE::IO::Logsheet *log = this->_logsheet.get();
+	*log << "Sent work package " << it->first << " again (" << reason <<
+	    ") to Task-" << MPITask;
+	MPI::logEntry(*log);
+	return (true);
+}
+
+bool
+BiometricEvaluation::MPI::Distributor::collectResults(
+    int timeout)
+{
+	BE::IO::Logsheet *log = this->_logsheet.get();
+
+	int task;
+	uint64_t size;
+	bool received{false};
+	while (this->_transport->probe(Transport::ANYSOURCE,
+	    MPI::MessageTag::Result, timeout, task, size)) {
+		received = true;
+		BE::Memory::uint8Array batch(size);
+		(void)this->_transport->receive(task, MPI::MessageTag::Result,
+		    batch, size);
+		if (size == 0) {
+			this->_resultsEnded.insert(task);
+			*log << "Received last results from Task-" << task;
+			MPI::logEntry(*log);
+		} else {
+			this->_resultCollector->add(task, std::move(batch));
+		}
+		timeout = 0;
+	}
+
+	/*
+	 * Acknowledge finished batches, in order, so tasks may send more.
+	 * The work that produced a batch not written is not reported
+	 * complete, and is redone when the job is restored, so the job
+	 * is ended rather than going on losing results.
+	 */
+	for (const auto &batch : this->_resultCollector->takeFinished()) {
+		const MPI::TaskStatus status = (batch.second ?
+		    MPI::TaskStatus::OK : MPI::TaskStatus::Failed);
+		this->_transport->sendValue(batch.first,
+		    MPI::MessageTag::Result, to_int_type(status));
+		if (batch.second || BE::MPI::QuickExit || BE::MPI::TermExit)
+			continue;
+		*log << "Results from Task-" << batch.first << " could not "
+		    "be written; ending the job";
+		MPI::logEntry(*log);
+		BE::MPI::QuickExit = true;
+	}
+	return (received);
+}
+
 void
-BiometricEvaluation::MPI::Distributor::distributeWork()
+BiometricEvaluation::MPI::Distributor::waitForFinalReports(
+    const std::string &description,
+    const std::function<bool(int)> &ended,
+    const std::function<bool()> &collect)
 {
-	MPI::WorkPackage workPackage;
-	int numTasks = this->_activeMpiTasks.size();
-	auto taskStatus = BE::Memory::make_unique<MPI::taskstat_t[]>(numTasks);
-	auto indices = BE::Memory::make_unique<int[]>(numTasks);
-	auto MPIstatus = BE::Memory::make_unique<::MPI::Status[]>(numTasks);
-	auto requests = BE::Memory::make_unique<::MPI::Request[]>(numTasks);
-	int numRequests;
 	BE::IO::Logsheet *log = this->_logsheet.get();
+	MPI::logMessage(*log, "Waiting for " + description);
 
 	/*
- 	 * Perform a non-blocking receive from all child tasks.
- 	 * This loop creates the initial set of receive requests,
- 	 * and in the loop below those requests are reposted for
- 	 * each Task that is sent a message.
- 	 */
-	int t = 0;
-	for (const auto &task : this->_activeMpiTasks) {
-		requests[t] = ::MPI::COMM_WORLD.Irecv(
-		    &taskStatus[t], 1, MPI_INT32_T, task,
-		    to_int_type(MPI::MessageTag::Control));
-		t++;
+	 * A task that failed may never report, so stop waiting once
+	 * nothing has arrived for a while.
+	 */
+	auto lastReceived = std::chrono::steady_clock::now();
+	while (true) {
+		std::vector<int> missing;
+		for (int task{1}; task < this->_resources->getNumTasks();
+		    task++)
+			if (!ended(task))
+				missing.push_back(task);
+		if (missing.empty())
+			return;
+
+		if (collect()) {
+			lastReceived = std::chrono::steady_clock::now();
+			continue;
+		}
+		if (std::chrono::steady_clock::now() - lastReceived <
+		    std::chrono::seconds(FINALREPORTTIMEOUT))
+			continue;
+
+		*log << "Stopped waiting for " << description << " after " <<
+		    FINALREPORTTIMEOUT << " s; none from";
+		for (const auto task : missing)
+			*log << " Task-" << task;
+		MPI::logEntry(*log);
+		return;
+	}
+}
+
+void
+BiometricEvaluation::MPI::Distributor::addPackagedPositions(
+    uint64_t first,
+    uint64_t last,
+    const std::string &label)
+{
+	/* Consecutive positions extend the previous range */
+	if (!this->_packagePositions.empty() &&
+	    (this->_packagePositions.back().first.second + 1 == first)) {
+		this->_packagePositions.back().first.second = last;
+		this->_packagePositions.back().second = label;
+		return;
+	}
+	this->_packagePositions.emplace_back(
+	    MPI::RangeSet::Range{first, last}, label);
+}
+
+const BiometricEvaluation::MPI::RangeSet &
+BiometricEvaluation::MPI::Distributor::getCompletedPositions() const
+{
+	return (this->_completedPositions);
+}
+
+bool
+BiometricEvaluation::MPI::Distributor::hasCompletionRecord() const
+{
+	return (this->_hasCompletionRecord);
+}
+
+std::string
+BiometricEvaluation::MPI::Distributor::getCompletedLabel(
+    uint64_t position)
+    const
+{
+	const auto it = this->_completedLabels.find(position);
+	if (it == this->_completedLabels.end())
+		return ("");
+	return (it->second);
+}
+
+bool
+BiometricEvaluation::MPI::Distributor::collectCompletions(
+    int timeout)
+{
+	BE::IO::Logsheet *log = this->_logsheet.get();
+
+	bool received{false};
+	int task;
+	uint64_t size;
+	while (this->_transport->probe(Transport::ANYSOURCE,
+	    MPI::MessageTag::Completion, timeout, task, size)) {
+		std::vector<uint64_t> ids(size / sizeof(uint64_t));
+		(void)this->_transport->receive(task,
+		    MPI::MessageTag::Completion, ids.data(), size);
+		timeout = 0;
+		received = true;
+		if (ids.empty()) {
+			this->_completionsEnded.insert(task);
+			*log << "Received last completions from Task-" << task;
+			MPI::logEntry(*log);
+			continue;
+		}
+
+		/* A package sent more than once is completed once */
+		for (const auto id : ids) {
+			const auto it = this->_outstandingPackages.find(id);
+			if (it == this->_outstandingPackages.end())
+				continue;
+			this->recordCompletion(it->second.requester,
+			    it->second.numElements);
+			if (BE::MPI::checkpointEnable)
+				this->completePositions(it->second.positions);
+			this->_outstandingPackages.erase(it);
+		}
+	}
+	return (received);
+}
+
+/*
+ * Write a telemetry sample to the telemetry Logsheet, or when there is
+ * none, as a comment in the log.
+ */
+static void
+writeTelemetry(
+    BiometricEvaluation::IO::Logsheet *telemetryLogsheet,
+    BiometricEvaluation::IO::Logsheet &logsheet,
+    const std::string &type,
+    const BiometricEvaluation::MPI::Telemetry::Sample &sample)
+{
+	const std::string row = BE::MPI::Telemetry::toString(type, sample);
+	try {
+		if (telemetryLogsheet != nullptr) {
+			*telemetryLogsheet << row;
+			telemetryLogsheet->newEntry();
+		} else {
+			logsheet.writeComment("Telemetry " + row);
+		}
+	} catch (const BE::Error::Exception &) {}
+}
+
+bool
+BiometricEvaluation::MPI::Distributor::collectTelemetry(
+    int timeout)
+{
+	IO::Logsheet *telemetryLog = this->_telemetryLogsheet.get();
+
+	bool received{false};
+	int task;
+	uint64_t size;
+	while (this->_transport->probe(Transport::ANYSOURCE,
+	    MPI::MessageTag::Telemetry, timeout, task, size)) {
+		MPI::Telemetry::Sample sample;
+		(void)this->_transport->receive(task,
+		    MPI::MessageTag::Telemetry, &sample, sizeof(sample));
+		timeout = 0;
+		received = true;
+		if (sample.final) {
+			this->_finalSamples[task] = sample;
+			continue;
+		}
+		writeTelemetry(telemetryLog, *this->_logsheet, "Sample",
+		    sample);
+	}
+
+	if (this->_telemetry.sampleDue(
+	    this->_resources->getTelemetryInterval())) {
+		this->_telemetry.setQueueDepths(
+		    this->_outstandingPackages.size(),
+		    this->_idleTasks.size());
+		writeTelemetry(telemetryLog, *this->_logsheet, "Sample",
+		    this->_telemetry.getSample());
+	}
+	return (received);
+}
+
+void
+BiometricEvaluation::MPI::Distributor::summarizeTelemetry()
+{
+	IO::Logsheet *log = this->_logsheet.get();
+	IO::Logsheet *telemetryLog = this->_telemetryLogsheet.get();
+
+	this->_telemetry.setQueueDepths(this->_outstandingPackages.size(),
+	    this->_idleTasks.size());
+	const auto sample = this->_telemetry.getSample(true);
+	writeTelemetry(telemetryLog, *log, "Final", sample);
+
+	/*
+	 * The total sums the counters of the other tasks, except that
+	 * elapsed time is the longest, and blocked time the mean, so
+	 * the rates and fractions derived from them hold for the job.
+	 */
+	MPI::Telemetry::Sample total;
+	total.rank = -1;
+	total.final = 1;
+	for (const auto &final : this->_finalSamples) {
+		writeTelemetry(telemetryLog, *log, "Final", final.second);
+		total.numWorkers += final.second.numWorkers;
+		total.elapsed = std::max(total.elapsed, final.second.elapsed);
+		total.packages += final.second.packages;
+		total.elements += final.second.elements;
+		total.bytes += final.second.bytes;
+		total.packagesProcessed += final.second.packagesProcessed;
+		total.blocked += final.second.blocked;
+		total.busy += final.second.busy;
 	}
+	if (!this->_finalSamples.empty())
+		total.blocked /= this->_finalSamples.size();
+	writeTelemetry(telemetryLog, *log, "Total", total);
+
+	const double workerTime = total.elapsed * total.numWorkers;
+	std::ostringstream summary;
+	summary << std::fixed << std::setprecision(1) << "Telemetry: " <<
+	    sample.packages << " work packages (" << sample.elements <<
+	    " elements, " << sample.bytes << " bytes) sent in " <<
+	    sample.elapsed << " s; blocked " << (sample.elapsed > 0 ?
+	    100 * sample.blocked / sample.elapsed : 0) << "%. Task-N: " <<
+	    (total.elapsed > 0 ? total.elements / total.elapsed : 0) <<
+	    " elements/s, blocked " << (total.elapsed > 0 ?
+	    100 * total.blocked / total.elapsed : 0) <<
+	    "%, workers busy " << (workerTime > 0 ?
+	    100 * total.busy / workerTime : 0) << "%";
+	MPI::logMessage(*log, summary.str());
+}
+
+void
+BiometricEvaluation::MPI::Distributor::completePositions(
+    const PackagedPositions &positions)
+{
+	for (const auto &position : positions) {
+		const auto &range = position.first;
+		this->_completedPositions.insert(range.first, range.second);
+		this->_completionFile << range.first << ' ' << range.second;
+		if (!position.second.empty()) {
+			this->_completedLabels[range.second] = position.second;
+			this->_completionFile << ' ' << position.second;
+		}
+		this->_completionFile << '\n';
+	}
+	this->_completionFile.flush();
+
+	/* Only labels from the end of the leading range onward are used */
+	const uint64_t firstMissing =
+	    this->_completedPositions.getFirstMissing();
+	if (firstMissing > 1)
+		this->_completedLabels.erase(this->_completedLabels.begin(),
+		    this->_completedLabels.lower_bound(firstMissing - 1));
+}
+
+void
+BiometricEvaluation::MPI::Distributor::loadCompletions()
+{
+	const std::string fileName = this->_resources->getCheckpointPath() +
+	    '/' + BE::MPI::Distributor::COMPLETIONFILENAME;
+	std::ifstream file(fileName);
+	if (!file)
+		return;
+	this->_hasCompletionRecord = true;
+
+	/* Each line is the first and last position, and a label */
+	std::string line;
+	while (std::getline(file, line)) {
+		std::istringstream fields(line);
+		uint64_t first, last;
+		if (!(fields >> first >> last) || (last < first))
+			continue;
+		this->_completedPositions.insert(first, last);
+		if (fields.get() == ' ') {
+			std::string label;
+			std::getline(fields, label);
+			if (!label.empty())
+				this->_completedLabels[last] = label;
+		}
+	}
+
+	BE::IO::Logsheet *log = this->_logsheet.get();
+	*log << "Checkpoint restore: " <<
+	    this->_completedPositions.getCount() << " completed elements";
+	MPI::logEntry(*log);
+}
+
+void
+BiometricEvaluation::MPI::Distributor::writeCompletions()
+{
+	const std::string fileName = this->_resources->getCheckpointPath() +
+	    '/' + BE::MPI::Distributor::COMPLETIONFILENAME;
+	const std::string tempFileName = fileName + ".tmp";
+
+	/* Written aside and renamed, so a crash leaves a complete file */
+	this->_completionFile.close();
+	{
+		std::ofstream file(tempFileName, std::ios::trunc);
+		for (const auto &range : this->_completedPositions.getRanges()) {
+			file << range.first << ' ' << range.second;
+			const auto it = this->_completedLabels.find(
+			    range.second);
+			if ((it != this->_completedLabels.end()) &&
+			    !it->second.empty())
+				file << ' ' << it->second;
+			file << '\n';
+		}
+		file.flush();
+		if (!file)
+			throw Error::StrategyError("Could not write " +
+			    tempFileName);
+	}
+	if (std::rename(tempFileName.c_str(), fileName.c_str()) != 0)
+		throw Error::StrategyError("Could not replace " + fileName +
+		    ": " + Error::errorStr());
+
+	this->_completionFile.open(fileName, std::ios::app);
+	if (!this->_completionFile)
+		throw Error::StrategyError("Could not open " + fileName);
+}
+
+uint64_t
+BiometricEvaluation::MPI::Distributor::getNumRemainingElements() const
+{
+	return (0);
+}
+
+void
+BiometricEvaluation::MPI::Distributor::recordCompletion(
+    int MPITask,
+    uint64_t numElements)
+{
+	const auto it = this->_taskThroughput.find(MPITask);
+	if (it == this->_taskThroughput.end())
+		return;
+
+	/*
+	 * Completions are counted rather than the time between work
+	 * requests, as a task with packages queued asks for more before
+	 * finishing any. Measure over at least the package duration, so
+	 * that packages finished together by several workers don't
+	 * swing the rate, and smooth with the previous rate as well.
+	 */
+	auto &throughput = it->second;
+	throughput.numCompleted += numElements;
+	const std::chrono::duration<double> elapsed =
+	    std::chrono::steady_clock::now() - throughput.since;
+	if (elapsed.count() < this->_resources->getPackageDuration())
+		return;
+	const double rate = throughput.numCompleted / elapsed.count();
+	throughput.since = std::chrono::steady_clock::now();
+	throughput.numCompleted = 0;
+	if (throughput.rate == 0)
+		throughput.rate = rate;
+	else
+		throughput.rate = (throughput.rate + rate) / 2;
+}
+
+bool
+BiometricEvaluation::MPI::Distributor::isWorkPackageFull(
+    uint64_t chunkSize,
+    uint64_t numElements,
+    uint64_t numBytes)
+    const
+{
+	if (!this->_resources->useAdaptiveChunkSize())
+		return (numElements >= chunkSize);
+
+	const uint64_t maxBytes = this->_resources->getMaxPackageSize();
+	if ((maxBytes != 0) && (numBytes >= maxBytes))
+		return (true);
+	const uint64_t maxElements = this->_resources->getMaxChunkSize();
+	if ((maxElements != 0) && (numElements >= maxElements))
+		return (true);
+	if (numBytes < this->_resources->getMinPackageSize())
+		return (false);
+
+	if (this->_packageElementLimit == 0) {
+		/* Enough elements to keep the task busy for the duration */
+		uint64_t limit = chunkSize;
+		const auto it = this->_taskThroughput.find(this->_currentTask);
+		if ((it != this->_taskThroughput.end()) &&
+		    (it->second.rate > 0))
+			limit = static_cast<uint64_t>(it->second.rate *
+			    this->_resources->getPackageDuration() /
+			    this->getNumServedTasks(this->_currentTask));
+
+		/*
+		 * Guided scheduling: take no more than half of an even
+		 * share of the remaining work, so that packages shrink as
+		 * work drains and all tasks finish at about the same time.
+		 */
+		const uint64_t remaining = this->getNumRemainingElements() +
+		    numElements;
+		uint64_t numTasks{0};
+		for (const auto task : this->_activeMpiTasks)
+			numTasks += this->getNumServedTasks(task);
+		numTasks = std::max<uint64_t>(1, numTasks);
+		if (this->getNumRemainingElements() != 0)
+			limit = std::min(limit,
+			    (remaining + (2 * numTasks) - 1) / (2 * numTasks));
+
+		limit = std::max(limit, this->_resources->getMinChunkSize());
+		if (maxElements != 0)
+			limit = std::min(limit, maxElements);
+		this->_packageElementLimit = std::max<uint64_t>(limit, 1);
+	}
+	return (numElements >= this->_packageElementLimit);
+}
+
+void
+BiometricEvaluation::MPI::Distributor::distributeWork()
+{
+	MPI::WorkPackage workPackage;
+	BE::IO::Logsheet *log = this->_logsheet.get();
 
 	/*
 	 * While there is work to be distributed, check for Exit conditions,
-	 * gather up all work package requests fairly, dispatch work, etc.
+	 * gather up all work package requests, dispatch work, etc.
 	 */
 	bool haveWork = true;
 	MPI::taskcmd_t taskCmd;
-	while (haveWork) {
+	const bool tracking = this->_resources->tracksWorkPackages();
+	const bool resending = this->_resources->resendsWorkPackages();
+	const bool telemetry = this->_resources->collectsTelemetry();
+	while (haveWork ||
+	    (resending && !this->_outstandingPackages.empty())) {
 
 		/*
 		 * Check for exit signal conditions. The action
@@ -223,81 +907,180 @@ BiometricEvaluation::MPI::Distributor::distributeWork()
 		}
 
 		/*
-		 * Implement a fair message processing scheme, where all 
-		 * posted messages are checked in a non-blocking fashion
-		 * as a set. Each MPI::Send() done by a Task must be matched
-		 * with an MPI::Recv() (or Irecv(), etc.), so once a
-		 * message is processed, we must call Irecv() for the Task
-		 * so future messages will be processed.
+		 * Wait a short while for a request from any task, so
+		 * exit conditions are noticed while tasks are busy.
+		 * Requests are answered in the order they arrive.
+		 * Returned results are taken between requests.
 		 */
-		numRequests = ::MPI::Request::Testsome(
-		    numTasks, requests.get(), indices.get(), MPIstatus.get());
-		for (int r = 0; r < numRequests; r++) {
-			int task = MPIstatus[r].Get_source();
-			/*
-	 		* If the task says that it is done,
-	 		* then take it out of the list of
-	 		* active tasks.
-			*/
-			*log << "Received ";
-			const auto ts = to_enum<MPI::TaskStatus>(
-			    taskStatus[indices[r]]);
-			if ((ts == MPI::TaskStatus::Exit) ||
-			    (ts == MPI::TaskStatus::Failed)) {
-				*log << "Exit/Failure from Task-" << task;
-				MPI::logEntry(*log);
-				this->_activeMpiTasks.erase(task);
-				continue;
-			} else if (ts == MPI::TaskStatus::
-			    RequestJobTermination) {
-				*log << "Job termination request from Task-" <<
-				    task;
-				MPI::logEntry(*log);
-				BE::MPI::TermExit = true;
-				continue;
+		int task;
+		uint64_t size;
+		if (this->_resultCollector != nullptr)
+			this->collectResults(0);
+		if (tracking)
+			this->collectCompletions(0);
+		if (telemetry)
+			this->collectTelemetry(0);
+
+		/*
+		 * Once no new work remains, tasks asking for work wait
+		 * for packages that are late, orphaned, or speculated on.
+		 */
+		for (auto it = this->_idleTasks.begin();
+		    it != this->_idleTasks.end(); ) {
+			if ((this->_activeMpiTasks.count(*it) != 0) &&
+			    this->resendWorkPackage(*it, !haveWork))
+				it = this->_idleTasks.erase(it);
+			else
+				++it;
+		}
+
+		bool requested;
+		{
+			MPI::Telemetry::BlockedTimer timer(this->_telemetry);
+			requested = this->_transport->probe(
+			    Transport::ANYSOURCE, MPI::MessageTag::Control,
+			    ((this->_resultCollector != nullptr) || tracking ?
+			    10 : 100), task, size);
+		}
+		if (!requested)
+			continue;
+		const auto ts = to_enum<MPI::TaskStatus>(
+		    this->_transport->receiveValue<MPI::taskstat_t>(task,
+		    MPI::MessageTag::Control));
+
+		/*
+		 * If the task says that it is done,
+		 * then take it out of the list of
+		 * active tasks.
+		 */
+		*log << "Received ";
+		if ((ts == MPI::TaskStatus::Exit) ||
+		    (ts == MPI::TaskStatus::Failed)) {
+			*log << "Exit/Failure from Task-" << task;
+			MPI::logEntry(*log);
+			this->_activeMpiTasks.erase(task);
+
+			/* The task takes answers to its held requests */
+			taskCmd = to_int_type(MPI::TaskCommand::Ignore);
+			for (auto it = this->_idleTasks.begin();
+			    it != this->_idleTasks.end(); ) {
+				if (*it != task) {
+					++it;
+					continue;
+				}
+				this->_transport->sendValue(task,
+				    MPI::MessageTag::Control, taskCmd);
+				it = this->_idleTasks.erase(it);
 			}
-			*log << "OK from Task-" << task;
+			if (this->_activeMpiTasks.empty())
+				break;
+			continue;
+		} else if (ts == MPI::TaskStatus::RequestJobTermination) {
+			*log << "Job termination request from Task-" << task;
 			MPI::logEntry(*log);
+			BE::MPI::TermExit = true;
+			continue;
+		}
+		*log << "OK from Task-" << task;
+		MPI::logEntry(*log);
 
-			this->createWorkPackage(workPackage);
+		if (resending && this->resendWorkPackage(task, !haveWork))
+			continue;
+		if (!haveWork) {
+			this->_idleTasks.push_back(task);
+			continue;
+		}
 
-			/*
-			 * If we are out of work, or in a shutdown
-			 * condition, tell the task to ignore the
-			 * reply. We need to do this so the
-			 * communication send/recv pairs stay in sync.
-			 */
-			if ((workPackage.getNumElements() == 0) ||
-			   (BiometricEvaluation::MPI::Exit ||
-			    BiometricEvaluation::MPI::QuickExit ||
-			    BiometricEvaluation::MPI::TermExit)) {
-				taskCmd = to_int_type(MPI::TaskCommand::Ignore);
-				::MPI::COMM_WORLD.Send(
-				    (void *)&taskCmd, 1, MPI_INT32_T, task,
-				    to_int_type(MPI::MessageTag::Control));
+		this->_currentTask = task;
+
+		/* A node leader is sent a package for each task it serves */
+		const uint64_t numPackages = this->getNumServedTasks(task);
+		std::vector<MPI::WorkPackage> workPackages;
+		std::vector<PackagedPositions> packagePositions;
+		while (workPackages.size() < numPackages) {
+			this->_packageElementLimit = 0;
+			this->_packagePositions.clear();
+			this->createWorkPackage(workPackage);
+			if (workPackage.getNumElements() == 0) {
+				this->_inputExhausted = true;
+				/* Elements that could not be read are done with */
+				if (BE::MPI::checkpointEnable)
+					this->completePositions(
+					    this->_packagePositions);
 				haveWork = false;
+				break;
+			}
+			workPackages.push_back(std::move(workPackage));
+			workPackage = MPI::WorkPackage();
+			packagePositions.push_back(
+			    std::move(this->_packagePositions));
+		}
+
+		/*
+		 * If we are out of work, or in a shutdown
+		 * condition, tell the task to ignore the
+		 * reply. We need to do this so the
+		 * communication send/recv pairs stay in sync.
+		 * Requests that follow are answered by shutdown().
+		 */
+		if (workPackages.empty() ||
+		   (BiometricEvaluation::MPI::Exit ||
+		    BiometricEvaluation::MPI::QuickExit ||
+		    BiometricEvaluation::MPI::TermExit)) {
+			haveWork = false;
+			if (resending && workPackages.empty()) {
+				this->_idleTasks.push_back(task);
 				continue;
 			}
-			/*
-			 * Tell the task to continue with the
-			 * data coming in the next messages.
-			 */
-			taskCmd = to_int_type(MPI::TaskCommand::Continue);
-			::MPI::COMM_WORLD.Send((void *)&taskCmd, 1, MPI_INT32_T,
-			    task, to_int_type(MPI::MessageTag::Control));
+			taskCmd = to_int_type(MPI::TaskCommand::Ignore);
+			this->_transport->sendValue(task,
+			    MPI::MessageTag::Control, taskCmd);
+			continue;
+		}
+		/*
+		 * Tell the task to continue with the
+		 * data coming in the next messages.
+		 */
+		taskCmd = to_int_type(MPI::TaskCommand::Continue);
+		this->_transport->sendValue(task, MPI::MessageTag::Control,
+		    taskCmd);
 
-			sendWorkPackage(workPackage, task);
+		std::vector<MPI::WorkPackage *> sending;
+		for (std::size_t i = 0; i < workPackages.size(); i++) {
+			if (tracking) {
+				workPackages[i].setID(this->_nextPackageID++);
+				auto &outstanding = this->_outstandingPackages[
+				    workPackages[i].getID()];
+				outstanding.positions =
+				    std::move(packagePositions[i]);
+				outstanding.requester = task;
+				outstanding.numElements =
+				    workPackages[i].getNumElements();
+			}
+			sending.push_back(&workPackages[i]);
+		}
+		this->sendWorkPackages(sending, task);
 
-			/*
-			 * Repost the non-blocking receive
-			 * for the task just given work.
-			 */
-			requests[indices[r]] = ::MPI::COMM_WORLD.Irecv(
-			    &taskStatus[indices[r]], 1, MPI_INT32_T,
-			    task, to_int_type(MPI::MessageTag::Control));
+		/* Throughput is measured from the first package sent */
+		const auto now = std::chrono::steady_clock::now();
+		auto &throughput = this->_taskThroughput[task];
+		if (throughput.since ==
+		    std::chrono::steady_clock::time_point{})
+			throughput.since = now;
+
+		if (resending) {
+			for (auto &sent : workPackages) {
+				auto &outstanding = this->_outstandingPackages[
+				    sent.getID()];
+				outstanding.tasks.insert(task);
+				outstanding.sent = now;
+				outstanding.workPackage = std::move(sent);
+			}
 		}
-		if (this->_activeMpiTasks.empty())
-			break;
+	}
+	if (this->_numResent != 0) {
+		*log << "Work packages sent again: " << this->_numResent;
+		MPI::logEntry(*log);
 	}
 
 	/*
@@ -314,57 +1097,21 @@ BiometricEvaluation::MPI::Distributor::distributeWork()
  	 * all Task-N that are still asking for work.
  	 * It's OK if Task-N never attempts to receive this message
  	 * as it is of a different tag than the normal control
- 	 * messages that are kept in sync of the Send()/Recv() pairs.
+ 	 * messages that are kept in sync of the send/receive pairs.
  	 * It is important that the job shutdown soon after this point.
  	 */
-	if (BiometricEvaluation::MPI::Exit) {
-		taskCmd = to_int_type(MPI::TaskCommand::Exit);
-	} else if (BiometricEvaluation::MPI::QuickExit) {
-		taskCmd = to_int_type(MPI::TaskCommand::QuickExit);
-	} else if (BiometricEvaluation::MPI::TermExit) {
-		taskCmd = to_int_type(MPI::TaskCommand::TermExit);
-	}
-	for (const auto &task : this->_activeMpiTasks) {
-		::MPI::COMM_WORLD.Isend(
-		    (void *)&taskCmd, 1, MPI_INT32_T, task,
-		    to_int_type(MPI::MessageTag::OOB));
-	}
-
-	/*
-	 * Once all the work as been distributed, we must tell the
-	 * Task there is no more work (via an Ignore message, and
-	 * not call Irecv() for that task. This approach keeps the
-	 * work message processing and shutdown message processing
-	 * independent.
-	 */
-	numRequests = ::MPI::Request::Testsome(
-	    numTasks, requests.get(), indices.get(), MPIstatus.get());
-
-	/*
- 	 * MPI runtime will indicate when there are no postponed
- 	 * message requests in the set of requests.
- 	 */
-	taskCmd = to_int_type(MPI::TaskCommand::Ignore);
- 	while (numRequests != MPI_UNDEFINED) {
-		for (int r = 0; r < numRequests; r++) {
-			int task = MPIstatus[r].Get_source();
-			const auto ts = to_enum<TaskStatus>(
-			    taskStatus[indices[r]]);
-			if ((ts == MPI::TaskStatus::Exit) ||
-			    (ts == MPI::TaskStatus::Failed)) {
-				*log << "Received Exit/Failure from Task-"
-				    << task;
-				MPI::logEntry(*log);
-				this->_activeMpiTasks.erase(task);
-			} else {
-				::MPI::COMM_WORLD.Send(
-				    (void *)&taskCmd, 1,
-				    MPI_INT32_T, task,
-				    to_int_type(MPI::MessageTag::Control));
-			}
-		}
-		numRequests = ::MPI::Request::Testsome(
-		    numTasks, requests.get(), indices.get(), MPIstatus.get());
+	if (BiometricEvaluation::MPI::Exit ||
+	    BiometricEvaluation::MPI::QuickExit ||
+	    BiometricEvaluation::MPI::TermExit) {
+		if (BiometricEvaluation::MPI::Exit)
+			taskCmd = to_int_type(MPI::TaskCommand::Exit);
+		else if (BiometricEvaluation::MPI::QuickExit)
+			taskCmd = to_int_type(MPI::TaskCommand::QuickExit);
+		else
+			taskCmd = to_int_type(MPI::TaskCommand::TermExit);
+		for (const auto &task : this->_activeMpiTasks)
+			this->_transport->sendValue(task,
+			    MPI::MessageTag::OOB, taskCmd);
 	}
 }
 
@@ -397,56 +1144,158 @@ BiometricEvaluation::MPI::Distributor::shutdown()
 	MPI::logEntry(*log);
 
 	/*
- 	 * Wait for each child task to ask for more work, then
- 	 * then tell them to exit. 
+ 	 * Answer each work request from the child tasks by telling
+	 * them to exit. A task may have several requests outstanding;
+	 * it sends an Exit status once it will make no more, and as
+	 * messages from a task arrive in order, all of its requests
+	 * have been answered by then.
  	 */
+	for (const auto task : this->_idleTasks) {
+		this->_transport->sendValue(task, MPI::MessageTag::Control,
+		    taskCmd);
+		*log << "Sent exit command to Task-" << task;
+		MPI::logEntry(*log);
+	}
+	this->_idleTasks.clear();
+
+	const bool tracking = this->_resources->tracksWorkPackages();
+	const bool telemetry = this->_resources->collectsTelemetry();
 	MPI::taskstat_t taskStatus;
-	::MPI::Status MPIstatus;
 	while(!this->_activeMpiTasks.empty()) {
 
-		/* Wait for the receive of the work request */
-		::MPI::COMM_WORLD.Recv(&taskStatus, 1, MPI_INT32_T,
-		    MPI_ANY_SOURCE, to_int_type(MPI::MessageTag::Control),
-		    MPIstatus);
+		/*
+		 * Wait for the receive of the work request, taking
+		 * returned results while waiting.
+		 */
+		int task;
+		uint64_t size;
+		if ((this->_resultCollector != nullptr) || tracking ||
+		    telemetry) {
+			if (this->_resultCollector != nullptr)
+				this->collectResults(0);
+			if (tracking)
+				this->collectCompletions(0);
+			if (telemetry)
+				this->collectTelemetry(0);
+			MPI::Telemetry::BlockedTimer timer(this->_telemetry);
+			if (!this->_transport->probe(Transport::ANYSOURCE,
+			    MPI::MessageTag::Control, 10, task, size))
+				continue;
+		}
+		taskStatus = this->_transport->receiveValue<MPI::taskstat_t>(
+		    Transport::ANYSOURCE, MPI::MessageTag::Control, &task);
+		const auto ts = to_enum<MPI::TaskStatus>(taskStatus);
+		if ((ts == MPI::TaskStatus::Exit) ||
+		    (ts == MPI::TaskStatus::Failed)) {
+			this->_activeMpiTasks.erase(task);
+			*log << "Received Exit/Failure from Task-" << task;
+			MPI::logEntry(*log);
+			continue;
+		}
+		if (ts != MPI::TaskStatus::OK)
+			continue;
 
 		/* Tell the task to exit */
-		int task = MPIstatus.Get_source();
-		::MPI::COMM_WORLD.Send(
-		    (void *)&taskCmd, 1, MPI_INT32_T, task,
-		    to_int_type(MPI::MessageTag::Control));
-
-		this->_activeMpiTasks.erase(task);
+		this->_transport->sendValue(task, MPI::MessageTag::Control,
+		    taskCmd);
 
 		*log << "Sent exit command to Task-" << task;
 		MPI::logEntry(*log);
 	}
 
+	/*
+	 * Every task sends an empty batch once all of its results have
+	 * been written, and an empty completion report once all of its
+	 * work packages are reported, before it reaches the barrier.
+	 */
+	if (tracking) {
+		/* Completions follow the acknowledgement of their results */
+		this->waitForFinalReports("remaining completions",
+		    [this](int task) {
+		    return (this->_completionsEnded.count(task) != 0); },
+		    [this]() {
+			const bool results = (this->_resultCollector !=
+			    nullptr) && this->collectResults(0);
+			return (this->collectCompletions(10) || results);
+		    });
+	}
+	if (this->_resultCollector != nullptr) {
+		this->waitForFinalReports("remaining results",
+		    [this](int task) {
+		    return (this->_resultsEnded.count(task) != 0); },
+		    [this]() { return (this->collectResults(100)); });
+		this->_resultCollector->finish();
+		*log << "Results written: " <<
+		    this->_resultCollector->getNumWritten() << " (" <<
+		    this->_resultCollector->getNumReplaced() <<
+		    " replaced, " << this->_resultCollector->getNumFailed() <<
+		    " failed)";
+		MPI::logEntry(*log);
+	}
+
+	/* Every task sends a final sample as well */
+	if (telemetry) {
+		this->waitForFinalReports("final telemetry",
+		    [this](int task) {
+		    return (this->_finalSamples.count(task) != 0); },
+		    [this]() { return (this->collectTelemetry(100)); });
+		this->summarizeTelemetry();
+	}
+
 	/* Wait for other tasks to start the shut down */
-	::MPI::COMM_WORLD.Barrier();
+	this->_transport->barrier();
 
 	/*
 	 * Wait for all tasks to send a final message even if
 	 * they've done no receiving of work.
 	 */
-	::MPI::Status mpiStatus;
 	for (int task = 1; task < this->_resources->getNumTasks(); task++) {
-		::MPI::COMM_WORLD.Recv(&taskStatus, 1, MPI_INT32_T,
-		    MPI_ANY_SOURCE, to_int_type(MPI::MessageTag::Control),
-		    mpiStatus);
+		int source;
+		taskStatus = this->_transport->receiveValue<MPI::taskstat_t>(
+		    Transport::ANYSOURCE, MPI::MessageTag::Control, &source);
 		*log << "Received " << to_enum<TaskStatus>(taskStatus) << " " <<
-		    "from Task-" << mpiStatus.Get_source();
+		    "from Task-" << source;
 		MPI::logEntry(*log);
 	}
 	/*
-	 * If all the work has been distributed, remove the checkpoint file.
+	 * If all the work has been distributed and reported complete,
+	 * remove the checkpoint files. Otherwise, whether from an exit
+	 * signal or from tasks that failed, keep them, leaving only the
+	 * completed ranges in the completion file. The number of
+	 * remaining elements may be unknown (0), so it is only logged.
 	 */
-	if ((BE::MPI::checkpointEnable) &&
-	    !BE::MPI::Exit) {
+	const uint64_t numRemaining = this->getNumRemainingElements();
+	const bool finished = this->_inputExhausted &&
+	    this->_outstandingPackages.empty();
+	if ((BE::MPI::checkpointEnable) && finished) {
 		std::string chkFileName =
 		    this->_resources->getCheckpointPath() + '/' +
 		    BE::MPI::Distributor::CHECKPOINTFILENAME;
 		this->_checkpointData.reset();
 		unlink(chkFileName.c_str());
+		this->_completionFile.close();
+		unlink((this->_resources->getCheckpointPath() + '/' +
+		    BE::MPI::Distributor::COMPLETIONFILENAME).c_str());
+	} else if (BE::MPI::checkpointEnable) {
+		try {
+			this->writeCompletions();
+		} catch (const Error::Exception &e) {
+			MPI::logMessage(*log, "Writing completions: " +
+			    e.whatString());
+		}
+		*log << "Completed elements: " <<
+		    this->_completedPositions.getCount() << " in " <<
+		    this->_completedPositions.getRanges().size() <<
+		    " range(s); ";
+		if (this->_inputExhausted)
+			*log << "all elements distributed, ";
+		else if (numRemaining == 0)
+			*log << "elements remain to be distributed, ";
+		else
+			*log << numRemaining << " element(s) not distributed, ";
+		*log << this->_outstandingPackages.size() <<
+		    " work package(s) not completed";
+		MPI::logEntry(*log);
 	}
 }
 
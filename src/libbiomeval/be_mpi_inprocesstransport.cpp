@@ -0,0 +1,394 @@
+/**
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties.  Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain.  NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <be_error.h>
+#include <be_error_exception.h>
+#include "be_mpi_inprocesstransport_impl.h"
+
+namespace BE = BiometricEvaluation;
+
+/*
+ * Rank of the task run by the calling thread.
+ */
+static thread_local int taskRank{0};
+
+/*
+ * A pipe written to whenever a message is delivered to the task's
+ * mailbox.
+ */
+class BiometricEvaluation::MPI::InProcessTransport::MailboxMessageWaiter :
+    public BiometricEvaluation::MPI::Transport::MessageWaiter
+{
+public:
+	MailboxMessageWaiter(
+	    Mailbox &mailbox);
+	~MailboxMessageWaiter();
+
+	int getDescriptor() const override;
+	void rearm() override;
+
+private:
+	Mailbox &_mailbox;
+	int _pipe[2];
+};
+
+BiometricEvaluation::MPI::InProcessTransport::MailboxMessageWaiter::
+    MailboxMessageWaiter(
+    Mailbox &mailbox) :
+    _mailbox{mailbox}
+{
+	if (::pipe(this->_pipe) != 0)
+		throw Error::StrategyError("Could not create pipe: " +
+		    Error::errorStr());
+	for (const auto fd : this->_pipe)
+		::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+	std::lock_guard<std::mutex> lock(this->_mailbox.mutex);
+	this->_mailbox.notifyDescriptor = this->_pipe[1];
+}
+
+BiometricEvaluation::MPI::InProcessTransport::MailboxMessageWaiter::
+    ~MailboxMessageWaiter()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->_mailbox.mutex);
+		this->_mailbox.notifyDescriptor = -1;
+	}
+	::close(this->_pipe[0]);
+	::close(this->_pipe[1]);
+}
+
+int
+BiometricEvaluation::MPI::InProcessTransport::MailboxMessageWaiter::
+    getDescriptor()
+    const
+{
+	return (this->_pipe[0]);
+}
+
+void
+BiometricEvaluation::MPI::InProcessTransport::MailboxMessageWaiter::rearm()
+{
+	char buf[64];
+	while (::read(this->_pipe[0], buf, sizeof(buf)) > 0)
+		;
+
+	/* Messages that arrived before draining are still waiting */
+	std::lock_guard<std::mutex> lock(this->_mailbox.mutex);
+	if (!this->_mailbox.messages.empty()) {
+		const char event{0};
+		(void)::write(this->_pipe[1], &event, sizeof(event));
+	}
+}
+
+/*
+ * Messages are delivered to the mailbox when sent, so a send is complete
+ * as soon as it starts.
+ */
+class BiometricEvaluation::MPI::InProcessTransport::CompletedSendRequest :
+    public BiometricEvaluation::MPI::Transport::SendRequest
+{
+public:
+	bool test() override;
+	void wait() override;
+};
+
+bool
+BiometricEvaluation::MPI::InProcessTransport::CompletedSendRequest::test()
+{
+	return (true);
+}
+
+void
+BiometricEvaluation::MPI::InProcessTransport::CompletedSendRequest::wait()
+{
+}
+
+/******************************************************************************/
+/* Class method definitions.                                                  */
+/******************************************************************************/
+BiometricEvaluation::MPI::InProcessTransport::InProcessTransport(
+    int numTasks) :
+    _numTasks{numTasks}
+{
+	if (numTasks < 1)
+		throw Error::ParameterError("Invalid number of tasks");
+	for (int task = 0; task < numTasks; task++)
+		this->_mailboxes.emplace_back(new Mailbox());
+}
+
+void
+BiometricEvaluation::MPI::InProcessTransport::setTaskRank(
+    int rank)
+{
+	taskRank = rank;
+}
+
+void
+BiometricEvaluation::MPI::InProcessTransport::endTask()
+{
+	this->getMailbox(this->getRank()).ended = true;
+
+	/* Wake tasks waiting on messages from it */
+	for (auto &mailbox : this->_mailboxes) {
+		std::lock_guard<std::mutex> lock(mailbox->mutex);
+		mailbox->condition.notify_all();
+	}
+
+	/* Release a barrier that was only waiting for it */
+	std::lock_guard<std::mutex> lock(this->_barrierMutex);
+	this->_numEndedTasks++;
+	if ((this->_barrierCount > 0) && (this->_barrierCount >=
+	    this->_numTasks - this->_numEndedTasks)) {
+		this->_barrierCount = 0;
+		this->_barrierGeneration++;
+		this->_barrierCondition.notify_all();
+	}
+}
+
+BiometricEvaluation::MPI::InProcessTransport::~InProcessTransport()
+{
+}
+
+/******************************************************************************/
+/* Object method definitions.                                                 */
+/******************************************************************************/
+int
+BiometricEvaluation::MPI::InProcessTransport::getRank()
+    const
+{
+	return (taskRank);
+}
+
+int
+BiometricEvaluation::MPI::InProcessTransport::getNumTasks()
+    const
+{
+	return (this->_numTasks);
+}
+
+std::string
+BiometricEvaluation::MPI::InProcessTransport::getProcessorName()
+    const
+{
+	char hostname[256]{};
+	if (::gethostname(hostname, sizeof(hostname) - 1) != 0)
+		return ("localhost");
+	return (hostname);
+}
+
+std::vector<int>
+BiometricEvaluation::MPI::InProcessTransport::getNodes()
+{
+	return (std::vector<int>(this->_numTasks, 0));
+}
+
+BiometricEvaluation::MPI::InProcessTransport::Mailbox &
+BiometricEvaluation::MPI::InProcessTransport::getMailbox(
+    int rank)
+{
+	if ((rank < 0) || (rank >= this->_numTasks))
+		throw Error::ParameterError("Invalid task " +
+		    std::to_string(rank));
+	return (*this->_mailboxes[rank]);
+}
+
+void
+BiometricEvaluation::MPI::InProcessTransport::deliver(
+    int destination,
+    Message &&message)
+{
+	Mailbox &mailbox = this->getMailbox(destination);
+	{
+		std::lock_guard<std::mutex> lock(mailbox.mutex);
+		mailbox.messages.push_back(std::move(message));
+		if (mailbox.notifyDescriptor != -1) {
+			const char event{0};
+			(void)::write(mailbox.notifyDescriptor, &event,
+			    sizeof(event));
+		}
+	}
+	mailbox.condition.notify_all();
+}
+
+void
+BiometricEvaluation::MPI::InProcessTransport::send(
+    int destination,
+    MessageTag tag,
+    const void *data,
+    uint64_t size)
+{
+	Message message{this->getRank(), tag, Memory::uint8Array(size)};
+	if (size != 0)
+		std::memcpy(message.data, data, size);
+	this->deliver(destination, std::move(message));
+}
+
+void
+BiometricEvaluation::MPI::InProcessTransport::send(
+    int destination,
+    MessageTag tag,
+    const std::vector<Memory::uint8Array> &segments)
+{
+	uint64_t size{0};
+	for (const auto &segment : segments)
+		size += segment.size();
+
+	Message message{this->getRank(), tag, Memory::uint8Array(size)};
+	uint64_t offset{0};
+	for (const auto &segment : segments) {
+		if (segment.size() == 0)
+			continue;
+		std::memcpy(&message.data[offset], segment, segment.size());
+		offset += segment.size();
+	}
+	this->deliver(destination, std::move(message));
+}
+
+std::unique_ptr<BiometricEvaluation::MPI::Transport::SendRequest>
+BiometricEvaluation::MPI::InProcessTransport::startSend(
+    int destination,
+    MessageTag tag,
+    const void *data,
+    uint64_t size)
+{
+	this->send(destination, tag, data, size);
+	return (std::unique_ptr<SendRequest>(new CompletedSendRequest()));
+}
+
+std::deque<BiometricEvaluation::MPI::InProcessTransport::Message>::iterator
+BiometricEvaluation::MPI::InProcessTransport::find(
+    Mailbox &mailbox,
+    std::unique_lock<std::mutex> &lock,
+    int source,
+    MessageTag tag,
+    int timeout)
+{
+	const auto matches = [&](const Message &message) {
+		return (((source == ANYSOURCE) || (message.source == source))
+		    && (message.tag == tag));
+	};
+	/* Whether a matching message can still be sent */
+	const auto sendable = [&]() -> bool {
+		if (source != ANYSOURCE)
+			return (!this->getMailbox(source).ended);
+		for (int task = 0; task < this->_numTasks; task++)
+			if ((task != this->getRank()) &&
+			    !this->_mailboxes[task]->ended)
+				return (true);
+		return (false);
+	};
+
+	const auto end = std::chrono::steady_clock::now() +
+	    std::chrono::milliseconds(timeout > 0 ? timeout : 0);
+	while (true) {
+		for (auto it = mailbox.messages.begin();
+		    it != mailbox.messages.end(); it++)
+			if (matches(*it))
+				return (it);
+		if (!sendable())
+			return (mailbox.messages.end());
+
+		if (timeout < 0)
+			mailbox.condition.wait(lock);
+		else if (mailbox.condition.wait_until(lock, end) ==
+		    std::cv_status::timeout)
+			break;
+	}
+
+	/* Time is up, but a message may have arrived at the last moment */
+	for (auto it = mailbox.messages.begin(); it != mailbox.messages.end();
+	    it++)
+		if (matches(*it))
+			return (it);
+	return (mailbox.messages.end());
+}
+
+bool
+BiometricEvaluation::MPI::InProcessTransport::probe(
+    int source,
+    MessageTag tag,
+    int timeout,
+    int &actualSource,
+    uint64_t &size)
+{
+	Mailbox &mailbox = this->getMailbox(this->getRank());
+	std::unique_lock<std::mutex> lock(mailbox.mutex);
+	const auto it = this->find(mailbox, lock, source, tag, timeout);
+	if (it == mailbox.messages.end())
+		return (false);
+	actualSource = it->source;
+	size = it->data.size();
+	return (true);
+}
+
+int
+BiometricEvaluation::MPI::InProcessTransport::receive(
+    int source,
+    MessageTag tag,
+    void *data,
+    uint64_t size)
+{
+	Mailbox &mailbox = this->getMailbox(this->getRank());
+	std::unique_lock<std::mutex> lock(mailbox.mutex);
+	const auto it = this->find(mailbox, lock, source, tag, -1);
+	if (it == mailbox.messages.end())
+		throw Error::StrategyError("Task-" + (source == ANYSOURCE ?
+		    std::string("N") : std::to_string(source)) +
+		    " has ended");
+	if (it->data.size() > size)
+		throw Error::StrategyError("Message of " +
+		    std::to_string(it->data.size()) + " bytes received into "
+		    "buffer of " + std::to_string(size) + " bytes");
+	if (it->data.size() != 0)
+		std::memcpy(data, it->data, it->data.size());
+	const int sender = it->source;
+	mailbox.messages.erase(it);
+	return (sender);
+}
+
+void
+BiometricEvaluation::MPI::InProcessTransport::barrier()
+{
+	std::unique_lock<std::mutex> lock(this->_barrierMutex);
+	const uint64_t generation = this->_barrierGeneration;
+	if (++this->_barrierCount >= this->_numTasks - this->_numEndedTasks) {
+		this->_barrierCount = 0;
+		this->_barrierGeneration++;
+		this->_barrierCondition.notify_all();
+		return;
+	}
+	this->_barrierCondition.wait(lock, [&] {
+	    return (this->_barrierGeneration != generation); });
+}
+
+std::unique_ptr<BiometricEvaluation::MPI::Transport::MessageWaiter>
+BiometricEvaluation::MPI::InProcessTransport::newMessageWaiter()
+{
+	return (std::unique_ptr<MessageWaiter>(new MailboxMessageWaiter(
+	    this->getMailbox(this->getRank()))));
+}
+
+void
+BiometricEvaluation::MPI::InProcessTransport::shutdown()
+{
+}
+
+void
+BiometricEvaluation::MPI::InProcessTransport::abort(
+    int errcode)
+{
+	std::_Exit(errcode);
+}
@@ -0,0 +1,161 @@
+/**
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties.  Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain.  NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+#ifndef _BE_MPI_INPROCESSTRANSPORT_IMPL_H
+#define _BE_MPI_INPROCESSTRANSPORT_IMPL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include <be_mpi_transport.h>
+
+namespace BiometricEvaluation {
+	namespace MPI {
+
+		/**
+		 * @brief
+		 * Transport between tasks that are threads of one
+		 * process.
+		 * @details
+		 * Each task has a mailbox of messages sent to it, from
+		 * which messages are taken in the order they arrived,
+		 * selected by source and tag. The rank of a task is a
+		 * property of its thread, set with setTaskRank(); threads
+		 * that have not set one are Task-0.
+		 */
+		class InProcessTransport : public Transport {
+		public:
+			/**
+			 * @param[in] numTasks
+			 * The number of tasks in the job.
+			 */
+			InProcessTransport(
+			    int numTasks);
+
+			/**
+			 * @brief
+			 * Set the rank of the calling thread's task.
+			 * @param[in] rank
+			 * Rank of the task run by this thread.
+			 */
+			static void setTaskRank(
+			    int rank);
+
+			/**
+			 * @brief
+			 * End the calling thread's task without the
+			 * messages and barriers other tasks may be waiting
+			 * for.
+			 * @details
+			 * Barriers no longer wait for the task, probes for
+			 * its messages stop waiting once none are left, and
+			 * receives of a message it will never send throw
+			 * Error::StrategyError.
+			 */
+			void endTask();
+
+			int getRank() const override;
+			int getNumTasks() const override;
+			std::string getProcessorName() const override;
+			std::vector<int> getNodes() override;
+
+			void send(
+			    int destination,
+			    MessageTag tag,
+			    const void *data,
+			    uint64_t size) override;
+			void send(
+			    int destination,
+			    MessageTag tag,
+			    const std::vector<Memory::uint8Array> &segments)
+			    override;
+			std::unique_ptr<SendRequest> startSend(
+			    int destination,
+			    MessageTag tag,
+			    const void *data,
+			    uint64_t size) override;
+			bool probe(
+			    int source,
+			    MessageTag tag,
+			    int timeout,
+			    int &actualSource,
+			    uint64_t &size) override;
+			int receive(
+			    int source,
+			    MessageTag tag,
+			    void *data,
+			    uint64_t size) override;
+			void barrier() override;
+			std::unique_ptr<MessageWaiter>
+			    newMessageWaiter() override;
+			void shutdown() override;
+			void abort(int errcode) override;
+
+			~InProcessTransport();
+
+		private:
+			class MailboxMessageWaiter;
+			class CompletedSendRequest;
+
+			struct Message {
+				int source;
+				MessageTag tag;
+				Memory::uint8Array data;
+			};
+
+			struct Mailbox {
+				std::mutex mutex;
+				std::condition_variable condition;
+				std::deque<Message> messages;
+				/* Written when a message arrives, or -1 */
+				int notifyDescriptor{-1};
+				/* The task will send no more messages */
+				std::atomic<bool> ended{false};
+			};
+
+			/*
+			 * Deliver a message to a task's mailbox.
+			 */
+			void deliver(
+			    int destination,
+			    Message &&message);
+
+			/*
+			 * Find the first message matching source and tag in
+			 * the calling task's mailbox, waiting up to timeout
+			 * milliseconds (< 0 forever); end() if none, or if
+			 * the tasks that could send one have ended. The
+			 * mailbox lock must be held.
+			 */
+			std::deque<Message>::iterator find(
+			    Mailbox &mailbox,
+			    std::unique_lock<std::mutex> &lock,
+			    int source,
+			    MessageTag tag,
+			    int timeout);
+
+			Mailbox &getMailbox(
+			    int rank);
+
+			int _numTasks;
+			std::vector<std::unique_ptr<Mailbox>> _mailboxes;
+
+			std::mutex _barrierMutex;
+			std::condition_variable _barrierCondition;
+			int _barrierCount{0};
+			uint64_t _barrierGeneration{0};
+			/* Tasks no longer taking part in barriers */
+			int _numEndedTasks{0};
+		};
+	}
+}
+
+#endif /* _BE_MPI_INPROCESSTRANSPORT_IMPL_H */
@@ -0,0 +1,450 @@
+/**
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties.  Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain.  NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <mpi.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <be_error.h>
+#include <be_error_exception.h>
+#include "be_mpi_mpitransport_impl.h"
+
+namespace BE = BiometricEvaluation;
+using namespace BE::Framework::Enumeration;
+
+/*
+ * Local helper functions.
+ */
+
+static int
+toMPISource(
+    int source)
+{
+	return (source == BE::MPI::Transport::ANYSOURCE ?
+	    MPI_ANY_SOURCE : source);
+}
+
+static int
+toMPICount(
+    uint64_t size)
+{
+	if (size > INT_MAX)
+		throw BE::Error::StrategyError("Message of " +
+		    std::to_string(size) + " bytes is too large for MPI");
+	return (static_cast<int>(size));
+}
+
+/*
+ * Read everything available from a non-blocking descriptor.
+ */
+static void
+drainDescriptor(
+    int fd)
+{
+	char buf[64];
+	while (::read(fd, buf, sizeof(buf)) > 0)
+		;
+}
+
+/*
+ * MPI offers no descriptor to wait on, so a thread blocks probing for a
+ * message from any task and writes to a pipe when one is available. The
+ * thread then waits to be rearmed, after the task has taken the
+ * message, so it doesn't find the same message again.
+ */
+class BiometricEvaluation::MPI::MPITransport::ProbingMessageWaiter :
+    public BiometricEvaluation::MPI::Transport::MessageWaiter
+{
+public:
+	ProbingMessageWaiter();
+	~ProbingMessageWaiter();
+
+	int getDescriptor() const override;
+	void rearm() override;
+
+private:
+	void run();
+
+	int _pipe[2];
+	int _rank;
+	std::mutex _mutex;
+	std::condition_variable _condition;
+	bool _armed{false};
+	bool _probing{false};
+	bool _stop{false};
+	bool _wakeupSent{false};
+	bool _wakeupReceived{false};
+	::MPI::Request _wakeupRequest;
+	std::thread _thread;
+};
+
+BiometricEvaluation::MPI::MPITransport::ProbingMessageWaiter::
+    ProbingMessageWaiter() :
+    _rank{::MPI::COMM_WORLD.Get_rank()}
+{
+	if (::pipe(this->_pipe) != 0)
+		throw Error::StrategyError("Could not create pipe: " +
+		    Error::errorStr());
+	for (const auto fd : this->_pipe)
+		::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+	this->_thread = std::thread(&ProbingMessageWaiter::run, this);
+}
+
+BiometricEvaluation::MPI::MPITransport::ProbingMessageWaiter::
+    ~ProbingMessageWaiter()
+{
+	/*
+	 * A thread blocked in Probe() is woken by a message to ourself,
+	 * which must be received by someone before the send completes.
+	 */
+	{
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		this->_stop = true;
+		if (this->_probing) {
+			static const int32_t wakeup{0};
+			this->_wakeupRequest = ::MPI::COMM_WORLD.Isend(
+			    &wakeup, 1, MPI_INT32_T, this->_rank,
+			    to_int_type(MPI::MessageTag::OOB));
+			this->_wakeupSent = true;
+		}
+	}
+	this->_condition.notify_all();
+	this->_thread.join();
+
+	if (this->_wakeupSent) {
+		if (!this->_wakeupReceived) {
+			int32_t wakeup;
+			::MPI::COMM_WORLD.Recv(&wakeup, 1, MPI_INT32_T,
+			    this->_rank, to_int_type(MPI::MessageTag::OOB));
+		}
+		this->_wakeupRequest.Wait();
+	}
+	::close(this->_pipe[0]);
+	::close(this->_pipe[1]);
+}
+
+int
+BiometricEvaluation::MPI::MPITransport::ProbingMessageWaiter::getDescriptor()
+    const
+{
+	return (this->_pipe[0]);
+}
+
+void
+BiometricEvaluation::MPI::MPITransport::ProbingMessageWaiter::rearm()
+{
+	/*
+	 * A message still pending after draining is found again once
+	 * the thread is rearmed.
+	 */
+	drainDescriptor(this->_pipe[0]);
+	{
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		if (this->_armed || this->_probing)
+			return;
+		this->_armed = true;
+	}
+	this->_condition.notify_all();
+}
+
+void
+BiometricEvaluation::MPI::MPITransport::ProbingMessageWaiter::run()
+{
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(this->_mutex);
+			this->_condition.wait(lock, [this] {
+			    return (this->_armed || this->_stop); });
+			if (this->_stop)
+				return;
+			this->_armed = false;
+			this->_probing = true;
+		}
+
+		::MPI::Status status;
+		::MPI::COMM_WORLD.Probe(MPI_ANY_SOURCE, MPI_ANY_TAG, status);
+		bool wakeup = (status.Get_source() == this->_rank);
+		if (wakeup) {
+			int32_t buf;
+			::MPI::COMM_WORLD.Recv(&buf, 1, MPI_INT32_T,
+			    this->_rank, to_int_type(MPI::MessageTag::OOB));
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(this->_mutex);
+			this->_probing = false;
+			if (wakeup) {
+				this->_wakeupReceived = true;
+				return;
+			}
+		}
+		const char event{0};
+		(void)::write(this->_pipe[1], &event, sizeof(event));
+	}
+}
+
+/*
+ * A send started with MPI_Isend.
+ */
+class BiometricEvaluation::MPI::MPITransport::MPISendRequest :
+    public BiometricEvaluation::MPI::Transport::SendRequest
+{
+public:
+	MPISendRequest(
+	    ::MPI::Request request);
+	~MPISendRequest();
+
+	bool test() override;
+	void wait() override;
+
+private:
+	::MPI::Request _request;
+	bool _complete{false};
+};
+
+BiometricEvaluation::MPI::MPITransport::MPISendRequest::MPISendRequest(
+    ::MPI::Request request) :
+    _request{request}
+{
+}
+
+BiometricEvaluation::MPI::MPITransport::MPISendRequest::~MPISendRequest()
+{
+	this->wait();
+}
+
+bool
+BiometricEvaluation::MPI::MPITransport::MPISendRequest::test()
+{
+	if (!this->_complete)
+		this->_complete = this->_request.Test();
+	return (this->_complete);
+}
+
+void
+BiometricEvaluation::MPI::MPITransport::MPISendRequest::wait()
+{
+	if (!this->_complete) {
+		this->_request.Wait();
+		this->_complete = true;
+	}
+}
+
+/******************************************************************************/
+/* Class method definitions.                                                  */
+/******************************************************************************/
+BiometricEvaluation::MPI::MPITransport::MPITransport(
+    int &argc,
+    char **&argv)
+{
+	/*
+	 * The Receiver waits for MPI messages from a helper thread when
+	 * the implementation allows it, and polls otherwise.
+	 */
+	(void)::MPI::Init_thread(argc, argv, MPI_THREAD_MULTIPLE);
+	this->_rank = ::MPI::COMM_WORLD.Get_rank();
+	this->_numTasks = ::MPI::COMM_WORLD.Get_size();
+}
+
+BiometricEvaluation::MPI::MPITransport::~MPITransport()
+{
+}
+
+/******************************************************************************/
+/* Object method definitions.                                                 */
+/******************************************************************************/
+int
+BiometricEvaluation::MPI::MPITransport::getRank()
+    const
+{
+	return (this->_rank);
+}
+
+int
+BiometricEvaluation::MPI::MPITransport::getNumTasks()
+    const
+{
+	return (this->_numTasks);
+}
+
+std::string
+BiometricEvaluation::MPI::MPITransport::getProcessorName()
+    const
+{
+	char hn[MPI_MAX_PROCESSOR_NAME];
+	int hlen;
+	(void)MPI_Get_processor_name(hn, &hlen);
+	return (std::string(hn, hlen));
+}
+
+std::vector<int>
+BiometricEvaluation::MPI::MPITransport::getNodes()
+{
+	/*
+	 * Tasks that can share memory are on the same node; each is
+	 * numbered by the lowest rank among them.
+	 */
+	MPI_Comm nodeComm;
+	if (MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED,
+	    this->_rank, MPI_INFO_NULL, &nodeComm) != MPI_SUCCESS)
+		throw Error::StrategyError("Could not split communicator "
+		    "by node");
+	int node{this->_rank};
+	(void)MPI_Bcast(&node, 1, MPI_INT, 0, nodeComm);
+	(void)MPI_Comm_free(&nodeComm);
+
+	std::vector<int> nodes(this->_numTasks);
+	(void)MPI_Allgather(&node, 1, MPI_INT, nodes.data(), 1, MPI_INT,
+	    MPI_COMM_WORLD);
+	return (nodes);
+}
+
+void
+BiometricEvaluation::MPI::MPITransport::send(
+    int destination,
+    MessageTag tag,
+    const void *data,
+    uint64_t size)
+{
+	::MPI::COMM_WORLD.Send(data, toMPICount(size), MPI_BYTE,
+	    destination, to_int_type(tag));
+}
+
+void
+BiometricEvaluation::MPI::MPITransport::send(
+    int destination,
+    MessageTag tag,
+    const std::vector<Memory::uint8Array> &segments)
+{
+	if (segments.size() == 1) {
+		this->send(destination, tag, segments[0], segments[0].size());
+		return;
+	}
+
+	/*
+	 * Data gathered from several segments is described to MPI
+	 * with a derived datatype instead of being copied into one
+	 * buffer; the receiver sees the same contiguous bytes.
+	 */
+	std::vector<int> lengths;
+	std::vector<::MPI::Aint> displacements;
+	lengths.reserve(segments.size());
+	displacements.reserve(segments.size());
+	uint64_t size{0};
+	for (const auto &segment : segments) {
+		if (segment.size() == 0)
+			continue;
+		size += segment.size();
+		lengths.push_back(toMPICount(segment.size()));
+		displacements.push_back(::MPI::Get_address(
+		    const_cast<uint8_t *>(&segment[0])));
+	}
+	(void)toMPICount(size);
+	if (lengths.empty()) {
+		this->send(destination, tag, nullptr, 0);
+		return;
+	}
+
+	::MPI::Datatype gathered = ::MPI::BYTE.Create_hindexed(
+	    static_cast<int>(lengths.size()), lengths.data(),
+	    displacements.data());
+	gathered.Commit();
+	::MPI::COMM_WORLD.Send(::MPI::BOTTOM, 1, gathered, destination,
+	    to_int_type(tag));
+	gathered.Free();
+}
+
+std::unique_ptr<BiometricEvaluation::MPI::Transport::SendRequest>
+BiometricEvaluation::MPI::MPITransport::startSend(
+    int destination,
+    MessageTag tag,
+    const void *data,
+    uint64_t size)
+{
+	return (std::unique_ptr<SendRequest>(new MPISendRequest(
+	    ::MPI::COMM_WORLD.Isend(data, toMPICount(size), MPI_BYTE,
+	    destination, to_int_type(tag)))));
+}
+
+bool
+BiometricEvaluation::MPI::MPITransport::probe(
+    int source,
+    MessageTag tag,
+    int timeout,
+    int &actualSource,
+    uint64_t &size)
+{
+	::MPI::Status status;
+	if (timeout < 0) {
+		::MPI::COMM_WORLD.Probe(toMPISource(source), to_int_type(tag),
+		    status);
+	} else {
+		/*
+		 * MPI has no timed probe, so check again after a short
+		 * nap until the time is up.
+		 */
+		const auto end = std::chrono::steady_clock::now() +
+		    std::chrono::milliseconds(timeout);
+		while (!::MPI::COMM_WORLD.Iprobe(toMPISource(source),
+		    to_int_type(tag), status)) {
+			if (std::chrono::steady_clock::now() >= end)
+				return (false);
+			std::this_thread::sleep_for(
+			    std::chrono::microseconds(50));
+		}
+	}
+	actualSource = status.Get_source();
+	size = status.Get_count(MPI_BYTE);
+	return (true);
+}
+
+int
+BiometricEvaluation::MPI::MPITransport::receive(
+    int source,
+    MessageTag tag,
+    void *data,
+    uint64_t size)
+{
+	::MPI::Status status;
+	::MPI::COMM_WORLD.Recv(data, toMPICount(size), MPI_BYTE,
+	    toMPISource(source), to_int_type(tag), status);
+	return (status.Get_source());
+}
+
+void
+BiometricEvaluation::MPI::MPITransport::barrier()
+{
+	::MPI::COMM_WORLD.Barrier();
+}
+
+std::unique_ptr<BiometricEvaluation::MPI::Transport::MessageWaiter>
+BiometricEvaluation::MPI::MPITransport::newMessageWaiter()
+{
+	if (::MPI::Query_thread() != MPI_THREAD_MULTIPLE)
+		return (nullptr);
+	return (std::unique_ptr<MessageWaiter>(new ProbingMessageWaiter()));
+}
+
+void
+BiometricEvaluation::MPI::MPITransport::shutdown()
+{
+	::MPI::Finalize();
+}
+
+void
+BiometricEvaluation::MPI::MPITransport::abort(
+    int errcode)
+{
+	::MPI::COMM_WORLD.Abort(errcode);
+}
@@ -0,0 +1,101 @@
+/**
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties.  Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain.  NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+#ifndef _BE_MPI_MPITRANSPORT_IMPL_H
+#define _BE_MPI_MPITRANSPORT_IMPL_H
+
+#include <be_mpi_transport.h>
+
+namespace BiometricEvaluation {
+	namespace MPI {
+
+		/**
+		 * @brief
+		 * Transport over MPI, one MPI task per rank.
+		 */
+		class MPITransport : public Transport {
+		public:
+			/**
+			 * @brief
+			 * Initialize MPI.
+			 * @details
+			 * MPI_THREAD_MULTIPLE is requested so messages can
+			 * be waited for from a helper thread.
+			 * @param[in] argc
+			 * The argument count passed to main().
+			 * @param[in] argv
+			 * The argument vector passed to main().
+			 */
+			MPITransport(
+			    int &argc,
+			    char **&argv);
+
+			int getRank() const override;
+			int getNumTasks() const override;
+			std::string getProcessorName() const override;
+			std::vector<int> getNodes() override;
+
+			void send(
+			    int destination,
+			    MessageTag tag,
+			    const void *data,
+			    uint64_t size) override;
+			void send(
+			    int destination,
+			    MessageTag tag,
+			    const std::vector<Memory::uint8Array> &segments)
+			    override;
+			std::unique_ptr<SendRequest> startSend(
+			    int destination,
+			    MessageTag tag,
+			    const void *data,
+			    uint64_t size) override;
+			bool probe(
+			    int source,
+			    MessageTag tag,
+			    int timeout,
+			    int &actualSource,
+			    uint64_t &size) override;
+			int receive(
+			    int source,
+			    MessageTag tag,
+			    void *data,
+			    uint64_t size) override;
+			void barrier() override;
+
+			/**
+			 * @return
+			 * A MessageWaiter, or nullptr if the MPI
+			 * implementation does not support
+			 * MPI_THREAD_MULTIPLE.
+			 */
+			std::unique_ptr<MessageWaiter>
+			    newMessageWaiter() override;
+
+			/** Finalize MPI. */
+			void shutdown() override;
+			void abort(int errcode) override;
+
+			/*
+			 * Does not finalize MPI, as worker processes forked
+			 * from the task destroy their copy.
+			 */
+			~MPITransport();
+
+		private:
+			class ProbingMessageWaiter;
+			class MPISendRequest;
+
+			int _rank;
+			int _numTasks;
+		};
+	}
+}
+
+#endif /* _BE_MPI_MPITRANSPORT_IMPL_H */
@@ -0,0 +1,95 @@
+/**
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties.  Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain.  NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+#include <algorithm>
+#include <iterator>
+
+#include <be_error_exception.h>
+#include <be_mpi_rangeset.h>
+
+void
+BiometricEvaluation::MPI::RangeSet::insert(
+    uint64_t first,
+    uint64_t last)
+{
+	if (last < first)
+		throw Error::ParameterError("Range ends before it starts");
+
+	/*
+	 * Absorb every range that overlaps or adjoins the new one, taking
+	 * its positions out of the count, then add the combined range.
+	 */
+	auto it = this->_ranges.upper_bound(first);
+	if ((it != this->_ranges.begin()) &&
+	    ((first == 0) || (std::prev(it)->second >= first - 1)))
+		it = std::prev(it);
+	while ((it != this->_ranges.end()) &&
+	    ((last == UINT64_MAX) || (it->first <= last + 1))) {
+		first = std::min(first, it->first);
+		last = std::max(last, it->second);
+		this->_count -= it->second - it->first + 1;
+		it = this->_ranges.erase(it);
+	}
+	this->_ranges[first] = last;
+	this->_count += last - first + 1;
+}
+
+void
+BiometricEvaluation::MPI::RangeSet::insert(
+    uint64_t position)
+{
+	this->insert(position, position);
+}
+
+bool
+BiometricEvaluation::MPI::RangeSet::contains(
+    uint64_t position)
+    const
+{
+	auto it = this->_ranges.upper_bound(position);
+	if (it == this->_ranges.begin())
+		return (false);
+	return (std::prev(it)->second >= position);
+}
+
+uint64_t
+BiometricEvaluation::MPI::RangeSet::getFirstMissing(
+    uint64_t from)
+    const
+{
+	auto it = this->_ranges.upper_bound(from);
+	if (it == this->_ranges.begin())
+		return (from);
+	it = std::prev(it);
+	if (it->second < from)
+		return (from);
+	return (it->second + 1);
+}
+
+uint64_t
+BiometricEvaluation::MPI::RangeSet::getCount()
+    const
+{
+	return (this->_count);
+}
+
+std::vector<BiometricEvaluation::MPI::RangeSet::Range>
+BiometricEvaluation::MPI::RangeSet::getRanges()
+    const
+{
+	return (std::vector<Range>(this->_ranges.begin(),
+	    this->_ranges.end()));
+}
+
+bool
+BiometricEvaluation::MPI::RangeSet::empty()
+    const
+{
+	return (this->_ranges.empty());
+}
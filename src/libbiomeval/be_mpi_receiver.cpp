@@ -7,12 +7,21 @@
  * its use by other parties, and makes no guarantees, expressed or implied,
  * about its quality, reliability, or any other characteristic.
  */
+#include <cstring>
+#include <deque>
+#include <mutex>
 #include <set>
 #include <sstream>
-#include <mpi.h>
+#include <thread>
+#include <poll.h>
 #include <signal.h>
+#include <sys/mman.h>
 #include <time.h>
+#include <unistd.h>
 
+#include <be_error.h>
+#include <be_io_utility.h>
+#include <be_memory.h>
 #include <be_memory_autoarrayutility.h>
 #include <be_mpi.h>
 #include <be_mpi_exception.h>
@@ -47,23 +56,46 @@ static void commandToMessage(
 }
 
 /*
- * Convert a message to a task status.
+ * Convert a message to a task status. Results may follow the status,
+ * after a NUL.
  */
 static BiometricEvaluation::MPI::TaskStatus
 messageToStatus(const BE::Memory::uint8Array &message)
 {
-	return (to_enum<BE::MPI::TaskStatus>(std::stoi(to_string(message))));
+	const char *status = reinterpret_cast<const char *>(&message[0]);
+	return (to_enum<BE::MPI::TaskStatus>(std::stoi(std::string(status,
+	    ::strnlen(status, message.size())))));
 }
 
 /*
- * Convert a task status to a message.
+ * Convert a task status to a message, followed by results if any.
  */
 static void statusToMessage(
     const BiometricEvaluation::MPI::TaskStatus taskStatus,
-    BE::Memory::uint8Array &message)
+    BE::Memory::uint8Array &message,
+    const BE::MPI::ResultBatch &results = BE::MPI::ResultBatch())
 {
 	BE::Memory::AutoArrayUtility::setString(message,
 	    std::to_string(to_int_type(taskStatus)));
+	if (results.empty())
+		return;
+
+	/* setString() leaves the NUL as the last element */
+	const uint64_t offset = message.size();
+	message.resize(offset + results.getSize());
+	std::memcpy(&message[offset], results.getData(), results.getSize());
+}
+
+/*
+ * Read everything available from a non-blocking descriptor.
+ */
+static void
+drainDescriptor(
+    int fd)
+{
+	char buf[64];
+	while (::read(fd, buf, sizeof(buf)) > 0)
+		;
 }
 
 /******************************************************************************/
@@ -74,10 +106,78 @@ static void statusToMessage(
  */
 BiometricEvaluation::MPI::Receiver::PackageWorker::PackageWorker(
     const std::shared_ptr<MPI::WorkPackageProcessor> &workPackageProcessor,
-    const std::shared_ptr<MPI::Resources> &resources)
+    const std::shared_ptr<MPI::Resources> &resources,
+    int workerNumber) :
+    _threaded{resources->useThreadedWorkers()},
+    _workerNumber{workerNumber}
 {
 	this->_workPackageProcessor = workPackageProcessor;
 	this->_resources = resources;
+
+	/*
+	 * Map the memory shared with the worker now, so the worker
+	 * process inherits it when forked. If the mapping can't be made,
+	 * work packages go through the pipe. Worker threads are handed
+	 * work packages directly.
+	 */
+	const uint64_t size = resources->getWorkerSharedMemorySize();
+	if ((size != 0) && !this->_threaded) {
+		void *sharedMemory = ::mmap(nullptr, size,
+		    PROT_READ | PROT_WRITE,
+		    MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if (sharedMemory != MAP_FAILED) {
+			this->_sharedMemory =
+			    static_cast<uint8_t *>(sharedMemory);
+			this->_sharedMemorySize = size;
+		}
+	}
+}
+
+uint8_t *
+BiometricEvaluation::MPI::Receiver::PackageWorker::getSharedMemory() const
+{
+	return (this->_sharedMemory);
+}
+
+uint64_t
+BiometricEvaluation::MPI::Receiver::PackageWorker::getSharedMemorySize()
+    const
+{
+	return (this->_sharedMemorySize);
+}
+
+void
+BiometricEvaluation::MPI::Receiver::PackageWorker::setWorkPackage(
+    MPI::WorkPackage &&workPackage)
+{
+	std::lock_guard<std::mutex> lock(this->_workPackageMutex);
+	this->_workPackage = std::move(workPackage);
+}
+
+uint64_t
+BiometricEvaluation::MPI::Receiver::PackageWorker::getPackageID() const
+{
+	return (this->_packageID);
+}
+
+void
+BiometricEvaluation::MPI::Receiver::PackageWorker::setPackageID(
+    uint64_t id)
+{
+	this->_packageID = id;
+}
+
+BiometricEvaluation::MPI::Telemetry::Clock::time_point
+BiometricEvaluation::MPI::Receiver::PackageWorker::getPackageStart() const
+{
+	return (this->_packageStart);
+}
+
+void
+BiometricEvaluation::MPI::Receiver::PackageWorker::setPackageStart(
+    MPI::Telemetry::Clock::time_point start)
+{
+	this->_packageStart = start;
 }
 
 int32_t
@@ -88,10 +188,16 @@ BiometricEvaluation::MPI::Receiver::PackageWorker::workerMain()
 	 * we are finished.
 	 */
 	try {
-		this->_logsheet =
-		    BE::MPI::openLogsheet(
-			this->_resources->getLogsheetURL(),
-			"MPI::Worker");
+		/*
+		 * Worker threads share the process ID that names the
+		 * Receiver's log file, so add the worker number.
+		 */
+		std::string url = this->_resources->getLogsheetURL();
+		if (this->_threaded && (url != "") &&
+		    (IO::Logsheet::getTypeFromURL(url) ==
+		    IO::Logsheet::Kind::File))
+			url += "-worker" + std::to_string(this->_workerNumber);
+		this->_logsheet = BE::MPI::openLogsheet(url, "MPI::Worker");
 	} catch (const Error::Exception &e) {
 		MPI::printStatus("Worker failed to open log sheet (" +
 		    e.whatString() +  ')');
@@ -101,7 +207,8 @@ BiometricEvaluation::MPI::Receiver::PackageWorker::workerMain()
 
 	/*
 	 * At this point, we are in a child process with its
-	 * own copy of the package processor object.
+	 * own copy of the package processor object, or in a
+	 * thread sharing the Receiver's.
 	 */
 	BiometricEvaluation::MPI::WorkPackage workPackage;
 	BE::Memory::uint8Array message;
@@ -114,8 +221,14 @@ BiometricEvaluation::MPI::Receiver::PackageWorker::workerMain()
 	 * file references and resources.
 	 */
 	try {
-		this->_workPackageProcessor =
-		    this->_workPackageProcessor->newProcessor(this->_logsheet);
+		if (this->_threaded)
+			this->_workPackageProcessor =
+			    this->_workPackageProcessor->newThreadedProcessor(
+			    this->_logsheet);
+		else
+			this->_workPackageProcessor =
+			    this->_workPackageProcessor->newProcessor(
+			    this->_logsheet);
 	} catch (const BE::Error::Exception &e) {
 		std::string error{"Worker failed to create a child package "
 		    "processor (" + e.whatString() + ")"};
@@ -159,9 +272,15 @@ BiometricEvaluation::MPI::Receiver::PackageWorker::workerMain()
 
 		/*
 		 * Send a status message to report status, asking for more
-		 * work unless we are in a bad state; then exit.
+		 * work unless we are in a bad state; then exit. Results
+		 * of the previous work package go along with it.
 		 */
-		statusToMessage(taskStatus, message);
+		const MPI::ResultBatch results =
+		    this->_workPackageProcessor->takeResults();
+		if (this->_resources->getResultRecordStore().empty())
+			statusToMessage(taskStatus, message);
+		else
+			statusToMessage(taskStatus, message, results);
 		try {
 			this->sendMessageToManager(message);
 			if (taskStatus != MPI::TaskStatus::OK) {
@@ -207,9 +326,39 @@ BiometricEvaluation::MPI::Receiver::PackageWorker::workerMain()
 			this->receiveMessageFromManager(message);
 			uint64_t wpCount;
 			std::memcpy(&wpCount, &message[0], sizeof(wpCount));
-			this->waitForMessage();
-			this->receiveMessageFromManager(message);
-			workPackage = MPI::WorkPackage(message);
+			if (this->_threaded) {
+				/* Package was handed over in memory */
+				std::lock_guard<std::mutex> lock(
+				    this->_workPackageMutex);
+				workPackage = std::move(this->_workPackage);
+				this->_workPackage = MPI::WorkPackage();
+			} else if (message.size() == (2 * sizeof(uint64_t))) {
+				/*
+				 * Package data is in shared memory. It is
+				 * copied out once: a package owns its data,
+				 * which the processor may keep past this
+				 * package, while the Receiver writes the
+				 * next package over the region as soon as
+				 * we ask for more work.
+				 */
+				uint64_t wpSize;
+				std::memcpy(&wpSize, &message[sizeof(wpCount)],
+				    sizeof(wpSize));
+				if ((this->_sharedMemory == nullptr) ||
+				    (wpSize > this->_sharedMemorySize))
+					throw Error::StrategyError("Invalid "
+					    "shared memory package size");
+				message = BE::Memory::uint8Array(wpSize);
+				if (wpSize != 0)
+					std::memcpy(&message[0],
+					    this->_sharedMemory, wpSize);
+			} else {
+				this->waitForMessage();
+				this->receiveMessageFromManager(message);
+			}
+			if (!this->_threaded)
+				workPackage = MPI::WorkPackage(
+				    std::move(message));
 			workPackage.setNumElements(wpCount);
 		} catch (const Error::Exception &e) {
 			MPI::logMessage(*log, "Failed to receive work package: "
@@ -242,15 +391,26 @@ BiometricEvaluation::MPI::Receiver::PackageWorker::workerMain()
 
 BiometricEvaluation::MPI::Receiver::PackageWorker::~PackageWorker()
 {
+	if (this->_sharedMemory != nullptr)
+		::munmap(this->_sharedMemory, this->_sharedMemorySize);
 }
 
 BiometricEvaluation::MPI::Receiver::Receiver(
     const std::string &propertiesFileName,
     const std::shared_ptr<BiometricEvaluation::MPI::WorkPackageProcessor>
-        &workPackageProcessor)
+        &workPackageProcessor) :
+    _transport{MPI::getTransport()}
 {
+	if (this->_transport == nullptr)
+		throw Error::ObjectDoesNotExist("MPI::Runtime has not been "
+		    "constructed");
 	this->_workPackageProcessor = workPackageProcessor;
 	this->_resources.reset(new Resources(propertiesFileName));
+	this->_telemetry = MPI::Telemetry(this->_transport->getRank());
+	if (this->_resources->useThreadedWorkers())
+		this->_processManager.reset(new Process::POSIXThreadManager());
+	else
+		this->_processManager.reset(new Process::ForkManager());
 }
 
 /******************************************************************************/
@@ -260,20 +420,126 @@ BiometricEvaluation::MPI::Receiver::~Receiver()
 {
 }
 
-void
+bool
 BiometricEvaluation::MPI::Receiver::sendWorkPackage(
     MPI::WorkPackage &workPackage)
 {
 	/*
-	 * While there is some worker available, send the work package
-	 * to the first worker from which we receive a request. If that
-	 * worker wants to go on furlough, we move on to the next worker.
-	 * If there are no more workers to process the package, then
-	 * we log the fact that the package is lost and return.
+	 * Send the work package to a worker that asked for work while
+	 * none was queued, or else to the first worker from which we
+	 * receive a request. If no worker is ready, return so the caller
+	 * can tend to messages from Task-0 before trying again.
 	 */
 	std::shared_ptr<Process::WorkerController> worker;
 	BE::Memory::uint8Array message;
-	BE::Memory::uint8Array wpData;
+	BE::IO::Logsheet *log = this->_logsheet.get();
+
+	if (!this->_readyWorkers.empty()) {
+		this->receiveOutOfBand();
+		if (MPI::QuickExit || MPI::TermExit)
+			return (false);
+		worker = this->_readyWorkers.front();
+		this->_readyWorkers.pop_front();
+	} else {
+		worker = this->takeReadyWorker();
+		if (worker == nullptr)
+			return (false);
+	}
+
+	/*
+	 * Tell the worker to continue on.
+	 */
+	commandToMessage(MPI::TaskCommand::Continue, message);
+	worker->sendMessageToWorker(message);
+			
+	/*
+	 * A work package is sent in two parts: 
+	 * The number of elements, and the raw data.
+	 *
+	 * When the data fits in the memory shared with the worker, it
+	 * is placed there instead, and its size follows the number of
+	 * elements. The worker only asks for work once it is done with
+	 * the previous package, so the memory is not in use.
+	 */
+	uint64_t wpCount = workPackage.getNumElements();
+	const BE::Memory::uint8Array &wpData = workPackage.getData();
+	const uint64_t wpSize = wpData.size();
+	const auto packageWorker = std::dynamic_pointer_cast<PackageWorker>(
+	    worker->getWorker());
+	if (this->_nodeLeader)
+		this->_telemetry.countPackage(wpCount, wpSize);
+	if (packageWorker != nullptr) {
+		packageWorker->setPackageID(workPackage.getID());
+		packageWorker->setPackageStart(MPI::Telemetry::Clock::now());
+	}
+	if ((packageWorker != nullptr) &&
+	    this->_resources->useThreadedWorkers()) {
+		/* A worker thread takes the package itself */
+		packageWorker->setWorkPackage(std::move(workPackage));
+		message.resize(sizeof(wpCount));
+		std::memcpy(&message[0], &wpCount, sizeof(wpCount));
+		worker->sendMessageToWorker(message);
+		*log << "Handed work package of size " << wpSize <<
+		    " to worker thread";
+	} else if ((packageWorker != nullptr) &&
+	    (packageWorker->getSharedMemory() != nullptr) &&
+	    (wpSize <= packageWorker->getSharedMemorySize())) {
+		if (wpSize != 0)
+			std::memcpy(packageWorker->getSharedMemory(), wpData,
+			    wpSize);
+		message.resize(2 * sizeof(uint64_t));
+		std::memcpy(&message[0], &wpCount, sizeof(wpCount));
+		std::memcpy(&message[sizeof(wpCount)], &wpSize,
+		    sizeof(wpSize));
+		worker->sendMessageToWorker(message);
+		*log << "Sent work package of size " << wpSize <<
+		    " to worker (shared memory)";
+	} else {
+		message.resize(sizeof(wpCount));
+		std::memcpy(&message[0], &wpCount, sizeof(wpCount));
+		worker->sendMessageToWorker(message);
+		worker->sendMessageToWorker(wpData);
+		*log << "Sent work package of size " << wpSize <<
+		    " to worker";
+	}
+	MPI::logEntry(*log);
+	return (true);
+}
+
+void
+BiometricEvaluation::MPI::Receiver::receiveOutOfBand()
+{
+	BE::IO::Logsheet *log = this->_logsheet.get();
+	int source;
+	uint64_t size;
+	if (!this->_transport->probe(this->_workSource, MPI::MessageTag::OOB,
+	    0, source, size))
+		return;
+
+	const MPI::taskcmd_t oobCmd =
+	    this->_transport->receiveValue<MPI::taskcmd_t>(this->_workSource,
+	    MPI::MessageTag::OOB);
+	const auto oobCmdE = to_enum<TaskCommand>(oobCmd);
+
+	/* A node leader passes the command on to the tasks it serves */
+	for (const auto member : this->_members)
+		this->_transport->sendValue(member, MPI::MessageTag::OOB,
+		    oobCmd);
+	if (oobCmdE == MPI::TaskCommand::QuickExit) {
+		MPI::logMessage(*log, "OOB Quick Exit received");
+		MPI::QuickExit = true;
+	}
+	if (oobCmdE == MPI::TaskCommand::TermExit) {
+		MPI::logMessage(*log, "OOB Term Exit received");
+		MPI::TermExit = true;
+	}
+}
+
+std::shared_ptr<BiometricEvaluation::Process::WorkerController>
+BiometricEvaluation::MPI::Receiver::takeReadyWorker()
+{
+	std::shared_ptr<Process::WorkerController> worker;
+	BE::Memory::uint8Array message;
 	MPI::TaskStatus taskStatus;
 	BE::IO::Logsheet *log = this->_logsheet.get();
 
@@ -283,7 +549,7 @@ BiometricEvaluation::MPI::Receiver::sendWorkPackage(
 	 * is exiting, and when there may be no more workers.
 	 */
 	while (true) {
-		if (this->_processManager.getNumActiveWorkers() == 0)
+		if (this->_processManager->getNumActiveWorkers() == 0)
 			throw (Error::StrategyError("No workers"));
 
 		/*
@@ -293,22 +559,7 @@ BiometricEvaluation::MPI::Receiver::sendWorkPackage(
  		 * because we can be waiting a long time for a worker
  		 * to request a work package.
  		 */
-		bool oobmsg = ::MPI::COMM_WORLD.Iprobe(0,
-		    to_int_type(MPI::MessageTag::OOB));
-		if (oobmsg) {
-			MPI::taskcmd_t oobCmd;
-			::MPI::COMM_WORLD.Recv((void *)&oobCmd, 1, MPI_INT32_T,
-			    0, to_int_type(MPI::MessageTag::OOB));
-			const auto oobCmdE = to_enum<TaskCommand>(oobCmd);
-			if (oobCmdE == MPI::TaskCommand::QuickExit) {
-				MPI::logMessage(*log, "OOB Quick Exit received");
-				MPI::QuickExit = true;
-			}
-			if (oobCmdE == MPI::TaskCommand::TermExit) {
-				MPI::logMessage(*log, "OOB Term Exit received");
-				MPI::TermExit = true;
-			}
-		}
+		this->receiveOutOfBand();
 
  		 /*
 		 * If Quick or Term Exit, do not send out the work package.
@@ -316,28 +567,21 @@ BiometricEvaluation::MPI::Receiver::sendWorkPackage(
 		 * Receiver is not done here.
 		 */
 		if (MPI::QuickExit || MPI::TermExit) {
-			return;
+			return (nullptr);
 		}
 
-		/*
- 		 * If no worker is ready, pause for a bit, then go back
- 		 * to the top of the loop and start over.
- 		 */
 		bool msgAvail =
-		    this->_processManager.getNextMessage(worker, message, 0);
-		if (!msgAvail) {
-			struct timespec ts;
-			ts.tv_sec = 0;
-			ts.tv_nsec = 100000000L;	/* 100 milliseconds */
-			nanosleep(&ts, NULL);
-			continue;
-		}
+		    this->_processManager->getNextMessage(worker, message, 0);
+		if (!msgAvail)
+			return (nullptr);
 
 		/*
-		 * Once a worker is ready, we're dedicated to sending off
-		 * the work package, so no checks for Exit conditions here.
+		 * Once a worker is ready, it waits for the next work
+		 * package, so no checks for Exit conditions here.
 		 */
-		taskStatus = messageToStatus(message);
+		taskStatus = this->takeWorkerStatus(
+		    dynamic_cast<PackageWorker *>(worker->getWorker().get()),
+		    message);
 
 		/*
 		 * When a worker gets into trouble, have it stop processing.
@@ -346,7 +590,7 @@ BiometricEvaluation::MPI::Receiver::sendWorkPackage(
 			throw MPI::TerminateJob();
 		if (taskStatus != MPI::TaskStatus::OK) {
 			try {  
-				this->_processManager.stopWorker(worker);
+				this->_processManager->stopWorker(worker);
 			} catch (const Error::Exception &e) {
 				MPI::logMessage(*log,
 				    "Task-N stopping worker: Caught: "
@@ -356,39 +600,313 @@ BiometricEvaluation::MPI::Receiver::sendWorkPackage(
 			break;
 		}
 	}
+	return (worker);
+}
+
+BiometricEvaluation::MPI::TaskCommand
+BiometricEvaluation::MPI::Receiver::receiveWorkPackage(
+    std::deque<MPI::WorkPackage> &workPackages)
+{
+	BE::IO::Logsheet *log = this->_logsheet.get();
+
+	const BE::MPI::TaskCommand taskCommandE = to_enum<TaskCommand>(
+	    this->_transport->receiveValue<MPI::taskcmd_t>(this->_workSource,
+	    MPI::MessageTag::Control));
+	MPI::logMessage(*log, to_string(taskCommandE) + " command");
+	if (taskCommandE != MPI::TaskCommand::Continue)
+		return (taskCommandE);
 
 	/*
-	 * Tell the worker to continue on.
+	 * Receive three pieces of information:
+	 * The raw data and length in the first message;
+	 * The number of elements and the package ID in the second message.
 	 */
-	commandToMessage(MPI::TaskCommand::Continue, message);
-	worker->sendMessageToWorker(message);
-			
+	int source;
+	uint64_t length;
+	{
+		MPI::Telemetry::BlockedTimer timer(this->_telemetry);
+		(void)this->_transport->probe(this->_workSource,
+		    MPI::MessageTag::Data, -1, source, length);
+	}
+	BE::Memory::uint8Array workPackageRaw(length);
+	(void)this->_transport->receive(this->_workSource,
+	    MPI::MessageTag::Data, workPackageRaw, length);
+
+	uint64_t header[2];
+	(void)this->_transport->receive(this->_workSource,
+	    MPI::MessageTag::Data, header, sizeof(header));
+
+	if (this->_nodeLeader) {
+		this->splitWorkPackages(workPackageRaw, header[0],
+		    workPackages);
+		return (taskCommandE);
+	}
+
+	MPI::WorkPackage workPackage(std::move(workPackageRaw));
+	workPackage.setNumElements(header[0]);
+	workPackage.setID(header[1]);
+	this->_telemetry.countPackage(header[0], length);
+	workPackages.push_back(std::move(workPackage));
+	return (taskCommandE);
+}
+
+void
+BiometricEvaluation::MPI::Receiver::splitWorkPackages(
+    const Memory::uint8Array &data,
+    uint64_t numPackages,
+    std::deque<MPI::WorkPackage> &workPackages)
+{
 	/*
-	 * A work package is sent in two parts: 
-	 * The number of elements, and the raw data.
+	 * Each package is preceded by its number of elements, ID, and
+	 * size, as written by Distributor::sendWorkPackages().
 	 */
-	uint64_t wpCount = workPackage.getNumElements();
-	message.resize(sizeof(wpCount));
-	std::memcpy(&message[0], &wpCount, sizeof(wpCount));
-	worker->sendMessageToWorker(message);
-	workPackage.getData(wpData);
-	worker->sendMessageToWorker(wpData);
-	*log << "Sent work package of size " << wpData.size() << " to worker";
+	uint64_t offset{0};
+	for (uint64_t i = 0; i < numPackages; i++) {
+		uint64_t frame[3];
+		if ((data.size() - offset) < sizeof(frame))
+			throw Error::DataError("Truncated work packages");
+		std::memcpy(frame, &data[offset], sizeof(frame));
+		offset += sizeof(frame);
+		if ((data.size() - offset) < frame[2])
+			throw Error::DataError("Truncated work packages");
+
+		BE::Memory::uint8Array packageData(frame[2]);
+		if (frame[2] != 0)
+			std::memcpy(packageData, &data[offset], frame[2]);
+		offset += frame[2];
+
+		MPI::WorkPackage workPackage(std::move(packageData));
+		workPackage.setNumElements(frame[0]);
+		workPackage.setID(frame[1]);
+		workPackages.push_back(std::move(workPackage));
+	}
+}
+
+void
+BiometricEvaluation::MPI::Receiver::forwardWorkPackage(
+    MPI::WorkPackage &workPackage,
+    int member)
+{
+	/* As Task-0 sends a package; see receiveWorkPackage() */
+	this->_transport->sendValue(member, MPI::MessageTag::Control,
+	    static_cast<MPI::taskcmd_t>(to_int_type(
+	    MPI::TaskCommand::Continue)));
+	this->_transport->send(member, MPI::MessageTag::Data,
+	    workPackage.getData(), workPackage.getSize());
+	const uint64_t header[2]{workPackage.getNumElements(),
+	    workPackage.getID()};
+	this->_transport->send(member, MPI::MessageTag::Data, header,
+	    sizeof(header));
+
+	BE::IO::Logsheet *log = this->_logsheet.get();
+	*log << "Sent work package of size " << workPackage.getSize() <<
+	    " to Task-" << member;
 	MPI::logEntry(*log);
 }
 
+void
+BiometricEvaluation::MPI::Receiver::serveMembers(
+    std::deque<MPI::WorkPackage> &workPackages,
+    bool ending,
+    MPI::TaskCommand endCommand)
+{
+	BE::IO::Logsheet *log = this->_logsheet.get();
+
+	/*
+	 * Requests are taken from each task in turn, as Task-0 takes
+	 * them from us, and answered in the order they arrive.
+	 */
+	for (auto it = this->_members.begin(); it != this->_members.end(); ) {
+		const int member = *it;
+		bool ended{false};
+		int source;
+		uint64_t size;
+		while (this->_transport->probe(member, MPI::MessageTag::Control,
+		    0, source, size)) {
+			const MPI::taskstat_t status =
+			    this->_transport->receiveValue<MPI::taskstat_t>(
+			    member, MPI::MessageTag::Control);
+			const auto ts = to_enum<MPI::TaskStatus>(status);
+			if (ts == MPI::TaskStatus::OK) {
+				this->_memberRequests.push_back(member);
+				continue;
+			}
+			if (ts == MPI::TaskStatus::RequestJobTermination) {
+				this->_transport->sendValue(0,
+				    MPI::MessageTag::Control, status);
+				continue;
+			}
+			ended = true;
+			break;
+		}
+		if (!ended) {
+			++it;
+			continue;
+		}
+
+		/* The task takes answers to its held requests */
+		*log << "Received Exit/Failure from Task-" << member;
+		MPI::logEntry(*log);
+		for (auto request = this->_memberRequests.begin();
+		    request != this->_memberRequests.end(); ) {
+			if (*request != member) {
+				++request;
+				continue;
+			}
+			this->_transport->sendValue(member,
+			    MPI::MessageTag::Control,
+			    static_cast<MPI::taskcmd_t>(to_int_type(
+			    MPI::TaskCommand::Ignore)));
+			request = this->_memberRequests.erase(request);
+		}
+		it = this->_members.erase(it);
+	}
+
+	while (!this->_memberRequests.empty() &&
+	    (ending || !workPackages.empty())) {
+		const int member = this->_memberRequests.front();
+		this->_memberRequests.pop_front();
+		if (ending) {
+			this->_transport->sendValue(member,
+			    MPI::MessageTag::Control,
+			    static_cast<MPI::taskcmd_t>(to_int_type(
+			    endCommand)));
+			continue;
+		}
+		this->forwardWorkPackage(workPackages.front(), member);
+		workPackages.pop_front();
+	}
+}
+
+void
+BiometricEvaluation::MPI::Receiver::endMembers(
+    std::deque<MPI::WorkPackage> &workPackages,
+    MPI::TaskCommand endCommand,
+    MPI::Transport::MessageWaiter *messageWaiter)
+{
+	if (this->_members.empty())
+		return;
+	MPI::logMessage(*this->_logsheet, "Ending served tasks");
+
+	/* Tasks that are to stop now hear so at once */
+	if ((endCommand == MPI::TaskCommand::QuickExit) ||
+	    (endCommand == MPI::TaskCommand::TermExit))
+		for (const auto member : this->_members)
+			this->_transport->sendValue(member,
+			    MPI::MessageTag::OOB,
+			    static_cast<MPI::taskcmd_t>(to_int_type(
+			    endCommand)));
+
+	/*
+	 * Each task asks for work until told to end, then says it
+	 * has; packages still queued are no longer handed out.
+	 */
+	while (true) {
+		this->receiveOutOfBand();
+		if (this->returnsResults())
+			this->exchangeResults();
+		this->reportCompletions();
+		this->serveMembers(workPackages, true, endCommand);
+		if (this->_members.empty())
+			break;
+		this->waitForEvent(messageWaiter, true, false);
+	}
+}
+
+void
+BiometricEvaluation::MPI::Receiver::endWorkPackageRequests(
+    const MPI::TaskStatus &taskStatus,
+    uint32_t &numRequests,
+    std::deque<MPI::WorkPackage> &workPackages)
+{
+	/*
+	 * Tell Task-0 that no more requests will follow, then take its
+	 * answers to the requests still outstanding so the send/recv
+	 * pairs stay in sync.
+	 */
+	this->_transport->sendValue(this->_workSource, MPI::MessageTag::Control,
+	    static_cast<MPI::taskstat_t>(to_int_type(taskStatus)));
+	for (; numRequests > 0; numRequests--)
+		(void)this->receiveWorkPackage(workPackages);
+}
+
+void
+BiometricEvaluation::MPI::Receiver::waitForEvent(
+    MPI::Transport::MessageWaiter *messageWaiter,
+    bool replyExpected,
+    bool includeWorkers)
+{
+	std::vector<struct pollfd> fds;
+	if (includeWorkers)
+		for (const auto fd :
+		    this->_processManager->getReceivingPipes())
+			fds.push_back({fd, POLLIN, 0});
+	if (MPI::signalDescriptor != -1)
+		fds.push_back({MPI::signalDescriptor, POLLIN, 0});
+
+	/*
+	 * Without a message waiter, wake periodically to check for
+	 * messages from Task-0, more often when a reply is expected.
+	 * With one, the timeout is only a safety net.
+	 */
+	int timeout;
+	if (messageWaiter != nullptr) {
+		messageWaiter->rearm();
+		fds.push_back({messageWaiter->getDescriptor(), POLLIN, 0});
+		timeout = 1000;
+	} else {
+		timeout = (replyExpected ? 10 : 100);
+	}
+
+	MPI::Telemetry::BlockedTimer timer(this->_telemetry);
+	if (::poll(fds.data(), fds.size(), timeout) > 0 &&
+	    (MPI::signalDescriptor != -1)) {
+		for (const auto &fd : fds)
+			if ((fd.fd == MPI::signalDescriptor) &&
+			    (fd.revents & POLLIN))
+				drainDescriptor(fd.fd);
+	}
+}
+
 BiometricEvaluation::MPI::TaskStatus
 BiometricEvaluation::MPI::Receiver::requestWorkPackages()
 {
-	BE::Memory::uint8Array workPackageRaw(0);
-
-	::MPI::Status MPIstatus;
-	BE::MPI::taskstat_t taskStatus;
-	BE::MPI::taskcmd_t taskCommand;
 	MPI::TaskStatus status = MPI::TaskStatus::OK;
 	BE::IO::Logsheet *log = this->_logsheet.get();
 
-	while (true) {
+	/*
+	 * Each request sent to Task-0 is a credit that Task-0 answers,
+	 * in order, with a command and possibly a work package. Keep
+	 * up to the prefetch count of packages requested or queued, so
+	 * that a worker becoming free is handed a package without
+	 * waiting on Task-0. After the first, a request is sent as each
+	 * queued package is taken, but several may be sent together, so
+	 * Task-0 measures throughput from completion reports instead.
+	 */
+	const uint64_t served = this->_members.size() + 1;
+	const uint64_t prefetch = this->_resources->getPrefetchPackages() *
+	    served;
+	std::deque<MPI::WorkPackage> workPackages;
+	uint32_t numRequests = 0;
+	bool requesting = true;
+	MPI::TaskCommand endCommand = MPI::TaskCommand::Exit;
+
+	std::unique_ptr<MPI::Transport::MessageWaiter> messageWaiter;
+	try {
+		messageWaiter = this->_transport->newMessageWaiter();
+	} catch (const Error::Exception &e) {
+		MPI::logMessage(*log, "Polling for messages: " +
+		    e.whatString());
+	}
+
+	while (requesting || !workPackages.empty()) {
+
+		/*
+		 * Take an out-of-band command whatever else is done this
+		 * time around: left pending, it would wake the message
+		 * waiter at once, and we would spin until it was taken.
+		 */
+		this->receiveOutOfBand();
 
 		/*
 		 * Check local exit conditions.
@@ -397,105 +915,377 @@ BiometricEvaluation::MPI::Receiver::requestWorkPackages()
 		 */
 		if (MPI::Exit) {
 			MPI::logMessage(*log, "Exit signal");
-			taskStatus = to_int_type(MPI::TaskStatus::Exit);
-			::MPI::COMM_WORLD.Send(
-			    (void *)&taskStatus, 1, MPI_INT32_T,
-			    0, to_int_type(MPI::MessageTag::Control));
 			status = MPI::TaskStatus::Exit;
 			break;
 		}
 		if (MPI::QuickExit) {
 			MPI::logMessage(*log, "Quick Exit signal");
-			this->_processManager.broadcastSignal(SIGINT);
-			taskStatus = to_int_type(MPI::TaskStatus::Exit);
-			::MPI::COMM_WORLD.Send(
-			    (void *)&taskStatus, 1, MPI_INT32_T,
-			    0, to_int_type(MPI::MessageTag::Control));
+			endCommand = MPI::TaskCommand::QuickExit;
+			this->signalWorkers(SIGINT);
 			status = MPI::TaskStatus::Exit;
 			break;
 		}
 		if (MPI::TermExit) {
 			MPI::logMessage(*log, "Termination Exit signal");
-			this->_processManager.broadcastSignal(SIGKILL);
-			taskStatus = to_int_type(MPI::TaskStatus::Exit);
-			::MPI::COMM_WORLD.Send(
-			    (void *)&taskStatus, 1, MPI_INT32_T,
-			    0, to_int_type(MPI::MessageTag::Control));
+			endCommand = MPI::TaskCommand::TermExit;
+			this->signalWorkers(SIGKILL);
 			status = MPI::TaskStatus::Exit;
 			break;
 		}
 
-		MPI::logMessage(*log, "Asking for work package");
-		taskStatus = to_int_type(MPI::TaskStatus::OK);
-		::MPI::COMM_WORLD.Sendrecv(
-		    (void *)&taskStatus, 1, MPI_INT32_T, 0,
-		    to_int_type(MPI::MessageTag::Control), &taskCommand, 1,
-		    MPI_INT32_T, 0, to_int_type(MPI::MessageTag::Control));
-
-		const BE::MPI::TaskCommand  taskCommandE =
-		    to_enum<TaskCommand>(taskCommand);
-		MPI::logMessage(*log, to_string(taskCommandE) + " command");
-		if (taskCommandE == MPI::TaskCommand::Ignore) {
-			continue;
+		if (this->returnsResults())
+			this->exchangeResults();
+		this->reportCompletions();
+		this->reportTelemetry(workPackages.size());
+		if (this->_nodeLeader)
+			this->serveMembers(workPackages, false, endCommand);
+
+		/* A node leader is sent a package per task it serves */
+		while (requesting &&
+		    (((numRequests * served) + workPackages.size()) <
+		    prefetch)) {
+			MPI::logMessage(*log, "Asking for work package");
+			this->_transport->sendValue(this->_workSource,
+			    MPI::MessageTag::Control,
+			    static_cast<MPI::taskstat_t>(
+			    to_int_type(MPI::TaskStatus::OK)));
+			numRequests++;
 		}
-		if (taskCommandE == MPI::TaskCommand::Exit) {
-			break;
-		}		
-		if (taskCommandE == MPI::TaskCommand::QuickExit) {
-			this->_processManager.broadcastSignal(SIGINT);
-			break;
-		}		
-		if (taskCommandE == MPI::TaskCommand::TermExit) {
-			this->_processManager.broadcastSignal(SIGKILL);
-			break;
-		}		
+
 		/*
-		 * Receive three pieces of information:
-		 * The raw data and length in the first message;
-		 * The number of elements in the second message.
+		 * Take answers from Task-0 as they arrive.
 		 */
-		::MPI::COMM_WORLD.Probe(0, to_int_type(MPI::MessageTag::Data),
-		    MPIstatus);
-		uint64_t length = MPIstatus.Get_count(MPI_CHAR);
-		workPackageRaw.resize(length);
-		::MPI::COMM_WORLD.Recv(
-		    (void *)&workPackageRaw[0], length, MPI_CHAR, 0,
-		    to_int_type(MPI::MessageTag::Data));
-		workPackageRaw.resize(length);
-
-		uint64_t numElements;
-		::MPI::COMM_WORLD.Recv(
-		    (void *)&numElements, 1, MPI_UINT64_T, 0,
-		    to_int_type(MPI::MessageTag::Data));
+		int source;
+		uint64_t size;
+		if ((numRequests > 0) &&
+		    this->_transport->probe(this->_workSource,
+		    MPI::MessageTag::Control, 0, source, size)) {
+			const BE::MPI::TaskCommand taskCommand =
+			    this->receiveWorkPackage(workPackages);
+			numRequests--;
+			if ((taskCommand == MPI::TaskCommand::Continue) ||
+			    (taskCommand == MPI::TaskCommand::Ignore))
+				continue;
+
+			/*
+			 * Task-0 is shutting down. On Exit, packages
+			 * already queued are still handed to workers.
+			 */
+			requesting = false;
+			endCommand = taskCommand;
+			this->endWorkPackageRequests(MPI::TaskStatus::Exit,
+			    numRequests, workPackages);
+			if (taskCommand == MPI::TaskCommand::QuickExit) {
+				this->signalWorkers(SIGINT);
+				break;
+			}
+			if (taskCommand == MPI::TaskCommand::TermExit) {
+				this->signalWorkers(SIGKILL);
+				break;
+			}
+			continue;
+		}
+
+		/* Tasks served by a node leader expect quick replies too */
+		const bool replyExpected = (numRequests > 0) ||
+		    !this->_members.empty();
 		try {
-			MPI::WorkPackage workPackage(workPackageRaw);
-			workPackage.setNumElements(numElements);
-			this->sendWorkPackage(workPackage);
+			/*
+			 * While Task-0 is behind on writing results, only
+			 * its messages are waited for; workers that want
+			 * work would otherwise wake us continually.
+			 */
+			if (this->holdingResults()) {
+				this->waitForEvent(messageWaiter.get(),
+				    replyExpected, false);
+			} else if (workPackages.empty()) {
+				/*
+				 * While waiting on Task-0, take the status,
+				 * results, and completed package of each
+				 * worker that finishes, holding it for the
+				 * next package.
+				 */
+				auto worker = this->takeReadyWorker();
+				if (worker != nullptr)
+					this->_readyWorkers.push_back(worker);
+				else
+					this->waitForEvent(messageWaiter.get(),
+					    replyExpected);
+			} else if (this->sendWorkPackage(workPackages.front())) {
+				workPackages.pop_front();
+			} else {
+				this->waitForEvent(messageWaiter.get(),
+				    replyExpected);
+			}
 		} catch (const MPI::TerminateJob &e) {
 			MPI::logMessage(*log,
 			    "Package processor requested job termination " +
 			    e.whatString());
-			taskStatus = to_int_type(
-			    MPI::TaskStatus::RequestJobTermination);
-			::MPI::COMM_WORLD.Send(
-			    (void *)&taskStatus, 1, MPI_INT32_T, 0,
-			     to_int_type(MPI::MessageTag::Control));
+			if (!workPackages.empty())
+				workPackages.pop_front();
+			if (requesting) {
+				this->_transport->sendValue(this->_workSource,
+				    MPI::MessageTag::Control,
+				    static_cast<MPI::taskstat_t>(to_int_type(
+				    MPI::TaskStatus::RequestJobTermination)));
+			}
 			status = MPI::TaskStatus::RequestJobTermination;
 		} catch (const Error::Exception &e) {
 			MPI::logMessage(*log,
 			    "Failure to process work package: "
 			    + e.whatString());
-			taskStatus = to_int_type(MPI::TaskStatus::Failed);
-			::MPI::COMM_WORLD.Send(
-			    (void *)&taskStatus, 1, MPI_INT32_T, 0,
-			     to_int_type(MPI::MessageTag::Control));
 			status = MPI::TaskStatus::Failed;
 			break;
 		}
 	}
+
+	if (requesting)
+		this->endWorkPackageRequests(status, numRequests,
+		    workPackages);
+	if (this->_nodeLeader)
+		this->endMembers(workPackages, endCommand,
+		    messageWaiter.get());
+	if (!workPackages.empty()) {
+		*log << "Discarded " << workPackages.size() <<
+		    " queued work package(s)";
+		MPI::logEntry(*log);
+	}
 	return (status);
 }
 
+bool
+BiometricEvaluation::MPI::Receiver::returnsResults() const
+{
+	return (!this->_resources->getResultRecordStore().empty());
+}
+
+void
+BiometricEvaluation::MPI::Receiver::takeWorkerResults(
+    const Memory::uint8Array &message)
+{
+	const uint8_t *end = &message[0] + message.size();
+	const uint8_t *results = static_cast<const uint8_t *>(
+	    std::memchr(&message[0], '\0', message.size()));
+	if ((results == nullptr) || (++results == end))
+		return;
+
+	try {
+		this->_results.append(results, end - results);
+	} catch (const Error::DataError &e) {
+		MPI::logMessage(*this->_logsheet, "Discarded results from "
+		    "worker: " + e.whatString());
+	}
+}
+
+void
+BiometricEvaluation::MPI::Receiver::exchangeResults(
+    bool flush)
+{
+	int source;
+	uint64_t size;
+	while (this->_transport->probe(0, MPI::MessageTag::Result, 0,
+	    source, size)) {
+		/* Each batch is acknowledged in turn, written or not */
+		const auto status = to_enum<MPI::TaskStatus>(
+		    this->_transport->receiveValue<MPI::taskstat_t>(0,
+		    MPI::MessageTag::Result));
+		if (this->_resultBatchesInFlight > 0)
+			this->_resultBatchesInFlight--;
+		if (this->_sentCompletions.empty())
+			continue;
+		if (status == MPI::TaskStatus::OK) {
+			this->_completedPackages.insert(
+			    this->_completedPackages.end(),
+			    this->_sentCompletions.front().begin(),
+			    this->_sentCompletions.front().end());
+		} else {
+			MPI::logMessage(*this->_logsheet, "Results of " +
+			    std::to_string(
+			    this->_sentCompletions.front().size()) +
+			    " work package(s) were not written; not "
+			    "reporting them complete");
+		}
+		this->_sentCompletions.pop_front();
+	}
+	while (!this->_resultSends.empty() &&
+	    this->_resultSends.front().first->test())
+		this->_resultSends.pop_front();
+
+	if (this->_results.empty() || (this->_resultBatchesInFlight >=
+	    this->_resources->getResultBatchesInFlight()))
+		return;
+	/*
+	 * Completed work packages are only reported once their results
+	 * are written, so while Task-0 has no batch of ours in hand,
+	 * send their results without waiting for a full batch.
+	 */
+	if (!flush && (this->_results.getSize() <
+	    this->_resources->getResultBatchSize()) &&
+	    (this->_resultCompletions.empty() ||
+	    (this->_resultBatchesInFlight != 0)))
+		return;
+
+	/*
+	 * The batch is sent without blocking, so that Task-0 sending a
+	 * work package to this task at the same time can't deadlock us.
+	 */
+	MPI::ResultBatch batch = std::move(this->_results);
+	this->_results = MPI::ResultBatch();
+	auto request = this->_transport->startSend(0, MPI::MessageTag::Result,
+	    batch.getData(), batch.getSize());
+	this->_resultSends.emplace_back(std::move(request), std::move(batch));
+	this->_resultBatchesInFlight++;
+	this->_sentCompletions.push_back(std::move(this->_resultCompletions));
+	this->_resultCompletions.clear();
+}
+
+bool
+BiometricEvaluation::MPI::Receiver::holdingResults() const
+{
+	return (this->returnsResults() &&
+	    (this->_resultBatchesInFlight >=
+	    this->_resources->getResultBatchesInFlight()) &&
+	    (this->_results.getSize() >=
+	    this->_resources->getResultBatchSize()));
+}
+
+void
+BiometricEvaluation::MPI::Receiver::flushResults()
+{
+	while (true) {
+		this->exchangeResults(true);
+		if (this->_results.empty() &&
+		    (this->_resultBatchesInFlight == 0))
+			break;
+
+		int source;
+		uint64_t size;
+		(void)this->_transport->probe(0, MPI::MessageTag::Result, -1,
+		    source, size);
+	}
+	for (auto &send : this->_resultSends)
+		send.first->wait();
+	this->_resultSends.clear();
+
+	/* An empty batch tells Task-0 that no more results follow */
+	this->_transport->send(0, MPI::MessageTag::Result, nullptr, 0);
+}
+
+BiometricEvaluation::MPI::TaskStatus
+BiometricEvaluation::MPI::Receiver::takeWorkerStatus(
+    PackageWorker *packageWorker,
+    const Memory::uint8Array &message)
+{
+	const uint64_t numResults = this->_results.getNumResults();
+	this->takeWorkerResults(message);
+	const MPI::TaskStatus taskStatus = messageToStatus(message);
+	if (packageWorker == nullptr)
+		return (taskStatus);
+	if (packageWorker->getPackageStart() !=
+	    MPI::Telemetry::Clock::time_point()) {
+		this->_telemetry.countProcessed(
+		    packageWorker->getPackageStart());
+		packageWorker->setPackageStart(
+		    MPI::Telemetry::Clock::time_point());
+	}
+
+	/*
+	 * A worker sends its status once done with its work package,
+	 * unless an immediate exit cut the package short.
+	 */
+	const uint64_t id = packageWorker->getPackageID();
+	packageWorker->setPackageID(0);
+	if (id == 0)
+		return (taskStatus);
+	if ((taskStatus != MPI::TaskStatus::OK) &&
+	    ((taskStatus != MPI::TaskStatus::Exit) || MPI::QuickExit ||
+	    MPI::TermExit))
+		return (taskStatus);
+
+	if (this->_results.getNumResults() != numResults)
+		this->_resultCompletions.push_back(id);
+	else
+		this->_completedPackages.push_back(id);
+	return (taskStatus);
+}
+
+void
+BiometricEvaluation::MPI::Receiver::reportCompletions()
+{
+	while (!this->_completionSends.empty() &&
+	    this->_completionSends.front().first->test())
+		this->_completionSends.pop_front();
+	if (!this->_resources->tracksWorkPackages() ||
+	    this->_completedPackages.empty())
+		return;
+
+	/* Sent without blocking, as are results */
+	std::vector<uint64_t> ids = std::move(this->_completedPackages);
+	this->_completedPackages.clear();
+	auto request = this->_transport->startSend(0,
+	    MPI::MessageTag::Completion, ids.data(),
+	    ids.size() * sizeof(uint64_t));
+	this->_completionSends.emplace_back(std::move(request),
+	    std::move(ids));
+}
+
+void
+BiometricEvaluation::MPI::Receiver::reportTelemetry(
+    uint64_t queued,
+    bool final)
+{
+	while (!this->_telemetrySends.empty() &&
+	    this->_telemetrySends.front().first->test())
+		this->_telemetrySends.pop_front();
+	if (!this->_resources->collectsTelemetry())
+		return;
+	if (!final && !this->_telemetry.sampleDue(
+	    this->_resources->getTelemetryInterval()))
+		return;
+
+	/* Sent without blocking, as are results */
+	this->_telemetry.setQueueDepths(queued, this->_readyWorkers.size());
+	auto sample = BE::Memory::make_unique<MPI::Telemetry::Sample>(
+	    this->_telemetry.getSample(final));
+	auto request = this->_transport->startSend(0,
+	    MPI::MessageTag::Telemetry, sample.get(), sizeof(*sample));
+	this->_telemetrySends.emplace_back(std::move(request),
+	    std::move(sample));
+	if (!final)
+		return;
+
+	for (auto &send : this->_telemetrySends)
+		send.first->wait();
+	this->_telemetrySends.clear();
+}
+
+void
+BiometricEvaluation::MPI::Receiver::receiveNodeLeader()
+{
+	BE::IO::Logsheet *log = this->_logsheet.get();
+
+	const int32_t leader = this->_transport->receiveValue<int32_t>(0,
+	    MPI::MessageTag::Control);
+	if (leader != this->_transport->getRank()) {
+		this->_workSource = leader;
+		*log << "Asking node leader Task-" << leader << " for work";
+		MPI::logEntry(*log);
+		return;
+	}
+
+	int source;
+	uint64_t size;
+	(void)this->_transport->probe(0, MPI::MessageTag::Control, -1, source,
+	    size);
+	std::vector<int32_t> members(size / sizeof(int32_t));
+	(void)this->_transport->receive(0, MPI::MessageTag::Control,
+	    members.data(), size);
+	this->_members.insert(members.begin(), members.end());
+	this->_nodeLeader = true;
+	*log << "Leading " << members.size() << " other task(s)";
+	MPI::logEntry(*log);
+}
+
 void
 BiometricEvaluation::MPI::Receiver::startWorkers()
 {
@@ -504,10 +1294,12 @@ BiometricEvaluation::MPI::Receiver::startWorkers()
 	for (int w = 0; w < this->_resources->getWorkersPerNode(); w++) {
 		std::shared_ptr<PackageWorker> pw(new PackageWorker(
 		    this->_workPackageProcessor,
-		    this->_resources));
-		wc = this->_processManager.addWorker(pw);
+		    this->_resources, w));
+		this->_packageWorkers.push_back(pw);
+		wc = this->_processManager->addWorker(pw);
 		try {
-			this->_processManager.startWorker(wc, false, true);
+			this->_processManager->startWorker(wc, false, true,
+			    this->_resources->getWorkerPlacement());
 		} catch (const Error::Exception &e) {
 			MPI::logMessage(*log, "Worker start failed: " +
 			    e.whatString());
@@ -516,11 +1308,34 @@ BiometricEvaluation::MPI::Receiver::startWorkers()
 	}
 }
 
+void
+BiometricEvaluation::MPI::Receiver::signalWorkers(
+    int signo)
+{
+	if (!this->_resources->useThreadedWorkers()) {
+		static_cast<Process::ForkManager *>(
+		    this->_processManager.get())->broadcastSignal(signo);
+		return;
+	}
+
+	/*
+	 * A thread can't be interrupted or killed on its own, so set the
+	 * flag the signal handler would have set in a worker process.
+	 * Worker threads check it before asking for more work.
+	 */
+	if (signo == SIGKILL)
+		MPI::TermExit = true;
+	else
+		MPI::QuickExit = true;
+}
+
 void
 BiometricEvaluation::MPI::Receiver::start()
 {
 	/* Release other tasks to start up */
-	::MPI::COMM_WORLD.Barrier();
+	this->_transport->barrier();
+	if (this->_resources->useNodeLeaders())
+		(void)this->_transport->getNodes();
 
 	BE::MPI::taskstat_t taskStatus;
 	try {
@@ -530,23 +1345,21 @@ BiometricEvaluation::MPI::Receiver::start()
 			"MPI::Receiver");
 	} catch (const Error::Exception&) {
 		taskStatus = to_int_type(MPI::TaskStatus::Failed);
-		::MPI::COMM_WORLD.Send((void *)&taskStatus, 1, MPI_INT32_T,
-		    0, to_int_type(MPI::MessageTag::Control));
+		this->_transport->sendValue(0, MPI::MessageTag::Control, taskStatus);
 		this->shutdown(MPI::TaskStatus::Failed,
 		    "Failed opening Logsheet()");
 		return;
 	}
 	BE::IO::Logsheet *log = this->_logsheet.get();
 	MPI::logMessage(*log, "Wait for startup message");
-	BE::MPI::taskstat_t flag;
-	::MPI::COMM_WORLD.Recv(&flag, 1, MPI_INT32_T, 0, 
-	    to_int_type(MPI::MessageTag::Control));
+	const BE::MPI::taskstat_t flag =
+	    this->_transport->receiveValue<MPI::taskstat_t>(0,
+	    MPI::MessageTag::Control);
 
 	/* Shutdown Task-N if Task-0 says not OK */
 	taskStatus = to_int_type(MPI::TaskStatus::OK);
 	if (flag == to_int_type(MPI::TaskStatus::Failed)) {
-		::MPI::COMM_WORLD.Send((void *)&taskStatus, 1, MPI_INT32_T,
-		     0, to_int_type(MPI::MessageTag::Control));
+		this->_transport->sendValue(0, MPI::MessageTag::Control, taskStatus);
 		this->shutdown(MPI::TaskStatus::OK, "Distributor says abort");
 		return;
 	}
@@ -562,8 +1375,7 @@ BiometricEvaluation::MPI::Receiver::start()
 		MPI::logMessage(*log, "Could not initialize package processor: "
 		    + e.whatString());
 		taskStatus = to_int_type(MPI::TaskStatus::Failed);
-		::MPI::COMM_WORLD.Send((void *)&taskStatus, 1, MPI_INT32_T,
-		    0, to_int_type(MPI::MessageTag::Control));
+		this->_transport->sendValue(0, MPI::MessageTag::Control, taskStatus);
 		this->shutdown(MPI::TaskStatus::Failed,
 		    "Failed performInitalization()");
 		return;
@@ -571,16 +1383,18 @@ BiometricEvaluation::MPI::Receiver::start()
 	this->startWorkers();
 
 	//XXX Open log sheet
-	if (this->_processManager.getNumActiveWorkers() == 0) {
+	if (this->_processManager->getNumActiveWorkers() == 0) {
 		taskStatus = to_int_type(MPI::TaskStatus::Failed);
-		::MPI::COMM_WORLD.Send((void *)&taskStatus, 1, MPI_INT32_T,
-		    0, to_int_type(MPI::MessageTag::Control));
+		this->_transport->sendValue(0, MPI::MessageTag::Control, taskStatus);
 		this->shutdown(MPI::TaskStatus::Failed, "No workers");
 		return;
 	}
 
-	::MPI::COMM_WORLD.Send((void *)&taskStatus, 1, MPI_INT32_T,
-	    0, to_int_type(MPI::MessageTag::Control));
+	this->_transport->sendValue(0, MPI::MessageTag::Control, taskStatus);
+	if (this->_resources->useNodeLeaders())
+		this->receiveNodeLeader();
+	this->_telemetry = MPI::Telemetry(this->_transport->getRank(),
+	    this->_processManager->getNumActiveWorkers());
 	
 	MPI::TaskStatus status = this->requestWorkPackages();
 	std::string str;
@@ -607,7 +1421,20 @@ BiometricEvaluation::MPI::Receiver::shutdown(
 	/*
 	 * Tell all workers to shut down.
 	 */
-	uint32_t workerCount = this->_processManager.getNumActiveWorkers();
+	uint32_t workerCount = this->_processManager->getNumActiveWorkers();
+
+	/* Workers held for a package have already sent their status */
+	for (const auto &worker : this->_readyWorkers) {
+		try {
+			this->_processManager->stopWorker(worker);
+		} catch (const Error::Exception &e) {
+			MPI::logMessage(*log, "Task-N stopping worker: "
+			    "Caught: " + e.whatString());
+		}
+	}
+	workerCount -= std::min<uint32_t>(workerCount,
+	    this->_readyWorkers.size());
+	this->_readyWorkers.clear();
 
 	/*
 	 * If TermExit occurred, the workers were forcibly killed
@@ -627,7 +1454,7 @@ BiometricEvaluation::MPI::Receiver::shutdown(
 		bool msgAvail;
 		for (uint32_t i = 0; i < workerCount; i++) {
 			try {
-				msgAvail = this->_processManager.getNextMessage(
+				msgAvail = this->_processManager->getNextMessage(
 				    worker, inMessage);
 			} catch (const Error::Exception &e) {
 				MPI::logMessage(*log, "Task-N receiving message: "
@@ -642,14 +1469,88 @@ BiometricEvaluation::MPI::Receiver::shutdown(
 			}
 			if (!msgAvail)
 				break;
+			(void)this->takeWorkerStatus(dynamic_cast<
+			    PackageWorker *>(worker->getWorker().get()),
+			    inMessage);
 			try {
-				this->_processManager.stopWorker(worker);
+				this->_processManager->stopWorker(worker);
 			} catch (const Error::Exception &e) {
 				MPI::logMessage(*log, "Task-N stopping worker: "
 				"Caught: " + e.whatString());
 			}
 		}
 	}
+
+	/*
+	 * Worker threads must be finished before the objects they use
+	 * are destroyed.
+	 */
+	if (this->_resources->useThreadedWorkers()) {
+		MPI::logMessage(*log, "Waiting for worker threads");
+		for (const auto &packageWorker : this->_packageWorkers)
+			packageWorker->stop();
+		this->_processManager->waitForWorkerExit();
+	}
+
+	/*
+	 * Workers that ended on their own, such as on an exit signal,
+	 * sent the results of their last work package with their final
+	 * status. Killed workers may have left a partial message.
+	 */
+	if ((this->returnsResults() ||
+	    this->_resources->tracksWorkPackages()) &&
+	    (MPI::TermExit == false)) {
+		for (const auto &packageWorker : this->_packageWorkers) {
+			try {
+				while (packageWorker->
+				    getPendingBytesFromWorker() > 0) {
+					BE::Memory::uint8Array message;
+					packageWorker->receiveMessageFromWorker(
+					    message);
+					(void)this->takeWorkerStatus(
+					    packageWorker.get(), message);
+				}
+			} catch (const Error::Exception &) {}
+		}
+	}
+
+	if (this->returnsResults()) {
+		MPI::logMessage(*log, "Sending remaining results");
+		try {
+			this->flushResults();
+		} catch (const Error::Exception &e) {
+			MPI::logMessage(*log, "Sending results: Caught: " +
+			    e.whatString());
+		}
+	}
+
+	/*
+	 * Completions follow the results they depend on. An empty
+	 * report tells Task-0 that no more follow.
+	 */
+	if (this->_resources->tracksWorkPackages()) {
+		MPI::logMessage(*log, "Reporting completed work packages");
+		try {
+			this->reportCompletions();
+			for (auto &send : this->_completionSends)
+				send.first->wait();
+			this->_completionSends.clear();
+			this->_transport->send(0, MPI::MessageTag::Completion,
+			    nullptr, 0);
+		} catch (const Error::Exception &e) {
+			MPI::logMessage(*log, "Reporting completions: "
+			    "Caught: " + e.whatString());
+		}
+	}
+
+	/* Task-0 waits for the final sample of each task */
+	try {
+		this->reportTelemetry(0, true);
+	} catch (const Error::Exception &e) {
+		MPI::logMessage(*log, "Reporting telemetry: Caught: " +
+		    e.whatString());
+	}
+
 	/*
 	 * Call shutdown function in the work package processor. If that
 	 * fails, continue with the shutdown.
@@ -666,10 +1567,9 @@ BiometricEvaluation::MPI::Receiver::shutdown(
  	 * the queue for a receive operation done when the Task-0 is
  	 * still sending out data.
  	 */
-	::MPI::COMM_WORLD.Barrier();
+	this->_transport->barrier();
 	MPI::logMessage(*log, "Sending final message");
-	const BE::MPI::taskstat_t rawTaskStatus = to_int_type(taskStatus);
-	::MPI::COMM_WORLD.Send((void *)&rawTaskStatus, 1, MPI_INT32_T,
-	    0, to_int_type(MPI::MessageTag::Control));
+	this->_transport->sendValue(0, MPI::MessageTag::Control,
+	    static_cast<MPI::taskstat_t>(to_int_type(taskStatus)));
 }
 
@@ -7,6 +7,10 @@
  * its use by other parties, and makes no guarantees, expressed or implied,
  * about its quality, reliability, or any other characteristic.
  */
+#include <cstring>
+#include <string>
+#include <vector>
+
 #include <be_mpi_recordprocessor.h>
 #include <be_mpi_runtime.h>
 
@@ -40,39 +44,38 @@ BiometricEvaluation::MPI::RecordProcessor::processWorkPackage(
     MPI::WorkPackage &workPackage)
 {
 	/*
-	 * Extract the key/value data from the work package
+	 * Extract the key/value data from the work package, which is
+	 * read in place.
 	 */
-	 Memory::uint8Array packageData(0);
-	 workPackage.getData(packageData);
-	 uint64_t numElements = workPackage.getNumElements();
+	const Memory::uint8Array &packageData = workPackage.getData();
+	uint64_t numElements = workPackage.getNumElements();
+	if (this->_resources->useLocalReads()) {
+		this->processKeyRanges(packageData);
+		return;
+	}
 
 	/*
 	 * Call the implementation's record processor function
 	 * for each key.
 	 */
 	uint64_t index = 0;
-	Memory::uint8Array value(0);
 	for (uint64_t count = 0; count < numElements; count++) {
 
 		/*
 		 * Read the key length, value size, create a std::string
-		 * from the characters of that length, then create the data
-		 * array if size is non-zero.
+		 * from the characters of that length, then locate the
+		 * value if size is non-zero.
 		 */
-		uint32_t *pInt32 = (uint32_t *)&packageData[index];
-		uint32_t keyLength = *pInt32;
+		uint32_t keyLength;
+		std::memcpy(&keyLength, &packageData[index], sizeof(keyLength));
 		index += sizeof(uint32_t);
-		uint64_t *pInt64 = (uint64_t *)&packageData[index];
-		uint64_t valueSize = *pInt64;
+		uint64_t valueSize;
+		std::memcpy(&valueSize, &packageData[index], sizeof(valueSize));
 		index += sizeof(uint64_t);
-		std::string key((char *)&packageData[index], keyLength);
+		std::string key((const char *)&packageData[index], keyLength);
 		index += keyLength;
-		if (valueSize > 0) {
-			value.resize(valueSize);
-			std::memcpy((void *)&value[0],
-			    (void *)&packageData[index], valueSize);
-			index += valueSize;
-		}
+		const uint8_t *value = &packageData[index];
+		index += valueSize;
 
 		/*
 		 * Stop processing only when a quick or immediate exit
@@ -86,7 +89,8 @@ BiometricEvaluation::MPI::RecordProcessor::processWorkPackage(
 		}
 		try {
 			if (valueSize > 0) {
-				this->processRecord(key, value);
+				this->processRecordInPlace(key, value,
+				    valueSize);
 			} else {
 				this->processRecord(key);
 			}
@@ -101,3 +105,99 @@ BiometricEvaluation::MPI::RecordProcessor::processWorkPackage(
 	}
 }
 
+void
+BiometricEvaluation::MPI::RecordProcessor::processKeyRanges(
+    const Memory::uint8Array &packageData)
+{
+	std::shared_ptr<IO::RecordStore> recordStore =
+	    this->_resources->getRecordStore();
+	if (recordStore == nullptr)
+		throw Error::ObjectDoesNotExist("Input record store is needed "
+		    "to read records locally, but could not be opened");
+	IO::Logsheet *log = this->getLogsheet().get();
+
+	/*
+	 * Each range names its first and last records and the number of
+	 * records in sequence between them. The keys of a range are
+	 * sequenced first, and checked against the range, so that records
+	 * are only processed when this store sequences as the
+	 * Distributor's did.
+	 */
+	uint64_t index = 0;
+	std::vector<std::string> keys;
+	while (index < packageData.size()) {
+		uint32_t firstKeyLength, lastKeyLength;
+		std::memcpy(&firstKeyLength, &packageData[index],
+		    sizeof(firstKeyLength));
+		index += sizeof(uint32_t);
+		std::memcpy(&lastKeyLength, &packageData[index],
+		    sizeof(lastKeyLength));
+		index += sizeof(uint32_t);
+		uint64_t count;
+		std::memcpy(&count, &packageData[index], sizeof(count));
+		index += sizeof(uint64_t);
+		uint8_t withValues;
+		std::memcpy(&withValues, &packageData[index],
+		    sizeof(withValues));
+		index += sizeof(uint8_t);
+		const std::string firstKey((const char *)&packageData[index],
+		    firstKeyLength);
+		index += firstKeyLength;
+		const std::string lastKey((const char *)&packageData[index],
+		    lastKeyLength);
+		index += lastKeyLength;
+
+		keys.clear();
+		try {
+			recordStore->setCursorAtKey(firstKey);
+			for (uint64_t n = 0; n < count; n++)
+				keys.push_back(recordStore->sequenceKey());
+		} catch (const Error::Exception &e) {
+			log->writeDebug("Range at " + firstKey + ": Caught " +
+			    e.whatString());
+			continue;
+		}
+		if ((keys.front() != firstKey) || (keys.back() != lastKey))
+			throw Error::StrategyError("Range " + firstKey +
+			    " to " + lastKey + " was sequenced as " +
+			    keys.front() + " to " + keys.back() + "; input "
+			    "record stores differ");
+
+		for (const auto &key : keys) {
+			/* As above, only stop early on a quick exit */
+			if (MPI::QuickExit || MPI::TermExit) {
+				log->writeDebug(
+				    "Early exit: End record processing");
+				return;
+			}
+			if (withValues == 0) {
+				this->processRecord(key);
+				continue;
+			}
+			Memory::uint8Array value;
+			try {
+				value = recordStore->read(key);
+			} catch (const Error::Exception &e) {
+				log->writeDebug("Range at " + firstKey +
+				    ": Caught " + e.whatString());
+				continue;
+			}
+			if (value.size() > 0)
+				this->processRecordInPlace(key, value,
+				    value.size());
+			else
+				this->processRecord(key);
+		}
+	}
+}
+
+void
+BiometricEvaluation::MPI::RecordProcessor::processRecordInPlace(
+    const std::string &key,
+    const uint8_t *value,
+    const uint64_t size)
+{
+	Memory::uint8Array valueCopy(size);
+	std::memcpy(&valueCopy[0], value, size);
+	this->processRecord(key, valueCopy);
+}
@@ -8,6 +8,8 @@
  * about its quality, reliability, or any other characteristic.
  */
 
+#include <algorithm>
+
 #include <be_mpi_recordstoredistributor.h>
 
 namespace BE = BiometricEvaluation;
@@ -59,38 +61,69 @@ BiometricEvaluation::MPI::RecordStoreDistributor::~RecordStoreDistributor()
 }
 
 /*
- * Add a string key to the given buffer, preceded by the length of the
- * key. The key is written as characters, without the nul terminator.
- * The index out parameter is updated to the location of where the
- * next write can take place.
+ * Add a record to the given work package: a segment holding the length of
+ * the key, the size of the value, and the key written as characters
+ * without the nul terminator, followed by the value, if any, moved
+ * into the package without being copied.
  */
 static void
-fillBufferWithKeyAndValue(
-    BE::Memory::uint8Array &buf,
+appendKeyAndValue(
+    BE::MPI::WorkPackage &workPackage,
     const std::string &key,
-    BE::Memory::uint8Array &value,
-    BE::Memory::uint8Array::size_type &index)
+    BE::Memory::uint8Array &&value)
 {
 	uint32_t keyLength = key.length();
 	uint64_t valueSize =  value.size();
-	uint64_t neededSpace = index		/* buffer space in use */
-	    + sizeof(uint32_t) + keyLength	/* space for key and length */
-	    + sizeof(uint64_t) + valueSize;	/* for value and size */
-	buf.resize(neededSpace);
-
-	/* Write the key length, value size, key, value if non-zero size */
-	uint32_t *pInt32 = (uint32_t *)&buf[index];
-	*pInt32 = (uint32_t)keyLength;
+	BE::Memory::uint8Array header(sizeof(uint32_t) + sizeof(uint64_t) +
+	    keyLength);
+
+	/* Write the key length, value size, key */
+	BE::Memory::uint8Array::size_type index = 0;
+	std::memcpy(&header[index], &keyLength, sizeof(keyLength));
 	index += sizeof(uint32_t);
-	uint64_t *pInt64 = (uint64_t *)&buf[index];
-	*pInt64 = (uint64_t)valueSize;
+	std::memcpy(&header[index], &valueSize, sizeof(valueSize));
 	index += sizeof(uint64_t);
-	std::memcpy((char *)&buf[index], key.data(), keyLength);
-	index += keyLength;
-	if (valueSize != 0) {
-		std::memcpy((void *)&buf[index], &value[0], valueSize);
-		index += valueSize;
-	}
+	std::memcpy(&header[index], key.data(), keyLength);
+	workPackage.appendData(std::move(header));
+	if (valueSize != 0)
+		workPackage.appendData(std::move(value));
+}
+
+/*
+ * Add a range of records to the given work package: a segment holding
+ * the lengths of the first and last keys, the number of records in the
+ * range, whether their values are to be read, and the first and last
+ * keys written as characters without the nul terminator.
+ */
+static void
+appendKeyRange(
+    BE::MPI::WorkPackage &workPackage,
+    const std::string &firstKey,
+    const std::string &lastKey,
+    uint64_t count,
+    bool includeValues)
+{
+	uint32_t firstKeyLength = firstKey.length();
+	uint32_t lastKeyLength = lastKey.length();
+	uint8_t withValues = (includeValues ? 1 : 0);
+	BE::Memory::uint8Array header((2 * sizeof(uint32_t)) +
+	    sizeof(uint64_t) + sizeof(uint8_t) + firstKeyLength +
+	    lastKeyLength);
+
+	/* Write the key lengths, record count, value flag, keys */
+	BE::Memory::uint8Array::size_type index = 0;
+	std::memcpy(&header[index], &firstKeyLength, sizeof(firstKeyLength));
+	index += sizeof(uint32_t);
+	std::memcpy(&header[index], &lastKeyLength, sizeof(lastKeyLength));
+	index += sizeof(uint32_t);
+	std::memcpy(&header[index], &count, sizeof(count));
+	index += sizeof(uint64_t);
+	std::memcpy(&header[index], &withValues, sizeof(withValues));
+	index += sizeof(uint8_t);
+	std::memcpy(&header[index], firstKey.data(), firstKeyLength);
+	index += firstKeyLength;
+	std::memcpy(&header[index], lastKey.data(), lastKeyLength);
+	workPackage.appendData(std::move(header));
 }
 
 void
@@ -98,52 +131,75 @@ BiometricEvaluation::MPI::RecordStoreDistributor::createWorkPackage(
     MPI::WorkPackage &workPackage)
 {
 	std::shared_ptr<BE::IO::Logsheet> log = this->getLogsheet();
+	workPackage = MPI::WorkPackage();
 
-	/* Create the package data buffer at a reasonable starting size */
-	BE::Memory::uint8Array packageData(16384);
-	
 	/*
 	 * If there are no more keys to be read from the record store,
 	 * send an empty work package.
 	 */
-	if (this->_recordsRemaining == 0) {
-		workPackage.setNumElements(0);
-		workPackage.setData(packageData);
+	if (this->_recordsRemaining == 0)
 		return;
-	}
 
 	/*
 	 * Distribute a work package based on the chunk size given
-	 * in the resources object. If a failure occurs reading a key,
-	 * continue onto the next key. It is possible to send an empty
+	 * in the resources object, or adaptively sized by the
+	 * Distributor. If a failure occurs reading a key, continue
+	 * onto the next key. It is possible to send an empty
 	 * work package due to sequential failures.
-	 */
-	uint64_t keyCount;
-	if (this->_recordsRemaining > this->_resources->getChunkSize()) {
-		keyCount = this->_resources->getChunkSize();
-	} else {
-		keyCount = this->_recordsRemaining;
-	}
-	
-	this->_recordsRemaining -= keyCount;
-
-	/*
+	 *
 	 * The value array must be 0-sized to start, and will stay that way
 	 * if values are not to be sent.
 	 */
 	BE::IO::RecordStore::Record record;
-	BE::Memory::uint8Array::size_type index = 0;
 	uint64_t realKeyCount = 0;
 	std::shared_ptr<IO::RecordStore> recordStore =
 	    this->_resources->getRecordStore();
+	const uint64_t chunkSize = this->_resources->getChunkSize();
+
+	/*
+	 * When receivers read the records themselves, only keys are
+	 * pulled, and each run of consecutive records becomes a range
+	 * named by its first and last keys.
+	 */
+	const bool localReads = this->_resources->useLocalReads();
+	std::string rangeFirstKey{}, rangeLastKey{};
+	uint64_t rangeCount = 0;
+	const auto endRange = [&]() {
+		if (rangeCount == 0)
+			return;
+		appendKeyRange(workPackage, rangeFirstKey, rangeLastKey,
+		    rangeCount, this->_includeValues);
+		rangeCount = 0;
+	};
 
 	/*
 	 * Pull keys, and possibly values, from the RecordStore and
 	 * combine a chunk of them into a single work package.
 	 */
-	for (uint64_t n = 0; n < keyCount; n++) {
+	const MPI::RangeSet &completed = this->getCompletedPositions();
+	for (uint64_t n = 0; (this->_recordsRemaining > 0) &&
+	    !this->isWorkPackageFull(chunkSize, n, workPackage.getSize());
+	    n++) {
+		/*
+		 * Pass over records completed before a checkpoint
+		 * restore; they are not counted as remaining.
+		 */
 		try {
-			if (this->_includeValues)
+			while (completed.contains(this->_nextPosition)) {
+				endRange();
+				(void)recordStore->sequenceKey();
+				this->_nextPosition++;
+			}
+		} catch (const Error::Exception &e) {
+			log->writeDebug("Caught " + e.whatString());
+			this->_recordsRemaining = 0;
+			break;
+		}
+
+		this->_recordsRemaining--;
+		const uint64_t position = this->_nextPosition++;
+		try {
+			if (this->_includeValues && !localReads)
 				record = recordStore->sequence();
 			else
 				record.key = recordStore->sequenceKey();
@@ -151,20 +207,38 @@ BiometricEvaluation::MPI::RecordStoreDistributor::createWorkPackage(
 			 * Save the last key sent for checkpointing purposes.
 			 */
 			this->_lastDistributedKey = record.key;
+			this->addPackagedPositions(position, position,
+			    record.key);
 
-			fillBufferWithKeyAndValue(packageData, record.key,
-			    record.data, index);
+			if (localReads) {
+				if (rangeCount == 0)
+					rangeFirstKey = record.key;
+				rangeLastKey = record.key;
+				rangeCount++;
+			} else {
+				appendKeyAndValue(workPackage, record.key,
+				    std::move(record.data));
+			}
 		} catch (const Error::Exception &e) {
 			log->writeDebug("Caught " + e.whatString());
+			this->addPackagedPositions(position, position);
+			endRange();
 			continue;
 		}
 		realKeyCount++;
 	}
+	endRange();
 	/*
 	 * NOTE: At this point it is possible to have no keys in the package.
 	 */
 	workPackage.setNumElements(realKeyCount);
-	workPackage.setData(packageData);
+}
+
+uint64_t
+BiometricEvaluation::MPI::RecordStoreDistributor::getNumRemainingElements()
+    const
+{
+	return (this->_recordsRemaining);
 }
 
 void
@@ -195,6 +269,39 @@ BiometricEvaluation::MPI::RecordStoreDistributor::checkpointSave(
 void
 BiometricEvaluation::MPI::RecordStoreDistributor::checkpointRestore()
 {
+	/*
+	 * With a record of completed positions, seek past the last
+	 * key of the completed prefix of the sequence; createWorkPackage()
+	 * passes over the rest.
+	 */
+	const MPI::RangeSet &completed = this->getCompletedPositions();
+	if (this->hasCompletionRecord()) {
+		try {
+			const uint64_t firstMissing =
+			    completed.getFirstMissing();
+			const std::string key = (firstMissing == 0 ? "" :
+			    this->getCompletedLabel(firstMissing - 1));
+			if (!key.empty()) {
+				auto recordStore =
+				    this->_resources->getRecordStore();
+				recordStore->setCursorAtKey(key);
+				(void)recordStore->sequenceKey();
+				this->_nextPosition = firstMissing;
+			}
+			this->_recordsRemaining -= std::min(
+			    completed.getCount(), this->_recordsRemaining);
+			this->getLogsheet()->writeDebug("Checkpoint restore: " +
+			    std::to_string(completed.getCount()) +
+			    " records completed, resuming at record " +
+			    std::to_string(this->_nextPosition));
+		} catch (const Error::Exception &e) {
+			this->getLogsheet()->writeDebug(
+			    "Checkpoint restore: Caught " + e.whatString());
+			throw;
+		}
+		return;
+	}
+
 	try {
 		auto chkData = this->getCheckpointData();
 		auto lastKey = chkData->getProperty(
@@ -22,6 +22,9 @@ BiometricEvaluation::MPI::RecordStoreResources::INPUTRSPROPERTY =
 const std::string
 BiometricEvaluation::MPI::RecordStoreResources::CHUNKSIZEPROPERTY =
     "Chunk Size";
+const std::string
+BiometricEvaluation::MPI::RecordStoreResources::LOCALREADSPROPERTY =
+    "Local Record Reads";
 
 /******************************************************************************/
 /* Class method definitions.                                                  */
@@ -49,6 +52,10 @@ BiometricEvaluation::MPI::RecordStoreResources::RecordStoreResources(
 		throw Error::ObjectDoesNotExist("Could not read properties: " +
 		    e.whatString());
 	}
+	try {
+		this->_localReads = props->getPropertyAsBoolean(
+		    MPI::RecordStoreResources::LOCALREADSPROPERTY);
+	} catch (const Error::ObjectDoesNotExist &) {}
 	try {
 		this->_recordStore = IO::RecordStore::openRecordStore(
 		    RSName, IO::Mode::ReadOnly);
@@ -81,6 +88,12 @@ BiometricEvaluation::MPI::RecordStoreResources::getRecordStore() const
 	return (this->_recordStore);
 }
 
+bool
+BiometricEvaluation::MPI::RecordStoreResources::useLocalReads() const
+{
+	return (this->_localReads);
+}
+
 std::vector<std::string>
 BiometricEvaluation::MPI::RecordStoreResources::getRequiredProperties()
 {
@@ -96,6 +109,7 @@ BiometricEvaluation::MPI::RecordStoreResources::getOptionalProperties()
 {
 	std::vector<std::string> props;
 	props = MPI::Resources::getOptionalProperties();
+	props.push_back(MPI::RecordStoreResources::LOCALREADSPROPERTY);
 	return (props);
 }
 
@@ -11,10 +11,10 @@
 #include <sys/types.h>
 #include <unistd.h>
 
-#include <mpi.h>
 #include <sstream>
 
 #include <be_mpi.h>
+#include <be_mpi_transport.h>
 #include <be_io_propertiesfile.h>
 #include <be_io_filelogsheet.h>
 #include <be_io_syslogsheet.h>
@@ -22,6 +22,7 @@
 #include <be_mpi_runtime.h>
 #include <be_system.h>
 #include <be_text.h>
+#include "be_mpi_inprocesstransport_impl.h"
 
 namespace BE = BiometricEvaluation;
 
@@ -40,6 +41,63 @@ const std::string
 BiometricEvaluation::MPI::Resources::LOGSHEETURLPROPERTY("Logsheet URL");
 const std::string
 BiometricEvaluation::MPI::Resources::CHECKPOINTPATHPROPERTY("Checkpoint Path");
+const std::string
+BiometricEvaluation::MPI::Resources::ADAPTIVECHUNKSIZEPROPERTY(
+    "Adaptive Chunk Size");
+const std::string
+BiometricEvaluation::MPI::Resources::MINCHUNKSIZEPROPERTY("Minimum Chunk Size");
+const std::string
+BiometricEvaluation::MPI::Resources::MAXCHUNKSIZEPROPERTY("Maximum Chunk Size");
+const std::string
+BiometricEvaluation::MPI::Resources::MINPACKAGESIZEPROPERTY(
+    "Minimum Package Size");
+const std::string
+BiometricEvaluation::MPI::Resources::MAXPACKAGESIZEPROPERTY(
+    "Maximum Package Size");
+const std::string
+BiometricEvaluation::MPI::Resources::PACKAGEDURATIONPROPERTY(
+    "Package Duration");
+const std::string
+BiometricEvaluation::MPI::Resources::PREFETCHPACKAGESPROPERTY(
+    "Prefetch Packages");
+const std::string
+BiometricEvaluation::MPI::Resources::WORKERSHAREDMEMORYPROPERTY(
+    "Worker Shared Memory Size");
+const std::string
+BiometricEvaluation::MPI::Resources::THREADEDWORKERSPROPERTY(
+    "Threaded Workers");
+const std::string
+BiometricEvaluation::MPI::Resources::WORKERPLACEMENTPROPERTY(
+    "Worker Placement");
+const std::string
+BiometricEvaluation::MPI::Resources::RESULTRECORDSTOREPROPERTY(
+    "Result Record Store");
+const std::string
+BiometricEvaluation::MPI::Resources::RESULTRECORDSTOREKINDPROPERTY(
+    "Result Record Store Kind");
+const std::string
+BiometricEvaluation::MPI::Resources::RESULTBATCHSIZEPROPERTY(
+    "Result Batch Size");
+const std::string
+BiometricEvaluation::MPI::Resources::RESULTBATCHESINFLIGHTPROPERTY(
+    "Result Batches In Flight");
+const std::string
+BiometricEvaluation::MPI::Resources::WORKPACKAGETIMEOUTPROPERTY(
+    "Work Package Timeout");
+const std::string
+BiometricEvaluation::MPI::Resources::SPECULATIVEPACKAGESPROPERTY(
+    "Speculative Work Packages");
+const std::string
+BiometricEvaluation::MPI::Resources::TELEMETRYINTERVALPROPERTY(
+    "Telemetry Interval");
+const std::string
+BiometricEvaluation::MPI::Resources::TELEMETRYLOGSHEETURLPROPERTY(
+    "Telemetry Logsheet URL");
+const std::string
+BiometricEvaluation::MPI::Resources::NODELEADERSPROPERTY("Node Leaders");
+const std::string
+BiometricEvaluation::MPI::Resources::TASKSPERNODELEADERPROPERTY(
+    "Tasks Per Node Leader");
 
 /******************************************************************************/
 /* Class method definitions.                                                  */
@@ -48,8 +106,12 @@ BiometricEvaluation::MPI::Resources::Resources(
     const std::string &propertiesFileName)
 {
 	this->_propertiesFileName = propertiesFileName;
-	this->_rank = ::MPI::COMM_WORLD.Get_rank();
-	this->_numTasks = ::MPI::COMM_WORLD.Get_size();
+	const auto transport = MPI::getTransport();
+	if (transport == nullptr)
+		throw Error::ObjectDoesNotExist("MPI::Runtime has not been "
+		    "constructed");
+	this->_rank = transport->getRank();
+	this->_numTasks = transport->getNumTasks();
 
 	/* Read the properties file */
 	std::unique_ptr<IO::PropertiesFile> props;
@@ -106,6 +168,178 @@ BiometricEvaluation::MPI::Resources::Resources(
 			this->_checkpointPath = "";
 		}
 	}
+
+	/*
+	 * Adaptive work package sizing bounds are only consulted when
+	 * adaptive sizing is enabled, but are validated regardless.
+	 */
+	try {
+		this->_adaptiveChunkSize = props->getPropertyAsBoolean(
+		    MPI::Resources::ADAPTIVECHUNKSIZEPROPERTY);
+	} catch (const Error::ObjectDoesNotExist &) {}
+	try {
+		this->_minChunkSize = props->getPropertyAsInteger(
+		    MPI::Resources::MINCHUNKSIZEPROPERTY);
+	} catch (const Error::ObjectDoesNotExist &) {}
+	try {
+		this->_maxChunkSize = props->getPropertyAsInteger(
+		    MPI::Resources::MAXCHUNKSIZEPROPERTY);
+	} catch (const Error::ObjectDoesNotExist &) {}
+	try {
+		this->_minPackageSize = props->getPropertyAsInteger(
+		    MPI::Resources::MINPACKAGESIZEPROPERTY);
+	} catch (const Error::ObjectDoesNotExist &) {}
+	try {
+		this->_maxPackageSize = props->getPropertyAsInteger(
+		    MPI::Resources::MAXPACKAGESIZEPROPERTY);
+	} catch (const Error::ObjectDoesNotExist &) {}
+	try {
+		this->_packageDuration = props->getPropertyAsDouble(
+		    MPI::Resources::PACKAGEDURATIONPROPERTY);
+	} catch (const Error::ObjectDoesNotExist &) {}
+
+	if (this->_minChunkSize == 0)
+		this->_minChunkSize = 1;
+	if ((this->_maxChunkSize != 0) &&
+	    (this->_maxChunkSize < this->_minChunkSize))
+		throw Error::StrategyError(MPI::Resources::MAXCHUNKSIZEPROPERTY +
+		    " is less than " + MPI::Resources::MINCHUNKSIZEPROPERTY);
+	if ((this->_maxPackageSize != 0) &&
+	    (this->_maxPackageSize < this->_minPackageSize))
+		throw Error::StrategyError(
+		    MPI::Resources::MAXPACKAGESIZEPROPERTY + " is less than " +
+		    MPI::Resources::MINPACKAGESIZEPROPERTY);
+	if (this->_packageDuration <= 0)
+		throw Error::StrategyError(
+		    MPI::Resources::PACKAGEDURATIONPROPERTY +
+		    " must be positive");
+
+	try {
+		const int64_t prefetch = props->getPropertyAsInteger(
+		    MPI::Resources::PREFETCHPACKAGESPROPERTY);
+		if (prefetch < 1)
+			throw Error::StrategyError(
+			    MPI::Resources::PREFETCHPACKAGESPROPERTY +
+			    " must be positive");
+		this->_prefetchPackages = static_cast<uint32_t>(prefetch);
+	} catch (const Error::ObjectDoesNotExist &) {}
+	try {
+		const int64_t sharedMemorySize = props->getPropertyAsInteger(
+		    MPI::Resources::WORKERSHAREDMEMORYPROPERTY);
+		if (sharedMemorySize < 0)
+			throw Error::StrategyError(
+			    MPI::Resources::WORKERSHAREDMEMORYPROPERTY +
+			    " must not be negative");
+		this->_workerSharedMemorySize = sharedMemorySize;
+	} catch (const Error::ObjectDoesNotExist &) {}
+	/*
+	 * Within one process the tasks are threads, and forking a
+	 * process that runs several threads is fragile.
+	 */
+	const bool inProcess = (dynamic_cast<const InProcessTransport *>(
+	    transport.get()) != nullptr);
+	this->_threadedWorkers = inProcess;
+	try {
+		this->_threadedWorkers = props->getPropertyAsBoolean(
+		    MPI::Resources::THREADEDWORKERSPROPERTY);
+	} catch (const Error::ObjectDoesNotExist &) {}
+	if (inProcess && !this->_threadedWorkers)
+		throw Error::StrategyError(
+		    MPI::Resources::THREADEDWORKERSPROPERTY + " must be true "
+		    "for a job run within one process");
+	try {
+		const std::string placement = props->getProperty(
+		    MPI::Resources::WORKERPLACEMENTPROPERTY);
+		try {
+			this->_workerPlacement =
+			    Framework::Enumeration::to_enum<
+			    Process::Placement>(placement);
+		} catch (const Error::ObjectDoesNotExist &) {
+			throw Error::StrategyError("Invalid " +
+			    MPI::Resources::WORKERPLACEMENTPROPERTY +
+			    ": " + placement);
+		}
+	} catch (const Error::ObjectDoesNotExist &) {}
+
+	/*
+	 * Results emitted by work package processors are only returned
+	 * when there is somewhere to keep them.
+	 */
+	try {
+		this->_resultRecordStore = props->getProperty(
+		    MPI::Resources::RESULTRECORDSTOREPROPERTY);
+	} catch (const Error::ObjectDoesNotExist &) {}
+	try {
+		const std::string kind = props->getProperty(
+		    MPI::Resources::RESULTRECORDSTOREKINDPROPERTY);
+		try {
+			this->_resultRecordStoreKind =
+			    Framework::Enumeration::to_enum<
+			    IO::RecordStore::Kind>(kind);
+		} catch (const Error::ObjectDoesNotExist &) {
+			throw Error::StrategyError("Invalid " +
+			    MPI::Resources::RESULTRECORDSTOREKINDPROPERTY +
+			    ": " + kind);
+		}
+	} catch (const Error::ObjectDoesNotExist &) {}
+	try {
+		const int64_t batchSize = props->getPropertyAsInteger(
+		    MPI::Resources::RESULTBATCHSIZEPROPERTY);
+		if (batchSize < 1)
+			throw Error::StrategyError(
+			    MPI::Resources::RESULTBATCHSIZEPROPERTY +
+			    " must be positive");
+		this->_resultBatchSize = batchSize;
+	} catch (const Error::ObjectDoesNotExist &) {}
+	try {
+		const int64_t inFlight = props->getPropertyAsInteger(
+		    MPI::Resources::RESULTBATCHESINFLIGHTPROPERTY);
+		if (inFlight < 1)
+			throw Error::StrategyError(
+			    MPI::Resources::RESULTBATCHESINFLIGHTPROPERTY +
+			    " must be positive");
+		this->_resultBatchesInFlight = static_cast<uint32_t>(inFlight);
+	} catch (const Error::ObjectDoesNotExist &) {}
+
+	try {
+		this->_workPackageTimeout = props->getPropertyAsDouble(
+		    MPI::Resources::WORKPACKAGETIMEOUTPROPERTY);
+		if (this->_workPackageTimeout < 0)
+			throw Error::StrategyError(
+			    MPI::Resources::WORKPACKAGETIMEOUTPROPERTY +
+			    " must not be negative");
+	} catch (const Error::ObjectDoesNotExist &) {}
+	try {
+		this->_speculativePackages = props->getPropertyAsBoolean(
+		    MPI::Resources::SPECULATIVEPACKAGESPROPERTY);
+	} catch (const Error::ObjectDoesNotExist &) {}
+
+	try {
+		this->_telemetryInterval = props->getPropertyAsDouble(
+		    MPI::Resources::TELEMETRYINTERVALPROPERTY);
+		if (this->_telemetryInterval < 0)
+			throw Error::StrategyError(
+			    MPI::Resources::TELEMETRYINTERVALPROPERTY +
+			    " must not be negative");
+	} catch (const Error::ObjectDoesNotExist &) {}
+	try {
+		this->_telemetryLogsheetURL = props->getProperty(
+		    MPI::Resources::TELEMETRYLOGSHEETURLPROPERTY);
+	} catch (const Error::ObjectDoesNotExist &) {}
+
+	try {
+		this->_nodeLeaders = props->getPropertyAsBoolean(
+		    MPI::Resources::NODELEADERSPROPERTY);
+	} catch (const Error::ObjectDoesNotExist &) {}
+	try {
+		const int64_t tasks = props->getPropertyAsInteger(
+		    MPI::Resources::TASKSPERNODELEADERPROPERTY);
+		if (tasks < 0)
+			throw Error::StrategyError(
+			    MPI::Resources::TASKSPERNODELEADERPROPERTY +
+			    " must not be negative");
+		this->_tasksPerNodeLeader = static_cast<uint32_t>(tasks);
+	} catch (const Error::ObjectDoesNotExist &) {}
 }
 
 std::vector<std::string>
@@ -122,6 +356,26 @@ BiometricEvaluation::MPI::Resources::getOptionalProperties()
 	std::vector<std::string> props;
 	props.push_back(MPI::Resources::LOGSHEETURLPROPERTY);
 	props.push_back(MPI::Resources::CHECKPOINTPATHPROPERTY);
+	props.push_back(MPI::Resources::ADAPTIVECHUNKSIZEPROPERTY);
+	props.push_back(MPI::Resources::MINCHUNKSIZEPROPERTY);
+	props.push_back(MPI::Resources::MAXCHUNKSIZEPROPERTY);
+	props.push_back(MPI::Resources::MINPACKAGESIZEPROPERTY);
+	props.push_back(MPI::Resources::MAXPACKAGESIZEPROPERTY);
+	props.push_back(MPI::Resources::PACKAGEDURATIONPROPERTY);
+	props.push_back(MPI::Resources::PREFETCHPACKAGESPROPERTY);
+	props.push_back(MPI::Resources::WORKERSHAREDMEMORYPROPERTY);
+	props.push_back(MPI::Resources::THREADEDWORKERSPROPERTY);
+	props.push_back(MPI::Resources::WORKERPLACEMENTPROPERTY);
+	props.push_back(MPI::Resources::RESULTRECORDSTOREPROPERTY);
+	props.push_back(MPI::Resources::RESULTRECORDSTOREKINDPROPERTY);
+	props.push_back(MPI::Resources::RESULTBATCHSIZEPROPERTY);
+	props.push_back(MPI::Resources::RESULTBATCHESINFLIGHTPROPERTY);
+	props.push_back(MPI::Resources::WORKPACKAGETIMEOUTPROPERTY);
+	props.push_back(MPI::Resources::SPECULATIVEPACKAGESPROPERTY);
+	props.push_back(MPI::Resources::TELEMETRYINTERVALPROPERTY);
+	props.push_back(MPI::Resources::TELEMETRYLOGSHEETURLPROPERTY);
+	props.push_back(MPI::Resources::NODELEADERSPROPERTY);
+	props.push_back(MPI::Resources::TASKSPERNODELEADERPROPERTY);
 	return (props);
 }
 
@@ -168,4 +422,141 @@ BiometricEvaluation::MPI::Resources::getWorkersPerNode() const
 	return (this->_workersPerNode);
 }
 
+bool
+BiometricEvaluation::MPI::Resources::useAdaptiveChunkSize() const
+{
+	return (this->_adaptiveChunkSize);
+}
+
+uint64_t
+BiometricEvaluation::MPI::Resources::getMinChunkSize() const
+{
+	return (this->_minChunkSize);
+}
+
+uint64_t
+BiometricEvaluation::MPI::Resources::getMaxChunkSize() const
+{
+	return (this->_maxChunkSize);
+}
+
+uint64_t
+BiometricEvaluation::MPI::Resources::getMinPackageSize() const
+{
+	return (this->_minPackageSize);
+}
+
+uint64_t
+BiometricEvaluation::MPI::Resources::getMaxPackageSize() const
+{
+	return (this->_maxPackageSize);
+}
+
+double
+BiometricEvaluation::MPI::Resources::getPackageDuration() const
+{
+	return (this->_packageDuration);
+}
+
+uint32_t
+BiometricEvaluation::MPI::Resources::getPrefetchPackages() const
+{
+	return (this->_prefetchPackages);
+}
+
+uint64_t
+BiometricEvaluation::MPI::Resources::getWorkerSharedMemorySize() const
+{
+	return (this->_workerSharedMemorySize);
+}
+
+bool
+BiometricEvaluation::MPI::Resources::useThreadedWorkers() const
+{
+	return (this->_threadedWorkers);
+}
+
+BiometricEvaluation::Process::Placement
+BiometricEvaluation::MPI::Resources::getWorkerPlacement() const
+{
+	return (this->_workerPlacement);
+}
+
+std::string
+BiometricEvaluation::MPI::Resources::getResultRecordStore() const
+{
+	return (this->_resultRecordStore);
+}
+
+BiometricEvaluation::IO::RecordStore::Kind
+BiometricEvaluation::MPI::Resources::getResultRecordStoreKind() const
+{
+	return (this->_resultRecordStoreKind);
+}
+
+uint64_t
+BiometricEvaluation::MPI::Resources::getResultBatchSize() const
+{
+	return (this->_resultBatchSize);
+}
+
+uint32_t
+BiometricEvaluation::MPI::Resources::getResultBatchesInFlight() const
+{
+	return (this->_resultBatchesInFlight);
+}
+
+double
+BiometricEvaluation::MPI::Resources::getWorkPackageTimeout() const
+{
+	return (this->_workPackageTimeout);
+}
+
+bool
+BiometricEvaluation::MPI::Resources::useSpeculativePackages() const
+{
+	return (this->_speculativePackages);
+}
+
+double
+BiometricEvaluation::MPI::Resources::getTelemetryInterval() const
+{
+	return (this->_telemetryInterval);
+}
 
+std::string
+BiometricEvaluation::MPI::Resources::getTelemetryLogsheetURL() const
+{
+	return (this->_telemetryLogsheetURL);
+}
+
+bool
+BiometricEvaluation::MPI::Resources::collectsTelemetry() const
+{
+	return (this->_telemetryInterval > 0);
+}
+
+bool
+BiometricEvaluation::MPI::Resources::useNodeLeaders() const
+{
+	return (this->_nodeLeaders);
+}
+
+uint32_t
+BiometricEvaluation::MPI::Resources::getTasksPerNodeLeader() const
+{
+	return (this->_tasksPerNodeLeader);
+}
+
+bool
+BiometricEvaluation::MPI::Resources::resendsWorkPackages() const
+{
+	return ((this->_workPackageTimeout > 0) || this->_speculativePackages);
+}
+
+bool
+BiometricEvaluation::MPI::Resources::tracksWorkPackages() const
+{
+	return (MPI::checkpointEnable || this->resendsWorkPackages() ||
+	    this->useAdaptiveChunkSize());
+}
@@ -0,0 +1,173 @@
+/**
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties.  Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain.  NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+#include <algorithm>
+#include <cstring>
+
+#include <be_error_exception.h>
+#include <be_mpi_resultbatch.h>
+
+/*
+ * Each result is serialized as the key length (uint32_t), the key, the
+ * value length (uint64_t), and the value, in host byte order.
+ */
+static const uint64_t KEYLENGTHSIZE{sizeof(uint32_t)};
+static const uint64_t VALUELENGTHSIZE{sizeof(uint64_t)};
+
+/******************************************************************************/
+/* Class method definitions.                                                  */
+/******************************************************************************/
+BiometricEvaluation::MPI::ResultBatch::ResultBatch()
+{
+}
+
+BiometricEvaluation::MPI::ResultBatch::ResultBatch(
+    Memory::uint8Array &&data) :
+    _numResults{countResults(data, data.size())}
+{
+	this->_data = std::move(data);
+	this->_capacity = this->_data.size();
+}
+
+uint64_t
+BiometricEvaluation::MPI::ResultBatch::countResults(
+    const uint8_t *data,
+    uint64_t size)
+{
+	uint64_t numResults{0};
+	uint64_t offset{0};
+	while (offset < size) {
+		if (size - offset < KEYLENGTHSIZE)
+			throw Error::DataError("Truncated result key length");
+		uint32_t keyLength;
+		std::memcpy(&keyLength, data + offset, KEYLENGTHSIZE);
+		offset += KEYLENGTHSIZE;
+		if (size - offset < keyLength + VALUELENGTHSIZE)
+			throw Error::DataError("Truncated result key");
+		offset += keyLength;
+
+		uint64_t valueLength;
+		std::memcpy(&valueLength, data + offset, VALUELENGTHSIZE);
+		offset += VALUELENGTHSIZE;
+		if (size - offset < valueLength)
+			throw Error::DataError("Truncated result value");
+		offset += valueLength;
+		numResults++;
+	}
+	return (numResults);
+}
+
+/******************************************************************************/
+/* Object method definitions.                                                 */
+/******************************************************************************/
+uint8_t *
+BiometricEvaluation::MPI::ResultBatch::extend(
+    uint64_t size)
+{
+	/* Grow geometrically; resize() only reallocates past capacity */
+	const uint64_t offset = this->_data.size();
+	if (offset + size > this->_capacity) {
+		this->_capacity = std::max(offset + size, 2 * this->_capacity);
+		this->_data.resize(this->_capacity);
+	}
+	this->_data.resize(offset + size);
+	return (&this->_data[offset]);
+}
+
+void
+BiometricEvaluation::MPI::ResultBatch::add(
+    const std::string &key,
+    const void *value,
+    uint64_t size)
+{
+	const uint32_t keyLength = static_cast<uint32_t>(key.size());
+	uint8_t *data = this->extend(KEYLENGTHSIZE + keyLength +
+	    VALUELENGTHSIZE + size);
+	std::memcpy(data, &keyLength, KEYLENGTHSIZE);
+	data += KEYLENGTHSIZE;
+	std::memcpy(data, key.data(), keyLength);
+	data += keyLength;
+	std::memcpy(data, &size, VALUELENGTHSIZE);
+	data += VALUELENGTHSIZE;
+	if (size != 0)
+		std::memcpy(data, value, size);
+	this->_numResults++;
+}
+
+void
+BiometricEvaluation::MPI::ResultBatch::append(
+    const uint8_t *data,
+    uint64_t size)
+{
+	const uint64_t numResults = countResults(data, size);
+	if (size != 0)
+		std::memcpy(this->extend(size), data, size);
+	this->_numResults += numResults;
+}
+
+std::vector<BiometricEvaluation::MPI::ResultBatch::Result>
+BiometricEvaluation::MPI::ResultBatch::getResults()
+    const
+{
+	std::vector<Result> results;
+	results.reserve(this->_numResults);
+
+	const uint8_t *data = this->_data;
+	uint64_t offset{0};
+	while (offset < this->_data.size()) {
+		uint32_t keyLength;
+		std::memcpy(&keyLength, data + offset, KEYLENGTHSIZE);
+		offset += KEYLENGTHSIZE;
+		std::string key(reinterpret_cast<const char *>(data + offset),
+		    keyLength);
+		offset += keyLength;
+
+		uint64_t valueLength;
+		std::memcpy(&valueLength, data + offset, VALUELENGTHSIZE);
+		offset += VALUELENGTHSIZE;
+		results.push_back({std::move(key), data + offset, valueLength});
+		offset += valueLength;
+	}
+	return (results);
+}
+
+const BiometricEvaluation::Memory::uint8Array &
+BiometricEvaluation::MPI::ResultBatch::getData()
+    const
+{
+	return (this->_data);
+}
+
+uint64_t
+BiometricEvaluation::MPI::ResultBatch::getSize()
+    const
+{
+	return (this->_data.size());
+}
+
+uint64_t
+BiometricEvaluation::MPI::ResultBatch::getNumResults()
+    const
+{
+	return (this->_numResults);
+}
+
+bool
+BiometricEvaluation::MPI::ResultBatch::empty()
+    const
+{
+	return (this->_numResults == 0);
+}
+
+void
+BiometricEvaluation::MPI::ResultBatch::clear()
+{
+	this->_data.resize(0);
+	this->_numResults = 0;
+}
@@ -0,0 +1,166 @@
+/**
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties.  Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain.  NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+#include <be_error_exception.h>
+#include <be_mpi_resultbatch.h>
+#include <be_mpi_resultcollector.h>
+
+/******************************************************************************/
+/* Class method definitions.                                                  */
+/******************************************************************************/
+BiometricEvaluation::MPI::ResultCollector::ResultCollector(
+    const std::string &pathname,
+    IO::RecordStore::Kind kind)
+{
+	try {
+		this->_recordStore = IO::RecordStore::openRecordStore(pathname,
+		    IO::Mode::ReadWrite);
+	} catch (const Error::ObjectDoesNotExist &) {
+		this->_recordStore = IO::RecordStore::createRecordStore(
+		    pathname, "Results", kind);
+		this->_recordStore->sync();
+	}
+
+	this->_thread = std::thread(&ResultCollector::run, this);
+}
+
+/******************************************************************************/
+/* Object method definitions.                                                 */
+/******************************************************************************/
+void
+BiometricEvaluation::MPI::ResultCollector::add(
+    int source,
+    Memory::uint8Array &&data)
+{
+	{
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		if (this->_finishing)
+			throw Error::StrategyError("Result collection finished");
+		this->_queue.emplace_back(source, std::move(data));
+	}
+	this->_condition.notify_all();
+}
+
+std::vector<std::pair<int, bool>>
+BiometricEvaluation::MPI::ResultCollector::takeFinished()
+{
+	std::vector<std::pair<int, bool>> finished;
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	finished.swap(this->_finished);
+	return (finished);
+}
+
+void
+BiometricEvaluation::MPI::ResultCollector::run()
+{
+	while (true) {
+		std::pair<int, Memory::uint8Array> batch;
+		{
+			std::unique_lock<std::mutex> lock(this->_mutex);
+			this->_condition.wait(lock, [this] {
+			    return (!this->_queue.empty() ||
+			    this->_finishing); });
+			if (this->_queue.empty())
+				return;
+			batch = std::move(this->_queue.front());
+			this->_queue.pop_front();
+		}
+
+		const bool written = this->write(batch.second);
+
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		this->_finished.emplace_back(batch.first, written);
+	}
+}
+
+bool
+BiometricEvaluation::MPI::ResultCollector::write(
+    Memory::uint8Array &data)
+{
+	uint64_t numWritten{0}, numReplaced{0}, numFailed{0};
+	try {
+		const MPI::ResultBatch batch(std::move(data));
+		for (const auto &result : batch.getResults()) {
+			try {
+				try {
+					this->_recordStore->insert(result.key,
+					    result.value, result.size);
+				} catch (const Error::ObjectExists &) {
+					this->_recordStore->replace(result.key,
+					    result.value, result.size);
+					numReplaced++;
+				}
+				numWritten++;
+			} catch (const Error::Exception &) {
+				numFailed++;
+			}
+		}
+	} catch (const Error::DataError &) {
+		numFailed++;
+	}
+
+	/*
+	 * A batch is acknowledged once written, after which the work
+	 * that produced it may be recorded as complete, so the
+	 * RecordStore must be usable should the job not end cleanly.
+	 */
+	try {
+		this->_recordStore->sync();
+	} catch (const Error::Exception &) {
+		numFailed++;
+	}
+
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	this->_numWritten += numWritten;
+	this->_numReplaced += numReplaced;
+	this->_numFailed += numFailed;
+	return (numFailed == 0);
+}
+
+void
+BiometricEvaluation::MPI::ResultCollector::finish()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		this->_finishing = true;
+	}
+	this->_condition.notify_all();
+	if (this->_thread.joinable()) {
+		this->_thread.join();
+		this->_recordStore->sync();
+	}
+}
+
+uint64_t
+BiometricEvaluation::MPI::ResultCollector::getNumWritten()
+{
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	return (this->_numWritten);
+}
+
+uint64_t
+BiometricEvaluation::MPI::ResultCollector::getNumReplaced()
+{
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	return (this->_numReplaced);
+}
+
+uint64_t
+BiometricEvaluation::MPI::ResultCollector::getNumFailed()
+{
+	std::lock_guard<std::mutex> lock(this->_mutex);
+	return (this->_numFailed);
+}
+
+BiometricEvaluation::MPI::ResultCollector::~ResultCollector()
+{
+	try {
+		this->finish();
+	} catch (...) {}
+}
@@ -7,11 +7,17 @@
  * its use by other parties, and makes no guarantees, expressed or implied,
  * about its quality, reliability, or any other characteristic.
  */
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
 #include <sstream>
-#include <mpi.h>
 #include <csignal>
+#include <thread>
 
 #include <be_mpi_runtime.h>
+#include "be_mpi_inprocesstransport_impl.h"
+#include "be_mpi_mpitransport_impl.h"
 
 using namespace BiometricEvaluation;
 
@@ -24,6 +30,13 @@ using namespace BiometricEvaluation;
 bool BiometricEvaluation::MPI::Exit;
 bool BiometricEvaluation::MPI::QuickExit;
 bool BiometricEvaluation::MPI::TermExit;
+int BiometricEvaluation::MPI::signalDescriptor{-1};
+
+/*
+ * Self-pipe written by the signal handler, so that a signal can wake
+ * a task waiting in poll().
+ */
+static int signalPipe[2]{-1, -1};
 
 /*
  * Whether capture checkpoint information, and/or restore a checkpoint 
@@ -39,7 +52,21 @@ BiometricEvaluation::MPI::Runtime::Runtime(
     _argc{argc}, _argv{argv}
 {
 	BiometricEvaluation::MPI::checkpointEnable = checkpointEnable;
-	::MPI::Init(this->_argc, this->_argv);
+	this->_transport.reset(new MPITransport(this->_argc, this->_argv));
+	MPI::setTransport(this->_transport);
+}
+
+BiometricEvaluation::MPI::Runtime::Runtime(
+    bool checkpointEnable) :
+    _argc{0}, _argv{nullptr}, _inProcess{true}
+{
+	BiometricEvaluation::MPI::checkpointEnable = checkpointEnable;
+	/* Not left over from an earlier job run by this process */
+	BiometricEvaluation::MPI::doCheckpointRestore = false;
+
+	/* The Distributor and a single Receiver */
+	this->_transport.reset(new InProcessTransport(2));
+	MPI::setTransport(this->_transport);
 }
 
 BiometricEvaluation::MPI::Runtime::~Runtime()
@@ -62,6 +89,13 @@ signalHandler(int signo)
 		default:
 			break;	/* ignore */
 	}
+
+	if (signalPipe[1] != -1) {
+		const int savedErrno = errno;
+		const char event{0};
+		(void)::write(signalPipe[1], &event, sizeof(event));
+		errno = savedErrno;
+	}
 }
 
 static void
@@ -70,6 +104,13 @@ setExitConditions()
 	BiometricEvaluation::MPI::Exit = false;
 	BiometricEvaluation::MPI::QuickExit = false;
 	BiometricEvaluation::MPI::TermExit = false;
+	if ((signalPipe[0] == -1) && (::pipe(signalPipe) == 0)) {
+		for (const auto fd : signalPipe) {
+			::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+			::fcntl(fd, F_SETFD, FD_CLOEXEC);
+		}
+		BiometricEvaluation::MPI::signalDescriptor = signalPipe[0];
+	}
 	struct sigaction sa;
 	sigemptyset(&sa.sa_mask);       /* Don't block other signals */
 	sa.sa_handler = signalHandler;
@@ -84,7 +125,44 @@ BiometricEvaluation::MPI::Runtime::start(
     BiometricEvaluation::MPI::Receiver &receiver)
 {
 	setExitConditions();
-	if (::MPI::COMM_WORLD.Get_rank() == 0)
+
+	/*
+	 * Within a single process, the Receiver is run by a thread of
+	 * its own as Task-1, while the calling thread is Task-0.
+	 */
+	if (this->_inProcess) {
+		/*
+		 * A task that fails is ended, so that the other is not
+		 * left waiting on it forever.
+		 */
+		auto transport = static_cast<InProcessTransport *>(
+		    this->_transport.get());
+		std::thread receiverThread([&receiver, transport]() {
+			InProcessTransport::setTaskRank(1);
+			try {
+				receiver.start();
+			} catch (const Error::Exception &e) {
+				printStatus("Could not start receiver: "
+				    + e.whatString());
+				transport->endTask();
+			}
+			printStatus("Finished");
+		});
+		try {
+			distributor.start();
+		} catch (const Error::Exception &e) {
+			printStatus("Could not start distributor: "
+			    + e.whatString());
+			/* As if by a quick exit signal, then release waits */
+			signalHandler(SIGINT);
+			transport->endTask();
+		}
+		receiverThread.join();
+		printStatus("Finished");
+		return;
+	}
+
+	if (this->_transport->getRank() == 0)
 		try {
 			distributor.start();
 		} catch (const Error::Exception &e) {
@@ -105,12 +183,12 @@ BiometricEvaluation::MPI::Runtime::start(
 void
 BiometricEvaluation::MPI::Runtime::shutdown()
 {
-	::MPI::Finalize();
+	this->_transport->shutdown();
 }
 
 void
 BiometricEvaluation::MPI::Runtime::abort(int errcode)
 {
-	::MPI::COMM_WORLD.Abort(errcode);
+	this->_transport->abort(errcode);
 }
 
@@ -0,0 +1,127 @@
+/**
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties.  Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain.  NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+#include <iomanip>
+#include <sstream>
+
+#include <be_mpi_telemetry.h>
+
+BiometricEvaluation::MPI::Telemetry::BlockedTimer::BlockedTimer(
+    Telemetry &telemetry) :
+    _telemetry(telemetry),
+    _start(Clock::now())
+{
+
+}
+
+BiometricEvaluation::MPI::Telemetry::BlockedTimer::~BlockedTimer()
+{
+	this->_telemetry.addBlocked(Clock::now() - this->_start);
+}
+
+BiometricEvaluation::MPI::Telemetry::Telemetry(
+    int rank,
+    uint64_t numWorkers) :
+    _start(Clock::now()),
+    _lastSample(_start)
+{
+	this->_sample.rank = rank;
+	this->_sample.numWorkers = numWorkers;
+}
+
+void
+BiometricEvaluation::MPI::Telemetry::countPackage(
+    uint64_t numElements,
+    uint64_t size)
+{
+	this->_sample.packages++;
+	this->_sample.elements += numElements;
+	this->_sample.bytes += size;
+}
+
+void
+BiometricEvaluation::MPI::Telemetry::countProcessed(
+    Clock::time_point start)
+{
+	this->_sample.packagesProcessed++;
+	this->_sample.busy += std::chrono::duration<double>(
+	    Clock::now() - start).count();
+}
+
+void
+BiometricEvaluation::MPI::Telemetry::addBlocked(
+    Clock::duration duration)
+{
+	this->_sample.blocked += std::chrono::duration<double>(
+	    duration).count();
+}
+
+void
+BiometricEvaluation::MPI::Telemetry::setQueueDepths(
+    uint64_t queued,
+    uint64_t idle)
+{
+	this->_sample.queued = queued;
+	this->_sample.idle = idle;
+}
+
+BiometricEvaluation::MPI::Telemetry::Sample
+BiometricEvaluation::MPI::Telemetry::getSample(
+    bool final) const
+{
+	Sample sample = this->_sample;
+	sample.final = final;
+	sample.elapsed = std::chrono::duration<double>(
+	    Clock::now() - this->_start).count();
+	return (sample);
+}
+
+bool
+BiometricEvaluation::MPI::Telemetry::sampleDue(
+    double interval)
+{
+	const auto now = Clock::now();
+	if (std::chrono::duration<double>(now - this->_lastSample).count() <
+	    interval)
+		return (false);
+	this->_lastSample = now;
+	return (true);
+}
+
+std::string
+BiometricEvaluation::MPI::Telemetry::getHeader()
+{
+	return ("Type Rank Workers Elapsed Packages Elements Bytes "
+	    "Processed Blocked Busy Queued Idle PackagesPerSec "
+	    "ElementsPerSec BlockedFraction BusyFraction");
+}
+
+std::string
+BiometricEvaluation::MPI::Telemetry::toString(
+    const std::string &type,
+    const Sample &sample)
+{
+	const double elapsed = sample.elapsed;
+	const auto perSecond = [&](double value) -> double {
+		return (elapsed > 0 ? value / elapsed : 0);
+	};
+	/* Worker time available is the elapsed time of every worker */
+	const double workerTime = elapsed * sample.numWorkers;
+
+	std::ostringstream s;
+	s << std::fixed << std::setprecision(3);
+	s << type << " " << sample.rank << " " << sample.numWorkers << " " <<
+	    elapsed << " " << sample.packages << " " << sample.elements <<
+	    " " << sample.bytes << " " << sample.packagesProcessed << " " <<
+	    sample.blocked << " " << sample.busy << " " << sample.queued <<
+	    " " << sample.idle << " " << perSecond(sample.packages) << " " <<
+	    perSecond(sample.elements) << " " << perSecond(sample.blocked) <<
+	    " " << (workerTime > 0 ? sample.busy / workerTime : 0);
+	return (s.str());
+}
@@ -0,0 +1,44 @@
+/**
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties.  Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain.  NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+#include <be_mpi_transport.h>
+
+namespace BE = BiometricEvaluation;
+
+/*
+ * The Transport of the job in this process.
+ */
+static std::shared_ptr<BE::MPI::Transport> transport;
+
+const int BiometricEvaluation::MPI::Transport::ANYSOURCE{-1};
+
+BiometricEvaluation::MPI::Transport::MessageWaiter::~MessageWaiter()
+{
+}
+
+BiometricEvaluation::MPI::Transport::SendRequest::~SendRequest()
+{
+}
+
+BiometricEvaluation::MPI::Transport::~Transport()
+{
+}
+
+std::shared_ptr<BiometricEvaluation::MPI::Transport>
+BiometricEvaluation::MPI::getTransport()
+{
+	return (transport);
+}
+
+void
+BiometricEvaluation::MPI::setTransport(
+    const std::shared_ptr<Transport> &newTransport)
+{
+	transport = newTransport;
+}
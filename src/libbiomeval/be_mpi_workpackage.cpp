@@ -8,6 +8,8 @@
  * about its quality, reliability, or any other characteristic.
  */
 
+#include <cstring>
+
 #include <be_mpi_workpackage.h>
 
 using namespace BiometricEvaluation;
@@ -22,7 +24,13 @@ BiometricEvaluation::MPI::WorkPackage::WorkPackage()
 BiometricEvaluation::MPI::WorkPackage::WorkPackage(
     const Memory::uint8Array &data)
 {
-	this->_data = data;
+	this->setData(data);
+}
+
+BiometricEvaluation::MPI::WorkPackage::WorkPackage(
+    Memory::uint8Array &&data)
+{
+	this->setData(std::move(data));
 }
 
 /******************************************************************************/
@@ -36,19 +44,61 @@ void
 BiometricEvaluation::MPI::WorkPackage::getData(Memory::uint8Array &data)
     const
 {
-	data = this->_data;
+	data = this->getData();
+}
+
+const BiometricEvaluation::Memory::uint8Array &
+BiometricEvaluation::MPI::WorkPackage::getData()
+    const
+{
+	if (this->_segments.size() != 1) {
+		Memory::uint8Array data(this->_size);
+		uint64_t offset = 0;
+		for (const auto &segment : this->_segments) {
+			if (segment.size() == 0)
+				continue;
+			std::memcpy(&data[offset], segment, segment.size());
+			offset += segment.size();
+		}
+		this->_segments.clear();
+		this->_segments.push_back(std::move(data));
+	}
+	return (this->_segments.front());
 }
 
 void
 BiometricEvaluation::MPI::WorkPackage::setData(const Memory::uint8Array &data)
 {
-	this->_data = data;
+	this->setData(Memory::uint8Array(data));
+}
+
+void
+BiometricEvaluation::MPI::WorkPackage::setData(Memory::uint8Array &&data)
+{
+	this->_segments.clear();
+	this->_size = 0;
+	this->appendData(std::move(data));
+}
+
+void
+BiometricEvaluation::MPI::WorkPackage::appendData(
+    Memory::uint8Array &&segment)
+{
+	this->_size += segment.size();
+	this->_segments.push_back(std::move(segment));
+}
+
+const std::vector<BiometricEvaluation::Memory::uint8Array> &
+BiometricEvaluation::MPI::WorkPackage::getSegments()
+    const
+{
+	return (this->_segments);
 }
 
 uint64_t
 BiometricEvaluation::MPI::WorkPackage::getSize() const
 {
-	return (this->_data.size());
+	return (this->_size);
 }
 
 uint64_t
@@ -61,6 +111,19 @@ void
 BiometricEvaluation::MPI::WorkPackage::setNumElements(
     const uint64_t numElements)
 {
-	this->_numElements = numElements;;
+	this->_numElements = numElements;
+}
+
+uint64_t
+BiometricEvaluation::MPI::WorkPackage::getID() const
+{
+	return (this->_id);
+}
+
+void
+BiometricEvaluation::MPI::WorkPackage::setID(
+    const uint64_t id)
+{
+	this->_id = id;
 }
 
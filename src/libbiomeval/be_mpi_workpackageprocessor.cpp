@@ -15,6 +15,13 @@ BiometricEvaluation::MPI::WorkPackageProcessor::~WorkPackageProcessor()
 {
 }
 
+std::shared_ptr<BiometricEvaluation::MPI::WorkPackageProcessor>
+BiometricEvaluation::MPI::WorkPackageProcessor::newThreadedProcessor(
+    std::shared_ptr<BE::IO::Logsheet> &logsheet)
+{
+	return (this->newProcessor(logsheet));
+}
+
 void
 BiometricEvaluation::MPI::WorkPackageProcessor::setLogsheet(
     std::shared_ptr<BE::IO::Logsheet> &logsheet)
@@ -32,3 +39,28 @@ void
 BiometricEvaluation::MPI::WorkPackageProcessor::performShutdown()
 {
 }
+
+void
+BiometricEvaluation::MPI::WorkPackageProcessor::emitResult(
+    const std::string &key,
+    const void *value,
+    uint64_t size)
+{
+	this->_results.add(key, value, size);
+}
+
+void
+BiometricEvaluation::MPI::WorkPackageProcessor::emitResult(
+    const std::string &key,
+    const Memory::uint8Array &value)
+{
+	this->_results.add(key, value, value.size());
+}
+
+BiometricEvaluation::MPI::ResultBatch
+BiometricEvaluation::MPI::WorkPackageProcessor::takeResults()
+{
+	BE::MPI::ResultBatch results(std::move(this->_results));
+	this->_results = BE::MPI::ResultBatch();
+	return (results);
+}
@@ -0,0 +1,193 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <system_error>
+
+#include <be_error_exception.h>
+#include <be_process_executor.h>
+
+namespace BE = BiometricEvaluation;
+
+/** Executor that owns the calling thread, if any */
+static thread_local const BE::Process::Executor *currentExecutor{nullptr};
+/** Index of the calling thread's queue in currentExecutor */
+static thread_local uint32_t currentIndex{0};
+
+/** Chunks per thread made by parallel loops, to even out uneven work */
+static const uint64_t ChunksPerThread = 4;
+
+BiometricEvaluation::Process::Executor::Executor(
+    uint32_t numThreads)
+{
+	if (numThreads == 0)
+		numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+	this->_queues.reserve(numThreads);
+	for (uint32_t i = 0; i < numThreads; i++)
+		this->_queues.push_back(std::make_unique<Queue>());
+
+	this->_threads.reserve(numThreads);
+	try {
+		for (uint32_t i = 0; i < numThreads; i++)
+			this->_threads.emplace_back(&Executor::threadMain,
+			    this, i);
+	} catch (const std::system_error &e) {
+		{
+			std::lock_guard<std::mutex> lock(this->_mutex);
+			this->_stopping = true;
+		}
+		this->_taskQueued.notify_all();
+		for (auto &thread : this->_threads)
+			thread.join();
+		throw Error::StrategyError("Could not start thread (" +
+		    std::string(e.what()) + ")");
+	}
+}
+
+BiometricEvaluation::Process::Executor::~Executor()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		this->_stopping = true;
+	}
+	this->_taskQueued.notify_all();
+	for (auto &thread : this->_threads)
+		thread.join();
+}
+
+uint32_t
+BiometricEvaluation::Process::Executor::getNumThreads()
+    const
+{
+	return (static_cast<uint32_t>(this->_threads.size()));
+}
+
+bool
+BiometricEvaluation::Process::Executor::isPoolThread()
+    const
+{
+	return (currentExecutor == this);
+}
+
+void
+BiometricEvaluation::Process::Executor::enqueue(
+    std::function<void()> task)
+{
+	uint32_t index;
+	if (this->isPoolThread())
+		index = currentIndex;
+	else
+		index = this->_nextQueue.fetch_add(1,
+		    std::memory_order_relaxed) % this->_queues.size();
+
+	{
+		std::lock_guard<std::mutex> lock(this->_queues[index]->mutex);
+		this->_queues[index]->tasks.push_back(std::move(task));
+	}
+
+	/*
+	 * Count under the sleep mutex so a thread that has just found
+	 * nothing to do cannot miss the notification.
+	 */
+	{
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		this->_numQueued++;
+	}
+	this->_taskQueued.notify_one();
+}
+
+bool
+BiometricEvaluation::Process::Executor::takeTask(
+    uint32_t index,
+    std::function<void()> &task)
+{
+	/* Newest of our own tasks, whose data is most likely cached */
+	{
+		Queue &own = *this->_queues[index];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.tasks.empty()) {
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+			this->_numQueued--;
+			return (true);
+		}
+	}
+
+	/* Oldest of another thread's tasks */
+	const uint32_t numQueues = this->_queues.size();
+	for (uint32_t i = 1; i < numQueues; i++) {
+		Queue &victim = *this->_queues[(index + i) % numQueues];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.tasks.empty()) {
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			this->_numQueued--;
+			return (true);
+		}
+	}
+
+	return (false);
+}
+
+bool
+BiometricEvaluation::Process::Executor::runPendingTask()
+{
+	std::function<void()> task;
+	if (!this->takeTask(this->isPoolThread() ? currentIndex : 0, task))
+		return (false);
+	task();
+	return (true);
+}
+
+void
+BiometricEvaluation::Process::Executor::threadMain(
+    uint32_t index)
+{
+	currentExecutor = this;
+	currentIndex = index;
+
+	std::function<void()> task;
+	for (;;) {
+		if (this->takeTask(index, task)) {
+			task();
+			task = nullptr;
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(this->_mutex);
+		this->_taskQueued.wait(lock, [&]() {
+			return (this->_stopping || (this->_numQueued != 0));
+		});
+		/* Finish queued work before stopping */
+		if (this->_stopping && (this->_numQueued == 0))
+			break;
+	}
+
+	currentExecutor = nullptr;
+}
+
+uint64_t
+BiometricEvaluation::Process::Executor::getNumChunks(
+    uint64_t count,
+    uint64_t grainSize)
+    const
+{
+	if (grainSize == 0)
+		return (std::max<uint64_t>(1, std::min<uint64_t>(count,
+		    this->getNumThreads() * ChunksPerThread)));
+	return (std::max<uint64_t>(1, (count + grainSize - 1) / grainSize));
+}
+
+BiometricEvaluation::Process::Executor&
+BiometricEvaluation::Process::Executor::getDefault()
+{
+	static Executor executor{};
+	return (executor);
+}
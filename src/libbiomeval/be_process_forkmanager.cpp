@@ -18,6 +18,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <iterator>
 #include <map>
 
 #include <be_error.h>
@@ -112,19 +113,26 @@ BiometricEvaluation::Process::ForkManager::addWorker(
 void
 BiometricEvaluation::Process::ForkManager::startWorkers(
     bool wait,
-    bool communicate)
+    bool communicate,
+    Placement placement)
 {
 	/* Ensure all Workers have finished their previous assignments */
 	if (this->getNumActiveWorkers() != 0)
 		throw Error::ObjectExists();
 	this->reset();
 
+	/* Place every Worker before starting any */
+	std::vector<std::vector<uint32_t>> cpus;
+	for (uint32_t i = 0; i < getTotalWorkers(); i++)
+		cpus.push_back(getPlacementCPUs(placement, i));
+
 	for (uint32_t i = 0; i < getTotalWorkers(); i++) {
 		std::shared_ptr<ForkWorkerController> fwc =
 		    std::static_pointer_cast<ForkWorkerController>(_workers[i]);
-		fwc->start(communicate);
+		fwc->start(communicate, cpus[i]);
 		_wcStatus[fwc].pid = fwc->getPID();
 		_wcStatus[fwc].isWorking = true;
+		this->watchWorker(fwc);
 	}
 	
 	/* In the child case, start() will eventually exit the child */
@@ -150,7 +158,8 @@ void
 BiometricEvaluation::Process::ForkManager::startWorker(
     std::shared_ptr<WorkerController> worker,
     bool wait,
-    bool communicate)
+    bool communicate,
+    Placement placement)
 {
 	if (worker->isWorking())
 		throw Error::ObjectExists();
@@ -163,12 +172,14 @@ BiometricEvaluation::Process::ForkManager::startWorker(
 
 	std::shared_ptr<ForkWorkerController> fwc =
 	    std::static_pointer_cast<ForkWorkerController>(*it);
-	fwc->start(communicate);
+	fwc->start(communicate, getPlacementCPUs(placement,
+	    std::distance(_workers.begin(), it)));
 	
 	/* In the child case, start() will eventually exit the child */
 	_parent = true;
 	_wcStatus[fwc].pid = fwc->getPID();
 	_wcStatus[fwc].isWorking = true;
+	this->watchWorker(fwc);
 
 	/* Optionally wait for all processes to exit. */
 	if (wait)
@@ -188,7 +199,8 @@ BiometricEvaluation::Process::ForkManager::startWorker(
 
 void
 BiometricEvaluation::Process::ForkWorkerController::start(
-    bool communicate)
+    bool communicate,
+    const std::vector<uint32_t> &cpus)
 {
 	if (this->isWorking())
 		throw Error::ObjectExists();
@@ -221,6 +233,13 @@ BiometricEvaluation::Process::ForkWorkerController::start(
 		    
 		/* Run workerMain() -- required method */
 		int32_t rv;
+		try {
+			bindToCPUs(cpus, true);
+		} catch (const Error::Exception &e) {
+			std::cerr << "PID " << getpid() << ": " <<
+			    e.whatString() << std::endl;
+			std::exit(EXIT_FAILURE);
+		}
 		try {
 			rv = getWorker()->workerMain();
 		} catch (...) {
@@ -256,6 +275,7 @@ BiometricEvaluation::Process::ForkManager::stopWorker(
 		    "by this Manager");
 	
 	_pendingExit.push_back(*it);
+	this->unwatchWorker(*it);
 
 	std::static_pointer_cast<ForkWorkerController>(*it)->stop();
 }
@@ -8,23 +8,34 @@
  * about its quality, reliability, or any other characteristic.
  */
 
-#include <sys/select.h>
+#ifdef Linux
+#include <sys/epoll.h>
+#endif
+
+#include <poll.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <cerrno>
+#include <chrono>
 
 #include <be_error.h>
-#include <be_io_utility.h>
 #include <be_process_manager.h>
 
 BiometricEvaluation::Process::Manager::Manager()
 {
-
+#ifdef Linux
+	_pollFD = epoll_create1(EPOLL_CLOEXEC);
+	if (_pollFD == -1)
+		throw Error::StrategyError("Could not create epoll instance (" +
+		    Error::errorStr() + ")");
+#endif
 }
 
 BiometricEvaluation::Process::Manager::~Manager()
 {
-
+	if (_pollFD != -1)
+		close(_pollFD);
 }
 
 /*
@@ -73,6 +84,8 @@ BiometricEvaluation::Process::Manager::reset()
 	for (auto &worker : this->_workers)
 		worker->reset();
 
+	while (!_watched.empty())
+		this->unwatchPipe(_watched.begin()->first);
 	_pendingExit.clear();
 }
 
@@ -80,97 +93,183 @@ BiometricEvaluation::Process::Manager::reset()
  * Communications
  */
 
-bool
-BiometricEvaluation::Process::Manager::waitForMessage(
-    std::shared_ptr<WorkerController> &sender,
-    int *nextFD,
-    int numSeconds)
-    const
+void
+BiometricEvaluation::Process::Manager::watchWorker(
+    const std::shared_ptr<WorkerController> &worker)
 {
-	bool result = false;
-	fd_set set;
-	
-	/* Listen for all Worker receiving pipes */
-	FD_ZERO(&set);
-	int maxfd = 0, curfd;
-	std::map<std::shared_ptr<WorkerController>, int> fds;
-	
-	struct timeval timeout, *timeoutptr = nullptr;
-	if (numSeconds >= 0) {
-		timeout.tv_sec = numSeconds;
-		timeout.tv_usec = 0;
-		timeoutptr = &timeout;
+	int fd;
+	try {
+		fd = worker->getWorker()->getReceivingPipe();
+	} catch (const Error::Exception&) {
+		/* Communication not enabled, or Worker exiting */
+		return;
 	}
-	
-	/* Round up all receiving pipes */
-	bool finished = false;
-	bool haveFD = false;
-	while (!finished) {
-		for (size_t i = 0; i < _workers.size(); i++) {
-			/*
-                         * Add only active pipes to list: If the worker is
-                         * asked to stop, it will be in the pending exit list;
-                         * if it ended on its own, it won't be working anymore.
-                         */
-			if (find(_pendingExit.begin(), _pendingExit.end(),
-			    _workers[i]) != _pendingExit.end())
-				continue;
-			if (!_workers[i]->isWorking())
-				continue;
-				
-			try {
-				curfd = _workers[i]->getWorker()->
-				    getReceivingPipe();
-				FD_SET(curfd, &set);
-				haveFD = true;
-				if (curfd > maxfd)
-					maxfd = curfd;
-				fds[_workers[i]] = curfd;
-			} catch (const Error::ObjectDoesNotExist&) {
-				/* Don't add pipes for exiting Workers */
-			}
-		}
 
-		/* Don't hang in select if there are no file descriptors */
-		if (!haveFD) {
-			result = false;
-			finished = true;
+	/* A restarted Worker keeps its pipes */
+	if (_watched.find(fd) == _watched.end()) {
+#ifdef Linux
+		struct epoll_event event{};
+		event.events = EPOLLIN;
+		event.data.fd = fd;
+		if (epoll_ctl(_pollFD, EPOLL_CTL_ADD, fd, &event) != 0)
+			throw Error::StrategyError("Could not listen to "
+			    "Worker pipe (" + Error::errorStr() + ")");
+#endif
+	}
+	_watched[fd] = worker;
+}
+
+void
+BiometricEvaluation::Process::Manager::unwatchWorker(
+    const std::shared_ptr<WorkerController> &worker)
+    const
+{
+	/* The Worker may no longer give out its pipe once asked to stop */
+	for (const auto &watched : _watched) {
+		if (watched.second == worker) {
+			this->unwatchPipe(watched.first);
 			break;
 		}
-		
-		int ret = select(maxfd + 1, &set, nullptr, nullptr, timeoutptr);
+	}
+}
+
+void
+BiometricEvaluation::Process::Manager::unwatchPipe(
+    int fd)
+    const
+{
+#ifdef Linux
+	/* Pipe may still be open in later children, so remove explicitly */
+	(void)epoll_ctl(_pollFD, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+	_watched.erase(fd);
+}
+
+std::vector<int>
+BiometricEvaluation::Process::Manager::waitForReadablePipes(
+    int numSeconds)
+    const
+{
+	using Clock = std::chrono::steady_clock;
+	const auto deadline = Clock::now() + std::chrono::seconds(numSeconds);
+
+	std::vector<int> readable;
+	while (readable.empty() && !_watched.empty()) {
+		int timeout = -1;
+		if (numSeconds >= 0)
+			timeout = std::max<int64_t>(0, std::chrono::duration_cast<
+			    std::chrono::milliseconds>(deadline -
+			    Clock::now()).count());
+
 		/*
-		 * We don't reset timeout value here (for Linux systems)
-		 * because when something, or nothing, is available, we return,
-		 * and for interrupted calls can just leave the remaining
-		 * timeout in place.
+		 * Pipes with data are readable; pipes whose Worker ended
+		 * and that hold nothing are not listened to again.
 		 */
-		if (ret == 0) {
-			/* Nothing available */
-			result = false;
-			finished = true;
-		} else if (ret < 0) {
-			/* Could have been interrupted while blocking */
+		std::vector<int> hungUp;
+#ifdef Linux
+		std::vector<struct epoll_event> events(_watched.size());
+		const int ret = epoll_wait(_pollFD, events.data(),
+		    events.size(), timeout);
+		for (int i = 0; i < ret; i++) {
+			if (events[i].events & EPOLLIN)
+				readable.push_back(events[i].data.fd);
+			else
+				hungUp.push_back(events[i].data.fd);
+		}
+#else
+		std::vector<struct pollfd> fds;
+		fds.reserve(_watched.size());
+		for (const auto &watched : _watched)
+			fds.push_back({watched.first, POLLIN, 0});
+		const int ret = ::poll(fds.data(), fds.size(), timeout);
+		for (const auto &pfd : fds) {
+			if ((ret <= 0) || (pfd.revents == 0))
+				continue;
+			if (pfd.revents & POLLIN)
+				readable.push_back(pfd.fd);
+			else
+				hungUp.push_back(pfd.fd);
+		}
+#endif
+		/*
+		 * Could have been interrupted while blocking, such as by
+		 * a Worker exiting. Shared memory channels do not hang up,
+		 * so look for Workers that ended.
+		 */
+		if (ret < 0) {
 			if (errno != EINTR)
-				finished = true;
-		} else {
-			/* Something available -- check what */
-			for (std::map<std::shared_ptr<WorkerController>, int>::
-			    const_iterator it = fds.begin(); it != fds.end();
-			    it++) {
-				if (FD_ISSET(it->second, &set) != 0) {
-					if (nextFD != nullptr)
-						*nextFD = it->second;
-					result = true;
-					sender = it->first;
-					break;
-				}
+				break;
+			for (const auto &watched : _watched)
+				if (!watched.second->isWorking())
+					hungUp.push_back(watched.first);
+		}
+
+		for (const auto fd : hungUp)
+			this->unwatchPipe(fd);
+
+		/*
+		 * Ignore Workers that ended on their own, and shared memory
+		 * channels that were found empty since they signaled.
+		 */
+		for (auto it = readable.begin(); it != readable.end(); ) {
+			const auto &worker = _watched.at(*it);
+			if (!worker->isWorking()) {
+				this->unwatchPipe(*it);
+				it = readable.erase(it);
+			} else if ((worker->getWorker()->
+			    getSharedMemoryChannelSize() != 0) &&
+			    (worker->getWorker()->
+			    getPendingBytesFromWorker() == 0)) {
+				it = readable.erase(it);
+			} else {
+				it++;
 			}
-			finished = true;
 		}
+
+		if ((ret == 0) || ((numSeconds >= 0) &&
+		    (Clock::now() >= deadline)))
+			break;
 	}
 
-	return (result);
+	/* Take turns, starting after the pipe last read */
+	std::sort(readable.begin(), readable.end());
+	std::rotate(readable.begin(), std::upper_bound(readable.begin(),
+	    readable.end(), _lastPipe), readable.end());
+
+	return (readable);
+}
+
+bool
+BiometricEvaluation::Process::Manager::waitForMessage(
+    std::shared_ptr<WorkerController> &sender,
+    int *nextFD,
+    int numSeconds)
+    const
+{
+	const std::vector<int> readable = this->waitForReadablePipes(
+	    numSeconds);
+	if (readable.empty())
+		return (false);
+
+	_lastPipe = readable.front();
+	sender = _watched.at(_lastPipe);
+	if (nextFD != nullptr)
+		*nextFD = _lastPipe;
+
+	return (true);
+}
+
+std::vector<int>
+BiometricEvaluation::Process::Manager::getReceivingPipes()
+    const
+{
+	std::vector<int> pipes;
+	pipes.reserve(_watched.size());
+	for (const auto &watched : _watched)
+		if (watched.second->isWorking())
+			pipes.push_back(watched.first);
+
+	return (pipes);
 }
 
 bool
@@ -180,18 +279,45 @@ BiometricEvaluation::Process::Manager::getNextMessage(
     int timeout)
     const
 {
-	int fd = 0;
-	if (this->waitForMessage(sender, &fd, timeout) == false)
+	if (this->waitForMessage(sender, nullptr, timeout) == false)
 		return (false);
 
-	uint64_t length;
-	IO::Utility::readPipe(&length, sizeof(length), fd);
-	message.resize(length);
-	IO::Utility::readPipe(message, fd);
+	sender->getWorker()->receiveMessageFromWorker(message);
 
 	return (true);
 }
 
+uint64_t
+BiometricEvaluation::Process::Manager::getNextMessages(
+    std::vector<std::pair<std::shared_ptr<WorkerController>,
+    Memory::uint8Array>> &messages,
+    int numSeconds)
+    const
+{
+	uint64_t numMessages = 0;
+	for (const auto fd : this->waitForReadablePipes(numSeconds)) {
+		const auto sender = _watched.at(fd);
+		_lastPipe = fd;
+
+		/*
+		 * Read what was waiting when we looked, at least one
+		 * message, so a chatty Worker cannot hold us here.
+		 */
+		const uint64_t available = sender->getWorker()->
+		    getPendingBytesFromWorker();
+		uint64_t consumed = 0;
+		do {
+			Memory::uint8Array message;
+			sender->getWorker()->receiveMessageFromWorker(message);
+			consumed += sizeof(uint64_t) + message.size();
+			messages.emplace_back(sender, std::move(message));
+			numMessages++;
+		} while (consumed < available);
+	}
+
+	return (numMessages);
+}
+
 void
 BiometricEvaluation::Process::Manager::broadcastMessage(
     Memory::uint8Array &message)
@@ -0,0 +1,214 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <map>
+#include <mutex>
+#include <string>
+
+#ifdef BIOMEVAL_WITH_HWLOC
+#include <hwloc.h>
+#endif
+
+#include <be_error.h>
+#include <be_error_exception.h>
+#include <be_process_placement.h>
+
+namespace BE = BiometricEvaluation;
+
+const std::map<BiometricEvaluation::Process::Placement, std::string>
+BE_Process_Placement_EnumToStringMap = {
+	{BiometricEvaluation::Process::Placement::None, "None"},
+	{BiometricEvaluation::Process::Placement::Compact, "Compact"},
+	{BiometricEvaluation::Process::Placement::Scatter, "Scatter"},
+	{BiometricEvaluation::Process::Placement::PerCore, "Per Core"},
+	{BiometricEvaluation::Process::Placement::PerNUMANode,
+	    "Per NUMA Node"}
+};
+BE_FRAMEWORK_ENUMERATION_DEFINITIONS(
+    BiometricEvaluation::Process::Placement,
+    BE_Process_Placement_EnumToStringMap);
+
+#ifdef BIOMEVAL_WITH_HWLOC
+/**
+ * @brief
+ * Obtain the topology of this machine.
+ * @details
+ * Loaded once and kept, so Workers forked after the first placement
+ * inherit it rather than each loading their own. A loaded topology
+ * may be read from several threads.
+ */
+static hwloc_topology_t
+getTopology()
+{
+	static hwloc_topology_t topology{nullptr};
+	static bool loaded{false};
+	static std::once_flag once;
+
+	std::call_once(once, []() {
+		if (hwloc_topology_init(&topology) != 0)
+			return;
+		if (hwloc_topology_load(topology) != 0) {
+			hwloc_topology_destroy(topology);
+			return;
+		}
+		loaded = true;
+	});
+	if (!loaded)
+		throw BE::Error::NotImplemented("The topology of this machine "
+		    "is unknown");
+	return (topology);
+}
+
+/**
+ * @brief
+ * Obtain the CPUs of each object of a type that may be used.
+ *
+ * @param[in] topology
+ *	Topology of the machine.
+ * @param[in] type
+ *	Type of object.
+ * @param[in] allowed
+ *	CPUs that may be used.
+ *
+ * @return
+ *	CPUs of each object sharing CPUs with allowed, limited to
+ *	allowed. Caller must free each.
+ */
+static std::vector<hwloc_bitmap_t>
+getCPUSets(
+    hwloc_topology_t topology,
+    hwloc_obj_type_t type,
+    hwloc_const_cpuset_t allowed)
+{
+	std::vector<hwloc_bitmap_t> sets;
+	hwloc_obj_t obj{nullptr};
+	while ((obj = hwloc_get_next_obj_by_type(topology, type, obj)) !=
+	    nullptr) {
+		if ((obj->cpuset == nullptr) ||
+		    !hwloc_bitmap_intersects(obj->cpuset, allowed))
+			continue;
+		sets.push_back(hwloc_bitmap_alloc());
+		hwloc_bitmap_and(sets.back(), obj->cpuset, allowed);
+	}
+	return (sets);
+}
+
+/** Free CPU sets from getCPUSets() */
+static void
+freeCPUSets(
+    std::vector<hwloc_bitmap_t> &sets)
+{
+	for (auto &set : sets)
+		hwloc_bitmap_free(set);
+	sets.clear();
+}
+#endif /* BIOMEVAL_WITH_HWLOC */
+
+std::vector<uint32_t>
+BiometricEvaluation::Process::getPlacementCPUs(
+    Placement placement,
+    uint32_t index)
+{
+	if (placement == Placement::None)
+		return {};
+
+#ifdef BIOMEVAL_WITH_HWLOC
+	hwloc_topology_t topology = getTopology();
+	hwloc_bitmap_t cpuset = hwloc_bitmap_alloc();
+	if (cpuset == nullptr)
+		throw Error::StrategyError("Could not allocate CPU set");
+
+	/* Stay within CPUs given to us, such as by an MPI launcher */
+	if (hwloc_get_cpubind(topology, cpuset, HWLOC_CPUBIND_THREAD) != 0)
+		hwloc_bitmap_copy(cpuset,
+		    hwloc_topology_get_allowed_cpuset(topology));
+
+	std::vector<hwloc_bitmap_t> sets;
+	switch (placement) {
+	case Placement::None:
+		break;
+	case Placement::Compact:
+		sets = getCPUSets(topology, HWLOC_OBJ_PU, cpuset);
+		break;
+	case Placement::PerCore:
+		sets = getCPUSets(topology, HWLOC_OBJ_CORE, cpuset);
+		if (sets.empty())
+			sets = getCPUSets(topology, HWLOC_OBJ_PU, cpuset);
+		break;
+	case Placement::PerNUMANode:
+		sets = getCPUSets(topology, HWLOC_OBJ_NUMANODE, cpuset);
+		break;
+	case Placement::Scatter: {
+		/* Take NUMA nodes in turn, then cores within each */
+		std::vector<hwloc_bitmap_t> nodes = getCPUSets(topology,
+		    HWLOC_OBJ_NUMANODE, cpuset);
+		if (!nodes.empty()) {
+			hwloc_bitmap_copy(cpuset,
+			    nodes[index % nodes.size()]);
+			index /= nodes.size();
+		}
+		freeCPUSets(nodes);
+		sets = getCPUSets(topology, HWLOC_OBJ_CORE, cpuset);
+		break;
+	}
+	}
+	if (!sets.empty())
+		hwloc_bitmap_copy(cpuset, sets[index % sets.size()]);
+	freeCPUSets(sets);
+
+	std::vector<uint32_t> cpus;
+	unsigned int cpu;
+	hwloc_bitmap_foreach_begin(cpu, cpuset)
+		cpus.push_back(cpu);
+	hwloc_bitmap_foreach_end();
+	hwloc_bitmap_free(cpuset);
+
+	return (cpus);
+#else
+	(void)index;
+	throw Error::NotImplemented("Placing Workers requires hwloc");
+#endif
+}
+
+void
+BiometricEvaluation::Process::bindToCPUs(
+    const std::vector<uint32_t> &cpus,
+    bool wholeProcess)
+{
+	if (cpus.empty())
+		return;
+
+#ifdef BIOMEVAL_WITH_HWLOC
+	hwloc_topology_t topology = getTopology();
+	hwloc_bitmap_t cpuset = hwloc_bitmap_alloc();
+	if (cpuset == nullptr)
+		throw Error::StrategyError("Could not allocate CPU set");
+	for (const auto cpu : cpus)
+		hwloc_bitmap_set(cpuset, cpu);
+
+	if (hwloc_set_cpubind(topology, cpuset, wholeProcess ?
+	    HWLOC_CPUBIND_PROCESS : HWLOC_CPUBIND_THREAD) != 0) {
+		const std::string reason = Error::errorStr();
+		hwloc_bitmap_free(cpuset);
+		throw Error::StrategyError("Could not bind to CPUs (" +
+		    reason + ")");
+	}
+
+	/*
+	 * Memory is not bound: first-touch allocation already places it
+	 * on the NUMA nodes of cpuset, and may still spill to other nodes
+	 * when those run out.
+	 */
+	hwloc_bitmap_free(cpuset);
+#else
+	(void)wholeProcess;
+	throw Error::NotImplemented("Placing Workers requires hwloc");
+#endif
+}
@@ -11,6 +11,8 @@
 #include <cerrno>
 #include <cstdlib>
 #include <algorithm>
+#include <iostream>
+#include <iterator>
 
 #include <be_error.h>
 #include <be_error_signal_manager.h>
@@ -35,18 +37,27 @@ BiometricEvaluation::Process::POSIXThreadManager::addWorker(
 void
 BiometricEvaluation::Process::POSIXThreadManager::startWorkers(
     bool wait,
-    bool communicate)
+    bool communicate,
+    Placement placement)
 {
 	/* Ensure all Workers have finished their previous assignments */
 	if (this->getNumActiveWorkers() != 0)
 		throw Error::ObjectExists();
 	this->reset();
 
+	/* Place every Worker before starting any */
+	std::vector<std::vector<uint32_t>> cpus;
+	for (uint32_t i = 0; i < this->getTotalWorkers(); i++)
+		cpus.push_back(getPlacementCPUs(placement, i));
+
 	std::vector<std::shared_ptr<WorkerController>>::const_iterator it;
-	for (it = _workers.begin(); it != _workers.end(); it++)
+	for (it = _workers.begin(); it != _workers.end(); it++) {
 		std::static_pointer_cast<POSIXThreadWorkerController>(*it)->
-		    start(communicate);
-			
+		    start(communicate, cpus[std::distance(_workers.cbegin(),
+		    it)]);
+		this->watchWorker(*it);
+	}
+
 	if (wait)
 		_wait();
 }
@@ -55,7 +66,8 @@ void
 BiometricEvaluation::Process::POSIXThreadManager::startWorker(
     std::shared_ptr<WorkerController> worker,
     bool wait,
-    bool communicate)
+    bool communicate,
+    Placement placement)
 {
 	if (worker->isWorking())
 		throw Error::ObjectExists();
@@ -67,8 +79,10 @@ BiometricEvaluation::Process::POSIXThreadManager::startWorker(
 		    "by this Manager");
 
 	std::static_pointer_cast<POSIXThreadWorkerController>(*it)->
-	    start(communicate);
-				
+	    start(communicate, getPlacementCPUs(placement,
+	    std::distance(_workers.begin(), it)));
+	this->watchWorker(*it);
+
 	if (wait)
 		_wait();
 
@@ -85,7 +99,8 @@ BiometricEvaluation::Process::POSIXThreadManager::stopWorker(
 		    "by this Manager");
 		    
 	_pendingExit.push_back(*it);
-	
+	this->unwatchWorker(*it);
+
 	std::static_pointer_cast<POSIXThreadWorkerController>(*it)->stop();
 }
 
@@ -94,9 +109,13 @@ BiometricEvaluation::Process::POSIXThreadManager::_wait()
 {
 	/* TODO: This only closes threads in order. */
 	std::vector<std::shared_ptr<WorkerController>>::const_iterator it;
-	for (it = _workers.begin(); it != _workers.end(); it++)
+	for (it = _workers.begin(); it != _workers.end(); it++) {
+		/* No thread to join when a Worker was never started */
+		if ((*it)->everWorked() == false)
+			continue;
 		pthread_join(std::static_pointer_cast<
 		    POSIXThreadWorkerController>(*it)->_thread, nullptr);
+	}
 }
 
 void
@@ -140,6 +159,16 @@ BiometricEvaluation::Process::POSIXThreadWorkerController::workerMainWrapper(
 	((POSIXThreadWorkerController *)_this)->_hasWorked = true;
 	((POSIXThreadWorkerController *)_this)->_working = true;
 	((POSIXThreadWorkerController *)_this)->_rvSet = false;
+	try {
+		bindToCPUs(((POSIXThreadWorkerController *)_this)->_cpus,
+		    false);
+	} catch (const Error::Exception &e) {
+		std::cerr << "Worker thread: " << e.whatString() << std::endl;
+		((POSIXThreadWorkerController *)_this)->_rv = EXIT_FAILURE;
+		((POSIXThreadWorkerController *)_this)->_rvSet = true;
+		((POSIXThreadWorkerController *)_this)->_working = false;
+		return (nullptr);
+	}
 	try {
 		((POSIXThreadWorkerController *)_this)->_rv =
 		    ((POSIXThreadWorkerController *)_this)->getWorker()->
@@ -184,15 +213,27 @@ BiometricEvaluation::Process::POSIXThreadWorkerController::
 
 void
 BiometricEvaluation::Process::POSIXThreadWorkerController::start(
-    bool communicate)
+    bool communicate,
+    const std::vector<uint32_t> &cpus)
 {
 	if (this->isWorking())
 		throw Error::ObjectExists();
 	this->reset();
+	this->_cpus = cpus;
 	
 	if (communicate)
 		this->getWorker()->_initCommunication();
+
+	/*
+	 * Mark as working before the thread runs, so the Worker is
+	 * counted as active as soon as this method returns.
+	 */
+	this->_hasWorked = true;
+	this->_working = true;
 	if (::pthread_create(&this->_thread, nullptr,
-	    POSIXThreadWorkerController::workerMainWrapper, this) != 0)
+	    POSIXThreadWorkerController::workerMainWrapper, this) != 0) {
+		this->_hasWorked = false;
+		this->_working = false;
 		throw Error::StrategyError("pthread_create() error");
+	}
 }
@@ -0,0 +1,330 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifdef Linux
+#include <sys/eventfd.h>
+#endif
+#include <sys/mman.h>
+#include <sys/types.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+#include <be_error.h>
+#include <be_error_exception.h>
+#include <be_process_sharedmemorychannel.h>
+
+/*
+ * State shared by sender and receiver, followed by the buffer. Positions
+ * count bytes ever written and read, so the ring is empty when they are
+ * equal. Each side keeps its position and flag on its own cache line.
+ */
+struct BiometricEvaluation::Process::SharedMemoryChannel::Ring
+{
+	/** Bytes written by the sender */
+	alignas(64) std::atomic<uint64_t> head{0};
+	/** Sender is waiting for space */
+	std::atomic<uint32_t> senderWaiting{0};
+	/** Process of the sender */
+	std::atomic<pid_t> senderPID{0};
+
+	/** Bytes read by the receiver */
+	alignas(64) std::atomic<uint64_t> tail{0};
+	/** Receiver is waiting for data; set until the first message */
+	std::atomic<uint32_t> receiverWaiting{1};
+	/** Process of the receiver */
+	std::atomic<pid_t> receiverPID{0};
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+    std::atomic<uint32_t>::is_always_lock_free,
+    "Shared memory channels need address-free atomics");
+
+namespace BE = BiometricEvaluation;
+
+/** How often, in milliseconds, a blocked side checks on the other */
+static const int LivenessInterval = 1000;
+
+/** Make an event descriptor readable */
+static void
+notify(
+    int fd)
+{
+#ifdef Linux
+	const uint64_t one = 1;
+	(void)::write(fd, &one, sizeof(one));
+#else
+	const char one = 1;
+	(void)::write(fd, &one, sizeof(one));
+#endif
+}
+
+/** Make an event descriptor not readable */
+static void
+drain(
+    int fd)
+{
+#ifdef Linux
+	uint64_t count;
+	(void)::read(fd, &count, sizeof(count));
+#else
+	char buf[64];
+	while (::read(fd, buf, sizeof(buf)) > 0);
+#endif
+}
+
+/** Wait for an event descriptor to become readable */
+static void
+waitOn(
+    int fd,
+    int milliseconds)
+{
+	struct pollfd pfd{fd, POLLIN, 0};
+	if ((::poll(&pfd, 1, milliseconds) < 0) && (errno != EINTR))
+		throw BE::Error::StrategyError("Could not wait on channel (" +
+		    BE::Error::errorStr() + ")");
+}
+
+/** Whether the process on the other side of the channel still exists */
+static bool
+isAlive(
+    pid_t pid)
+{
+	if ((pid == 0) || (pid == ::getpid()))
+		return (true);
+	return ((::kill(pid, 0) == 0) || (errno != ESRCH));
+}
+
+/** Create a non-blocking event descriptor pair */
+static void
+createEvent(
+    int event[2])
+{
+#ifdef Linux
+	event[0] = event[1] = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (event[0] == -1)
+		throw BE::Error::StrategyError("Could not create eventfd (" +
+		    BE::Error::errorStr() + ")");
+#else
+	if (::pipe(event) != 0)
+		throw BE::Error::StrategyError("Could not create pipe (" +
+		    BE::Error::errorStr() + ")");
+	for (int i = 0; i < 2; i++) {
+		::fcntl(event[i], F_SETFL,
+		    ::fcntl(event[i], F_GETFL) | O_NONBLOCK);
+		::fcntl(event[i], F_SETFD, FD_CLOEXEC);
+	}
+#endif
+}
+
+static void
+closeEvent(
+    int event[2])
+{
+	if (event[0] != -1)
+		::close(event[0]);
+	if ((event[1] != -1) && (event[1] != event[0]))
+		::close(event[1]);
+	event[0] = event[1] = -1;
+}
+
+BiometricEvaluation::Process::SharedMemoryChannel::SharedMemoryChannel(
+    uint64_t capacity) :
+    _ring{nullptr},
+    _capacity{capacity},
+    _mappedSize{sizeof(Ring) + capacity},
+    _dataEvent{-1, -1},
+    _spaceEvent{-1, -1}
+{
+	if (capacity == 0)
+		throw Error::ParameterError("Channel capacity must be positive");
+
+	void *memory = ::mmap(nullptr, this->_mappedSize,
+	    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (memory == MAP_FAILED)
+		throw Error::StrategyError("Could not map channel (" +
+		    Error::errorStr() + ")");
+	this->_ring = new (memory) Ring();
+
+	try {
+		createEvent(this->_dataEvent);
+		createEvent(this->_spaceEvent);
+	} catch (const Error::Exception&) {
+		closeEvent(this->_dataEvent);
+		::munmap(memory, this->_mappedSize);
+		throw;
+	}
+}
+
+BiometricEvaluation::Process::SharedMemoryChannel::~SharedMemoryChannel()
+{
+	closeEvent(this->_dataEvent);
+	closeEvent(this->_spaceEvent);
+	::munmap(this->_ring, this->_mappedSize);
+}
+
+void
+BiometricEvaluation::Process::SharedMemoryChannel::write(
+    const uint8_t *data,
+    uint64_t size)
+{
+	uint8_t *buffer = reinterpret_cast<uint8_t *>(this->_ring + 1);
+	while (size > 0) {
+		/* Only the sender moves head */
+		const uint64_t head = this->_ring->head.load(
+		    std::memory_order_relaxed);
+		const uint64_t space = this->_capacity -
+		    (head - this->_ring->tail.load(std::memory_order_acquire));
+		if (space == 0) {
+			/* Ask to be woken, then look again before sleeping */
+			drain(this->_spaceEvent[0]);
+			this->_ring->senderWaiting.store(1);
+			if (this->_ring->tail.load() + this->_capacity != head)
+				continue;
+			waitOn(this->_spaceEvent[0], LivenessInterval);
+			if (!isAlive(this->_ring->receiverPID.load()))
+				throw Error::ObjectDoesNotExist("Channel "
+				    "receiver has exited");
+			continue;
+		}
+
+		const uint64_t count = std::min(size, space);
+		const uint64_t offset = head % this->_capacity;
+		const uint64_t first = std::min(count,
+		    this->_capacity - offset);
+		std::memcpy(buffer + offset, data, first);
+		std::memcpy(buffer, data + first, count - first);
+		this->_ring->head.store(head + count);
+		if (this->_ring->receiverWaiting.exchange(0) != 0)
+			notify(this->_dataEvent[1]);
+
+		data += count;
+		size -= count;
+	}
+}
+
+void
+BiometricEvaluation::Process::SharedMemoryChannel::read(
+    uint8_t *data,
+    uint64_t size)
+{
+	const uint8_t *buffer = reinterpret_cast<uint8_t *>(this->_ring + 1);
+	while (size > 0) {
+		/* Only the receiver moves tail */
+		const uint64_t tail = this->_ring->tail.load(
+		    std::memory_order_relaxed);
+		const uint64_t available = this->_ring->head.load(
+		    std::memory_order_acquire) - tail;
+		if (available == 0) {
+			drain(this->_dataEvent[0]);
+			this->_ring->receiverWaiting.store(1);
+			if (this->_ring->head.load() != tail)
+				continue;
+			waitOn(this->_dataEvent[0], LivenessInterval);
+			if (!isAlive(this->_ring->senderPID.load()))
+				throw Error::ObjectDoesNotExist("Channel "
+				    "sender has exited");
+			continue;
+		}
+
+		const uint64_t count = std::min(size, available);
+		const uint64_t offset = tail % this->_capacity;
+		const uint64_t first = std::min(count,
+		    this->_capacity - offset);
+		std::memcpy(data, buffer + offset, first);
+		std::memcpy(data + first, buffer, count - first);
+		this->_ring->tail.store(tail + count);
+		if (this->_ring->senderWaiting.exchange(0) != 0)
+			notify(this->_spaceEvent[1]);
+
+		data += count;
+		size -= count;
+	}
+}
+
+void
+BiometricEvaluation::Process::SharedMemoryChannel::send(
+    const Memory::uint8Array &message)
+{
+	this->_ring->senderPID.store(::getpid(), std::memory_order_relaxed);
+
+	const uint64_t length = message.size();
+	this->write(reinterpret_cast<const uint8_t *>(&length),
+	    sizeof(length));
+	this->write(message, length);
+}
+
+void
+BiometricEvaluation::Process::SharedMemoryChannel::receive(
+    Memory::uint8Array &message)
+{
+	this->_ring->receiverPID.store(::getpid(), std::memory_order_relaxed);
+
+	uint64_t length;
+	this->read(reinterpret_cast<uint8_t *>(&length), sizeof(length));
+	message.resize(length);
+	this->read(message, length);
+}
+
+uint64_t
+BiometricEvaluation::Process::SharedMemoryChannel::getPendingBytes()
+{
+	this->_ring->receiverPID.store(::getpid(), std::memory_order_relaxed);
+
+	const uint64_t tail = this->_ring->tail.load(
+	    std::memory_order_relaxed);
+	const uint64_t pending = this->_ring->head.load(
+	    std::memory_order_acquire) - tail;
+	if (pending != 0)
+		return (pending);
+
+	/* Empty: rearm the descriptor for the next message */
+	drain(this->_dataEvent[0]);
+	this->_ring->receiverWaiting.store(1);
+	return (this->_ring->head.load() - tail);
+}
+
+bool
+BiometricEvaluation::Process::SharedMemoryChannel::waitForMessage(
+    int milliseconds)
+{
+	using Clock = std::chrono::steady_clock;
+	const auto deadline = Clock::now() +
+	    std::chrono::milliseconds(milliseconds);
+
+	while (this->getPendingBytes() == 0) {
+		int timeout = -1;
+		if (milliseconds >= 0) {
+			timeout = std::chrono::duration_cast<
+			    std::chrono::milliseconds>(deadline -
+			    Clock::now()).count();
+			if (timeout <= 0)
+				return (false);
+		}
+		waitOn(this->_dataEvent[0], timeout);
+	}
+	return (true);
+}
+
+int
+BiometricEvaluation::Process::SharedMemoryChannel::getDescriptor()
+    const
+{
+	return (this->_dataEvent[0]);
+}
@@ -9,10 +9,11 @@
  */
 
 #include <cerrno>
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
-#include <filesystem>
+#include <map>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
@@ -20,8 +21,10 @@
 #include <string_view>
 
 #include <sys/resource.h>
+#include <sys/stat.h>
 #include <sys/syscall.h>
 #include <dirent.h>
+#include <fcntl.h>
 #include <pthread.h>
 #include <unistd.h>
 
@@ -29,10 +32,10 @@
 #include <be_text.h>
 #include <be_time.h>
 #include <be_process_statistics.h>
+#include <be_process_statisticsfile.h>
 #include <be_io_utility.h>
 
 namespace BE = BiometricEvaluation;
-namespace fs = std::filesystem;
 
 typedef std::vector<std::tuple<pid_t, float, float>> TaskStatsList;
 
@@ -130,21 +133,155 @@ internalGetProcName(pid_t pid)
 #endif
 }
 
-static PSTATS
-internalGetPstats(pid_t pid)
+/*
+ * Read /proc files without allocating: each file is kept open and read
+ * again from its start into a fixed buffer, then scanned in place.
+ */
 #if defined Linux
+/** Skip blanks, then parse an unsigned decimal number */
+static uint64_t
+scanNumber(
+    const char *&p,
+    const char *end)
 {
-	std::ostringstream tp;
-	tp <<  "/proc/" << pid << "/status";
-	if (!BE::IO::Utility::fileExists(tp.str()))
-		throw BE::Error::StrategyError(
-		    "Could not find " + tp.str() + ".");
+	while ((p < end) && ((*p == ' ') || (*p == '\t')))
+		p++;
+	uint64_t value{0};
+	while ((p < end) && (*p >= '0') && (*p <= '9'))
+		value = (value * 10) + (*p++ - '0');
+	return (value);
+}
 
-	/* Read the process status into a string so we can parse it. */
-	std::ifstream ifs(tp.str().c_str());
-	if (ifs.fail())
-		throw BE::Error::StrategyError(
-		    "Could not open " + tp.str() + ".");
+/** Whether the line at p starts with "key:", skipping past it if so */
+static bool
+scanKey(
+    const char *&p,
+    const char *end,
+    std::string_view key)
+{
+	if ((static_cast<std::size_t>(end - p) <= key.size()) ||
+	    (std::memcmp(p, key.data(), key.size()) != 0) ||
+	    (p[key.size()] != ':'))
+		return (false);
+	p += key.size() + 1;
+	return (true);
+}
+
+/** Obtain the start of the line after the one at p */
+static const char *
+nextLine(
+    const char *p,
+    const char *end)
+{
+	const void *newline = std::memchr(p, '\n', end - p);
+	return (newline == nullptr ? end :
+	    static_cast<const char *>(newline) + 1);
+}
+#endif /* Linux */
+
+struct BiometricEvaluation::Process::Statistics::Sampler
+{
+	/**
+	 * @throw Error::NotImplemented
+	 *	Sampling is not implemented on this OS.
+	 */
+	Sampler(
+	    pid_t pid);
+	~Sampler();
+
+	/** Read /proc/<pid>/status */
+	PSTATS
+	readStatus();
+
+	/** Read /proc/<pid>/io into sample, if permitted */
+	void
+	readIO(
+	    Sample &sample);
+
+	/**
+	 * Read /proc/<pid>/task/<tid>/stat for each task, computing
+	 * deltas from the previous recorded read when record is set.
+	 */
+	void
+	readTasks(
+	    std::vector<TaskSample> &tasks,
+	    bool record);
+
+	/** Read fd from its start, returning bytes read */
+	ssize_t
+	read(
+	    int fd);
+
+#if defined Linux
+	/** An open task stat file and the task's recorded times */
+	struct Task
+	{
+		int fd{-1};
+		uint64_t utime{};
+		uint64_t stime{};
+		bool recorded{};
+		uint64_t generation{};
+	};
+
+	int statusFD{-1};
+	int ioFD{-1};
+	DIR *taskDir{nullptr};
+	std::map<pid_t, Task> tasks{};
+	/** Incremented for each read of the tasks */
+	uint64_t generation{};
+	uint64_t ticksPerSecond{};
+	char buffer[4096];
+#endif
+};
+
+#if defined Linux
+BiometricEvaluation::Process::Statistics::Sampler::Sampler(
+    pid_t pid)
+{
+	const std::string path{"/proc/" + std::to_string(pid)};
+	this->statusFD = ::open((path + "/status").c_str(),
+	    O_RDONLY | O_CLOEXEC);
+	if (this->statusFD == -1)
+		throw BE::Error::StrategyError("Could not open " + path +
+		    "/status (" + BE::Error::errorStr() + ")");
+
+	/* Optional: may not be permitted or configured */
+	this->ioFD = ::open((path + "/io").c_str(), O_RDONLY | O_CLOEXEC);
+	this->taskDir = ::opendir((path + "/task").c_str());
+
+	const long ticks = ::sysconf(_SC_CLK_TCK);
+	this->ticksPerSecond = (ticks > 0 ? ticks : 100);
+}
+
+BiometricEvaluation::Process::Statistics::Sampler::~Sampler()
+{
+	for (auto &task : this->tasks)
+		::close(task.second.fd);
+	if (this->taskDir != nullptr)
+		::closedir(this->taskDir);
+	if (this->ioFD != -1)
+		::close(this->ioFD);
+	::close(this->statusFD);
+}
+
+ssize_t
+BiometricEvaluation::Process::Statistics::Sampler::read(
+    int fd)
+{
+	ssize_t length;
+	do {
+		length = ::pread(fd, this->buffer, sizeof(this->buffer), 0);
+	} while ((length == -1) && (errno == EINTR));
+	return (length);
+}
+
+PSTATS
+BiometricEvaluation::Process::Statistics::Sampler::readStatus()
+{
+	const ssize_t length = this->read(this->statusFD);
+	if (length <= 0)
+		throw BE::Error::StrategyError("Could not read process "
+		    "status (" + BE::Error::errorStr() + ")");
 
 	/*
 	 * The status info for a process is composed on n lines in this form:
@@ -152,149 +289,175 @@ internalGetPstats(pid_t pid)
 	 * so, for example:
 	 *	VmSize:    2164 kB
 	 */
-	std::string oneline, key, value;
-	std::string::size_type idx;
-	PSTATS stats;
-	while (!ifs.eof()) {
-		std::getline(ifs, oneline);
-		idx = oneline.find(":");
-		value = oneline.substr(idx + 1, oneline.length());
-		key = BE::Text::trimWhitespace(oneline.substr(0, idx));
+	PSTATS stats{};
+	const char *end = this->buffer + length;
+	for (const char *p = this->buffer; p < end; p = nextLine(p, end)) {
+		if (*p == 'V') {
+			if (scanKey(p, end, VmRSSProp))
+				stats.vmrss = scanNumber(p, end);
+			else if (scanKey(p, end, VmSizeProp))
+				stats.vmsize = scanNumber(p, end);
+			else if (scanKey(p, end, VmPeakProp))
+				stats.vmpeak = scanNumber(p, end);
+			else if (scanKey(p, end, VmDataProp))
+				stats.vmdata = scanNumber(p, end);
+			else if (scanKey(p, end, VmStackProp))
+				stats.vmstack = scanNumber(p, end);
+		} else if (scanKey(p, end, ThreadsProp)) {
+			stats.threads = scanNumber(p, end);
+		}
+	}
+	return (stats);
+}
+
+void
+BiometricEvaluation::Process::Statistics::Sampler::readIO(
+    Sample &sample)
+{
+	if (this->ioFD == -1)
+		return;
+	const ssize_t length = this->read(this->ioFD);
+	if (length <= 0)
+		return;
 
-		//XXX May want to remove non-digits in value string
+	const char *end = this->buffer + length;
+	for (const char *p = this->buffer; p < end; p = nextLine(p, end)) {
+		if (scanKey(p, end, "rchar"))
+			sample.readChars = scanNumber(p, end);
+		else if (scanKey(p, end, "wchar"))
+			sample.writeChars = scanNumber(p, end);
+		else if (scanKey(p, end, "syscr"))
+			sample.readCalls = scanNumber(p, end);
+		else if (scanKey(p, end, "syscw"))
+			sample.writeCalls = scanNumber(p, end);
+		else if (scanKey(p, end, "read_bytes"))
+			sample.readBytes = scanNumber(p, end);
+		else if (scanKey(p, end, "write_bytes"))
+			sample.writeBytes = scanNumber(p, end);
+	}
+}
 
-		/*
-		 * The call to strtoll() works for all the stat values here
-		 * because the entry in /proc/<pid>/status has the number
-		 * separated from the units by a whitespace.
-		 */
-		if (key == VmRSSProp) {
-			stats.vmrss = (uint64_t)std::strtoll(value.c_str(),
-			    nullptr, 10);
-			continue;
-		}
-		if (key == VmSizeProp) {
-			stats.vmsize = (uint64_t)std::strtoll(value.c_str(),
-			    nullptr, 10);
+void
+BiometricEvaluation::Process::Statistics::Sampler::readTasks(
+    std::vector<TaskSample> &samples,
+    bool record)
+{
+	samples.clear();
+	if (this->taskDir == nullptr)
+		return;
+
+	this->generation++;
+	::rewinddir(this->taskDir);
+	const struct dirent *entry;
+	while ((entry = ::readdir(this->taskDir)) != nullptr) {
+		if ((entry->d_name[0] < '0') || (entry->d_name[0] > '9'))
 			continue;
+		const pid_t tid = std::strtol(entry->d_name, nullptr, 10);
+
+		Task &task = this->tasks[tid];
+		if (task.fd == -1) {
+			task.fd = ::openat(::dirfd(this->taskDir),
+			    (std::string(entry->d_name) + "/stat").c_str(),
+			    O_RDONLY | O_CLOEXEC);
+			/* Task exited since the directory was read */
+			if (task.fd == -1) {
+				this->tasks.erase(tid);
+				continue;
+			}
 		}
-		if (key == VmPeakProp) {
-			stats.vmpeak = (uint64_t)std::strtoll(value.c_str(),
-			    nullptr, 10);
+		const ssize_t length = this->read(task.fd);
+		if (length <= 0)
 			continue;
-		}
-		if (key == VmDataProp) {
-			stats.vmdata = (uint64_t)std::strtoll(value.c_str(),
-			    nullptr, 10);
+
+		/*
+		 * ID is the first field and the command name, which may
+		 * contain spaces, is in parentheses. User time is the
+		 * 14th field and system time the 15th.
+		 */
+		const char *end = this->buffer + length;
+		const char *p = end;
+		while ((p > this->buffer) && (*(p - 1) != ')'))
+			p--;
+		if (p == this->buffer)
 			continue;
+		for (int field = 3; field < 14; field++) {
+			while ((p < end) && (*p == ' '))
+				p++;
+			while ((p < end) && (*p != ' '))
+				p++;
 		}
-		if (key == VmStackProp) {
-			stats.vmstack = (uint64_t)std::strtoll(value.c_str(),
-			    nullptr, 10);
-			continue;
+		TaskSample sample{};
+		sample.tid = tid;
+		sample.utime = scanNumber(p, end) *
+		    BE::Time::MicrosecondsPerSecond / this->ticksPerSecond;
+		sample.stime = scanNumber(p, end) *
+		    BE::Time::MicrosecondsPerSecond / this->ticksPerSecond;
+		task.generation = this->generation;
+
+		if (record) {
+			if (task.recorded) {
+				sample.utimeDelta = sample.utime -
+				    std::min(task.utime, sample.utime);
+				sample.stimeDelta = sample.stime -
+				    std::min(task.stime, sample.stime);
+			} else {
+				sample.utimeDelta = sample.utime;
+				sample.stimeDelta = sample.stime;
+			}
+			task.utime = sample.utime;
+			task.stime = sample.stime;
+			task.recorded = true;
 		}
-		if (key == ThreadsProp) {
-			stats.threads = (uint64_t)std::strtoll(value.c_str(),
-			    nullptr, 10);
-			continue;
+		samples.push_back(sample);
+	}
+
+	/* Close the files of tasks that have exited */
+	for (auto it = this->tasks.begin(); it != this->tasks.end(); ) {
+		if (it->second.generation != this->generation) {
+			::close(it->second.fd);
+			it = this->tasks.erase(it);
+		} else {
+			it++;
 		}
 	}
-	ifs.close();
-	return (stats);
 }
-
-#elif defined Darwin
-
-/*
- * Local function to get usage stats from the Darwin (Mac OS-X) OS.
- */
+#else /* Linux */
+BiometricEvaluation::Process::Statistics::Sampler::Sampler(
+    pid_t)
 {
 	throw BE::Error::NotImplemented();
 }
 
-#else /* Unsupported OS */
+BiometricEvaluation::Process::Statistics::Sampler::~Sampler() = default;
 
-/*
- * The default, not-implemented-here stats function.
- */
+PSTATS
+BiometricEvaluation::Process::Statistics::Sampler::readStatus()
 {
 	throw BE::Error::NotImplemented();
 }
-#endif	/* OS check */
 
-/*
- * Get the task statistics for the given process ID. This function will
- * return whatever information has been gathered when the stats cannot be
- * obtained, including the system-wide clock ticks setting as that is needed to
- * derive the times spent in the task.
- */
-static TaskStatsList
-internalGetTasksStats(pid_t pid)
-#if defined Linux
+void
+BiometricEvaluation::Process::Statistics::Sampler::readIO(
+    Sample &)
 {
-	TaskStatsList allStats{};
-	std::string tpath{"/proc/" + std::to_string(pid) + "/task/"};
-	if (!fs::is_directory(tpath))
-		return (allStats);
-
-	/*
-	 * Iterate through all /proc/<pid>/task/<tid>/stat files.
-	 */
-	float ticksPerSec = (float)sysconf(_SC_CLK_TCK);
-	if (ticksPerSec <= 0)
-		return (allStats);
-
-	for (auto& p: fs::directory_iterator(tpath)) {
-		std::string tstatPath{p.path().string() + "/stat"};
-		std::ifstream ifs(tstatPath);
-		//XXX Should we continue here to the next subdir, and
-		//XXX build an exception string to throw at the loop end?
-		if (!ifs)
-			break;
-
-		std::string line{};
-		if (!std::getline(ifs, line)) {
-			/* Task likely exited while reading */
-			break;
-		}
-		/*
-		 * Tokenize the line using the space character.
-		 * ID is first field, user time is the 14th field,
-		 * system time is the 15th field.
-		 */
-		const auto tokens = BE::Text::split(line, ' ', false);
-		if (tokens.size() < 15)
-			break;
-
-		/*
-		 * Add the stats for this task to the set of stats.
-		 */
-		pid_t tid = std::stoi(tokens[0]);
-		float utime = (float)std::stoi(tokens[13]) / ticksPerSec;
-		float stime = (float)std::stoi(tokens[14]) / ticksPerSec;
-		allStats.push_back(std::make_tuple(tid, utime, stime));
-	}
-	return (allStats);
+	throw BE::Error::NotImplemented();
 }
 
-#elif defined Darwin
-
-/*
- * Local function to get usage stats from the Darwin (Mac OS-X) OS.
- */
+void
+BiometricEvaluation::Process::Statistics::Sampler::readTasks(
+    std::vector<TaskSample> &,
+    bool)
 {
 	throw BE::Error::NotImplemented();
 }
 
-#else /* Unsupported OS */
-
-/*
- * The default, not-implemented-here stats function.
- */
+ssize_t
+BiometricEvaluation::Process::Statistics::Sampler::read(
+    int)
 {
 	throw BE::Error::NotImplemented();
 }
-#endif	/* OS check */
+#endif /* Linux */
 
 static void internalGetCPUTimes(
     uint64_t *usertime,
@@ -391,6 +554,16 @@ BiometricEvaluation::Process::Statistics::Statistics(
 	}
 }
 
+BiometricEvaluation::Process::Statistics::Statistics(
+    const std::shared_ptr<StatisticsFileWriter> &statisticsFile) :
+    _pid(getpid()),
+    _logging(true),
+    _autoLogging(false),
+    _statisticsFile(statisticsFile)
+{
+	pthread_mutex_init(&_logMutex, nullptr);
+}
+
 std::tuple<
     uint64_t,
     uint64_t>
@@ -408,7 +581,24 @@ std::vector<std::tuple<
     float>>
 BiometricEvaluation::Process::Statistics::getTasksStats()
 {
-	return (internalGetTasksStats(this->_pid));
+	std::vector<TaskSample> tasks;
+	pthread_mutex_lock(&this->_logMutex);
+	try {
+		this->getSampler().readTasks(tasks, false);
+	} catch (const BE::Error::Exception &) {
+		pthread_mutex_unlock(&this->_logMutex);
+		throw;
+	}
+	pthread_mutex_unlock(&this->_logMutex);
+
+	TaskStatsList allStats;
+	for (const auto &task : tasks)
+		allStats.emplace_back(task.tid,
+		    static_cast<float>(task.utime) /
+		    BE::Time::MicrosecondsPerSecond,
+		    static_cast<float>(task.stime) /
+		    BE::Time::MicrosecondsPerSecond);
+	return (allStats);
 }
 
 std::tuple<
@@ -419,8 +609,15 @@ std::tuple<
     uint64_t>
 BiometricEvaluation::Process::Statistics::getMemorySizes()
 {
-	/* Let exceptions from this call float out */
-	PSTATS ps = internalGetPstats(_pid);
+	PSTATS ps;
+	pthread_mutex_lock(&this->_logMutex);
+	try {
+		ps = this->getSampler().readStatus();
+	} catch (const BE::Error::Exception &) {
+		pthread_mutex_unlock(&this->_logMutex);
+		throw;
+	}
+	pthread_mutex_unlock(&this->_logMutex);
 	return (std::make_tuple(ps.vmrss, ps.vmsize, ps.vmpeak, ps.vmdata,
 	     ps.vmstack));
 }
@@ -428,7 +625,15 @@ BiometricEvaluation::Process::Statistics::getMemorySizes()
 uint32_t
 BiometricEvaluation::Process::Statistics::getNumThreads()
 {
-	PSTATS ps = internalGetPstats(_pid);
+	PSTATS ps;
+	pthread_mutex_lock(&this->_logMutex);
+	try {
+		ps = this->getSampler().readStatus();
+	} catch (const BE::Error::Exception &) {
+		pthread_mutex_unlock(&this->_logMutex);
+		throw;
+	}
+	pthread_mutex_unlock(&this->_logMutex);
 	return (ps.threads);
 }
 
@@ -438,33 +643,44 @@ BiometricEvaluation::Process::Statistics::logStats()
 	if (!_logging)
 		throw BE::Error::ObjectDoesNotExist();
 
-	PSTATS ps;
-	uint64_t usertime, systemtime;
+	Sample s;
 	pthread_mutex_lock(&this->_logMutex);
-	try { 
-		ps = internalGetPstats(_pid);
-		internalGetCPUTimes(&usertime, &systemtime);
+	try {
+		s = this->sampleLocked();
 	} catch (const BE::Error::Exception &) {
 		pthread_mutex_unlock(&this->_logMutex);
 		throw;
 	}
-	*_logSheet << usertime << " " << systemtime << " ";
-	*_logSheet << ps.vmrss << " " << ps.vmsize << " " << ps.vmpeak << " ";
-	*_logSheet << ps.vmdata << " " << ps.vmstack << " " << ps.threads;
+	if (this->_statisticsFile != nullptr) {
+		try {
+			this->_statisticsFile->write(s);
+		} catch (const BE::Error::Exception &) {
+			pthread_mutex_unlock(&this->_logMutex);
+			throw;
+		}
+		pthread_mutex_unlock(&this->_logMutex);
+		return;
+	}
+
+	*_logSheet << s.utime << " " << s.stime << " ";
+	*_logSheet << s.vmrss << " " << s.vmsize << " " << s.vmpeak << " ";
+	*_logSheet << s.vmdata << " " << s.vmstack << " " << s.threads;
 	*_logSheet << " " << std::quoted(this->_comment);
 	_logSheet->newEntry();
 
-	auto tls = this->_tasksLogSheet->get();
 	if (_doTasksLogging) {
-		auto allStats = internalGetTasksStats(_pid);
+		auto tls = this->_tasksLogSheet->get();
 		*tls << this->_pid << ' ';
-		for (auto [tid, utime, stime]: allStats) {
-			if (tid == this->_loggingTaskID) {
-				*tls << '{' << tid << "(L), ";
+		for (const auto &task : s.tasks) {
+			if (task.tid == this->_loggingTaskID) {
+				*tls << '{' << task.tid << "(L), ";
 			} else {
-				*tls << '{' << tid << ", ";
+				*tls << '{' << task.tid << ", ";
 			}
-			*tls << utime << ", " << stime << "} ";
+			*tls << static_cast<float>(task.utime) /
+			    BE::Time::MicrosecondsPerSecond << ", " <<
+			    static_cast<float>(task.stime) /
+			    BE::Time::MicrosecondsPerSecond << "} ";
 		}
 		tls->newEntry();
 	}
@@ -472,10 +688,106 @@ BiometricEvaluation::Process::Statistics::logStats()
 	pthread_mutex_unlock(&this->_logMutex);
 }
 
+BiometricEvaluation::Process::Statistics::Sampler &
+BiometricEvaluation::Process::Statistics::getSampler()
+{
+	if (this->_sampler == nullptr)
+		this->_sampler = std::make_unique<Sampler>(this->_pid);
+	return (*this->_sampler);
+}
+
+BiometricEvaluation::Process::Statistics::Sample
+BiometricEvaluation::Process::Statistics::sampleLocked()
+{
+	Sampler &sampler = this->getSampler();
+
+	Sample s;
+	s.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+	    std::chrono::system_clock::now().time_since_epoch()).count();
+	internalGetCPUTimes(&s.utime, &s.stime);
+	const PSTATS ps = sampler.readStatus();
+	s.vmrss = ps.vmrss;
+	s.vmsize = ps.vmsize;
+	s.vmpeak = ps.vmpeak;
+	s.vmdata = ps.vmdata;
+	s.vmstack = ps.vmstack;
+	s.threads = ps.threads;
+	sampler.readIO(s);
+	sampler.readTasks(s.tasks, true);
+
+	/* Overwrite the oldest sample once the buffer is full */
+	if (this->_samples.size() < this->_sampleCapacity)
+		this->_samples.push_back(s);
+	else
+		this->_samples[this->_nextSample] = s;
+	this->_nextSample = (this->_nextSample + 1) % this->_sampleCapacity;
+
+	return (s);
+}
+
+BiometricEvaluation::Process::Statistics::Sample
+BiometricEvaluation::Process::Statistics::sample()
+{
+	Sample s;
+	pthread_mutex_lock(&this->_logMutex);
+	try {
+		s = this->sampleLocked();
+	} catch (const BE::Error::Exception &) {
+		pthread_mutex_unlock(&this->_logMutex);
+		throw;
+	}
+	pthread_mutex_unlock(&this->_logMutex);
+	return (s);
+}
+
+std::vector<BiometricEvaluation::Process::Statistics::Sample>
+BiometricEvaluation::Process::Statistics::getSamples()
+{
+	pthread_mutex_lock(&this->_logMutex);
+	std::vector<Sample> samples;
+	samples.reserve(this->_samples.size());
+	if (this->_samples.size() < this->_sampleCapacity) {
+		samples = this->_samples;
+	} else {
+		samples.insert(samples.end(),
+		    this->_samples.cbegin() + this->_nextSample,
+		    this->_samples.cend());
+		samples.insert(samples.end(), this->_samples.cbegin(),
+		    this->_samples.cbegin() + this->_nextSample);
+	}
+	pthread_mutex_unlock(&this->_logMutex);
+	return (samples);
+}
+
+void
+BiometricEvaluation::Process::Statistics::setSampleCapacity(
+    uint32_t capacity)
+{
+	if (capacity == 0)
+		throw BE::Error::ParameterError("Capacity must be positive");
+
+	pthread_mutex_lock(&this->_logMutex);
+	this->_samples.clear();
+	this->_samples.shrink_to_fit();
+	this->_nextSample = 0;
+	this->_sampleCapacity = capacity;
+	pthread_mutex_unlock(&this->_logMutex);
+}
+
+uint32_t
+BiometricEvaluation::Process::Statistics::getSampleCapacity()
+    const
+{
+	return (this->_sampleCapacity);
+}
+
 extern "C" void
 BiometricEvaluation::Process::Statistics::callStatistics_logStats()
 {
-	this->logStats();
+	if (this->_autoSampling)
+		this->sample();
+	else
+		this->logStats();
 }
 
 extern "C" void *
@@ -571,6 +883,46 @@ BiometricEvaluation::Process::Statistics::startAutoLogging(
 	if (interval == 0)
 		return;
 
+	this->_autoSampling = false;
+	this->startAutoThread(interval);
+	if (this->_statisticsFile != nullptr)
+		return;
+
+	std::ostringstream comment;
+	comment << StartAutologComment << interval << " microseconds.";
+	_logSheet->writeComment(comment.str());
+	if (_doTasksLogging) {
+		_tasksLogSheet->get()->writeComment(comment.str());
+	}
+}
+
+void
+BiometricEvaluation::Process::Statistics::startAutoSampling(
+    uint64_t interval)
+{
+	if (_autoLogging)
+		throw BE::Error::ObjectExists();
+	if (interval == 0)
+		return;
+
+	/* Fail here, rather than in the sampling thread */
+	pthread_mutex_lock(&this->_logMutex);
+	try {
+		this->getSampler();
+	} catch (const BE::Error::Exception &) {
+		pthread_mutex_unlock(&this->_logMutex);
+		throw;
+	}
+	pthread_mutex_unlock(&this->_logMutex);
+
+	this->_autoSampling = true;
+	this->startAutoThread(interval);
+}
+
+void
+BiometricEvaluation::Process::Statistics::startAutoThread(
+    uint64_t interval)
+{
 	slp.interval = interval;
 	slp.stat = this;
 	slp.flag = 0;
@@ -584,13 +936,6 @@ BiometricEvaluation::Process::Statistics::startAutoLogging(
 		    BE::Error::errorStr());
 	}
 
-	std::ostringstream comment;
-	comment << StartAutologComment << slp.interval << " microseconds.";
-	_logSheet->writeComment(comment.str());
-	if (_doTasksLogging) {
-		_tasksLogSheet->get()->writeComment(comment.str());
-	}
-
 	/*
 	 * Synchronize with the logging thread so it can copy the info
 	 * out of the logging package before it is freed.
@@ -613,8 +958,41 @@ BiometricEvaluation::Process::Statistics::startAutoLogging(
 void
 BiometricEvaluation::Process::Statistics::stopAutoLogging()
 {
-	if (!_autoLogging)
+	if (!_autoLogging || _autoSampling)
 		throw BE::Error::ObjectDoesNotExist();
+	this->stopAutoThread();
+	if (this->_statisticsFile != nullptr) {
+		pthread_mutex_lock(&this->_logMutex);
+		try {
+			this->_statisticsFile->flush();
+		} catch (const BE::Error::Exception &) {
+			pthread_mutex_unlock(&this->_logMutex);
+			throw;
+		}
+		pthread_mutex_unlock(&this->_logMutex);
+		return;
+	}
+
+	std::ostringstream comment;
+	comment << StopAutologComment;
+	_logSheet->writeComment(comment.str());
+	if (_doTasksLogging) {
+		_tasksLogSheet->get()->writeComment(comment.str());
+	}
+}
+
+void
+BiometricEvaluation::Process::Statistics::stopAutoSampling()
+{
+	if (!_autoLogging || !_autoSampling)
+		throw BE::Error::ObjectDoesNotExist();
+	this->stopAutoThread();
+	this->_autoSampling = false;
+}
+
+void
+BiometricEvaluation::Process::Statistics::stopAutoThread()
+{
 	_autoLogging = false;
 	int retval = pthread_cancel(_loggingThread);
 	if (retval != 0)
@@ -624,12 +1002,6 @@ BiometricEvaluation::Process::Statistics::stopAutoLogging()
 
 	/* Wait for the logging thread to exit */
 	pthread_join(_loggingThread, nullptr);
-	std::ostringstream comment;
-	comment << StopAutologComment;
-	_logSheet->writeComment(comment.str());
-	if (_doTasksLogging) {
-		_tasksLogSheet->get()->writeComment(comment.str());
-	}
 }
 
 void
@@ -0,0 +1,421 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <cstring>
+
+#include <be_error_exception.h>
+#include <be_io_utility.h>
+#include <be_process_statisticsfile.h>
+
+namespace BE = BiometricEvaluation;
+
+/*
+ * File layout, all integers little-endian:
+ *
+ *	"BESTATS\0"
+ *	uint32 version
+ *	uint32 number of sample fields, then each name (uint8 length, chars)
+ *	uint32 number of task fields, then each name
+ *	blocks
+ *
+ * Each block is:
+ *
+ *	"SBLK"
+ *	uint32 number of samples
+ *	uint32 number of tasks
+ *	uint32 compression (0 for none, 1 for gzip)
+ *	uint64 size of the records
+ *	uint64 size of the records as stored
+ *	sample records, then task records, as stored
+ *
+ * Every field of a record is a uint64. A task record's first field is
+ * the index, within its block, of the sample it belongs to.
+ */
+static const char FileMagic[8] = {'B', 'E', 'S', 'T', 'A', 'T', 'S', '\0'};
+static const char BlockMagic[4] = {'S', 'B', 'L', 'K'};
+static const uint32_t Version = 1;
+static const uint32_t BlockHeaderSize = 32;
+static const uint32_t NoCompression = 0;
+static const uint32_t GZIPCompression = 1;
+
+static const std::vector<std::string> SampleFields = {
+    "timestamp", "utime", "stime", "vmrss", "vmsize", "vmpeak", "vmdata",
+    "vmstack", "threads", "readChars", "writeChars", "readCalls",
+    "writeCalls", "readBytes", "writeBytes"
+};
+static const std::vector<std::string> TaskFields = {
+    "sample", "tid", "utime", "stime", "utimeDelta", "stimeDelta"
+};
+
+static void
+putUInt32(
+    std::vector<uint8_t> &buffer,
+    uint32_t value)
+{
+	for (int i = 0; i < 4; i++)
+		buffer.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+static void
+putUInt64(
+    std::vector<uint8_t> &buffer,
+    uint64_t value)
+{
+	for (int i = 0; i < 8; i++)
+		buffer.push_back(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+static uint32_t
+getUInt32(
+    const uint8_t *p)
+{
+	uint32_t value{0};
+	for (int i = 0; i < 4; i++)
+		value |= static_cast<uint32_t>(p[i]) << (8 * i);
+	return (value);
+}
+
+static uint64_t
+getUInt64(
+    const uint8_t *p)
+{
+	uint64_t value{0};
+	for (int i = 0; i < 8; i++)
+		value |= static_cast<uint64_t>(p[i]) << (8 * i);
+	return (value);
+}
+
+static void
+putFieldNames(
+    std::vector<uint8_t> &buffer,
+    const std::vector<std::string> &names)
+{
+	putUInt32(buffer, names.size());
+	for (const auto &name : names) {
+		buffer.push_back(static_cast<uint8_t>(name.size()));
+		buffer.insert(buffer.end(), name.cbegin(), name.cend());
+	}
+}
+
+/*
+ * Read the field names of a record from the schema header, and check
+ * that they start with the names this reader knows.
+ */
+static uint32_t
+readRecordWidth(
+    std::istream &stream,
+    const std::vector<std::string> &known)
+{
+	uint8_t count[4];
+	if (!stream.read(reinterpret_cast<char *>(count), sizeof(count)))
+		throw BE::Error::StrategyError("Truncated schema");
+	const uint32_t numFields = getUInt32(count);
+	if (numFields < known.size())
+		throw BE::Error::StrategyError("Unsupported schema");
+
+	for (uint32_t i = 0; i < numFields; i++) {
+		const int length = stream.get();
+		if (length == std::char_traits<char>::eof())
+			throw BE::Error::StrategyError("Truncated schema");
+		std::string name(length, '\0');
+		if (!stream.read(name.data(), length))
+			throw BE::Error::StrategyError("Truncated schema");
+		if ((i < known.size()) && (name != known[i]))
+			throw BE::Error::StrategyError("Unsupported schema "
+			    "field " + name);
+	}
+	return (numFields * sizeof(uint64_t));
+}
+
+BiometricEvaluation::Process::StatisticsFileWriter::StatisticsFileWriter(
+    const std::string &pathname,
+    bool compress,
+    uint32_t samplesPerBlock,
+    bool writeTasks) :
+    _pathname(pathname),
+    _samplesPerBlock(samplesPerBlock),
+    _writeTasks(writeTasks)
+{
+	if (samplesPerBlock == 0)
+		throw Error::ParameterError("Samples per block must be "
+		    "positive");
+	if (IO::Utility::fileExists(pathname))
+		throw Error::ObjectExists(pathname);
+	if (compress)
+		this->_compressor = IO::Compressor::createCompressor(
+		    IO::Compressor::Kind::GZIP);
+
+	this->_stream.open(pathname, std::ios::out | std::ios::binary);
+	if (!this->_stream)
+		throw Error::StrategyError("Could not create " + pathname);
+
+	std::vector<uint8_t> header(std::begin(FileMagic),
+	    std::end(FileMagic));
+	putUInt32(header, Version);
+	putFieldNames(header, SampleFields);
+	putFieldNames(header, TaskFields);
+	if (!this->_stream.write(reinterpret_cast<const char *>(
+	    header.data()), header.size()).flush())
+		throw Error::StrategyError("Could not write " + pathname);
+}
+
+BiometricEvaluation::Process::StatisticsFileWriter::~StatisticsFileWriter()
+{
+	try {
+		this->flush();
+	} catch (const Error::Exception &) {}
+}
+
+void
+BiometricEvaluation::Process::StatisticsFileWriter::write(
+    const Statistics::Sample &sample)
+{
+	putUInt64(this->_samples, sample.timestamp);
+	putUInt64(this->_samples, sample.utime);
+	putUInt64(this->_samples, sample.stime);
+	putUInt64(this->_samples, sample.vmrss);
+	putUInt64(this->_samples, sample.vmsize);
+	putUInt64(this->_samples, sample.vmpeak);
+	putUInt64(this->_samples, sample.vmdata);
+	putUInt64(this->_samples, sample.vmstack);
+	putUInt64(this->_samples, sample.threads);
+	putUInt64(this->_samples, sample.readChars);
+	putUInt64(this->_samples, sample.writeChars);
+	putUInt64(this->_samples, sample.readCalls);
+	putUInt64(this->_samples, sample.writeCalls);
+	putUInt64(this->_samples, sample.readBytes);
+	putUInt64(this->_samples, sample.writeBytes);
+
+	if (this->_writeTasks) {
+		for (const auto &task : sample.tasks) {
+			putUInt64(this->_tasks, this->_numSamples);
+			putUInt64(this->_tasks, static_cast<uint64_t>(task.tid));
+			putUInt64(this->_tasks, task.utime);
+			putUInt64(this->_tasks, task.stime);
+			putUInt64(this->_tasks, task.utimeDelta);
+			putUInt64(this->_tasks, task.stimeDelta);
+			this->_numTasks++;
+		}
+	}
+
+	if (++this->_numSamples == this->_samplesPerBlock)
+		this->flush();
+}
+
+void
+BiometricEvaluation::Process::StatisticsFileWriter::flush()
+{
+	if (this->_numSamples == 0)
+		return;
+
+	std::vector<uint8_t> &records = this->_samples;
+	records.insert(records.end(), this->_tasks.cbegin(),
+	    this->_tasks.cend());
+
+	Memory::uint8Array compressed{};
+	const uint8_t *stored = records.data();
+	uint64_t storedSize = records.size();
+	if (this->_compressor != nullptr) {
+		compressed = this->_compressor->compress(records.data(),
+		    records.size());
+		stored = compressed;
+		storedSize = compressed.size();
+	}
+
+	std::vector<uint8_t> header(std::begin(BlockMagic),
+	    std::end(BlockMagic));
+	putUInt32(header, this->_numSamples);
+	putUInt32(header, this->_numTasks);
+	putUInt32(header, this->_compressor != nullptr ? GZIPCompression :
+	    NoCompression);
+	putUInt64(header, records.size());
+	putUInt64(header, storedSize);
+
+	this->_stream.write(reinterpret_cast<const char *>(header.data()),
+	    header.size());
+	this->_stream.write(reinterpret_cast<const char *>(stored),
+	    storedSize);
+
+	this->_samples.clear();
+	this->_tasks.clear();
+	this->_numSamples = 0;
+	this->_numTasks = 0;
+	if (!this->_stream.flush())
+		throw Error::StrategyError("Could not write " +
+		    this->_pathname);
+}
+
+std::string
+BiometricEvaluation::Process::StatisticsFileWriter::getPathname()
+    const
+{
+	return (this->_pathname);
+}
+
+BiometricEvaluation::Process::StatisticsFileReader::StatisticsFileReader(
+    const std::string &pathname)
+{
+	if (!IO::Utility::fileExists(pathname))
+		throw Error::ObjectDoesNotExist(pathname);
+	this->_stream.open(pathname, std::ios::in | std::ios::binary);
+	if (!this->_stream)
+		throw Error::StrategyError("Could not open " + pathname);
+
+	char magic[sizeof(FileMagic)];
+	uint8_t version[4];
+	if (!this->_stream.read(magic, sizeof(magic)) ||
+	    (std::memcmp(magic, FileMagic, sizeof(magic)) != 0))
+		throw Error::StrategyError(pathname + " is not a statistics "
+		    "file");
+	if (!this->_stream.read(reinterpret_cast<char *>(version),
+	    sizeof(version)) || (getUInt32(version) != Version))
+		throw Error::StrategyError("Unsupported version of " +
+		    pathname);
+
+	this->_sampleWidth = readRecordWidth(this->_stream, SampleFields);
+	this->_taskWidth = readRecordWidth(this->_stream, TaskFields);
+}
+
+bool
+BiometricEvaluation::Process::StatisticsFileReader::readBlock()
+{
+	uint8_t header[BlockHeaderSize];
+	if (!this->_stream.read(reinterpret_cast<char *>(header),
+	    sizeof(header)))
+		return (false);
+	if (std::memcmp(header, BlockMagic, sizeof(BlockMagic)) != 0)
+		throw Error::StrategyError("Corrupt block header");
+	const uint32_t numSamples = getUInt32(header + 4);
+	const uint32_t numTasks = getUInt32(header + 8);
+	const uint32_t compression = getUInt32(header + 12);
+	const uint64_t size = getUInt64(header + 16);
+	const uint64_t storedSize = getUInt64(header + 24);
+	if (size != (static_cast<uint64_t>(numSamples) * this->_sampleWidth) +
+	    (static_cast<uint64_t>(numTasks) * this->_taskWidth))
+		throw Error::StrategyError("Corrupt block header");
+
+	Memory::uint8Array records(storedSize);
+	if (!this->_stream.read(reinterpret_cast<char *>(&records[0]),
+	    storedSize))
+		return (false);
+	switch (compression) {
+	case NoCompression:
+		break;
+	case GZIPCompression:
+		records = IO::Compressor::createCompressor(
+		    IO::Compressor::Kind::GZIP)->decompress(records);
+		break;
+	default:
+		throw Error::StrategyError("Unsupported block compression");
+	}
+	if (records.size() != size)
+		throw Error::StrategyError("Corrupt block");
+
+	this->_block.assign(numSamples, Statistics::Sample{});
+	this->_next = 0;
+	const uint8_t *p = records;
+	for (auto &sample : this->_block) {
+		sample.timestamp = getUInt64(p);
+		sample.utime = getUInt64(p + 8);
+		sample.stime = getUInt64(p + 16);
+		sample.vmrss = getUInt64(p + 24);
+		sample.vmsize = getUInt64(p + 32);
+		sample.vmpeak = getUInt64(p + 40);
+		sample.vmdata = getUInt64(p + 48);
+		sample.vmstack = getUInt64(p + 56);
+		sample.threads = getUInt64(p + 64);
+		sample.readChars = getUInt64(p + 72);
+		sample.writeChars = getUInt64(p + 80);
+		sample.readCalls = getUInt64(p + 88);
+		sample.writeCalls = getUInt64(p + 96);
+		sample.readBytes = getUInt64(p + 104);
+		sample.writeBytes = getUInt64(p + 112);
+		p += this->_sampleWidth;
+	}
+	for (uint32_t i = 0; i < numTasks; i++) {
+		const uint64_t index = getUInt64(p);
+		if (index >= numSamples)
+			throw Error::StrategyError("Corrupt task record");
+		Statistics::TaskSample task{};
+		task.tid = static_cast<pid_t>(getUInt64(p + 8));
+		task.utime = getUInt64(p + 16);
+		task.stime = getUInt64(p + 24);
+		task.utimeDelta = getUInt64(p + 32);
+		task.stimeDelta = getUInt64(p + 40);
+		this->_block[index].tasks.push_back(task);
+		p += this->_taskWidth;
+	}
+
+	return (true);
+}
+
+BiometricEvaluation::Process::Statistics::Sample
+BiometricEvaluation::Process::StatisticsFileReader::sequence()
+{
+	/* Blocks are never empty, but skip any that are */
+	while (this->_next == this->_block.size())
+		if (!this->readBlock())
+			throw Error::ObjectDoesNotExist("No more samples");
+
+	return (std::move(this->_block[this->_next++]));
+}
+
+void
+BiometricEvaluation::Process::StatisticsFileReader::writeCSV(
+    std::ostream &samplesCSV)
+{
+	this->writeCSV(samplesCSV, nullptr);
+}
+
+void
+BiometricEvaluation::Process::StatisticsFileReader::writeCSV(
+    std::ostream &samplesCSV,
+    std::ostream &tasksCSV)
+{
+	this->writeCSV(samplesCSV, &tasksCSV);
+}
+
+void
+BiometricEvaluation::Process::StatisticsFileReader::writeCSV(
+    std::ostream &samplesCSV,
+    std::ostream *tasksCSV)
+{
+	for (std::size_t i = 0; i < SampleFields.size(); i++)
+		samplesCSV << (i == 0 ? "" : ",") << SampleFields[i];
+	samplesCSV << '\n';
+	if (tasksCSV != nullptr)
+		*tasksCSV << "timestamp,tid,utime,stime,utimeDelta,"
+		    "stimeDelta\n";
+
+	while (true) {
+		Statistics::Sample s;
+		try {
+			s = this->sequence();
+		} catch (const Error::ObjectDoesNotExist &) {
+			break;
+		}
+
+		samplesCSV << s.timestamp << ',' << s.utime << ',' <<
+		    s.stime << ',' << s.vmrss << ',' << s.vmsize << ',' <<
+		    s.vmpeak << ',' << s.vmdata << ',' << s.vmstack << ',' <<
+		    s.threads << ',' << s.readChars << ',' << s.writeChars <<
+		    ',' << s.readCalls << ',' << s.writeCalls << ',' <<
+		    s.readBytes << ',' << s.writeBytes << '\n';
+		if (tasksCSV != nullptr)
+			for (const auto &task : s.tasks)
+				*tasksCSV << s.timestamp << ',' << task.tid <<
+				    ',' << task.utime << ',' << task.stime <<
+				    ',' << task.utimeDelta << ',' <<
+				    task.stimeDelta << '\n';
+	}
+
+	if (!samplesCSV || ((tasksCSV != nullptr) && !*tasksCSV))
+		throw Error::StrategyError("Could not write CSV");
+}
@@ -8,6 +8,7 @@
  * about its quality, reliability, or any other characteristic.
  */
 
+#include <sys/ioctl.h>
 #include <sys/select.h>
 
 #include <unistd.h>
@@ -21,7 +22,8 @@
 BiometricEvaluation::Process::Worker::Worker() :
     _stopRequested(false),
     _parameters(ParameterList()),
-    _communicationEnabled(false)
+    _communicationEnabled(false),
+    _sharedMemoryChannelSize(0)
 {
 }
 
@@ -89,6 +91,19 @@ BiometricEvaluation::Process::Worker::waitForMessage(
     int numSeconds)
     const
 {
+	/* Same loop, waking at least every 3 seconds to check for stop */
+	if (_channelToChild) {
+		while (!_stopRequested) {
+			const int timeout = (numSeconds >= 0 ?
+			    numSeconds * 1000 : 3000);
+			if (_channelToChild->waitForMessage(timeout))
+				return (true);
+			if (numSeconds >= 0)
+				break;
+		}
+		return (false);
+	}
+
 	bool result = false;
 	
 	struct timeval timeout;
@@ -167,6 +182,11 @@ BiometricEvaluation::Process::Worker::sendMessageToManager(
 	 * Send the message length, then the message contents.
 	 * All exceptions float out.
 	 */
+	if (_channelFromChild) {
+		_channelFromChild->send(message);
+		return;
+	}
+
 	uint64_t length = message.size();
 	IO::Utility::writePipe(&length, sizeof(length), _pipeFromChild[1]);
 	IO::Utility::writePipe(message, _pipeFromChild[1]);
@@ -179,12 +199,73 @@ BiometricEvaluation::Process::Worker::receiveMessageFromManager(
 	if (_communicationEnabled == false)
 		throw Error::StrategyError("Communication is not enabled");
 
+	if (_channelToChild) {
+		_channelToChild->receive(message);
+		return;
+	}
+
 	uint64_t length;
 	IO::Utility::readPipe(&length, sizeof(length), _pipeToChild[0]);
 	message.resize(length);
 	IO::Utility::readPipe(message, _pipeToChild[0]);
 }
 
+void
+BiometricEvaluation::Process::Worker::sendMessageToWorker(
+    const Memory::uint8Array &message)
+{
+	if (_communicationEnabled == false)
+		throw Error::StrategyError("Communication is not enabled");
+	if (_stopRequested)
+		throw Error::ObjectDoesNotExist("Worker is exiting");
+
+	if (_channelToChild) {
+		_channelToChild->send(message);
+		return;
+	}
+
+	/*
+	 * Send the message length, then the message contents.
+	 * All exceptions float out.
+	 */
+	uint64_t length = message.size();
+	IO::Utility::writePipe(&length, sizeof(length), _pipeToChild[1]);
+	IO::Utility::writePipe(message, _pipeToChild[1]);
+}
+
+void
+BiometricEvaluation::Process::Worker::receiveMessageFromWorker(
+    Memory::uint8Array &message)
+{
+	if (_communicationEnabled == false)
+		throw Error::StrategyError("Communication is not enabled");
+
+	if (_channelFromChild) {
+		_channelFromChild->receive(message);
+		return;
+	}
+
+	uint64_t length;
+	IO::Utility::readPipe(&length, sizeof(length), _pipeFromChild[0]);
+	message.resize(length);
+	IO::Utility::readPipe(message, _pipeFromChild[0]);
+}
+
+uint64_t
+BiometricEvaluation::Process::Worker::getPendingBytesFromWorker()
+{
+	if (_communicationEnabled == false)
+		throw Error::StrategyError("Communication is not enabled");
+
+	if (_channelFromChild)
+		return (_channelFromChild->getPendingBytes());
+
+	int available = 0;
+	if (ioctl(_pipeFromChild[0], FIONREAD, &available) != 0)
+		return (0);
+	return (available);
+}
+
 int
 BiometricEvaluation::Process::Worker::getSendingPipe()
     const
@@ -193,6 +274,9 @@ BiometricEvaluation::Process::Worker::getSendingPipe()
 		throw Error::StrategyError("Communication is not enabled");
 	if (_stopRequested)
 		throw Error::ObjectDoesNotExist("Worker is exiting");
+	if (_channelToChild)
+		throw Error::StrategyError("Messages are sent through "
+		    "shared memory");
 
 	return (_pipeToChild[1]);
 }
@@ -205,13 +289,41 @@ BiometricEvaluation::Process::Worker::getReceivingPipe()
 		throw Error::StrategyError("Communication is not enabled");
 	if (_stopRequested)
 		throw Error::ObjectDoesNotExist("Worker is exiting");
+	if (_channelFromChild)
+		return (_channelFromChild->getDescriptor());
 	
 	return (_pipeFromChild[0]);
 }
 
+void
+BiometricEvaluation::Process::Worker::setSharedMemoryChannelSize(
+    uint64_t size)
+{
+	if (_communicationEnabled)
+		throw Error::ObjectExists("Communication already initialized");
+	_sharedMemoryChannelSize = size;
+}
+
+uint64_t
+BiometricEvaluation::Process::Worker::getSharedMemoryChannelSize()
+    const
+{
+	return (_sharedMemoryChannelSize);
+}
+
 void
 BiometricEvaluation::Process::Worker::_initCommunication()
 {
+	/* Mapped now, so a forked Worker shares the channels */
+	if ((_communicationEnabled == false) &&
+	    (_sharedMemoryChannelSize != 0)) {
+		_channelToChild.reset(new SharedMemoryChannel(
+		    _sharedMemoryChannelSize));
+		_channelFromChild.reset(new SharedMemoryChannel(
+		    _sharedMemoryChannelSize));
+		_communicationEnabled = true;
+	}
+
 	if (_communicationEnabled == false) {
 		if (pipe(_pipeToChild) != 0)
 			throw Error::StrategyError("Could not create send "
@@ -233,6 +345,8 @@ BiometricEvaluation::Process::Worker::closeWorkerPipeEnds()
 {
  	if (_communicationEnabled == false)
 		throw Error::StrategyError("Communication is not enabled");
+	if (_channelToChild)
+		return;
 
 	close(_pipeToChild[0]);
 	close(_pipeFromChild[1]);
@@ -243,6 +357,8 @@ BiometricEvaluation::Process::Worker::closeManagerPipeEnds()
 {
  	if (_communicationEnabled == false)
 		throw Error::StrategyError("Communication is not enabled");
+	if (_channelToChild)
+		return;
 
 	close(_pipeToChild[1]);
 	close(_pipeFromChild[0]);
@@ -250,7 +366,7 @@ BiometricEvaluation::Process::Worker::closeManagerPipeEnds()
 
 BiometricEvaluation::Process::Worker::~Worker()
 {
-	if (_communicationEnabled == true) {
+	if ((_communicationEnabled == true) && !_channelToChild) {
 		close(_pipeFromChild[0]);
 		close(_pipeFromChild[1]);
 		close(_pipeToChild[0]);
@@ -11,7 +11,6 @@
 #include <unistd.h>
 
 #include <be_error.h>
-#include <be_io_utility.h>
 #include <be_process_workercontroller.h>
 
 BiometricEvaluation::Process::WorkerController::WorkerController(
@@ -100,13 +99,5 @@ void
 BiometricEvaluation::Process::WorkerController::sendMessageToWorker(
     const Memory::uint8Array &message)
 {
-	uint64_t length = message.size();
-	int pipeFD = getWorker()->getSendingPipe();
-
-	/*
-	 * Send the message length, then the message contents.
-	 * All exceptions float out.
-	 */
-	IO::Utility::writePipe(&length, sizeof(length), pipeFD);
-	IO::Utility::writePipe(message, pipeFD);
+	getWorker()->sendMessageToWorker(message);
 }
@@ -278,6 +278,32 @@ BiometricEvaluation::Text::split(
 	return (ret);
 }
 
+std::vector<std::string_view>
+BiometricEvaluation::Text::tokenize(
+    std::string_view str,
+    const char delimiter)
+{
+	std::vector<std::string_view> ret;
+
+	std::string_view::size_type start = 0;
+	while (start < str.length()) {
+		std::string_view::size_type end = str.find(delimiter, start);
+		if (end == std::string_view::npos)
+			end = str.length();
+
+		/* Don't insert empty tokens */
+		if (end != start)
+			ret.push_back(str.substr(start, end - start));
+		start = end + 1;
+	}
+
+	/* Add the original string if the delimiter was not found */
+	if (ret.size() == 0)
+		ret.push_back(str);
+
+	return (ret);
+}
+
 std::string
 BiometricEvaluation::Text::basename(
     const std::string &path)
@@ -11,11 +11,15 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <filesystem>
 #include <iostream>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include <sys/wait.h>
+#include <unistd.h>
+
 #include <be_io_utility.h>
 #include <be_memory_autoarrayutility.h>
 
@@ -25,24 +29,28 @@
 #include <be_io_filerecstore.h>
 #define TESTDEFINED
 #define MERGETESTDEFINED
+#define RSKIND BE::IO::RecordStore::Kind::File
 #endif
 
 #ifdef DBRECORDSTORETEST
 #include <be_io_dbrecstore.h>
 #define TESTDEFINED
 #define MERGETESTDEFINED
+#define RSKIND BE::IO::RecordStore::Kind::BerkeleyDB
 #endif
 
 #ifdef ARCHIVERECORDSTORETEST
 #include <be_io_archiverecstore.h>
 #define TESTDEFINED
 #define MERGETESTDEFINED
+#define RSKIND BE::IO::RecordStore::Kind::Archive
 #endif
 
 #ifdef SQLITERECORDSTORETEST
 #include <be_io_sqliterecstore.h>
 #define TESTDEFINED
 #define MERGETESTDEFINED
+#define RSKIND BE::IO::RecordStore::Kind::SQLite
 #endif
 
 #ifdef COMPRESSEDRECORDSTORETEST
@@ -434,6 +442,55 @@ TEST_F(ExistingRecordStore, keyFormat)
 	    BE::Error::StrategyError);
 }
 
+#ifdef RSKIND
+TEST(RecordStore, checksums)
+{
+	const std::string name = "rs_checksum_test";
+	const std::string data = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+	{
+		auto rs = BE::IO::RecordStore::createRecordStore(name, "",
+		    RSKIND);
+		rs->enableChecksums();
+		rs->insert("first", data.c_str(), data.size());
+		rs->insert("second", data.c_str(), data.size());
+		rs->replace("first", data.c_str(), data.size() - 1);
+		rs->remove("second");
+	}
+
+	/* Checksums are kept as records change, without a sync */
+	pid_t pid = ::fork();
+	ASSERT_NE(-1, pid);
+	if (pid == 0) {
+		auto rs = BE::IO::RecordStore::openRecordStore(name,
+		    BE::IO::Mode::ReadWrite);
+		rs->insert("unsynced", data.c_str(), data.size());
+		rs->insert("unchecked", data.c_str(), data.size());
+		::_exit(0);
+	}
+	ASSERT_EQ(pid, ::waitpid(pid, nullptr, 0));
+
+	/* As if the process exited while writing the last checksum */
+	const std::string checksumFile = name + "/.rschecksums";
+	std::filesystem::resize_file(checksumFile,
+	    std::filesystem::file_size(checksumFile) - 1);
+
+	auto rs = BE::IO::RecordStore::openRecordStore(name);
+	EXPECT_EQ(BE::IO::Utility::crc32c(data.c_str(), data.size() - 1),
+	    rs->getChecksum("first"));
+	EXPECT_EQ(BE::IO::Utility::crc32c(data.c_str(), data.size()),
+	    rs->getChecksum("unsynced"));
+	EXPECT_THROW(rs->getChecksum("second"), BE::Error::ObjectDoesNotExist);
+
+	/* Records without a checksum are not reported as corrupt */
+	EXPECT_THROW(rs->getChecksum("unchecked"),
+	    BE::Error::ObjectDoesNotExist);
+	EXPECT_TRUE(rs->verify().empty());
+	rs.reset();
+
+	BE::IO::RecordStore::removeRecordStore(name);
+}
+#endif /* RSKIND */
+
 #ifdef MERGETESTDEFINED
 TEST(RecordStore, mergeRecordStores)
 {
@@ -452,6 +509,46 @@ TEST(ArchiveRecordStore, vacuum)
 	EXPECT_GE(startingSpace, rs->getSpaceUsed());
 	delete rs;
 }
+
+TEST(ArchiveRecordStore, interruptedVacuum)
+{
+	const std::string name = "rs_vacuum_test";
+	{
+		BE::IO::ArchiveRecordStore rs(name, "");
+		rs.insert("key1", "data1", 5);
+	}
+	const std::string archive = name + '/' +
+	    BE::IO::ArchiveRecordStore::ARCHIVE_FILE_NAME + ".vacuum";
+	const std::string manifest = name + '/' +
+	    BE::IO::ArchiveRecordStore::MANIFEST_FILE_NAME + ".vacuum";
+
+	/* Leftovers of an uncommitted vacuum are removed only read-write */
+	std::FILE *fp = std::fopen(archive.c_str(), "w");
+	ASSERT_NE(nullptr, fp);
+	std::fclose(fp);
+	EXPECT_NO_THROW(BE::IO::ArchiveRecordStore(name,
+	    BE::IO::Mode::ReadOnly));
+	EXPECT_TRUE(BE::IO::Utility::fileExists(archive));
+	EXPECT_NO_THROW(BE::IO::ArchiveRecordStore(name,
+	    BE::IO::Mode::ReadWrite));
+	EXPECT_FALSE(BE::IO::Utility::fileExists(archive));
+
+	/* A committed vacuum cannot be completed read-only */
+	fp = std::fopen(manifest.c_str(), "w");
+	ASSERT_NE(nullptr, fp);
+	std::fputs("key1 5 0\n", fp);
+	std::fclose(fp);
+	EXPECT_THROW(BE::IO::ArchiveRecordStore(name, BE::IO::Mode::ReadOnly),
+	    BE::Error::StrategyError);
+	EXPECT_TRUE(BE::IO::Utility::fileExists(manifest));
+	{
+		BE::IO::ArchiveRecordStore rs(name, BE::IO::Mode::ReadWrite);
+		EXPECT_FALSE(BE::IO::Utility::fileExists(manifest));
+		EXPECT_EQ(1u, rs.getCount());
+	}
+
+	BE::IO::RecordStore::removeRecordStore(name);
+}
 #endif /* ARCHIVERECORDSTORETEST */
 
 int
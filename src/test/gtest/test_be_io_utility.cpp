@@ -13,6 +13,10 @@
 
 #include <unistd.h>
 
+#include <algorithm>
+#include <string>
+
+#include <be_io_mappedtextfile.h>
 #include <be_io_utility.h>
 #include <be_memory_autoarray.h>
 
@@ -69,6 +73,24 @@ TEST(IOUtility, FileIO)
 	EXPECT_EQ(0, unlink(tempFileName.c_str()));
 }
 
+TEST(IOUtility, CRC32C)
+{
+	/* Check value from RFC 3720, Appendix B.4 */
+	const std::string check{"123456789"};
+	EXPECT_EQ(0xE3069283, BE::IO::Utility::crc32c(check.data(),
+	    check.size()));
+
+	BE::Memory::uint8Array zeros(32);
+	std::fill(zeros.begin(), zeros.end(), 0);
+	EXPECT_EQ(0x8A9136AA, BE::IO::Utility::crc32c(zeros));
+
+	/* Incremental computation matches a single pass */
+	const uint32_t first = BE::IO::Utility::crc32c(check.data(), 4);
+	EXPECT_EQ(BE::IO::Utility::crc32c(check.data(), check.size()),
+	    BE::IO::Utility::crc32c(check.data() + 4, check.size() - 4,
+	    first));
+}
+
 TEST(IOUtility, SetAside)
 {
 	const std::string filename = "test_be_io_utility.cpp";
@@ -234,3 +256,45 @@ TEST(IOUtility, Permissions)
 	EXPECT_EQ(0, unlink(tempFileName.c_str()));
 }
 
+
+TEST(IOUtility, MappedTextFile)
+{
+	const std::string tempFileName = "temp_file";
+	if (BE::IO::Utility::fileExists(tempFileName))
+		ASSERT_EQ(unlink(tempFileName.c_str()), 0);
+
+	/* Lines on either side of blocks scanned together */
+	std::vector<std::string> lines;
+	std::string contents;
+	for (size_t length = 0; length < 100; length += 7) {
+		lines.push_back(std::string(length, 'a' + (length % 26)));
+		contents += lines.back() + "\n";
+	}
+	lines.push_back("no newline");
+	contents += lines.back();
+	BE::Memory::uint8Array buffer(contents.size());
+	std::copy(contents.begin(), contents.end(), buffer.begin());
+	BE::IO::Utility::writeFile(buffer, tempFileName);
+
+	{
+		BE::IO::MappedTextFile file(tempFileName);
+		EXPECT_EQ(contents.size(), file.getSize());
+		ASSERT_EQ(lines.size(), file.getNumLines());
+		for (uint64_t i = lines.size(); i > 0; i--)
+			EXPECT_EQ(lines[i - 1], file.getLine(i - 1));
+		EXPECT_THROW(file.getLine(lines.size()),
+		    BE::Error::ObjectDoesNotExist);
+	}
+
+	/* An empty file has no lines */
+	EXPECT_EQ(0, unlink(tempFileName.c_str()));
+	BE::IO::Utility::writeFile(BE::Memory::uint8Array(), tempFileName);
+	{
+		BE::IO::MappedTextFile file(tempFileName, true);
+		EXPECT_EQ(0, file.getNumLines());
+	}
+	EXPECT_EQ(0, unlink(tempFileName.c_str()));
+
+	EXPECT_THROW(BE::IO::MappedTextFile("BadFile"),
+	    BE::Error::ObjectDoesNotExist);
+}
@@ -0,0 +1,112 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include <be_error_exception.h>
+#include <be_mpi_rangeset.h>
+
+#include <gtest/gtest.h>
+
+namespace BE = BiometricEvaluation;
+
+using Ranges = std::vector<BE::MPI::RangeSet::Range>;
+
+TEST(RangeSet, Empty)
+{
+	BE::MPI::RangeSet set;
+	EXPECT_TRUE(set.empty());
+	EXPECT_EQ(0u, set.getCount());
+	EXPECT_TRUE(set.getRanges().empty());
+	EXPECT_FALSE(set.contains(0));
+	EXPECT_EQ(0u, set.getFirstMissing());
+	EXPECT_EQ(7u, set.getFirstMissing(7));
+}
+
+TEST(RangeSet, Insert)
+{
+	BE::MPI::RangeSet set;
+	set.insert(10, 19);
+	set.insert(30, 39);
+	set.insert(5);
+	EXPECT_FALSE(set.empty());
+	EXPECT_EQ(21u, set.getCount());
+	EXPECT_EQ((Ranges{{5, 5}, {10, 19}, {30, 39}}), set.getRanges());
+
+	EXPECT_TRUE(set.contains(5));
+	EXPECT_FALSE(set.contains(6));
+	EXPECT_TRUE(set.contains(10));
+	EXPECT_TRUE(set.contains(19));
+	EXPECT_FALSE(set.contains(20));
+	EXPECT_FALSE(set.contains(40));
+
+	EXPECT_THROW(set.insert(2, 1), BE::Error::ParameterError);
+	EXPECT_EQ(21u, set.getCount());
+}
+
+TEST(RangeSet, Merge)
+{
+	BE::MPI::RangeSet set;
+
+	/* Adjoining ranges, out of order, become one */
+	set.insert(10, 19);
+	set.insert(0, 9);
+	set.insert(20, 29);
+	EXPECT_EQ((Ranges{{0, 29}}), set.getRanges());
+	EXPECT_EQ(30u, set.getCount());
+
+	/* Positions already in the set are counted once */
+	set.insert(5, 14);
+	set.insert(29);
+	EXPECT_EQ((Ranges{{0, 29}}), set.getRanges());
+	EXPECT_EQ(30u, set.getCount());
+
+	/* A range spanning several absorbs them and the gaps between */
+	set.insert(40, 44);
+	set.insert(50, 54);
+	set.insert(35, 60);
+	EXPECT_EQ((Ranges{{0, 29}, {35, 60}}), set.getRanges());
+	EXPECT_EQ(56u, set.getCount());
+
+	/* Filling the gap leaves a single range */
+	set.insert(30, 34);
+	EXPECT_EQ((Ranges{{0, 60}}), set.getRanges());
+	EXPECT_EQ(61u, set.getCount());
+}
+
+TEST(RangeSet, FirstMissing)
+{
+	BE::MPI::RangeSet set;
+	set.insert(1, 4);
+	EXPECT_EQ(0u, set.getFirstMissing());
+
+	set.insert(0);
+	set.insert(8, 9);
+	EXPECT_EQ(5u, set.getFirstMissing());
+	EXPECT_EQ(5u, set.getFirstMissing(3));
+	EXPECT_EQ(6u, set.getFirstMissing(6));
+	EXPECT_EQ(10u, set.getFirstMissing(8));
+	EXPECT_EQ(11u, set.getFirstMissing(11));
+}
+
+TEST(RangeSet, Limits)
+{
+	BE::MPI::RangeSet set;
+	set.insert(UINT64_MAX - 1, UINT64_MAX);
+	set.insert(UINT64_MAX - 3, UINT64_MAX - 2);
+	EXPECT_EQ((Ranges{{UINT64_MAX - 3, UINT64_MAX}}), set.getRanges());
+	EXPECT_EQ(4u, set.getCount());
+	EXPECT_TRUE(set.contains(UINT64_MAX));
+
+	set.insert(0);
+	EXPECT_EQ(1u, set.getFirstMissing());
+	EXPECT_EQ(5u, set.getCount());
+}
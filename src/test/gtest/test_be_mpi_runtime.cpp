@@ -0,0 +1,450 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include <be_error_exception.h>
+#include <be_framework_enumeration.h>
+#include <be_io_recordstore.h>
+#include <be_io_utility.h>
+#include <be_mpi_distributor.h>
+#include <be_mpi_receiver.h>
+#include <be_mpi_recordprocessor.h>
+#include <be_mpi_recordstoredistributor.h>
+#include <be_mpi_runtime.h>
+
+#include <gtest/gtest.h>
+
+namespace BE = BiometricEvaluation;
+
+static const std::string PropsFile = "test_be_mpi_runtime.props";
+static const std::string InputRS = "test_be_mpi_runtime_input";
+static const std::string CheckpointPath = "test_be_mpi_runtime_chk";
+static const std::string ResultRS = "test_be_mpi_runtime_results";
+static const uint32_t NumRecords = 40;
+
+/**
+ * Number of times each key was processed, by any worker, and when given
+ * a value, whether it was the key, as each was written
+ */
+static std::map<std::string, uint32_t> processed;
+static std::map<std::string, bool> valueMatched;
+/** Number of records in each work package processed */
+static std::vector<uint64_t> packageSizes;
+static std::mutex processedMutex;
+/** Time taken to process each record */
+static std::chrono::microseconds recordDelay{0};
+/** Signal raised by the next record processed, when not 0 */
+static std::atomic<int> interruptSignal{0};
+/** Key whose result is emitted under a key that cannot be stored */
+static std::string unstorableKey{};
+
+/** Counts each record it is given, emitting its key as the result */
+class KeyCounter : public BE::MPI::RecordProcessor
+{
+public:
+	KeyCounter(
+	    const std::string &propertiesFileName) :
+	    BE::MPI::RecordProcessor(propertiesFileName),
+	    _propertiesFileName(propertiesFileName)
+	{
+	}
+
+	std::shared_ptr<BE::MPI::WorkPackageProcessor>
+	newProcessor(
+	    std::shared_ptr<BE::IO::Logsheet> &logsheet) override
+	{
+		auto processor = std::make_shared<KeyCounter>(
+		    _propertiesFileName);
+		processor->setLogsheet(logsheet);
+		return (processor);
+	}
+
+	void
+	performInitialization(
+	    std::shared_ptr<BE::IO::Logsheet> &logsheet) override
+	{
+		this->setLogsheet(logsheet);
+	}
+
+	void
+	processWorkPackage(
+	    BE::MPI::WorkPackage &workPackage) override
+	{
+		{
+			std::lock_guard<std::mutex> lock(processedMutex);
+			packageSizes.push_back(workPackage.getNumElements());
+		}
+		BE::MPI::RecordProcessor::processWorkPackage(workPackage);
+	}
+
+	void
+	processRecord(
+	    const std::string &key) override
+	{
+		{
+			std::lock_guard<std::mutex> lock(processedMutex);
+			processed[key]++;
+		}
+		if (recordDelay.count() != 0)
+			std::this_thread::sleep_for(recordDelay);
+		this->emitResult((key == unstorableKey ? "/" : "") + key,
+		    key.data(), key.size());
+		const int signo = interruptSignal.exchange(0);
+		if (signo != 0)
+			std::raise(signo);
+	}
+
+	void
+	processRecord(
+	    const std::string &key,
+	    const BE::Memory::uint8Array &value) override
+	{
+		{
+			std::lock_guard<std::mutex> lock(processedMutex);
+			valueMatched[key] = (std::string(value.cbegin(),
+			    value.cend()) == key);
+		}
+		this->processRecord(key);
+	}
+
+private:
+	std::string _propertiesFileName;
+};
+
+/** Package whose creation raises an exit signal, when not 0 */
+static std::atomic<uint32_t> exitAtPackage{0};
+
+/** A Distributor that does not know how many records remain */
+class UncountedDistributor : public BE::MPI::RecordStoreDistributor
+{
+public:
+	using BE::MPI::RecordStoreDistributor::RecordStoreDistributor;
+
+protected:
+	void
+	createWorkPackage(
+	    BE::MPI::WorkPackage &workPackage)
+	    override
+	{
+		/* The package created is then not sent */
+		if ((exitAtPackage != 0) && (++this->_numCreated ==
+		    exitAtPackage)) {
+			exitAtPackage = 0;
+			std::raise(SIGQUIT);
+		}
+		BE::MPI::RecordStoreDistributor::createWorkPackage(
+		    workPackage);
+	}
+
+	uint64_t
+	getNumRemainingElements()
+	    const
+	    override
+	{
+		return (0);
+	}
+
+private:
+	uint32_t _numCreated{0};
+};
+
+/** Run a job over InputRS within this process */
+template<typename DistributorType = BE::MPI::RecordStoreDistributor>
+static void
+runJob(
+    const std::string &properties,
+    bool checkpointEnable = false,
+    bool includeValues = false)
+{
+	{
+		std::ofstream props(PropsFile, std::ios::trunc);
+		props << "Input Record Store = " << InputRS << '\n' <<
+		    "Chunk Size = 3\n" <<
+		    "Workers Per Node = 2\n" <<
+		    "Checkpoint Path = " << CheckpointPath << '\n' <<
+		    properties;
+	}
+
+	processed.clear();
+	valueMatched.clear();
+	packageSizes.clear();
+	BE::MPI::Runtime runtime(checkpointEnable);
+	DistributorType distributor(PropsFile, includeValues);
+	BE::MPI::Receiver receiver(PropsFile,
+	    std::make_shared<KeyCounter>(PropsFile));
+	runtime.start(distributor, receiver);
+	runtime.shutdown();
+}
+
+/** Create InputRS, returning its keys in sequence order */
+static std::vector<std::string>
+createInput(
+    BE::IO::RecordStore::Kind kind)
+{
+	auto rs = BE::IO::RecordStore::createRecordStore(InputRS, "", kind);
+	for (uint32_t i = 0; i < NumRecords; i++) {
+		const std::string key = "key" + std::to_string(i);
+		rs->insert(key, key.c_str(), key.size());
+	}
+
+	std::vector<std::string> keys;
+	while (true) {
+		try {
+			keys.push_back(rs->sequenceKey());
+		} catch (const BE::Error::ObjectDoesNotExist &) {
+			break;
+		}
+	}
+	return (keys);
+}
+
+class InProcessJob :
+    public ::testing::TestWithParam<BE::IO::RecordStore::Kind>
+{
+protected:
+	void SetUp() override
+	{
+		try {
+			_keys = createInput(GetParam());
+		} catch (const BE::Error::NotImplemented &) {
+			GTEST_SKIP() << "RecordStore kind not implemented";
+		}
+		ASSERT_EQ(NumRecords, _keys.size());
+		BE::IO::Utility::makePath(CheckpointPath, S_IRWXU);
+	}
+
+	void TearDown() override
+	{
+		std::remove(PropsFile.c_str());
+		unstorableKey.clear();
+		recordDelay = std::chrono::microseconds{0};
+		for (const auto &rs : {InputRS, ResultRS}) {
+			try {
+				BE::IO::RecordStore::removeRecordStore(rs);
+			} catch (const BE::Error::Exception &) {}
+		}
+		try {
+			BE::IO::Utility::removeDirectory(CheckpointPath);
+		} catch (const BE::Error::Exception &) {}
+	}
+
+	/** Properties returning results to a RecordStore of this kind */
+	std::string resultProperties()
+	{
+		return ("Result Record Store = " + ResultRS + "\n" +
+		    "Result Record Store Kind = " + BE::Framework::Enumeration::
+		    to_string(GetParam()) + "\n");
+	}
+
+	std::vector<std::string> _keys{};
+};
+
+TEST_P(InProcessJob, CompletionRestore)
+{
+	/* As if a job stopped with two ranges of records completed */
+	{
+		std::ofstream checkpoint(CheckpointPath + '/' +
+		    BE::MPI::Distributor::CHECKPOINTFILENAME);
+		std::ofstream completions(CheckpointPath + '/' +
+		    BE::MPI::Distributor::COMPLETIONFILENAME);
+		completions << "0 9 " << _keys[9] << '\n' <<
+		    "15 19 " << _keys[19] << '\n';
+	}
+	runJob("", true);
+
+	for (uint32_t i = 0; i < NumRecords; i++) {
+		const bool completed = (i <= 9) || ((i >= 15) && (i <= 19));
+		EXPECT_EQ(completed ? 0u : 1u, processed[_keys[i]]) <<
+		    "Record " << i << ", " << _keys[i];
+	}
+
+	/* A finished job leaves nothing to restore */
+	EXPECT_FALSE(BE::IO::Utility::fileExists(CheckpointPath + '/' +
+	    BE::MPI::Distributor::CHECKPOINTFILENAME));
+	EXPECT_FALSE(BE::IO::Utility::fileExists(CheckpointPath + '/' +
+	    BE::MPI::Distributor::COMPLETIONFILENAME));
+}
+
+TEST_P(InProcessJob, DistributorFailure)
+{
+	/* A completed key that is not in the store fails the restore */
+	{
+		std::ofstream checkpoint(CheckpointPath + '/' +
+		    BE::MPI::Distributor::CHECKPOINTFILENAME);
+		std::ofstream completions(CheckpointPath + '/' +
+		    BE::MPI::Distributor::COMPLETIONFILENAME);
+		completions << "0 9 nosuchkey\n";
+	}
+
+	/* The Receiver exits rather than waiting on the Distributor */
+	runJob("", true);
+	EXPECT_TRUE(processed.empty());
+}
+
+TEST_P(InProcessJob, LocalReads)
+{
+	for (const bool includeValues : {false, true}) {
+		runJob("Local Record Reads = true\n", false, includeValues);
+		for (const auto &key : _keys) {
+			EXPECT_EQ(1u, processed[key]) << key;
+			if (includeValues) {
+				EXPECT_TRUE(valueMatched[key]) << key;
+			}
+		}
+		EXPECT_EQ(NumRecords, processed.size());
+		EXPECT_EQ(includeValues ? NumRecords : 0, valueMatched.size());
+	}
+}
+
+TEST_P(InProcessJob, CheckpointKeptUntilFinished)
+{
+	const std::string checkpoint = CheckpointPath + '/' +
+	    BE::MPI::Distributor::CHECKPOINTFILENAME;
+	const std::string completions = CheckpointPath + '/' +
+	    BE::MPI::Distributor::COMPLETIONFILENAME;
+
+	/* Stopped by a quick exit signal, so the job is unfinished */
+	interruptSignal = SIGINT;
+	runJob("", true);
+	EXPECT_TRUE(BE::IO::Utility::fileExists(checkpoint));
+	EXPECT_TRUE(BE::IO::Utility::fileExists(completions));
+	auto total = processed;
+
+	runJob("", true);
+	for (const auto &count : processed)
+		total[count.first] += count.second;
+	for (const auto &key : _keys)
+		EXPECT_LE(1u, total[key]) << key;
+	EXPECT_FALSE(BE::IO::Utility::fileExists(checkpoint));
+	EXPECT_FALSE(BE::IO::Utility::fileExists(completions));
+}
+
+TEST_P(InProcessJob, UncountedCheckpointKeptUntilFinished)
+{
+	const std::string checkpoint = CheckpointPath + '/' +
+	    BE::MPI::Distributor::CHECKPOINTFILENAME;
+	const std::string completions = CheckpointPath + '/' +
+	    BE::MPI::Distributor::COMPLETIONFILENAME;
+
+	/*
+	 * With one package at a time, every package sent before the exit
+	 * signal is completed, but records remain, though none are
+	 * reported.
+	 */
+	const std::string properties = "Workers Per Node = 1\n"
+	    "Prefetch Packages = 1\n";
+	exitAtPackage = 3;
+	runJob<UncountedDistributor>(properties, true);
+	EXPECT_EQ(6u, processed.size());
+	EXPECT_TRUE(BE::IO::Utility::fileExists(checkpoint));
+	EXPECT_TRUE(BE::IO::Utility::fileExists(completions));
+
+	runJob<UncountedDistributor>(properties, true);
+	EXPECT_EQ(NumRecords - 6, processed.size());
+	EXPECT_FALSE(BE::IO::Utility::fileExists(checkpoint));
+	EXPECT_FALSE(BE::IO::Utility::fileExists(completions));
+}
+
+TEST_P(InProcessJob, AdaptiveSizeWithPrefetch)
+{
+	static const uint32_t numRecords{2000};
+	{
+		auto rs = BE::IO::RecordStore::openRecordStore(InputRS,
+		    BE::IO::Mode::ReadWrite);
+		for (uint32_t i = NumRecords; i < numRecords; i++) {
+			const std::string key = "key" + std::to_string(i);
+			rs->insert(key, key.c_str(), key.size());
+		}
+	}
+
+	/*
+	 * Two workers at 1 ms a record complete at most 2000 records a
+	 * second, so packages of 0.05 s hold about 100. Packages held by
+	 * the Receiver must not be mistaken for work done.
+	 */
+	recordDelay = std::chrono::milliseconds(1);
+	runJob("Adaptive Chunk Size = true\n"
+	    "Package Duration = 0.05\n"
+	    "Prefetch Packages = 4\n");
+
+	EXPECT_EQ(numRecords, processed.size());
+	uint64_t total{0};
+	for (const auto size : packageSizes) {
+		EXPECT_GE(200u, size);
+		total += size;
+	}
+	EXPECT_EQ(numRecords, total);
+}
+
+TEST_P(InProcessJob, Results)
+{
+	runJob(this->resultProperties() + "Result Batch Size = 16\n");
+
+	auto results = BE::IO::RecordStore::openRecordStore(ResultRS);
+	EXPECT_EQ(NumRecords, results->getCount());
+	for (const auto &key : _keys) {
+		BE::Memory::uint8Array value;
+		ASSERT_NO_THROW(value = results->read(key)) << key;
+		EXPECT_EQ(key, std::string(value.cbegin(), value.cend()));
+	}
+}
+
+TEST_P(InProcessJob, UnwrittenResultsRedone)
+{
+	const std::string properties = this->resultProperties();
+
+	/* A result that cannot be written ends the job unfinished */
+	unstorableKey = _keys[20];
+	runJob(properties, true);
+	EXPECT_EQ(1u, processed[unstorableKey]);
+	EXPECT_TRUE(BE::IO::Utility::fileExists(CheckpointPath + '/' +
+	    BE::MPI::Distributor::COMPLETIONFILENAME));
+
+	/* Its work package was not recorded as complete */
+	unstorableKey.clear();
+	runJob(properties, true);
+	EXPECT_EQ(1u, processed[_keys[20]]);
+	auto results = BE::IO::RecordStore::openRecordStore(ResultRS);
+	EXPECT_EQ(NumRecords, results->getCount());
+	EXPECT_FALSE(BE::IO::Utility::fileExists(CheckpointPath + '/' +
+	    BE::MPI::Distributor::COMPLETIONFILENAME));
+}
+
+INSTANTIATE_TEST_SUITE_P(RecordStoreKind, InProcessJob, ::testing::Values(
+    BE::IO::RecordStore::Kind::BerkeleyDB,
+    BE::IO::RecordStore::Kind::Archive,
+    BE::IO::RecordStore::Kind::File,
+    BE::IO::RecordStore::Kind::SQLite));
+
+TEST(InProcessRuntime, ThreadedWorkersRequired)
+{
+	{
+		std::ofstream props(PropsFile, std::ios::trunc);
+		props << "Workers Per Node = 2\n" <<
+		    "Threaded Workers = false\n";
+	}
+
+	BE::MPI::Runtime runtime;
+	EXPECT_THROW(BE::MPI::Receiver(PropsFile,
+	    std::make_shared<KeyCounter>(PropsFile)), BE::Error::StrategyError);
+	std::remove(PropsFile.c_str());
+}
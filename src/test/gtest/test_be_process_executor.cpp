@@ -0,0 +1,163 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <atomic>
+#include <list>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <be_error_exception.h>
+#include <be_process_executor.h>
+
+#include <gtest/gtest.h>
+
+namespace BE = BiometricEvaluation;
+
+TEST(Executor, Construction)
+{
+	BE::Process::Executor executor(3);
+	EXPECT_EQ(3u, executor.getNumThreads());
+
+	BE::Process::Executor defaultExecutor;
+	EXPECT_GT(defaultExecutor.getNumThreads(), 0u);
+	EXPECT_FALSE(defaultExecutor.isPoolThread());
+}
+
+TEST(Executor, Submit)
+{
+	BE::Process::Executor executor(4);
+
+	auto sum = executor.submit([](int a, int b) { return (a + b); }, 2, 3);
+	EXPECT_EQ(5, sum.get());
+
+	auto failure = executor.submit([]() -> int {
+		throw std::runtime_error("failed");
+	});
+	EXPECT_THROW(failure.get(), std::runtime_error);
+
+	auto inPool = executor.submit([&executor]() {
+		return (executor.isPoolThread());
+	});
+	EXPECT_TRUE(inPool.get());
+}
+
+TEST(Executor, NestedTasks)
+{
+	/* Tasks waiting on their own tasks must not exhaust the pool */
+	BE::Process::Executor executor(2);
+
+	std::function<uint64_t(uint64_t)> fib = [&](uint64_t n) -> uint64_t {
+		if (n < 2)
+			return (n);
+		auto left = executor.submit(fib, n - 1);
+		const uint64_t right = fib(n - 2);
+		return (left.get() + right);
+	};
+	EXPECT_EQ(610u, executor.submit(fib, 15).get());
+}
+
+TEST(Executor, Then)
+{
+	BE::Process::Executor executor(2);
+
+	auto result = executor.submit([]() { return (20); }).then(
+	    [](BE::Process::Future<int> value) { return (value.get() + 1); }).then(
+	    [](BE::Process::Future<int> value) { return (value.get() * 2); });
+	EXPECT_EQ(42, result.get());
+
+	/* Continuations see the antecedent's exception */
+	auto recovered = executor.submit([]() -> int {
+		throw std::runtime_error("failed");
+	}).then([](BE::Process::Future<int> value) {
+		try {
+			return (value.get());
+		} catch (const std::runtime_error&) {
+			return (-1);
+		}
+	});
+	EXPECT_EQ(-1, recovered.get());
+
+	/* Continuation added after completion */
+	auto done = executor.submit([]() {});
+	done.wait();
+	EXPECT_TRUE(done.isReady());
+	EXPECT_TRUE(done.then([](BE::Process::Future<void>) {
+		return (true);
+	}).get());
+}
+
+TEST(Executor, ParallelFor)
+{
+	BE::Process::Executor executor(4);
+
+	std::vector<std::atomic<uint32_t>> counts(10000);
+	executor.parallelFor(0, static_cast<int>(counts.size()), [&](int i) {
+		counts[i]++;
+	});
+	for (const auto &count : counts)
+		EXPECT_EQ(1u, count);
+
+	/* Empty range and explicit grain size */
+	executor.parallelFor(5, 5, [](int) { FAIL(); });
+	std::atomic<uint64_t> total{0};
+	executor.parallelFor(uint64_t{0}, uint64_t{101}, [&](uint64_t i) {
+		total += i;
+	}, 7);
+	EXPECT_EQ(5050u, total);
+
+	EXPECT_THROW(executor.parallelFor(0, 100, [](int i) {
+		if (i == 50)
+			throw BE::Error::StrategyError("failed");
+	}), BE::Error::StrategyError);
+}
+
+TEST(Executor, ParallelForEach)
+{
+	BE::Process::Executor executor(4);
+
+	std::vector<uint64_t> values(5000);
+	std::iota(values.begin(), values.end(), 0);
+	executor.parallelForEach(values, [](uint64_t &value) { value *= 2; });
+	for (uint64_t i = 0; i < values.size(); i++)
+		EXPECT_EQ(2 * i, values[i]);
+
+	/* Iterators that can only move forward, as with RecordStores */
+	std::list<uint64_t> list(values.begin(), values.end());
+	std::atomic<uint64_t> total{0};
+	executor.parallelForEach(list.cbegin(), list.cend(),
+	    [&](uint64_t value) { total += value; }, 10);
+	EXPECT_EQ(std::accumulate(values.begin(), values.end(), uint64_t{0}),
+	    total);
+
+	EXPECT_THROW(executor.parallelForEach(list.cbegin(), list.cend(),
+	    [](uint64_t value) {
+		if (value == 42)
+			throw BE::Error::StrategyError("failed");
+	}), BE::Error::StrategyError);
+}
+
+TEST(Executor, DestructionRunsQueuedTasks)
+{
+	std::atomic<uint32_t> count{0};
+	{
+		BE::Process::Executor executor(2);
+		for (int i = 0; i < 100; i++)
+			executor.submit([&count]() { count++; });
+	}
+	EXPECT_EQ(100u, count);
+}
+
+TEST(Executor, Default)
+{
+	BE::Process::Executor &executor = BE::Process::Executor::getDefault();
+	EXPECT_EQ(&executor, &BE::Process::Executor::getDefault());
+	EXPECT_EQ(3, executor.submit([]() { return (3); }).get());
+}
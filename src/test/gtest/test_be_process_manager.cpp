@@ -8,8 +8,15 @@
  * about its quality, reliability, or any other characteristic.
  */
 
+#ifdef Linux
+#include <sched.h>
+#endif
 #include <unistd.h>
 
+#include <map>
+#include <set>
+#include <string>
+
 #ifdef FORK
 #include <csignal>
 #endif
@@ -110,6 +117,52 @@ public:
 	virtual ~TalkWorker() = default;
 };
 
+/** Sends back each message received, until receiving "QUIT" */
+class EchoWorker : public BE::Process::Worker
+{
+public:
+	int32_t
+	workerMain()
+	{
+		BE::Memory::uint8Array message;
+		while (this->waitForMessage()) {
+			this->receiveMessageFromManager(message);
+			if ((message.size() != 0) &&
+			    (to_string(message) == "QUIT"))
+				break;
+			this->sendMessageToManager(message);
+		}
+
+		return (0);
+	}
+};
+
+/** Sends the CPUs on which it may run, such as "0,4,", then waits */
+class AffinityWorker : public BE::Process::Worker
+{
+public:
+	int32_t
+	workerMain()
+	{
+		std::string cpus;
+#ifdef Linux
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		EXPECT_EQ(0, sched_getaffinity(0, sizeof(set), &set));
+		for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+			if (CPU_ISSET(cpu, &set))
+				cpus += std::to_string(cpu) + ",";
+#endif
+
+		BE::Memory::uint8Array message;
+		BE::Memory::AutoArrayUtility::setString(message, cpus);
+		this->sendMessageToManager(message);
+		if (this->waitForMessage())
+			this->receiveMessageFromManager(message);
+		return (0);
+	}
+};
+
 /** Returns PARAM - (sum of primes <= PARAM) */
 class PrimeWorker : public BE::Process::Worker
 {
@@ -306,6 +359,157 @@ TEST(ProcessManager, Communications)
 	EXPECT_EQ(manager->getNumActiveWorkers(), 0);
 }
 
+TEST(ProcessManager, BatchCommunications)
+{
+	std::unique_ptr<BE::Process::Manager> manager;
+#if defined FORK
+	manager.reset(new BE::Process::ForkManager());
+#elif defined THREAD
+	manager.reset(new BE::Process::POSIXThreadManager());
+#else
+	ASSERT_TRUE(false);
+#endif
+
+	for (auto i = 0; i < numWorkers; i++)
+		manager->addWorker(
+		    std::shared_ptr<TalkWorker>(new TalkWorker()));
+	manager->startWorkers(false, true);
+
+	BE::Memory::uint8Array message;
+	BE::Memory::AutoArrayUtility::setString(message, "To TalkWorker");
+	manager->broadcastMessage(message);
+
+	/* Each Worker sends one message, possibly in the same batch */
+	std::vector<std::pair<std::shared_ptr<BE::Process::WorkerController>,
+	    BE::Memory::uint8Array>> messages;
+	while (messages.size() < numWorkers) {
+		const auto previous = messages.size();
+		const auto numRead = manager->getNextMessages(messages, 1);
+		EXPECT_EQ(messages.size(), previous + numRead);
+		if (numRead == 0)
+			break;
+	}
+	ASSERT_EQ(messages.size(), numWorkers);
+
+	std::set<std::shared_ptr<BE::Process::WorkerController>> senders;
+	for (const auto &received : messages) {
+		EXPECT_EQ("To Manager", to_string(received.second));
+		senders.insert(received.first);
+	}
+	EXPECT_EQ(senders.size(), numWorkers);
+
+	BE::Memory::AutoArrayUtility::setString(message, "QUIT");
+	manager->broadcastMessage(message);
+
+	manager->waitForWorkerExit();
+	EXPECT_EQ(manager->getNumCompletedWorkers(), numWorkers);
+	EXPECT_FALSE(manager->getNextMessages(messages, 0));
+}
+
+TEST(ProcessManager, SharedMemoryCommunications)
+{
+	std::unique_ptr<BE::Process::Manager> manager;
+#if defined FORK
+	manager.reset(new BE::Process::ForkManager());
+#elif defined THREAD
+	manager.reset(new BE::Process::POSIXThreadManager());
+#else
+	ASSERT_TRUE(false);
+#endif
+
+	/* Small enough that larger messages are streamed through */
+	static const uint64_t channelSize = 256;
+	std::shared_ptr<BE::Process::WorkerController> workers[numWorkers];
+	for (auto i = 0; i < numWorkers; i++) {
+		auto worker = std::make_shared<EchoWorker>();
+		worker->setSharedMemoryChannelSize(channelSize);
+		EXPECT_EQ(channelSize, worker->getSharedMemoryChannelSize());
+		workers[i] = manager->addWorker(worker);
+	}
+	manager->startWorkers(false, true);
+	EXPECT_THROW(workers[0]->getWorker()->setSharedMemoryChannelSize(0),
+	    BE::Error::ObjectExists);
+
+	static const uint32_t numMessages = 50;
+	std::map<std::shared_ptr<BE::Process::WorkerController>,
+	    uint32_t> received;
+	for (uint32_t i = 0; i < numMessages; i++) {
+		/* Sizes from empty to several times the channel */
+		BE::Memory::uint8Array message((i * 37) % (channelSize * 4));
+		for (uint64_t j = 0; j < message.size(); j++)
+			message[j] = static_cast<uint8_t>(i + j);
+		for (auto &worker : workers)
+			worker->sendMessageToWorker(message);
+
+		std::shared_ptr<BE::Process::WorkerController> sender;
+		BE::Memory::uint8Array echo;
+		for (auto j = 0; j < numWorkers; j++) {
+			ASSERT_TRUE(manager->getNextMessage(sender, echo, 5));
+			EXPECT_EQ(message, echo);
+			received[sender]++;
+		}
+	}
+	for (auto &worker : workers)
+		EXPECT_EQ(numMessages, received[worker]);
+
+	BE::Memory::uint8Array message;
+	BE::Memory::AutoArrayUtility::setString(message, "QUIT");
+	manager->broadcastMessage(message);
+
+	manager->waitForWorkerExit();
+	EXPECT_EQ(manager->getNumCompletedWorkers(), numWorkers);
+	EXPECT_EQ(manager->getNumActiveWorkers(), 0);
+}
+
+TEST(ProcessManager, Placement)
+{
+	std::unique_ptr<BE::Process::Manager> manager;
+#if defined FORK
+	manager.reset(new BE::Process::ForkManager());
+#elif defined THREAD
+	manager.reset(new BE::Process::POSIXThreadManager());
+#else
+	ASSERT_TRUE(false);
+#endif
+
+	std::map<std::shared_ptr<BE::Process::WorkerController>,
+	    std::string> expected;
+	for (auto i = 0; i < numWorkers; i++) {
+		auto worker = manager->addWorker(
+		    std::make_shared<AffinityWorker>());
+		std::vector<uint32_t> cpus;
+		try {
+			cpus = BE::Process::getPlacementCPUs(
+			    BE::Process::Placement::Compact, i);
+		} catch (const BE::Error::NotImplemented&) {
+			EXPECT_THROW(manager->startWorkers(true, true,
+			    BE::Process::Placement::Compact),
+			    BE::Error::NotImplemented);
+			GTEST_SKIP() << "Built without hwloc";
+		}
+		EXPECT_FALSE(cpus.empty());
+		for (const auto cpu : cpus)
+			expected[worker] += std::to_string(cpu) + ",";
+	}
+	EXPECT_TRUE(BE::Process::getPlacementCPUs(
+	    BE::Process::Placement::None, 0).empty());
+
+	manager->startWorkers(false, true, BE::Process::Placement::Compact);
+	std::shared_ptr<BE::Process::WorkerController> sender;
+	BE::Memory::uint8Array message;
+	for (auto i = 0; i < numWorkers; i++) {
+		ASSERT_TRUE(manager->getNextMessage(sender, message, 5));
+#ifdef Linux
+		EXPECT_EQ(expected[sender], to_string(message));
+#endif
+	}
+
+	BE::Memory::AutoArrayUtility::setString(message, "QUIT");
+	manager->broadcastMessage(message);
+	manager->waitForWorkerExit();
+	EXPECT_EQ(numWorkers, manager->getNumCompletedWorkers());
+}
+
 TEST(ProcessManager, Individual)
 {
 	std::unique_ptr<BE::Process::Manager> manager;
@@ -0,0 +1,243 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include <unistd.h>
+
+#include <be_error_exception.h>
+#include <be_process_statisticsfile.h>
+
+#include <gtest/gtest.h>
+
+namespace BE = BiometricEvaluation;
+
+static const std::string StatsFile = "test_be_process_statisticsfile.bin";
+
+/** A Sample with distinct values, and i tasks */
+static BE::Process::Statistics::Sample
+makeSample(
+    uint64_t i)
+{
+	BE::Process::Statistics::Sample sample;
+	sample.timestamp = 1000000 * i;
+	sample.utime = i + 1;
+	sample.stime = i + 2;
+	sample.vmrss = i + 3;
+	sample.vmsize = i + 4;
+	sample.vmpeak = i + 5;
+	sample.vmdata = i + 6;
+	sample.vmstack = i + 7;
+	sample.threads = i + 8;
+	sample.readChars = i + 9;
+	sample.writeChars = i + 10;
+	sample.readCalls = i + 11;
+	sample.writeCalls = i + 12;
+	sample.readBytes = i + 13;
+	sample.writeBytes = i + 14;
+	for (uint64_t t = 0; t < i; t++)
+		sample.tasks.push_back({static_cast<pid_t>(100 + t), i * t,
+		    i + t, t, i});
+	return (sample);
+}
+
+static void
+expectEqual(
+    const BE::Process::Statistics::Sample &expected,
+    const BE::Process::Statistics::Sample &actual,
+    bool withTasks = true)
+{
+	EXPECT_EQ(expected.timestamp, actual.timestamp);
+	EXPECT_EQ(expected.utime, actual.utime);
+	EXPECT_EQ(expected.stime, actual.stime);
+	EXPECT_EQ(expected.vmrss, actual.vmrss);
+	EXPECT_EQ(expected.vmsize, actual.vmsize);
+	EXPECT_EQ(expected.vmpeak, actual.vmpeak);
+	EXPECT_EQ(expected.vmdata, actual.vmdata);
+	EXPECT_EQ(expected.vmstack, actual.vmstack);
+	EXPECT_EQ(expected.threads, actual.threads);
+	EXPECT_EQ(expected.readChars, actual.readChars);
+	EXPECT_EQ(expected.writeChars, actual.writeChars);
+	EXPECT_EQ(expected.readCalls, actual.readCalls);
+	EXPECT_EQ(expected.writeCalls, actual.writeCalls);
+	EXPECT_EQ(expected.readBytes, actual.readBytes);
+	EXPECT_EQ(expected.writeBytes, actual.writeBytes);
+
+	if (!withTasks) {
+		EXPECT_TRUE(actual.tasks.empty());
+		return;
+	}
+	ASSERT_EQ(expected.tasks.size(), actual.tasks.size());
+	for (std::size_t t = 0; t < expected.tasks.size(); t++) {
+		EXPECT_EQ(expected.tasks[t].tid, actual.tasks[t].tid);
+		EXPECT_EQ(expected.tasks[t].utime, actual.tasks[t].utime);
+		EXPECT_EQ(expected.tasks[t].stime, actual.tasks[t].stime);
+		EXPECT_EQ(expected.tasks[t].utimeDelta,
+		    actual.tasks[t].utimeDelta);
+		EXPECT_EQ(expected.tasks[t].stimeDelta,
+		    actual.tasks[t].stimeDelta);
+	}
+}
+
+class StatisticsFile : public ::testing::TestWithParam<bool>
+{
+protected:
+	void TearDown() override
+	{
+		std::remove(StatsFile.c_str());
+	}
+};
+
+TEST_P(StatisticsFile, RoundTrip)
+{
+	{
+		/* 7 samples make three full blocks and one partial */
+		BE::Process::StatisticsFileWriter writer(StatsFile, GetParam(),
+		    2);
+		for (uint64_t i = 0; i < 7; i++)
+			writer.write(makeSample(i));
+	}
+
+	BE::Process::StatisticsFileReader reader(StatsFile);
+	for (uint64_t i = 0; i < 7; i++)
+		expectEqual(makeSample(i), reader.sequence());
+	EXPECT_THROW(reader.sequence(), BE::Error::ObjectDoesNotExist);
+}
+
+TEST_P(StatisticsFile, WithoutTasks)
+{
+	{
+		BE::Process::StatisticsFileWriter writer(StatsFile, GetParam(),
+		    64, false);
+		for (uint64_t i = 0; i < 3; i++)
+			writer.write(makeSample(i));
+	}
+
+	BE::Process::StatisticsFileReader reader(StatsFile);
+	for (uint64_t i = 0; i < 3; i++)
+		expectEqual(makeSample(i), reader.sequence(), false);
+	EXPECT_THROW(reader.sequence(), BE::Error::ObjectDoesNotExist);
+}
+
+TEST_P(StatisticsFile, IncompleteBlock)
+{
+	{
+		BE::Process::StatisticsFileWriter writer(StatsFile, GetParam(),
+		    3);
+		for (uint64_t i = 0; i < 5; i++)
+			writer.write(makeSample(i));
+	}
+	/* As if the writer exited while writing the second block */
+	std::filesystem::resize_file(StatsFile,
+	    std::filesystem::file_size(StatsFile) - 5);
+
+	BE::Process::StatisticsFileReader reader(StatsFile);
+	for (uint64_t i = 0; i < 3; i++)
+		expectEqual(makeSample(i), reader.sequence());
+	EXPECT_THROW(reader.sequence(), BE::Error::ObjectDoesNotExist);
+}
+
+TEST_P(StatisticsFile, CSV)
+{
+	{
+		BE::Process::StatisticsFileWriter writer(StatsFile, GetParam());
+		for (uint64_t i = 0; i < 4; i++)
+			writer.write(makeSample(i));
+	}
+
+	BE::Process::StatisticsFileReader reader(StatsFile);
+	std::ostringstream samples, tasks;
+	reader.writeCSV(samples, tasks);
+
+	std::istringstream samplesLines(samples.str());
+	std::string line;
+	std::getline(samplesLines, line);
+	EXPECT_EQ("timestamp,utime,stime,vmrss,vmsize,vmpeak,vmdata,vmstack,"
+	    "threads,readChars,writeChars,readCalls,writeCalls,readBytes,"
+	    "writeBytes", line);
+	std::getline(samplesLines, line);
+	EXPECT_EQ("0,1,2,3,4,5,6,7,8,9,10,11,12,13,14", line);
+	uint32_t count{1};
+	while (std::getline(samplesLines, line))
+		count++;
+	EXPECT_EQ(4u, count);
+
+	/* 0 + 1 + 2 + 3 tasks */
+	std::istringstream tasksLines(tasks.str());
+	std::getline(tasksLines, line);
+	EXPECT_EQ("timestamp,tid,utime,stime,utimeDelta,stimeDelta", line);
+	std::getline(tasksLines, line);
+	EXPECT_EQ("1000000,100,0,1,0,1", line);
+	count = 1;
+	while (std::getline(tasksLines, line))
+		count++;
+	EXPECT_EQ(6u, count);
+}
+
+INSTANTIATE_TEST_SUITE_P(Compression, StatisticsFile, ::testing::Bool());
+
+TEST(StatisticsFileErrors, Open)
+{
+	EXPECT_THROW(BE::Process::StatisticsFileReader("nonexistent.bin"),
+	    BE::Error::ObjectDoesNotExist);
+	EXPECT_THROW(BE::Process::StatisticsFileWriter(StatsFile, true, 0),
+	    BE::Error::ParameterError);
+
+	{
+		std::ofstream text(StatsFile);
+		text << "Not a statistics file\n";
+	}
+	EXPECT_THROW(BE::Process::StatisticsFileWriter{StatsFile},
+	    BE::Error::ObjectExists);
+	EXPECT_THROW(BE::Process::StatisticsFileReader{StatsFile},
+	    BE::Error::StrategyError);
+	std::remove(StatsFile.c_str());
+}
+
+TEST(StatisticsFileWriter, Statistics)
+{
+	{
+		auto writer = std::make_shared<BE::Process::StatisticsFileWriter>(
+		    StatsFile);
+		BE::Process::Statistics stats(writer);
+		try {
+			stats.logStats();
+		} catch (const BE::Error::NotImplemented &) {
+			std::remove(StatsFile.c_str());
+			GTEST_SKIP() << "Statistics not implemented on this OS";
+		}
+		stats.logStats();
+		stats.startAutoLogging(10000);
+		::usleep(100000);
+		stats.stopAutoLogging();
+	}
+
+	BE::Process::StatisticsFileReader reader(StatsFile);
+	uint32_t count{0};
+	uint64_t previous{0};
+	while (true) {
+		BE::Process::Statistics::Sample sample;
+		try {
+			sample = reader.sequence();
+		} catch (const BE::Error::ObjectDoesNotExist &) {
+			break;
+		}
+		EXPECT_GE(sample.timestamp, previous);
+		EXPECT_GT(sample.vmrss, 0u);
+		EXPECT_FALSE(sample.tasks.empty());
+		previous = sample.timestamp;
+		count++;
+	}
+	EXPECT_GE(count, 3u);
+	std::remove(StatsFile.c_str());
+}
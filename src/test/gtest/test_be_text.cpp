@@ -95,6 +95,28 @@ TEST(Text, split)
 		EXPECT_EQ(expectedComponents[i], components[i]);
 }
 
+TEST(Text, tokenize)
+{
+	/* Tokens are views of the original string */
+	const std::string str = "1,,probe.wsq,gallery.wsq,";
+	std::vector<std::string_view> tokens = BE::Text::tokenize(str, ',');
+	ASSERT_EQ(3, tokens.size());
+	EXPECT_EQ("1", tokens[0]);
+	EXPECT_EQ("probe.wsq", tokens[1]);
+	EXPECT_EQ("gallery.wsq", tokens[2]);
+	EXPECT_EQ(str.data() + 3, tokens[1].data());
+
+	/* Escaped delimiters still end tokens */
+	tokens = BE::Text::tokenize("file\\ name 500", ' ');
+	ASSERT_EQ(3, tokens.size());
+	EXPECT_EQ("file\\", tokens[0]);
+
+	/* Tokenize on character not appearing in string */
+	tokens = BE::Text::tokenize(str, 'z');
+	ASSERT_EQ(1, tokens.size());
+	EXPECT_EQ(str, tokens[0]);
+}
+
 TEST(Text, filename)
 {
 	std::string path = "/this/portion/is/the/dirname/and_this_is_the_"
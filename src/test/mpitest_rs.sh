@@ -39,6 +39,7 @@ Workers Per Node = 1
 Logsheet URL = file://mpi.log
 Record Logsheet URL = file://record.log
 Checkpoint Path = $CHKPATH
+Result Record Store = test_be_rs_mpi_results
 #Logsheet URL = syslog://linc01b:2514
 #Record Logsheet URL = syslog://linc01b:2514
 EOF
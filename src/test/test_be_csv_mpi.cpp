@@ -178,16 +178,21 @@ main(int argc, char* argv[])
 	 * are take care of.
 	 */
 	/*
-	 * Process optional checkpoint and include-values flags.
+	 * Process optional checkpoint and in-process (run without MPI)
+	 * flags.
 	 */
-	bool checkpoint{false};
+	bool checkpoint{false}, inProcess{false};
 	char ch;
-	while ((ch = getopt(argc, argv, "c")) != -1) {
+	while ((ch = getopt(argc, argv, "cl")) != -1) {
 		switch (ch) {
 			case 'c': checkpoint = true; break;
+			case 'l': inProcess = true; break;
 		}
 	}
-	MPI::Runtime runtime(argc, argv, checkpoint);
+	std::unique_ptr<MPI::Runtime> runtimeInstance(inProcess ?
+	    new MPI::Runtime(checkpoint) :
+	    new MPI::Runtime(argc, argv, checkpoint));
+	MPI::Runtime &runtime = *runtimeInstance;
 	std::string propFile;
 	/* Create the properties file if needed */
 	if (!IO::Utility::fileExists(DefaultPropertiesFileName)) {
@@ -14,6 +14,7 @@
 #include <ctime>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 
 #include <be_io_archiverecstore.h>
@@ -218,6 +219,151 @@ int main (int argc, char* argv[]) {
 		return (EXIT_FAILURE);
 	}
 
+	/* Replace records in an open store, then compact it in place */
+	try {
+		IO::ArchiveRecordStore ars4(archivefn, IO::Mode::ReadWrite);
+		if (ars4.getDeadSpace() != 0) {
+			cout << "Failed test of dead space after vacuum" << endl;
+			return (EXIT_FAILURE);
+		}
+		Memory::uint8Array buf(32);
+		for (int i = 0; i < 100; i += 2) {
+			randkey.str(""); randkey << i;
+			if (randkey.str() == chkkey)
+				continue;
+			snprintf((char *)&buf[0], buf.size(), "replaced %d", i);
+			ars4.replace(randkey.str(), buf);
+		}
+		if (ars4.getDeadSpace() == 0) {
+			cout << "Failed test of dead space after replace" <<
+			    endl;
+			return (EXIT_FAILURE);
+		}
+		cout << "Passed test of dead space (" << ars4.getDeadSpace() <<
+		    " bytes)" << endl;
+
+		uint64_t oldSize = ars4.getSpaceUsed();
+		ars4.vacuum();
+		if ((ars4.getDeadSpace() != 0) || ars4.needsVacuum() ||
+		    (ars4.getSpaceUsed() >= oldSize)) {
+			cout << "Failed test of in-place vacuum" << endl;
+			return (EXIT_FAILURE);
+		}
+		for (int i = 0; i < 100; i += 2) {
+			randkey.str(""); randkey << i;
+			if (randkey.str() == chkkey)
+				continue;
+			snprintf((char *)&buf[0], buf.size(), "replaced %d", i);
+			if (ars4.read(randkey.str()) != buf) {
+				cout << "Failed test of reading after in-place "
+				    "vacuum" << endl;
+				return (EXIT_FAILURE);
+			}
+		}
+		cout << "Passed test of in-place vacuum" << endl;
+
+		/* Automatic vacuum once half the archive is dead space */
+		ars4.setVacuumThreshold(0.5);
+		bool compacted = false;
+		uint64_t deadSpace = 0;
+		for (int i = 0; i < 100; i++) {
+			if ((i % 2 == 0) && ((i > 60) || (i == 42)))
+				continue;
+			ars4.remove(to_string(i));
+			if (ars4.getDeadSpace() < deadSpace)
+				compacted = true;
+			deadSpace = ars4.getDeadSpace();
+		}
+		if (!compacted) {
+			cout << "Failed test of automatic vacuum" << endl;
+			return (EXIT_FAILURE);
+		}
+		cout << "Passed test of automatic vacuum" << endl;
+	} catch (const Error::Exception &e) {
+		cout << "Failed test of in-place vacuum: " << e.whatString() <<
+		    endl;
+		return (EXIT_FAILURE);
+	}
+
+	/* Vacuum in the background */
+	try {
+		auto pending = IO::ArchiveRecordStore::vacuumAsync(archivefn);
+		pending.get();
+		if (IO::ArchiveRecordStore::needsVacuum(archivefn)) {
+			cout << "Failed test of background vacuum" << endl;
+			return (EXIT_FAILURE);
+		}
+		IO::ArchiveRecordStore ars5(archivefn);
+		if (ars5.getCount() != 19) {
+			cout << "Failed test of count after background "
+			    "vacuum" << endl;
+			return (EXIT_FAILURE);
+		}
+		cout << "Passed test of background vacuum" << endl;
+	} catch (const Error::Exception &e) {
+		cout << "Failed test of background vacuum: " <<
+		    e.whatString() << endl;
+		return (EXIT_FAILURE);
+	}
+
+	/* Checksums can only be enabled on an empty store */
+	try {
+		IO::ArchiveRecordStore ars6(archivefn, IO::Mode::ReadWrite);
+		ars6.enableChecksums();
+		cout << "Failed test of enabling checksums on non-empty "
+		    "store" << endl;
+		return (EXIT_FAILURE);
+	} catch (const Error::StrategyError&) {
+		cout << "Passed test of enabling checksums on non-empty "
+		    "store" << endl;
+	}
+
+	/* Verify records against their checksums, then corrupt one */
+	string crcfn("arcrctestdir");
+	try {
+		IO::ArchiveRecordStore ars7(crcfn, "Test checksums");
+		ars7.enableChecksums();
+		Memory::uint8Array buf(64);
+		for (int i = 0; i < 100; i++) {
+			snprintf((char *)&buf[0], buf.size(), "record %d", i);
+			ars7.insert(to_string(i), buf);
+		}
+		ars7.replace("50", buf);
+		ars7.remove("51");
+		if (!ars7.verify(4).empty()) {
+			cout << "Failed test of verifying intact store" << endl;
+			return (EXIT_FAILURE);
+		}
+		cout << "Passed test of verifying intact store" << endl;
+	} catch (const Error::Exception &e) {
+		cout << "Failed test of verifying intact store: " <<
+		    e.whatString() << endl;
+		return (EXIT_FAILURE);
+	}
+
+	FILE *fp = fopen((crcfn + "/" +
+	    IO::ArchiveRecordStore::ARCHIVE_FILE_NAME).c_str(), "r+b");
+	if (fp == nullptr) {
+		cout << "Could not open archive to corrupt it" << endl;
+		return (EXIT_FAILURE);
+	}
+	fputc('X', fp);
+	fclose(fp);
+	try {
+		IO::ArchiveRecordStore ars8(crcfn);
+		vector<string> corrupt = ars8.verify();
+		if ((corrupt.size() != 1) || (corrupt[0] != "0")) {
+			cout << "Failed test of verifying corrupt store" << endl;
+			return (EXIT_FAILURE);
+		}
+		cout << "Passed test of verifying corrupt store" << endl;
+		IO::RecordStore::removeRecordStore(crcfn);
+	} catch (const Error::Exception &e) {
+		cout << "Failed test of verifying corrupt store: " <<
+		    e.whatString() << endl;
+		return (EXIT_FAILURE);
+	}
+
 	/* Remove the RecordStore */
 	cout << "Removing record store...";
 	try {
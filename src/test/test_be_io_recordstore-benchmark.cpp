@@ -0,0 +1,444 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+/*
+ * Run every RecordStore Kind through the same workloads and report
+ * throughput and latency as JSON, so that Kinds can be compared and
+ * regressions caught.
+ *
+ * Usage: test_be_io_recordstore-benchmark [-n count] [-s size,...]
+ *            [-k Kind,...] [-d directory] [-o output.json] [-r seed]
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <be_error_exception.h>
+#include <be_io_recordstore.h>
+#include <be_io_utility.h>
+#include <be_text.h>
+#include <be_time_timer.h>
+
+namespace BE = BiometricEvaluation;
+
+/** Records per store when -n is not given */
+static const uint64_t DEFAULT_COUNT{5000};
+/** Record sizes when -s is not given */
+static const std::vector<uint64_t> DEFAULT_SIZES{128, 4096, 65536};
+/** Kinds that can be created directly, when -k is not given */
+static const std::vector<BE::IO::RecordStore::Kind> DEFAULT_KINDS{
+    BE::IO::RecordStore::Kind::BerkeleyDB,
+    BE::IO::RecordStore::Kind::Archive,
+    BE::IO::RecordStore::Kind::File,
+    BE::IO::RecordStore::Kind::SQLite,
+    BE::IO::RecordStore::Kind::Compressed,
+    BE::IO::RecordStore::Kind::Deduplicated};
+/** Fraction of mixed workload operations that replace a record */
+static const double MIXED_WRITE_FRACTION{0.2};
+
+/** Measurements of one workload */
+struct Result
+{
+	std::string workload;
+	uint64_t ops{0};
+	uint64_t bytes{0};
+	uint64_t elapsedNS{0};
+	/** Latency of each operation, in nanoseconds */
+	std::vector<uint64_t> latencies;
+};
+
+/*
+ * Time each call of op(i) for i in [0, count).  op returns the number of
+ * bytes it transferred.
+ */
+template<typename Op>
+static Result
+measure(
+    const std::string &workload,
+    const uint64_t count,
+    Op op)
+{
+	Result result;
+	result.workload = workload;
+	result.latencies.reserve(count);
+
+	BE::Time::Timer total, timer;
+	total.start();
+	for (uint64_t i = 0; i < count; i++) {
+		timer.start();
+		result.bytes += op(i);
+		timer.stop();
+		result.latencies.push_back(
+		    timer.elapsed<std::chrono::nanoseconds>());
+	}
+	total.stop();
+
+	result.ops = count;
+	result.elapsedNS = total.elapsed<std::chrono::nanoseconds>();
+	return (result);
+}
+
+/* Nearest-rank percentile of sorted latencies */
+static uint64_t
+percentile(
+    const std::vector<uint64_t> &sorted,
+    const double p)
+{
+	if (sorted.empty())
+		return (0);
+	const auto rank = static_cast<std::vector<uint64_t>::size_type>(
+	    (p / 100.0) * sorted.size());
+	return (sorted[std::min(rank, sorted.size() - 1)]);
+}
+
+static std::string
+toJSON(
+    Result result)
+{
+	std::sort(result.latencies.begin(), result.latencies.end());
+	const double seconds = result.elapsedNS / 1e9;
+
+	std::ostringstream json;
+	json << std::fixed << std::setprecision(3) <<
+	    "{\"workload\": \"" << result.workload << "\", " <<
+	    "\"ops\": " << result.ops << ", " <<
+	    "\"bytes\": " << result.bytes << ", " <<
+	    "\"seconds\": " << std::setprecision(6) << seconds <<
+	    std::setprecision(3) << ", " <<
+	    "\"ops_per_second\": " <<
+	    (seconds > 0 ? result.ops / seconds : 0) << ", " <<
+	    "\"mb_per_second\": " <<
+	    (seconds > 0 ? (result.bytes / 1e6) / seconds : 0) << ", " <<
+	    "\"p50_us\": " << percentile(result.latencies, 50) / 1e3 <<
+	    ", " <<
+	    "\"p99_us\": " << percentile(result.latencies, 99) / 1e3 <<
+	    ", " <<
+	    "\"max_us\": " << (result.latencies.empty() ? 0 :
+	    result.latencies.back() / 1e3) << "}";
+	return (json.str());
+}
+
+static std::string
+escapeJSON(
+    const std::string &str)
+{
+	std::string escaped;
+	for (const char c : str) {
+		if ((c == '"') || (c == '\\'))
+			escaped += '\\';
+		if (static_cast<unsigned char>(c) < 0x20)
+			escaped += ' ';
+		else
+			escaped += c;
+	}
+	return (escaped);
+}
+
+/*
+ * Ask the kernel to drop cached pages of every file in a RecordStore, so
+ * the next reads come from the storage device.  This is advisory; pages
+ * of files open elsewhere, or on some file systems, may remain cached.
+ */
+static void
+evictFromCache(
+    const std::string &pathname)
+{
+	for (const auto &entry :
+	    std::filesystem::recursive_directory_iterator(pathname)) {
+		if (!entry.is_regular_file())
+			continue;
+		const int fd = ::open(entry.path().c_str(), O_RDONLY);
+		if (fd < 0)
+			continue;
+		::fdatasync(fd);
+#ifdef POSIX_FADV_DONTNEED
+		::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+		::close(fd);
+	}
+}
+
+/* Sequential key for record i */
+static std::string
+keyFor(
+    const uint64_t i)
+{
+	std::ostringstream key;
+	key << "key" << std::setw(10) << std::setfill('0') << i;
+	return (key.str());
+}
+
+/* Cursor that sequences a RecordStore from the start */
+static int
+cursorFor(
+    const uint64_t i)
+{
+	return (i == 0 ? BE::IO::RecordStore::BE_RECSTORE_SEQ_START :
+	    BE::IO::RecordStore::BE_RECSTORE_SEQ_NEXT);
+}
+
+/*
+ * Run all workloads against one Kind with one record size, returning
+ * the JSON array of results.
+ */
+static std::string
+benchmark(
+    const BE::IO::RecordStore::Kind kind,
+    const uint64_t count,
+    const uint64_t size,
+    const std::string &directory,
+    const uint64_t seed)
+{
+	std::mt19937_64 rng(seed);
+
+	/* Unique data per record, so no Kind can store duplicates once */
+	BE::Memory::uint8Array data(std::max<uint64_t>(size,
+	    sizeof(uint64_t)));
+	std::uniform_int_distribution<unsigned int> byte(0, 255);
+	for (auto &b : data)
+		b = static_cast<uint8_t>(byte(rng));
+	const auto dataFor = [&](const uint64_t i) -> const uint8_t* {
+		std::memcpy(data, &i, sizeof(i));
+		return (data);
+	};
+
+	std::vector<uint64_t> order(count);
+	for (uint64_t i = 0; i < count; i++)
+		order[i] = i;
+	std::vector<uint64_t> shuffled{order};
+	std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+	const std::string kindName{BE::Framework::Enumeration::to_string(
+	    kind)};
+	const std::string pathname{directory + "/rsbench_" + kindName};
+	const std::string randomPathname{pathname + "_random"};
+	std::vector<Result> results;
+
+	for (const auto &p : {pathname, randomPathname})
+		if (BE::IO::Utility::fileExists(p))
+			throw BE::Error::ObjectExists(p);
+
+	std::shared_ptr<BE::IO::RecordStore> rs;
+	try {
+		rs = BE::IO::RecordStore::createRecordStore(pathname,
+		    "RecordStore benchmark", kind);
+		results.push_back(measure("insert_sequential", count,
+		    [&](const uint64_t i) {
+			rs->insert(keyFor(i), dataFor(i), size);
+			return (size);
+		    }));
+		rs->sync();
+
+		/* Warm: the data was just written through this handle */
+		results.push_back(measure("read_sequential_warm", count,
+		    [&](const uint64_t i) {
+			return (rs->read(keyFor(i)).size());
+		    }));
+		results.push_back(measure("read_random_warm", count,
+		    [&](const uint64_t i) {
+			return (rs->read(keyFor(shuffled[i])).size());
+		    }));
+		results.push_back(measure("sequence_warm", count,
+		    [&](const uint64_t i) {
+			return (rs->sequence(cursorFor(i)).data.size());
+		    }));
+
+		/* Cold: a new handle, with its files evicted from the cache */
+		rs.reset();
+		evictFromCache(pathname);
+		rs = BE::IO::RecordStore::openRecordStore(pathname,
+		    BE::IO::Mode::ReadWrite);
+		results.push_back(measure("read_random_cold", count,
+		    [&](const uint64_t i) {
+			return (rs->read(keyFor(shuffled[i])).size());
+		    }));
+		rs.reset();
+		evictFromCache(pathname);
+		rs = BE::IO::RecordStore::openRecordStore(pathname,
+		    BE::IO::Mode::ReadWrite);
+		results.push_back(measure("sequence_cold", count,
+		    [&](const uint64_t i) {
+			return (rs->sequence(cursorFor(i)).data.size());
+		    }));
+
+		std::bernoulli_distribution isWrite(MIXED_WRITE_FRACTION);
+		std::uniform_int_distribution<uint64_t> anyRecord(0, count - 1);
+		results.push_back(measure("mixed", count,
+		    [&](const uint64_t) -> uint64_t {
+			const uint64_t i = anyRecord(rng);
+			if (isWrite(rng)) {
+				rs->replace(keyFor(i), dataFor(i + count),
+				    size);
+				return (size);
+			}
+			return (rs->read(keyFor(i)).size());
+		    }));
+		rs.reset();
+		BE::IO::RecordStore::removeRecordStore(pathname);
+
+		rs = BE::IO::RecordStore::createRecordStore(randomPathname,
+		    "RecordStore benchmark", kind);
+		results.push_back(measure("insert_random", count,
+		    [&](const uint64_t i) {
+			rs->insert(keyFor(shuffled[i]), dataFor(shuffled[i]),
+			    size);
+			return (size);
+		    }));
+		rs.reset();
+		BE::IO::RecordStore::removeRecordStore(randomPathname);
+	} catch (const BE::Error::Exception &) {
+		/*
+		 * Leave nothing behind to collide with the next run.  Neither
+		 * path existed beforehand, so anything there is ours, even
+		 * when a failed creation left it incomplete.
+		 */
+		rs.reset();
+		for (const auto &p : {pathname, randomPathname}) {
+			std::error_code ec;
+			std::filesystem::remove_all(p, ec);
+		}
+		throw;
+	}
+
+	std::string json;
+	for (const auto &result : results) {
+		if (!json.empty())
+			json += ",\n";
+		json += "        " + toJSON(result);
+	}
+	return (json);
+}
+
+static void
+usage(
+    const char *name)
+{
+	std::cerr << "Usage: " << name << " [-n count] [-s size,...] "
+	    "[-k Kind,...] [-d directory] [-o output.json] [-r seed]" <<
+	    std::endl;
+}
+
+int
+main(
+    int argc,
+    char *argv[])
+{
+	uint64_t count{DEFAULT_COUNT};
+	std::vector<uint64_t> sizes{DEFAULT_SIZES};
+	std::vector<BE::IO::RecordStore::Kind> kinds{DEFAULT_KINDS};
+	std::string directory{"."};
+	std::string outputPath;
+	uint64_t seed{std::random_device()()};
+
+	int ch;
+	try {
+		while ((ch = getopt(argc, argv, "n:s:k:d:o:r:")) != -1) {
+			switch (ch) {
+			case 'n':
+				count = std::stoull(optarg);
+				break;
+			case 's':
+				sizes.clear();
+				for (const auto &s : BE::Text::split(optarg,
+				    ','))
+					sizes.push_back(std::stoull(s));
+				break;
+			case 'k':
+				kinds.clear();
+				for (const auto &k : BE::Text::split(optarg,
+				    ','))
+					kinds.push_back(BE::Framework::
+					    Enumeration::to_enum<BE::IO::
+					    RecordStore::Kind>(k));
+				break;
+			case 'd':
+				directory = optarg;
+				break;
+			case 'o':
+				outputPath = optarg;
+				break;
+			case 'r':
+				seed = std::stoull(optarg);
+				break;
+			default:
+				usage(argv[0]);
+				return (EXIT_FAILURE);
+			}
+		}
+	} catch (const std::exception &e) {
+		std::cerr << "Invalid argument: " << e.what() << std::endl;
+		usage(argv[0]);
+		return (EXIT_FAILURE);
+	}
+	if (count == 0) {
+		usage(argv[0]);
+		return (EXIT_FAILURE);
+	}
+
+	std::ostringstream json;
+	json << "{\n  \"count\": " << count << ",\n  \"seed\": " << seed <<
+	    ",\n  \"runs\": [\n";
+	bool first{true}, failed{false};
+	for (const auto kind : kinds) {
+		for (const auto size : sizes) {
+			const std::string kindName{
+			    BE::Framework::Enumeration::to_string(kind)};
+			std::cerr << kindName << ", " << count <<
+			    " records of " << size << " bytes... ";
+
+			if (!first)
+				json << ",\n";
+			first = false;
+			json << "    {\"kind\": \"" << kindName << "\", " <<
+			    "\"record_size\": " << size << ", ";
+			try {
+				const std::string results = benchmark(kind,
+				    count, size, directory, seed);
+				json << "\"results\": [\n" << results <<
+				    "\n      ]}";
+				std::cerr << "done." << std::endl;
+			} catch (const BE::Error::Exception &e) {
+				json << "\"error\": \"" <<
+				    escapeJSON(e.whatString()) << "\"}";
+				std::cerr << "failed: " << e.whatString() <<
+				    std::endl;
+				failed = true;
+			}
+		}
+	}
+	json << "\n  ]\n}\n";
+
+	if (outputPath.empty())
+		std::cout << json.str();
+	else {
+		std::ofstream output(outputPath);
+		output << json.str();
+		if (!output) {
+			std::cerr << "Could not write " << outputPath <<
+			    std::endl;
+			return (EXIT_FAILURE);
+		}
+	}
+	return (failed ? EXIT_FAILURE : EXIT_SUCCESS);
+}
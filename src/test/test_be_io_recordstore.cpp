@@ -15,6 +15,7 @@
 #include <sstream>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <be_io_utility.h>
 #include <be_memory_autoarrayutility.h>
@@ -50,6 +51,11 @@
 #define TESTDEFINED
 #endif
 
+#ifdef DEDUPLICATEDRECORDSTORETEST
+#include <be_io_deduplicatedrecstore.h>
+#define TESTDEFINED
+#endif
+
 #ifdef TESTDEFINED
 using namespace BiometricEvaluation;
 #endif
@@ -136,6 +142,138 @@ testIterator(
 	cout << "Record 3: " << it->key << endl;
 }
 
+/*
+ * Test that every record matches the checksum stored when it was written.
+ */
+static int
+testVerify(IO::RecordStore *rs)
+{
+	cout << "Verifying record checksums... ";
+	try {
+		if (!rs->hasChecksums()) {
+			cout << "checksums not enabled; failed." << endl;
+			return (-1);
+		}
+		std::vector<std::string> corrupt = rs->verify();
+		if (!corrupt.empty()) {
+			cout << "failed (" << corrupt.size() << " corrupt, "
+			    "including " << corrupt.front() << ")." << endl;
+			return (-1);
+		}
+		cout << "success." << endl;
+	} catch (const Error::Exception &e) {
+		cout << "failed: " << e.what() << endl;
+		return (-1);
+	}
+	return (0);
+}
+
+/*
+ * Test obtaining sorted ranges of keys, including after the RecordStore
+ * is modified.
+ */
+static int
+testKeyRange(IO::RecordStore *rs)
+{
+	const std::vector<std::string> inserted{"range_c", "range_a",
+	    "range_b_1", "rangf", "range_b"};
+	const std::string dataStr{"range data"};
+
+	cout << "Obtaining sorted key ranges... ";
+	try {
+		/* Obtain a range first, so it must track later changes */
+		if (!rs->getKeysWithPrefix("range_").empty()) {
+			cout << "failed (keys before insert)." << endl;
+			return (-1);
+		}
+		for (const auto &key : inserted)
+			rs->insert(key, dataStr.data(), dataStr.size());
+
+		if (rs->getKeysWithPrefix("range_") !=
+		    std::vector<std::string>{"range_a", "range_b",
+		    "range_b_1", "range_c"}) {
+			cout << "failed (prefix)." << endl;
+			return (-1);
+		}
+		if (rs->getKeyRange("range_b", "range_c") !=
+		    std::vector<std::string>{"range_b", "range_b_1"}) {
+			cout << "failed (range)." << endl;
+			return (-1);
+		}
+		if (!rs->getKeyRange("range_c", "range_a").empty()) {
+			cout << "failed (inverted range)." << endl;
+			return (-1);
+		}
+		if (rs->getKeyRange("range_c") !=
+		    std::vector<std::string>{"range_c", "rangf"}) {
+			cout << "failed (unbounded range)." << endl;
+			return (-1);
+		}
+
+		rs->remove("range_b");
+		if (rs->getKeysWithPrefix("range_b") !=
+		    std::vector<std::string>{"range_b_1"}) {
+			cout << "failed (prefix after remove)." << endl;
+			return (-1);
+		}
+
+		for (const auto &key : inserted)
+			if (key != "range_b")
+				rs->remove(key);
+		cout << "success." << endl;
+	} catch (const Error::Exception &e) {
+		cout << "failed: " << e.what() << endl;
+		return (-1);
+	}
+	return (0);
+}
+
+#ifdef DEDUPLICATEDRECORDSTORETEST
+/*
+ * Test that identical data stored under several keys is stored once.
+ */
+static int
+testDeduplication(IO::DeduplicatedRecordStore *rs)
+{
+	const unsigned int numDuplicates = 4;
+	const string dataStr(4096, 'D');
+	Memory::uint8Array data(dataStr.size());
+	data.copy((uint8_t *)dataStr.data(), dataStr.size());
+
+	cout << "\nInserting " << numDuplicates << " identical records... ";
+	try {
+		const uint64_t logicalSize = rs->getLogicalSize();
+		for (unsigned int i = 0; i < numDuplicates; i++)
+			rs->insert("dup" + to_string(i), data);
+		if (rs->getLogicalSize() !=
+		    (logicalSize + (numDuplicates * data.size()))) {
+			cout << "failed (logical size)." << endl;
+			return (-1);
+		}
+		cout << "deduplication ratio is " <<
+		    rs->getDeduplicationRatio() << "; success." << endl;
+
+		cout << "Removing all but one duplicate... ";
+		for (unsigned int i = 1; i < numDuplicates; i++)
+			rs->remove("dup" + to_string(i));
+		if (rs->read("dup0") != data) {
+			cout << "failed (data changed)." << endl;
+			return (-1);
+		}
+		rs->remove("dup0");
+		if (rs->getLogicalSize() != logicalSize) {
+			cout << "failed (logical size)." << endl;
+			return (-1);
+		}
+		cout << "success." << endl;
+	} catch (const Error::Exception &e) {
+		cout << "failed: " << e.what() << endl;
+		return (-1);
+	}
+	return (0);
+}
+#endif
+
 #ifdef MERGETESTDEFINED
 /*
  * Test the ability to merge RecordStores of different types
@@ -697,6 +835,22 @@ main(int argc, char* argv[]) {
 	}
 #endif
 
+#ifdef DEDUPLICATEDRECORDSTORETEST
+	/* Call the constructor that will create a new DeduplicatedRecordStore. */
+	rsPath = "deduprs_test";
+	IO::DeduplicatedRecordStore *rs;
+	try {
+		rs = new IO::DeduplicatedRecordStore(rsPath,
+		    "DeduplicatedRecordStore Test", IO::RecordStore::Kind::SQLite);
+	} catch (const Error::ObjectExists &e) {
+		cout << "The Deduplicated Record Store exists; exiting." << endl;
+		return (EXIT_FAILURE);
+	} catch (const Error::StrategyError& e) {
+		cout << "A strategy error occurred: " << e.what() << endl;
+		return (EXIT_FAILURE);
+	}
+#endif
+
 #ifdef TESTDEFINED
 
 	cout << "Running tests with new record store:" << endl;
@@ -707,7 +861,17 @@ main(int argc, char* argv[]) {
 	} else
 		std::cout << "[PASS]\n";
 
-	if (runTests(rs) != 0) {
+	cout << "Enabling checksums... ";
+	try {
+		rs->enableChecksums();
+		cout << "success." << endl;
+	} catch (const Error::Exception &e) {
+		cout << "failed: " << e.what() << endl;
+		delete rs;
+		return (EXIT_FAILURE);
+	}
+
+	if ((runTests(rs) != 0) || (testVerify(rs) != 0)) {
 		delete rs;
 		return (EXIT_FAILURE);
 	}
@@ -785,6 +949,20 @@ main(int argc, char* argv[]) {
 	}
 #endif
 
+#ifdef DEDUPLICATEDRECORDSTORETEST
+	/* Call the constructor that will open an existing DeduplicatedRecordStore.*/
+	rsPath = "deduprs_test";
+	try {
+		rs = new IO::DeduplicatedRecordStore(rsPath, IO::Mode::ReadWrite);
+	} catch (const Error::ObjectDoesNotExist &e) {
+		cout << "The Deduplicated Record Store does not exist; exiting." << endl;
+		return (EXIT_FAILURE);
+	} catch (const Error::StrategyError& e) {
+		cout << "A strategy error occurred: " << e.what() << endl;
+		return (EXIT_FAILURE);
+	}
+#endif
+
 #ifdef TESTDEFINED
 
 	cout << endl << "----------------------------------------" << endl << endl;
@@ -797,11 +975,19 @@ main(int argc, char* argv[]) {
 		return (EXIT_FAILURE);
 	}
 
-	if (runTests(rs) != 0) {
+	if ((runTests(rs) != 0) || (testVerify(rs) != 0) ||
+	    (testKeyRange(rs) != 0)) {
 		delete rs;
 		return (EXIT_FAILURE);
 	}
 
+#ifdef DEDUPLICATEDRECORDSTORETEST
+	if (testDeduplication(rs) != 0) {
+		delete rs;
+		return (EXIT_FAILURE);
+	}
+#endif
+
 #ifdef ARCHIVERECORDSTORETEST
 	/*
 	 * Test vacuuming an ArchiveRecordStore
@@ -852,7 +1038,7 @@ main(int argc, char* argv[]) {
 		cout << "A strategy error occurred: " << e.what() << endl;
 		return (EXIT_FAILURE);
 	}
-	if (runTests(srs.get()) != 0)
+	if ((runTests(srs.get()) != 0) || (testVerify(srs.get()) != 0))
 		return (EXIT_FAILURE);
 	srs.reset();		// Close the RecordStore
 
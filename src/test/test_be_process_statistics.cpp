@@ -85,6 +85,84 @@ testMemorySizes(Process::Statistics &stats)
 	return (0);
 }
 
+static int
+testSampling(Process::Statistics &stats)
+{
+	cout << "Testing sample(): ";
+	try {
+		const auto first = stats.sample();
+		LONGDELAY;
+		const auto second = stats.sample();
+		if ((second.timestamp <= first.timestamp) ||
+		    (second.utime < first.utime) || (second.vmrss == 0) ||
+		    (second.tasks.size() != second.threads)) {
+			cout << "failure." << endl;
+			return (-1);
+		}
+		/* The delay was spent in this task */
+		uint64_t delta{0};
+		for (const auto &task : second.tasks)
+			if (task.tid == (pid_t)syscall(SYS_gettid))
+				delta = task.utimeDelta;
+		cout << "main task utime delta " << delta << ", read " <<
+		    second.readChars << " bytes in " << second.readCalls <<
+		    " calls: ";
+		if (delta == 0) {
+			cout << "failure." << endl;
+			return (-1);
+		}
+		cout << "success." << endl;
+
+		cout << "Testing sample capacity: ";
+		stats.setSampleCapacity(3);
+		for (int i = 0; i < 5; i++)
+			stats.sample();
+		auto samples = stats.getSamples();
+		if ((samples.size() != 3) ||
+		    (samples[0].timestamp > samples[1].timestamp) ||
+		    (samples[1].timestamp > samples[2].timestamp)) {
+			cout << "failure." << endl;
+			return (-1);
+		}
+		bool success = false;
+		try {
+			stats.setSampleCapacity(0);
+		} catch (const Error::ParameterError &) {
+			success = true;
+		}
+		if (!success) {
+			cout << "failure." << endl;
+			return (-1);
+		}
+		cout << "success." << endl;
+
+		cout << "Testing auto-sampling: " << flush;
+		stats.setSampleCapacity(100);
+		stats.startAutoSampling(Time::MicrosecondsPerSecond / 10);
+		sleep(1);
+		success = false;
+		try {
+			stats.startAutoSampling(1);
+		} catch (const Error::ObjectExists &) {
+			success = true;
+		}
+		stats.stopAutoSampling();
+		samples = stats.getSamples();
+		cout << samples.size() << " samples: ";
+		if (!success || (samples.size() < 5) || (samples.size() > 12)) {
+			cout << "failure." << endl;
+			return (-1);
+		}
+		cout << "success." << endl;
+	} catch (const Error::NotImplemented &e) {
+		cout << "Caught " << e.what() << "; OK" << endl;
+	} catch (const Error::Exception &e) {
+		cout << "Caught " << e.what() << "; failure." << endl;
+		return (-1);
+	}
+	return (0);
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -162,6 +240,12 @@ main(int argc, char *argv[])
 	if (testMemorySizes(stats) != 0)
 		return (EXIT_FAILURE);
 
+	/*
+	 * Samples, without logging.
+	 */
+	if (testSampling(stats) != 0)
+		return (EXIT_FAILURE);
+
 	pthread_join(thread1, nullptr);
 	pthread_join(thread2, nullptr);
 	pthread_join(thread3, nullptr);
@@ -231,6 +231,13 @@ TestRecordProcessor::processRecord(
 	 */
 	BE::IO::Logsheet *rlog = this->_recordLogsheet.get();
 	dumpRecord(*rlog, key, value);
+
+	/*
+	 * Return the size of the record to the Distributor, which
+	 * stores it when the Result Record Store property is set.
+	 */
+	const std::string size = std::to_string(value.size());
+	this->emitResult(key, size.c_str(), size.size());
 }
 
 /*
@@ -274,17 +281,22 @@ main(int argc, char* argv[])
 	 * are take care of.
 	 */
 	/*
-	 * Process optional checkpoint and include-values flags.
+	 * Process optional checkpoint, include-values, and in-process
+	 * (run without MPI) flags.
 	 */
-	bool checkpoint{false}, includeValues{false};
+	bool checkpoint{false}, includeValues{false}, inProcess{false};
 	char ch;
-	while ((ch = getopt(argc, argv, "cv")) != -1) {
+	while ((ch = getopt(argc, argv, "cvl")) != -1) {
 		switch (ch) {
 			case 'c': checkpoint = true; break;
 			case 'v': includeValues = true; break;
+			case 'l': inProcess = true; break;
 		}
 	}
-	MPI::Runtime runtime(argc, argv, checkpoint);
+	std::unique_ptr<MPI::Runtime> runtimeInstance(inProcess ?
+	    new MPI::Runtime(checkpoint) :
+	    new MPI::Runtime(argc, argv, checkpoint));
+	MPI::Runtime &runtime = *runtimeInstance;
 
 	std::string propFile;
 	/* Create the properties file if needed */